@@ -0,0 +1,42 @@
+#import <Foundation/Foundation.h>
+
+/// Persists graph history across relaunches so cards paint from disk and
+/// only fetch what happened since. One compact binary file per series in
+/// the current server's expendableCacheDirectory (so it is keyed by server
+/// URL, cleared with clearAllCaches, and purgeable by the OS). Past
+/// byteLimit the least recently read or written series are evicted.
+@interface HAHistoryDiskCache : NSObject
+
++ (instancetype)sharedCache;
+
+/// Disk budget for all series of the current server. Default 4 MB.
+@property (nonatomic, assign) unsigned long long byteLimit;
+
+/// Series key for a live window (ending now) of an entity: range is
+/// rounded to the minute, so successive "last N hours" requests share it.
++ (NSString *)keyForEntityId:(NSString *)entityId range:(NSTimeInterval)range maxPoints:(NSUInteger)maxPoints;
+
+/// Read a series off the main thread. Completion runs on the main queue
+/// with points in timestamp order and the range they were fetched for,
+/// or nil points if there is no usable series.
+- (void)readSeriesForKey:(NSString *)key
+              completion:(void (^)(NSArray<NSDictionary *> *points, NSTimeInterval coveredStart, NSTimeInterval coveredEnd))completion;
+
+/// Replace a series and evict down to byteLimit, asynchronously.
+- (void)writeSeries:(NSArray<NSDictionary *> *)points
+       coveredStart:(NSTimeInterval)coveredStart
+         coveredEnd:(NSTimeInterval)coveredEnd
+             forKey:(NSString *)key;
+
+/// Binary encoding: 32-byte header, then per point float64 offset from
+/// coveredStart and float64 value (plus min/max when the series has bands).
++ (NSData *)dataForPoints:(NSArray<NSDictionary *> *)points
+             coveredStart:(NSTimeInterval)coveredStart
+               coveredEnd:(NSTimeInterval)coveredEnd;
+
+/// Decode; nil if the data is truncated or not a series.
++ (NSArray<NSDictionary *> *)pointsFromData:(NSData *)data
+                               coveredStart:(NSTimeInterval *)coveredStart
+                                 coveredEnd:(NSTimeInterval *)coveredEnd;
+
+@end
@@ -0,0 +1,209 @@
+#import "HAHistoryDiskCache.h"
+#import "HACacheManager.h"
+#import "HALog.h"
+
+static NSString *const kHistoryDirectory = @"history";
+static NSString *const kSeriesExtension = @"series";
+static const uint32_t kSeriesMagic = 0x32484148; // "HAH2"; "HAH1" files held float32 values
+static const uint16_t kSeriesFlagBands = 1 << 0;
+
+/// On-disk header, little-endian (every device we run on).
+typedef struct {
+    uint32_t magic;
+    uint16_t flags;
+    uint16_t reserved;
+    uint32_t count;
+    uint32_t padding;
+    double coveredStart;
+    double coveredEnd;
+} HASeriesHeader;
+
+@interface HAHistoryDiskCache ()
+@property (nonatomic, strong) dispatch_queue_t ioQueue;
+@end
+
+@implementation HAHistoryDiskCache
+
++ (instancetype)sharedCache {
+    static HAHistoryDiskCache *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[HAHistoryDiskCache alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _byteLimit = 4 * 1024 * 1024;
+        _ioQueue = dispatch_queue_create("com.hadashboard.cache.history", DISPATCH_QUEUE_SERIAL);
+    }
+    return self;
+}
+
++ (NSString *)keyForEntityId:(NSString *)entityId range:(NSTimeInterval)range maxPoints:(NSUInteger)maxPoints {
+    // Entity IDs are [a-z0-9_.] already; anything else can't escape the directory
+    NSCharacterSet *unsafe = [[NSCharacterSet characterSetWithCharactersInString:
+                               @"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789._-"] invertedSet];
+    NSString *safeId = [[entityId componentsSeparatedByCharactersInSet:unsafe] componentsJoinedByString:@"_"];
+    return [NSString stringWithFormat:@"%@-%ldm-%lu", safeId, (long)llround(range / 60.0), (unsigned long)maxPoints];
+}
+
+#pragma mark - Paths
+
+/// Resolved on the calling thread, so a server switch can't redirect a
+/// queued read or write into the other server's directory.
+- (NSString *)directory {
+    NSString *base = [[HACacheManager sharedManager] expendableCacheDirectory];
+    if (!base) return nil;
+    return [base stringByAppendingPathComponent:kHistoryDirectory];
+}
+
+- (NSString *)pathForKey:(NSString *)key inDirectory:(NSString *)dir {
+    return [[dir stringByAppendingPathComponent:key] stringByAppendingPathExtension:kSeriesExtension];
+}
+
+#pragma mark - Read / Write
+
+- (void)readSeriesForKey:(NSString *)key
+              completion:(void (^)(NSArray<NSDictionary *> *, NSTimeInterval, NSTimeInterval))completion {
+    if (!completion) return;
+    NSString *dir = [self directory];
+    if (!dir || !key) {
+        dispatch_async(dispatch_get_main_queue(), ^{ completion(nil, 0, 0); });
+        return;
+    }
+    NSString *path = [self pathForKey:key inDirectory:dir];
+
+    dispatch_async(self.ioQueue, ^{
+        NSData *data = [NSData dataWithContentsOfFile:path];
+        NSTimeInterval coveredStart = 0, coveredEnd = 0;
+        NSArray *points = data ? [HAHistoryDiskCache pointsFromData:data coveredStart:&coveredStart coveredEnd:&coveredEnd] : nil;
+        NSFileManager *fm = [NSFileManager defaultManager];
+        if (data && !points) {
+            HALogW(@"cache", @"Discarding unreadable history series %@", key);
+            [fm removeItemAtPath:path error:nil];
+        } else if (points) {
+            // Reads count as use for LRU eviction
+            [fm setAttributes:@{NSFileModificationDate: [NSDate date]} ofItemAtPath:path error:nil];
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(points, coveredStart, coveredEnd);
+        });
+    });
+}
+
+- (void)writeSeries:(NSArray<NSDictionary *> *)points
+       coveredStart:(NSTimeInterval)coveredStart
+         coveredEnd:(NSTimeInterval)coveredEnd
+             forKey:(NSString *)key {
+    NSString *dir = [self directory];
+    if (!dir || !key || points.count == 0) return;
+    NSString *path = [self pathForKey:key inDirectory:dir];
+    NSArray *snapshot = [points copy];
+
+    dispatch_async(self.ioQueue, ^{
+        NSData *data = [HAHistoryDiskCache dataForPoints:snapshot coveredStart:coveredStart coveredEnd:coveredEnd];
+        [[NSFileManager defaultManager] createDirectoryAtPath:dir withIntermediateDirectories:YES attributes:nil error:nil];
+        if (![data writeToFile:path atomically:YES]) {
+            HALogE(@"cache", @"Failed to write history series %@", key);
+            return;
+        }
+        [self evictInDirectory:dir];
+    });
+}
+
+/// Oldest-modified first until the directory fits byteLimit. ioQueue only.
+- (void)evictInDirectory:(NSString *)dir {
+    NSFileManager *fm = [NSFileManager defaultManager];
+    NSArray<NSString *> *keys = @[NSURLContentModificationDateKey, NSURLFileSizeKey];
+    NSArray<NSURL *> *files = [fm contentsOfDirectoryAtURL:[NSURL fileURLWithPath:dir]
+                                includingPropertiesForKeys:keys
+                                                   options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                     error:nil];
+    unsigned long long total = 0;
+    NSMutableArray<NSDictionary *> *entries = [NSMutableArray arrayWithCapacity:files.count];
+    for (NSURL *url in files) {
+        NSDictionary *values = [url resourceValuesForKeys:keys error:nil];
+        unsigned long long size = [values[NSURLFileSizeKey] unsignedLongLongValue];
+        total += size;
+        [entries addObject:@{@"url": url, @"size": @(size), @"date": values[NSURLContentModificationDateKey] ?: [NSDate distantPast]}];
+    }
+    if (total <= self.byteLimit) return;
+
+    [entries sortUsingComparator:^NSComparisonResult(NSDictionary *a, NSDictionary *b) {
+        return [a[@"date"] compare:b[@"date"]];
+    }];
+    NSUInteger evicted = 0;
+    for (NSDictionary *entry in entries) {
+        if (total <= self.byteLimit) break;
+        if ([fm removeItemAtURL:entry[@"url"] error:nil]) {
+            total -= [entry[@"size"] unsignedLongLongValue];
+            evicted++;
+        }
+    }
+    HALogD(@"cache", @"Evicted %lu history series (%llu bytes kept)", (unsigned long)evicted, total);
+}
+
+#pragma mark - Encoding
+
++ (NSData *)dataForPoints:(NSArray<NSDictionary *> *)points
+             coveredStart:(NSTimeInterval)coveredStart
+               coveredEnd:(NSTimeInterval)coveredEnd {
+    BOOL bands = (points.firstObject[@"min"] != nil);
+    NSUInteger doublesPerPoint = bands ? 4 : 2;
+
+    HASeriesHeader header = {0};
+    header.magic = kSeriesMagic;
+    header.flags = bands ? kSeriesFlagBands : 0;
+    header.count = (uint32_t)points.count;
+    header.coveredStart = coveredStart;
+    header.coveredEnd = coveredEnd;
+
+    NSMutableData *data = [NSMutableData dataWithCapacity:sizeof(header) + points.count * doublesPerPoint * sizeof(double)];
+    [data appendBytes:&header length:sizeof(header)];
+    for (NSDictionary *pt in points) {
+        // float64 throughout: cumulative meters (energy, water) outgrow float32's ~7 digits
+        double record[4];
+        record[0] = [pt[@"timestamp"] doubleValue] - coveredStart;
+        record[1] = [pt[@"value"] doubleValue];
+        if (bands) {
+            // A point without a band collapses onto its value
+            record[2] = pt[@"min"] ? [pt[@"min"] doubleValue] : record[1];
+            record[3] = pt[@"max"] ? [pt[@"max"] doubleValue] : record[1];
+        }
+        [data appendBytes:record length:doublesPerPoint * sizeof(double)];
+    }
+    return data;
+}
+
++ (NSArray<NSDictionary *> *)pointsFromData:(NSData *)data
+                               coveredStart:(NSTimeInterval *)coveredStart
+                                 coveredEnd:(NSTimeInterval *)coveredEnd {
+    if (data.length < sizeof(HASeriesHeader)) return nil;
+    HASeriesHeader header;
+    memcpy(&header, data.bytes, sizeof(header));
+    if (header.magic != kSeriesMagic) return nil;
+
+    BOOL bands = (header.flags & kSeriesFlagBands) != 0;
+    NSUInteger doublesPerPoint = bands ? 4 : 2;
+    if (data.length != sizeof(header) + (NSUInteger)header.count * doublesPerPoint * sizeof(double)) return nil;
+
+    const double *records = (const double *)((const uint8_t *)data.bytes + sizeof(header));
+    NSMutableArray<NSDictionary *> *points = [NSMutableArray arrayWithCapacity:header.count];
+    for (uint32_t i = 0; i < header.count; i++) {
+        const double *r = records + i * doublesPerPoint;
+        NSNumber *timestamp = @(header.coveredStart + r[0]);
+        if (bands) {
+            [points addObject:@{@"timestamp": timestamp, @"value": @(r[1]), @"min": @(r[2]), @"max": @(r[3])}];
+        } else {
+            [points addObject:@{@"timestamp": timestamp, @"value": @(r[1])}];
+        }
+    }
+    if (coveredStart) *coveredStart = header.coveredStart;
+    if (coveredEnd) *coveredEnd = header.coveredEnd;
+    return points;
+}
+
+@end
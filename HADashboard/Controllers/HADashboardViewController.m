@@ -22,6 +22,14 @@
 #import "HASectionHeaderView.h"
 #import "HAColumnarLayout.h"
 #import "HAMasonryLayout.h"
+#import "HALayoutInvalidationContext.h"
+#import "HACardHeightCache.h"
+#import "HAUpdateFlusher.h"
+#import "HACellRenderStamp.h"
+#import "HACellViewModel.h"
+#import "HACardPrefetcher.h"
+#import "HACellWarmer.h"
+#import "HARequestCoalescer.h"
 #import "HAPanelLayout.h"
 #import "HASidebarLayout.h"
 #import "HABadgeRowCell.h"
@@ -39,18 +47,26 @@
 #import "HAMediaPlayerEntityCell.h"
 #import "HATileEntityCell.h"
 #import "HACalendarCardCell.h"
+#import "HAAreaCardCell.h"
 #import "HALogbookCardCell.h"
 #import "HATopAlignedFlowLayout.h"
 #import "HAHistoryManager.h"
+#import "HALogbookManager.h"
+#import "HADashboardConfigDiff.h"
+#import "HAVisibilityEngine.h"
+#import "HABitmapBufferPool.h"
 #import "HASunBasedTheme.h"
 #import <QuartzCore/QuartzCore.h>
 
 static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
 
+/// Row views made ahead for entities cards off screen, at most
+static const NSUInteger kMaxSpareRowViews = 32;
+
 @interface HADashboardViewController () <UICollectionViewDataSource, UICollectionViewDelegate,
     UICollectionViewDelegateFlowLayout, HAColumnarLayoutDelegate, HAMasonryLayoutDelegate, HAPanelLayoutDelegate,
     HASidebarLayoutDelegate, HAConnectionManagerDelegate, HAEntityDetailDelegate,
-    UIGestureRecognizerDelegate>
+    UIGestureRecognizerDelegate, HAUpdateFlusherDelegate, UICollectionViewDataSourcePrefetching>
 @property (nonatomic, strong) UICollectionView *collectionView;
 @property (nonatomic, strong) UIRefreshControl *refreshControl;
 @property (nonatomic, strong) UISegmentedControl *viewPicker;
@@ -60,7 +76,10 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
 @property (nonatomic, strong) UILabel *statusLabel;
 @property (nonatomic, strong) UIActivityIndicatorView *spinner;
 @property (nonatomic, strong) HADashboardConfig *dashboardConfig;
-@property (nonatomic, strong) NSSet<NSString *> *conditionEntityIds; // entity IDs used in visibility conditions
+@property (nonatomic, copy) NSString *builtViewKey; // which view dashboardConfig was built for
+@property (nonatomic, strong) HADashboardConfig *unfilteredConfig; // as built, before visibility conditions
+@property (nonatomic, strong) HAVisibilityEngine *visibilityEngine;
+@property (nonatomic, strong) HACardHeightCache *cardHeightCache;
 @property (nonatomic, strong) HALovelaceDashboard *lovelaceDashboard;
 @property (nonatomic, assign) NSUInteger selectedViewIndex;
 @property (nonatomic, assign) BOOL statesLoaded;
@@ -73,8 +92,12 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
 @property (nonatomic, strong) NSLayoutConstraint *collectionViewTopToPickerConstraint;
 @property (nonatomic, strong) NSLayoutConstraint *collectionViewTopToViewConstraint;
 @property (nonatomic, strong) NSLayoutConstraint *collectionViewTopToSafeAreaConstraint;
-@property (nonatomic, strong) NSMutableSet<NSIndexPath *> *pendingReloadPaths;
-@property (nonatomic, strong) NSTimer *reloadCoalesceTimer;
+@property (nonatomic, strong) HAUpdateFlusher *updateFlusher; // coalesces cell reloads onto display frames
+@property (nonatomic, strong) NSMapTable<UICollectionViewCell *, HACellRenderStamp *> *renderStamps; // what each cell was configured from
+@property (nonatomic, strong) dispatch_queue_t viewModelQueue; // builds tile view models off the main thread
+@property (nonatomic, strong) HACardPrefetcher *cardPrefetcher; // network loads for cards about to appear
+@property (nonatomic, strong) HACellWarmer *cellWarmer; // creates cells ahead of the first scroll, in idle time
+@property (nonatomic, strong) NSMutableSet<Class> *warmedCellClasses; // created at least once this launch
 @property (nonatomic, strong) CAGradientLayer *backgroundGradient;
 @property (nonatomic, strong) HABottomSheetTransitioningDelegate *bottomSheetDelegate;
 @property (nonatomic, strong) UILongPressGestureRecognizer *longPressGesture;
@@ -100,6 +123,15 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
     [self.view.layer insertSublayer:self.backgroundGradient atIndex:0];
     [self applyTheme];
 
+    self.updateFlusher = [[HAUpdateFlusher alloc] init];
+    self.renderStamps = [NSMapTable weakToStrongObjectsMapTable];
+    self.viewModelQueue = dispatch_queue_create("com.hadashboard.dash.viewmodels",
+                                                dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+    self.updateFlusher.delegate = self;
+    self.cardPrefetcher = [[HACardPrefetcher alloc] init];
+    self.cellWarmer = [[HACellWarmer alloc] init];
+    self.warmedCellClasses = [NSMutableSet set];
+
     // Compact nav bar
     if (@available(iOS 11.0, *)) {
         self.navigationController.navigationBar.prefersLargeTitles = NO;
@@ -293,6 +325,7 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
 - (void)viewWillDisappear:(BOOL)animated {
     [super viewWillDisappear:animated];
     [[NSNotificationCenter defaultCenter] removeObserver:self];
+    [self.cellWarmer stop];
     [self.kioskHideTimer invalidate];
     self.kioskHideTimer = nil;
 
@@ -311,6 +344,10 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
 - (void)didReceiveMemoryWarning {
     [super didReceiveMemoryWarning];
     [[HAHistoryManager sharedManager] clearCache];
+    [[HABitmapBufferPool sharedPool] drain];
+    [self.cardHeightCache removeAllHeights];
+    [self.cellWarmer stop];
+    [HAEntitiesCardCell removeAllSpareRowViews];
     HALogW(@"dash", @"Memory warning received, caches cleared");
 }
 
@@ -365,6 +402,7 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
 
 - (void)themeDidChange:(NSNotification *)notification {
     [self applyTheme];
+    [HAEntitiesCardCell removeAllSpareRowViews];
     [self.collectionView.collectionViewLayout invalidateLayout];
     [self.collectionView reloadData];
 }
@@ -451,6 +489,9 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
     self.collectionView.backgroundColor = [UIColor clearColor];
     self.collectionView.dataSource = self;
     self.collectionView.delegate = self;
+    if (@available(iOS 10.0, *)) {
+        self.collectionView.prefetchDataSource = self;
+    }
     self.collectionView.alwaysBounceVertical = YES;
     self.collectionView.translatesAutoresizingMaskIntoConstraints = NO;
     [self.view addSubview:self.collectionView];
@@ -734,9 +775,31 @@ static NSString * const kSectionHeaderReuseId = @"HASectionHeader";
 /// HA sections layout row unit height (matches web UI ~56px per row unit).
 static const CGFloat kRowUnitHeight = 56.0;
 
+/// Card height, memoized in cardHeightCache. What the computation reads
+/// besides the item: its section (for cards without their own
+/// entitiesSection), its entity, and for entities cards their rows.
 - (CGFloat)heightForItemAtIndexPath:(NSIndexPath *)indexPath itemWidth:(CGFloat)itemWidth {
     HADashboardConfigItem *item = [self itemAtIndexPath:indexPath];
     HADashboardConfigSection *section = [self sectionAtIndex:indexPath.section];
+    if (!self.cardHeightCache) self.cardHeightCache = [[HACardHeightCache alloc] init];
+
+    NSArray<NSString *> *entityIds = item.entityId ? @[item.entityId] : @[];
+    if ([item.cardType isEqualToString:@"entities"]) {
+        HADashboardConfigSection *entSection = item.entitiesSection ?: section;
+        if (entSection.entityIds.count > 0) entityIds = [entityIds arrayByAddingObjectsFromArray:entSection.entityIds];
+    }
+    return [self.cardHeightCache heightForItem:item
+                                       section:item.entitiesSection ? nil : section
+                                         width:itemWidth
+                                     entityIds:entityIds
+                                    computedBy:^CGFloat{
+        return [self computeHeightForItem:item section:section itemWidth:itemWidth];
+    }];
+}
+
+- (CGFloat)computeHeightForItem:(HADashboardConfigItem *)item
+                        section:(HADashboardConfigSection *)section
+                      itemWidth:(CGFloat)itemWidth {
     HAEntity *entity = [[HAConnectionManager sharedManager] entityForId:item.entityId];
 
     // Extra height for items that have a heading above the card
@@ -766,8 +829,13 @@ static const CGFloat kRowUnitHeight = 56.0;
     } else if ([item.cardType isEqualToString:@"entities"]) {
         HADashboardConfigSection *entSection = item.entitiesSection ?: section;
         if (entSection.entityIds.count > 0 || entSection.customProperties[@"sceneEntityIds"]) {
-            NSDictionary *allEntities = [[HAConnectionManager sharedManager] allEntities];
-            height = [HAEntitiesCardCell preferredHeightForSection:entSection entities:allEntities] + headingExtra;
+            // Just this card's rows, not a copy of the whole entity store
+            NSMutableDictionary *rowEntities = [NSMutableDictionary dictionaryWithCapacity:entSection.entityIds.count];
+            for (NSString *eid in entSection.entityIds) {
+                HAEntity *rowEntity = [[HAConnectionManager sharedManager] entityForId:eid];
+                if (rowEntity) rowEntities[eid] = rowEntity;
+            }
+            height = [HAEntitiesCardCell preferredHeightForSection:entSection entities:rowEntities] + headingExtra;
         } else {
             height = 100.0 + headingExtra;
         }
@@ -803,10 +871,7 @@ static const CGFloat kRowUnitHeight = 56.0;
         BOOL isCompact = [item.customProperties[@"compact"] boolValue];
         height = (isCompact ? [HATileEntityCell compactHeight] : [HATileEntityCell preferredHeightForConfigItem:item]) + headingExtra;
     } else if ([item.cardType isEqualToString:@"logbook"]) {
-        NSInteger hours = 24;
-        if ([item.customProperties[@"hours_to_show"] isKindOfClass:[NSNumber class]]) {
-            hours = [item.customProperties[@"hours_to_show"] integerValue];
-        }
+        NSInteger hours = [HALogbookCardCell hoursToShowForConfigItem:item];
         height = [HALogbookCardCell preferredHeightForHours:hours] + headingExtra;
     } else {
         height = 100.0 + headingExtra;
@@ -830,34 +895,22 @@ static const CGFloat kRowUnitHeight = 56.0;
     return MAX(cols, 1);
 }
 
-/// Remove items from dashboardConfig whose visibilityConditions aren't met.
-/// Also collects all condition entity IDs for change detection in entityDidUpdate:.
-- (void)filterConditionalItems:(NSDictionary<NSString *, HAEntity *> *)entities {
-    if (!self.dashboardConfig) return;
-
-    // Collect all entity IDs used in conditions (before filtering removes them)
-    NSMutableSet<NSString *> *condIds = [NSMutableSet set];
-    for (HADashboardConfigSection *section in self.dashboardConfig.sections) {
-        for (HADashboardConfigItem *item in section.items) {
-            for (NSDictionary *cond in item.visibilityConditions) {
-                NSString *eid = cond[@"entity"];
-                if (eid) [condIds addObject:eid];
-            }
-        }
-    }
-    for (HADashboardConfigItem *item in self.dashboardConfig.items) {
-        for (NSDictionary *cond in item.visibilityConditions) {
-            NSString *eid = cond[@"entity"];
-            if (eid) [condIds addObject:eid];
-        }
-    }
-    self.conditionEntityIds = [condIds copy];
+/// Copy of config without the items the visibility engine has hidden.
+/// Items are shared, not copied, so diffing against the previous visible
+/// config sees only the items that appeared or disappeared.
+- (HADashboardConfig *)visibleConfigFromConfig:(HADashboardConfig *)config {
+    if (!config) return nil;
+    HADashboardConfig *visible = [[HADashboardConfig alloc] init];
+    visible.title = config.title;
+    visible.columns = config.columns;
+    visible.strategyType = config.strategyType;
+    visible.strategyConfig = config.strategyConfig;
 
     NSMutableArray<HADashboardConfigSection *> *filteredSections = [NSMutableArray array];
-    for (HADashboardConfigSection *section in self.dashboardConfig.sections) {
+    for (HADashboardConfigSection *section in config.sections) {
         NSMutableArray<HADashboardConfigItem *> *filteredItems = [NSMutableArray array];
         for (HADashboardConfigItem *item in section.items) {
-            if ([self item:item meetsConditions:entities]) {
+            if ([self.visibilityEngine isItemVisible:item]) {
                 [filteredItems addObject:item];
             }
         }
@@ -876,54 +929,76 @@ static const CGFloat kRowUnitHeight = 56.0;
     }
     // Also filter top-level items
     NSMutableArray<HADashboardConfigItem *> *filteredItems = [NSMutableArray array];
-    for (HADashboardConfigItem *item in self.dashboardConfig.items) {
-        if ([self item:item meetsConditions:entities]) {
+    for (HADashboardConfigItem *item in config.items) {
+        if ([self.visibilityEngine isItemVisible:item]) {
             [filteredItems addObject:item];
         }
     }
-    self.dashboardConfig.sections = filteredSections;
-    self.dashboardConfig.items = filteredItems;
+    visible.sections = filteredSections;
+    visible.items = filteredItems;
+    return visible;
+}
+
+/// Show and hide the items in change without rebuilding: the visible
+/// config is re-derived from unfilteredConfig and diffed against the one
+/// on screen, so only those items are inserted or deleted (animated).
+/// Returns NO if it had to fall back to a full reload.
+- (BOOL)applyVisibilityChange:(HAVisibilityChange *)change {
+    if (!change.hasChanges || !self.unfilteredConfig) return YES;
+    HALogD(@"dash", @"Visibility: %lu shown, %lu hidden",
+           (unsigned long)change.shownItems.count, (unsigned long)change.hiddenItems.count);
+    HADashboardConfig *oldConfig = self.dashboardConfig;
+    HADashboardConfig *newConfig = [self visibleConfigFromConfig:self.unfilteredConfig];
+    HADashboardConfigDiff *diff = oldConfig ? [HADashboardConfigDiff diffFromConfig:oldConfig toConfig:newConfig] : nil;
+    self.dashboardConfig = newConfig;
+    if (diff) {
+        [self applyDashboardDiff:diff fromConfig:oldConfig];
+        return YES;
+    }
+    [self.cardPrefetcher cancelAll];
+    [self buildEntityToIndexPathMap];
+    [self.collectionView reloadData];
+    return NO;
 }
 
-/// Check if item's visibilityConditions are all met. nil conditions = always visible.
-- (BOOL)item:(HADashboardConfigItem *)item meetsConditions:(NSDictionary<NSString *, HAEntity *> *)entities {
-    NSArray<NSDictionary *> *conditions = item.visibilityConditions;
-    if (!conditions || conditions.count == 0) return YES;
-
-    for (NSDictionary *condition in conditions) {
-        NSString *entityId = condition[@"entity"];
-        NSString *requiredState = condition[@"state"];
-        NSString *requiredStateNot = condition[@"state_not"];
-        if (!entityId) continue;
-
-        HAEntity *entity = entities[entityId];
-        NSString *currentState = entity.state;
+/// Identifies the view being shown; a config built for another view is
+/// never diffed against.
+- (NSString *)currentViewKey {
+    BOOL lovelace = (self.lovelaceDashboard && self.lovelaceDashboard.views.count > 0);
+    if (!lovelace) return @"default";
+    NSString *path = [[HAAuthManager sharedManager] selectedDashboardPath] ?: @"";
+    return [NSString stringWithFormat:@"%@#%lu", path, (unsigned long)self.selectedViewIndex];
+}
 
-        if (requiredState && ![requiredState isEqualToString:currentState ?: @""]) {
-            return NO; // state doesn't match
-        }
-        if (requiredStateNot && [requiredStateNot isEqualToString:currentState ?: @""]) {
-            return NO; // state matches the "not" value
-        }
-    }
-    return YES;
+/// Rebuild from scratch and reload every cell: first load, view switches,
+/// and returning from Settings (which can change how any cell renders).
+- (void)rebuildDashboard {
+    [self rebuildDashboardIncrementally:NO];
 }
 
-/// Check if an entity ID is referenced in any visibility condition.
-/// Uses the pre-collected set (built before filtering removes hidden items).
-- (BOOL)entityUsedInVisibilityConditions:(NSString *)entityId {
-    return entityId && [self.conditionEntityIds containsObject:entityId];
+/// Rebuild, but apply only what changed since the last build as batch
+/// updates, reconfiguring just the items whose content changed. For data
+/// changes on the view being shown: visibility conditions, registries,
+/// state refreshes, Lovelace updates. Falls back to a full reload when
+/// there's nothing to diff against (other view, other layout, reordered
+/// sections). Returns YES if it was applied incrementally.
+- (BOOL)updateDashboard {
+    return [self rebuildDashboardIncrementally:YES];
 }
 
-- (void)rebuildDashboard {
-    if (!self.statesLoaded) return;
+- (BOOL)rebuildDashboardIncrementally:(BOOL)incremental {
+    if (!self.statesLoaded) return NO;
     // Don't build until we know whether a Lovelace config exists — otherwise
     // we briefly flash the auto-generated "default" entity dump before the
     // real dashboard arrives.
-    if (!self.lovelaceFetchDone) return;
+    if (!self.lovelaceFetchDone) return NO;
     [[HAPerfMonitor sharedMonitor] markRebuildStart];
 
     NSDictionary<NSString *, HAEntity *> *entities = [[HAConnectionManager sharedManager] allEntities];
+    HADashboardConfig *oldConfig = self.dashboardConfig;
+    UICollectionViewLayout *oldLayout = self.collectionView.collectionViewLayout;
+    NSString *oldViewKey = self.builtViewKey;
+    NSInteger oldMaxColumns = [self columnarMaxColumns];
 
     if (self.lovelaceDashboard && self.lovelaceDashboard.views.count > 0) {
         [self buildLovelaceDashboard:entities];
@@ -931,16 +1006,39 @@ static const CGFloat kRowUnitHeight = 56.0;
         [self buildDefaultDashboardFromEntities:entities];
     }
 
-    // Filter out items whose visibility conditions aren't met
-    [self filterConditionalItems:entities];
+    // Filter out items whose visibility conditions aren't met; the engine
+    // keeps the dependency index for entityDidUpdate: and rotation
+    self.unfilteredConfig = self.dashboardConfig;
+    if (!self.visibilityEngine) self.visibilityEngine = [[HAVisibilityEngine alloc] init];
+    [self.visibilityEngine indexConfig:self.unfilteredConfig];
+    [self.visibilityEngine evaluateWithEntities:entities screenSize:self.view.bounds.size];
+    self.dashboardConfig = [self visibleConfigFromConfig:self.unfilteredConfig];
+    self.builtViewKey = [self currentViewKey];
 
-    // Build reverse lookup map: entityId -> [NSIndexPath, ...]
-    [self buildEntityToIndexPathMap];
+    HADashboardConfigDiff *diff = nil;
+    if (incremental && oldConfig && self.dashboardConfig &&
+        self.collectionView.collectionViewLayout == oldLayout &&
+        [oldViewKey isEqualToString:self.builtViewKey]) {
+        diff = [HADashboardConfigDiff diffFromConfig:oldConfig toConfig:self.dashboardConfig];
+    }
 
     [self showLoading:NO message:nil];
     [self showConnectionBar:NO message:nil];
     [self.refreshControl endRefreshing];
-    [self.collectionView reloadData];
+    if (diff) {
+        [self applyDashboardDiff:diff fromConfig:oldConfig];
+        // The diff covers sections and items, not the column settings
+        if (self.dashboardConfig.columns != oldConfig.columns || [self columnarMaxColumns] != oldMaxColumns) {
+            [self.collectionView.collectionViewLayout invalidateLayout];
+        }
+    } else {
+        // Prefetches are keyed by index path and were asked for the old build
+        [self.cardPrefetcher cancelAll];
+        // Build reverse lookup map: entityId -> [NSIndexPath, ...]
+        [self buildEntityToIndexPathMap];
+        [self.collectionView reloadData];
+        [self scheduleCellWarmUp];
+    }
     [[HAPerfMonitor sharedMonitor] markRebuildEnd];
 
     // Screenshot trigger: when /tmp/take_screenshot exists, capture after layout settles
@@ -956,6 +1054,66 @@ static const CGFloat kRowUnitHeight = 56.0;
             });
         }
     }
+    return (diff != nil);
+}
+
+/// maxColumns of the columnar layout in use, or 0 for other layouts.
+- (NSInteger)columnarMaxColumns {
+    UICollectionViewLayout *layout = self.collectionView.collectionViewLayout;
+    return [layout isKindOfClass:[HAColumnarLayout class]] ? ((HAColumnarLayout *)layout).maxColumns : 0;
+}
+
+/// The collection view still shows oldConfig; move it to self.dashboardConfig.
+- (void)applyDashboardDiff:(HADashboardConfigDiff *)diff fromConfig:(HADashboardConfig *)oldConfig {
+    HADashboardConfig *newConfig = self.dashboardConfig;
+    if (diff.hasStructuralChanges) {
+        HALogD(@"dash", @"Dashboard diff: -%lu/+%lu sections, -%lu/+%lu/~%lu items, %lu updated",
+               (unsigned long)diff.deletedSections.count, (unsigned long)diff.insertedSections.count,
+               (unsigned long)diff.deletedItems.count, (unsigned long)diff.insertedItems.count,
+               (unsigned long)diff.movedItems.count, (unsigned long)diff.updatedItems.count);
+        // Queued reloads and prefetches hold old index paths
+        BOOL hadPendingReloads = (self.updateFlusher.pendingCount > 0);
+        [self.cardPrefetcher cancelAll];
+        self.dashboardConfig = oldConfig;
+        [self.collectionView performBatchUpdates:^{
+            self.dashboardConfig = newConfig;
+            [self buildEntityToIndexPathMap];
+            [self.collectionView deleteSections:diff.deletedSections];
+            [self.collectionView insertSections:diff.insertedSections];
+            [self.collectionView deleteItemsAtIndexPaths:diff.deletedItems];
+            [self.collectionView insertItemsAtIndexPaths:diff.insertedItems];
+            for (NSArray<NSIndexPath *> *move in diff.movedItems) {
+                [self.collectionView moveItemAtIndexPath:move[0] toIndexPath:move[1]];
+            }
+        } completion:nil];
+        if (hadPendingReloads) {
+            [self.updateFlusher removeAllPending];
+            [self scheduleReloadForIndexPaths:self.collectionView.indexPathsForVisibleItems];
+        }
+    } else {
+        [self buildEntityToIndexPathMap];
+        // A changed card may have changed height
+        [self invalidateHeightsForItemsAtIndexPaths:diff.updatedItems];
+    }
+    // Changed cards are reconfigured in place: no dequeue, no flash. Cards
+    // that can't be are reloaded, as a full reload would have.
+    NSArray<NSIndexPath *> *notReconfigured = [self reconfigureVisibleCellsAtIndexPaths:[NSSet setWithArray:diff.updatedItems]];
+    if (notReconfigured.count > 0) [self.collectionView reloadItemsAtIndexPaths:notReconfigured];
+}
+
+/// Re-lay out after these items' heights may have changed. The dashboard
+/// layouts re-query just these and move what's below; others get a full
+/// invalidation.
+- (void)invalidateHeightsForItemsAtIndexPaths:(NSArray<NSIndexPath *> *)indexPaths {
+    if (indexPaths.count == 0) return;
+    UICollectionViewLayout *layout = self.collectionView.collectionViewLayout;
+    if (![[[layout class] invalidationContextClass] isSubclassOfClass:[HALayoutInvalidationContext class]]) {
+        [layout invalidateLayout];
+        return;
+    }
+    HALayoutInvalidationContext *context = [[HALayoutInvalidationContext alloc] init];
+    [context invalidateHeightsForItemsAtIndexPaths:indexPaths];
+    [layout invalidateLayoutWithContext:context];
 }
 
 - (void)buildEntityToIndexPathMap {
@@ -976,9 +1134,11 @@ static const CGFloat kRowUnitHeight = 56.0;
 
             // Map entity IDs from the item's nested entitiesSection
             // (entities cards, badges, graphs store child IDs here)
+            // plus the entities their special rows read (buttons, conditions)
             HADashboardConfigSection *entSection = item.entitiesSection;
-            if (entSection.entityIds.count > 0) {
-                for (NSString *eid in entSection.entityIds) {
+            NSArray<NSString *> *rowEntityIds = [HAEntitiesCardCell orderedRowEntityIdsForSection:entSection];
+            if (entSection.entityIds.count > 0 || rowEntityIds.count > 0) {
+                for (NSString *eid in [(entSection.entityIds ?: @[]) arrayByAddingObjectsFromArray:rowEntityIds]) {
                     if (!map[eid]) map[eid] = [NSMutableArray array];
                     if (![map[eid] containsObject:ip]) {
                         [map[eid] addObject:ip];
@@ -1429,7 +1589,7 @@ static const CGFloat kRowUnitHeight = 56.0;
     HADashboardConfigSection *section = [self sectionAtIndex:indexPath.section];
     HAConnectionManager *conn = [HAConnectionManager sharedManager];
     HAEntity *entity = [conn entityForId:item.entityId];
-    NSDictionary *allEntities = [conn allEntities];
+    NSDictionary *entities = [self renderedEntitiesForItem:item section:section];
 
     NSString *reuseId = [HAEntityCellFactory reuseIdentifierForEntity:entity cardType:item.cardType];
     UICollectionViewCell *cell = [collectionView dequeueReusableCellWithReuseIdentifier:reuseId forIndexPath:indexPath];
@@ -1443,7 +1603,7 @@ static const CGFloat kRowUnitHeight = 56.0;
         [(HAMarkdownCardCell *)cell configureWithConfigItem:item];
     } else if ([cell isKindOfClass:[HABadgeRowCell class]]) {
         HADashboardConfigSection *entSection = item.entitiesSection ?: section;
-        [(HABadgeRowCell *)cell configureWithSection:entSection entities:allEntities];
+        [(HABadgeRowCell *)cell configureWithSection:entSection entities:entities];
         __weak typeof(self) weakSelf = self;
         ((HABadgeRowCell *)cell).entityTapBlock = ^(HAEntity *tappedEntity) {
             // Badges default to more-info (no per-badge action config yet)
@@ -1451,7 +1611,7 @@ static const CGFloat kRowUnitHeight = 56.0;
         };
     } else if ([cell isKindOfClass:[HAGlanceCardCell class]]) {
         HADashboardConfigSection *entSection = item.entitiesSection ?: section;
-        [(HAGlanceCardCell *)cell configureWithSection:entSection entities:allEntities configItem:item];
+        [(HAGlanceCardCell *)cell configureWithSection:entSection entities:entities configItem:item];
         __weak typeof(self) weakSelf = self;
         ((HAGlanceCardCell *)cell).entityTapBlock = ^(HAEntity *tappedEntity, NSDictionary *actionConfig) {
             // Use per-entity action config if available, fall back to card-level
@@ -1461,24 +1621,29 @@ static const CGFloat kRowUnitHeight = 56.0;
     } else if ([cell isKindOfClass:[HAGraphCardCell class]]) {
         HADashboardConfigSection *entSection = item.entitiesSection ?: section;
         if (entSection.entityIds.count > 0) {
-            [(HAGraphCardCell *)cell configureWithSection:entSection entities:allEntities];
+            [(HAGraphCardCell *)cell configureWithSection:entSection entities:entities];
         } else {
             [(HAGraphCardCell *)cell configureWithEntity:entity item:item];
         }
     } else if ([cell isKindOfClass:[HAEntitiesCardCell class]]) {
         HADashboardConfigSection *entSection = item.entitiesSection ?: section;
-        [(HAEntitiesCardCell *)cell configureWithSection:entSection entities:allEntities configItem:item];
+        [(HAEntitiesCardCell *)cell configureWithSection:entSection entities:entities configItem:item];
         __weak typeof(self) weakSelf = self;
         ((HAEntitiesCardCell *)cell).entityTapBlock = ^(HAEntity *tappedEntity) {
             [weakSelf presentEntityDetail:tappedEntity];
         };
     } else if ([cell isKindOfClass:[HACalendarCardCell class]]) {
-        HADashboardConfigSection *entSection = item.entitiesSection ?: section;
-        NSArray *calEntityIds = entSection.entityIds.count > 0 ? entSection.entityIds : (item.entityId ? @[item.entityId] : @[]);
+        NSArray *calEntityIds = [self calendarEntityIdsForItem:item section:section];
         [(HACalendarCardCell *)cell configureWithEntityIds:calEntityIds configItem:item];
+    } else if ([cell isKindOfClass:[HALogbookCardCell class]]) {
+        HADashboardConfigSection *entSection = item.entitiesSection ?: section;
+        [(HALogbookCardCell *)cell configureWithSection:entSection entities:entities configItem:item];
     } else if ([cell isKindOfClass:[HABaseEntityCell class]]) {
         [(HABaseEntityCell *)cell configureWithEntity:entity configItem:item];
     }
+    // Dequeued cells are always configured (prepareForReuse clears them);
+    // the stamp lets later reloads of this cell skip unchanged inputs
+    [self recordRenderStampForCell:cell item:item section:section entities:entities];
 
     // Apply blur background here for iOS 9 compatibility.
     // On iOS 9, willDisplayCell may not fire for initially visible cells.
@@ -1576,6 +1741,165 @@ static const CGFloat kRowUnitHeight = 56.0;
     }
 }
 
+#pragma mark - UICollectionViewDataSourcePrefetching
+
+/// Graph, camera, calendar and logbook cards only fetch once they are
+/// displayed, too late to have anything to show as they scroll in.
+/// Prefetching starts the same loads while the card is still off screen;
+/// the cell's own fetch then joins them or reuses their result.
+- (void)collectionView:(UICollectionView *)collectionView prefetchItemsAtIndexPaths:(NSArray<NSIndexPath *> *)indexPaths {
+    for (NSIndexPath *indexPath in indexPaths) {
+        HACardPrefetchStartBlock start = [self prefetchStartBlockForItemAtIndexPath:indexPath];
+        if (start) [self.cardPrefetcher prefetchKey:indexPath start:start];
+    }
+}
+
+- (void)collectionView:(UICollectionView *)collectionView cancelPrefetchingForItemsAtIndexPaths:(NSArray<NSIndexPath *> *)indexPaths {
+    for (NSIndexPath *indexPath in indexPaths) {
+        [self.cardPrefetcher cancelPrefetchForKey:indexPath];
+    }
+}
+
+/// The loads the item's cell will start in beginLoading, or nil for cards
+/// that load nothing over the network.
+- (HACardPrefetchStartBlock)prefetchStartBlockForItemAtIndexPath:(NSIndexPath *)indexPath {
+    HADashboardConfigItem *item = [self itemAtIndexPath:indexPath];
+    if (!item) return nil;
+    HADashboardConfigSection *section = [self sectionAtIndex:indexPath.section];
+    HADashboardConfigSection *entSection = item.entitiesSection ?: section;
+    HAEntity *entity = [[HAConnectionManager sharedManager] entityForId:item.entityId];
+    Class cellClass = [HAEntityCellFactory cellClassForEntity:entity cardType:item.cardType];
+
+    if ([cellClass isSubclassOfClass:[HAGraphCardCell class]]) {
+        // A single-entity graph with no entity yet doesn't load
+        if (entSection.entityIds.count == 0 && !entity) return nil;
+        NSInteger hours = 24;
+        BOOL timeline = NO;
+        NSArray<NSString *> *entityIds = [HAGraphCardCell historyEntityIdsForItem:item section:entSection
+                                                                        hoursBack:&hours timeline:&timeline];
+        if (entityIds.count == 0) return nil;
+        return ^NSArray<HARequestInterest *> *(dispatch_block_t done) {
+            HAHistoryManager *mgr = [HAHistoryManager sharedManager];
+            NSMutableArray<HARequestInterest *> *interests = [NSMutableArray arrayWithCapacity:entityIds.count];
+            __block NSUInteger remaining = entityIds.count;
+            for (NSString *entityId in entityIds) {
+                HARequestInterest *interest = [mgr prefetchWindowForEntityId:entityId hoursBack:hours timeline:timeline
+                                                                  completion:^{
+                    if (--remaining == 0) done();
+                }];
+                if (interest) [interests addObject:interest];
+            }
+            return interests;
+        };
+    }
+    if ([cellClass isSubclassOfClass:[HACameraEntityCell class]]) {
+        if (!entity) return nil;
+        return ^NSArray<HARequestInterest *> *(dispatch_block_t done) {
+            HARequestInterest *interest = [HACameraEntityCell prefetchSnapshotForEntity:entity completion:done];
+            return interest ? @[interest] : nil;
+        };
+    }
+    if ([cellClass isSubclassOfClass:[HACalendarCardCell class]]) {
+        NSArray<NSString *> *entityIds = [self calendarEntityIdsForItem:item section:section];
+        if (entityIds.count == 0) return nil;
+        return ^NSArray<HARequestInterest *> *(dispatch_block_t done) {
+            HARequestInterest *interest = [HACalendarCardCell prefetchEventsForEntityIds:entityIds configItem:item
+                                                                              completion:done];
+            return interest ? @[interest] : nil;
+        };
+    }
+    if ([cellClass isSubclassOfClass:[HALogbookCardCell class]]) {
+        NSArray<NSString *> *entityIds = [HALogbookCardCell entityFilterForSection:entSection configItem:item];
+        NSInteger hours = [HALogbookCardCell hoursToShowForConfigItem:item];
+        return ^NSArray<HARequestInterest *> *(dispatch_block_t done) {
+            HARequestInterest *interest = [[HALogbookManager sharedManager] prefetchEntriesForEntityIds:entityIds
+                                                                                              hoursBack:hours
+                                                                                             completion:done];
+            return interest ? @[interest] : nil;
+        };
+    }
+    return nil;
+}
+
+/// Calendars a calendar card shows: its section's entities, or its own.
+- (NSArray<NSString *> *)calendarEntityIdsForItem:(HADashboardConfigItem *)item section:(HADashboardConfigSection *)section {
+    HADashboardConfigSection *entSection = item.entitiesSection ?: section;
+    return entSection.entityIds.count > 0 ? entSection.entityIds : (item.entityId ? @[item.entityId] : @[]);
+}
+
+#pragma mark - Cell Warm-Up
+
+/// The first scroll through a new dashboard creates each cell class, and
+/// every entities card's row views, on demand mid-scroll. Do that ahead,
+/// in idle time, until the user first touches the dashboard.
+- (void)scheduleCellWarmUp {
+    [self.cellWarmer stop];
+    __weak typeof(self) weakSelf = self;
+    // Planned on the first idle pass, once the reload has laid out the
+    // cards on screen (which already have their cells)
+    [self.cellWarmer enqueueTask:^{
+        [weakSelf planCellWarmUp];
+    }];
+}
+
+- (void)planCellWarmUp {
+    for (UICollectionViewCell *cell in self.collectionView.visibleCells) {
+        [self.warmedCellClasses addObject:[cell class]];
+    }
+    NSSet<NSIndexPath *> *visible = [NSSet setWithArray:self.collectionView.indexPathsForVisibleItems];
+    NSMutableSet<Class> *planned = [self.warmedCellClasses mutableCopy];
+    NSUInteger rowCount = 0;
+    __weak typeof(self) weakSelf = self;
+
+    for (NSUInteger s = 0; s < self.dashboardConfig.sections.count; s++) {
+        HADashboardConfigSection *section = self.dashboardConfig.sections[s];
+        for (NSUInteger i = 0; i < section.items.count; i++) {
+            NSIndexPath *indexPath = [NSIndexPath indexPathForItem:i inSection:s];
+            if ([visible containsObject:indexPath]) continue;
+            HADashboardConfigItem *item = section.items[i];
+            HAEntity *entity = [[HAConnectionManager sharedManager] entityForId:item.entityId];
+            Class cellClass = [HAEntityCellFactory cellClassForEntity:entity cardType:item.cardType];
+            if (![planned containsObject:cellClass]) {
+                [planned addObject:cellClass];
+                [self.cellWarmer enqueueTask:^{
+                    [weakSelf warmCellClass:cellClass atIndexPath:indexPath];
+                }];
+            }
+            if ([cellClass isSubclassOfClass:[HAEntitiesCardCell class]]) {
+                rowCount += (item.entitiesSection ?: section).entityIds.count;
+            }
+        }
+    }
+
+    // Row views go to a shared pool any entities cell draws from, so these
+    // are made in the quantity needed; cells can't be handed to the
+    // collection view's reuse queue, so a class is only created once.
+    rowCount = MIN(rowCount, kMaxSpareRowViews);
+    NSUInteger spares = [HAEntitiesCardCell spareRowViewCount];
+    for (NSUInteger n = spares; n < rowCount; n++) {
+        [self.cellWarmer enqueueTask:^{
+            [HAEntitiesCardCell addSpareRowView];
+        }];
+    }
+    HALogD(@"dash", @"Cell warm-up: %lu classes, %lu row views",
+           (unsigned long)(planned.count - self.warmedCellClasses.count),
+           (unsigned long)(rowCount > spares ? rowCount - spares : 0));
+}
+
+/// Create and lay out a throwaway cell so the first real one skips the
+/// class's one-time costs (class set-up, fonts, images, layout engine).
+- (void)warmCellClass:(Class)cellClass atIndexPath:(NSIndexPath *)indexPath {
+    if ([self.warmedCellClasses containsObject:cellClass]) return;
+    [self.warmedCellClasses addObject:cellClass];
+    CGRect frame = [self.collectionView.collectionViewLayout layoutAttributesForItemAtIndexPath:indexPath].frame;
+    if (CGRectIsEmpty(frame)) {
+        // Not laid out (yet); any card-sized frame does
+        frame = CGRectMake(0, 0, CGRectGetWidth(self.collectionView.bounds), 120);
+    }
+    UICollectionViewCell *cell = [[cellClass alloc] initWithFrame:CGRectMake(0, 0, CGRectGetWidth(frame), CGRectGetHeight(frame))];
+    [cell layoutIfNeeded];
+}
+
 #pragma mark - HAColumnarLayoutDelegate
 
 - (CGFloat)collectionView:(UICollectionView *)collectionView
@@ -1667,6 +1991,12 @@ heightForHeaderInSection:(NSInteger)section {
     self.lastTapPoint = [gesture locationInView:self.collectionView];
 }
 
+- (void)collectionView:(UICollectionView *)collectionView didHighlightItemAtIndexPath:(NSIndexPath *)indexPath {
+    // The card being touched gets its state updates without coalescing,
+    // including the one its action is about to cause
+    [self.updateFlusher prioritizeIndexPath:indexPath forDuration:3.0];
+}
+
 - (void)collectionView:(UICollectionView *)collectionView didSelectItemAtIndexPath:(NSIndexPath *)indexPath {
     [collectionView deselectItemAtIndexPath:indexPath animated:YES];
 
@@ -1820,6 +2150,13 @@ heightForHeaderInSection:(NSInteger)section {
     [self executeActionType:@"double_tap_action" forEntity:entity configProperties:item.customProperties];
 }
 
+- (BOOL)gestureRecognizer:(UIGestureRecognizer *)gestureRecognizer shouldReceiveTouch:(UITouch *)touch {
+    // Called on touch down anywhere on the dashboard (taps and drags alike):
+    // idle-time warm-up must not compete with whatever the user does next
+    [self.cellWarmer stop];
+    return YES;
+}
+
 - (BOOL)gestureRecognizerShouldBegin:(UIGestureRecognizer *)gestureRecognizer {
     if (gestureRecognizer != self.doubleTapGesture) return YES;
 
@@ -2009,6 +2346,10 @@ heightForHeaderInSection:(NSInteger)section {
             } else {
                 self.dashboardConfig.columns = isLandscape ? 2 : 1;
             }
+            self.unfilteredConfig.columns = self.dashboardConfig.columns;
+            // Items with screen conditions may come and go with the new size
+            [self applyVisibilityChange:[self.visibilityEngine updateForScreenSize:size
+                                                                          entities:[[HAConnectionManager sharedManager] allEntities]]];
         }
         [self.collectionView.collectionViewLayout invalidateLayout];
     } completion:nil];
@@ -2021,8 +2362,9 @@ heightForHeaderInSection:(NSInteger)section {
     // - Default dashboard (no lovelace config): needs area grouping
     // - Strategy dashboard: connection manager re-resolves with area data and sends
     //   updated lovelaceDashboard, so we rebuild to pick it up
-    if (self.statesLoaded) {
-        [self rebuildDashboard];
+    if (self.statesLoaded && [self updateDashboard]) {
+        // Registry names and areas show in cards the config doesn't mention
+        [self scheduleReloadForIndexPaths:self.collectionView.indexPathsForVisibleItems];
     }
 }
 
@@ -2035,11 +2377,13 @@ heightForHeaderInSection:(NSInteger)section {
     // while the next HTTP image fetch completes.
     if ([[entity domain] isEqualToString:HAEntityDomainCamera]) return;
 
-    // If this entity is used in a visibility condition, the update may add/remove
-    // items from the collection view — trigger a full rebuild instead of cell reload.
-    if ([self entityUsedInVisibilityConditions:entity.entityId]) {
-        [self rebuildDashboard];
-        return;
+    // If this entity is used in a visibility condition, the update may show or
+    // hide the items that depend on it — apply that first, then reload its own
+    // cells at their new index paths below.
+    if ([self.visibilityEngine dependsOnEntityId:entity.entityId]) {
+        HAVisibilityChange *change = [self.visibilityEngine updateForEntityId:entity.entityId
+                                                                     entities:[[HAConnectionManager sharedManager] allEntities]];
+        if (![self applyVisibilityChange:change]) return; // fully reloaded
     }
 
     NSArray<NSIndexPath *> *indexPaths = self.entityToIndexPaths[entity.entityId];
@@ -2068,41 +2412,46 @@ heightForHeaderInSection:(NSInteger)section {
     }
 }
 
-/// Coalesce multiple entity updates into a single batch reload
+/// Coalesce entity updates: reloads are applied on display frames, each
+/// path within a bounded delay, and large sets are spread over frames.
 - (void)scheduleReloadForIndexPaths:(NSArray<NSIndexPath *> *)paths {
-    if (!self.pendingReloadPaths) {
-        self.pendingReloadPaths = [NSMutableSet set];
-    }
-    [self.pendingReloadPaths addObjectsFromArray:paths];
-
-    // Coalesce: batch rapid-fire entity updates into a single reload pass.
-    // 300ms batches more updates together (reduces flush frequency on A5 devices)
-    // while still feeling responsive for user-triggered changes.
-    [self.reloadCoalesceTimer invalidate];
-    self.reloadCoalesceTimer = [NSTimer scheduledTimerWithTimeInterval:0.3
-                                                               target:self
-                                                             selector:@selector(flushPendingReloads)
-                                                             userInfo:nil
-                                                              repeats:NO];
+    [self.updateFlusher enqueueIndexPaths:paths];
 }
 
-- (void)flushPendingReloads {
-    if (self.pendingReloadPaths.count == 0) return;
-
-    // Take a snapshot and clear before iterating
-    NSSet<NSIndexPath *> *pending = [self.pendingReloadPaths copy];
-    [self.pendingReloadPaths removeAllObjects];
+#pragma mark - HAUpdateFlusherDelegate
 
+- (void)updateFlusher:(HAUpdateFlusher *)flusher flushIndexPaths:(NSArray<NSIndexPath *> *)indexPaths {
+    // Off-screen paths need nothing: scroll-in configures from current state,
+    // and the render stamp then keeps this flush from configuring it again.
     // Early exit: check if ANY pending path intersects with visible cells.
     // On iPad 2, this saves ~40ms when many entities update but none are visible.
     NSSet<NSIndexPath *> *visible = [NSSet setWithArray:self.collectionView.indexPathsForVisibleItems];
-    NSMutableSet *intersection = [pending mutableCopy];
+    NSMutableSet *intersection = [NSMutableSet setWithArray:indexPaths];
     [intersection intersectSet:visible];
     if (intersection.count == 0) return;
 
     [[HAPerfMonitor sharedMonitor] markRebuildStart];
+    [self reconfigureVisibleCellsAtIndexPaths:intersection];
+    [[HAPerfMonitor sharedMonitor] markRebuildEnd];
+}
+
+/// Configure the visible cells among paths again from the current config
+/// and entity states, without reloading them. Cells whose render stamp is
+/// still current (nothing they read has changed since they were last
+/// configured, e.g. on scroll-in) are left alone, and tiles that only saw
+/// entity changes are updated from view models built off the main thread.
+/// Returns the visible, changed cells with no in-place configure (markdown,
+/// glance, calendar, logbook, heading); entity updates leave those alone.
+- (NSArray<NSIndexPath *> *)reconfigureVisibleCellsAtIndexPaths:(NSSet<NSIndexPath *> *)paths {
+    if (paths.count == 0) return @[];
+    NSSet<NSIndexPath *> *visible = [NSSet setWithArray:self.collectionView.indexPathsForVisibleItems];
+    NSMutableSet *intersection = [paths mutableCopy];
+    [intersection intersectSet:visible];
+    if (intersection.count == 0) return @[];
+
     HAConnectionManager *conn = [HAConnectionManager sharedManager];
-    NSDictionary *allEntities = [conn allEntities];
+    NSMutableArray<NSIndexPath *> *tilePaths = [NSMutableArray array];
+    NSMutableArray<NSIndexPath *> *notReconfigured = [NSMutableArray array];
     for (NSIndexPath *ip in intersection) {
 
         UICollectionViewCell *cell = [self.collectionView cellForItemAtIndexPath:ip];
@@ -2112,30 +2461,148 @@ heightForHeaderInSection:(NSInteger)section {
         if (!item) continue;
 
         HADashboardConfigSection *section = [self sectionAtIndex:ip.section];
+        NSDictionary *entities = [self renderedEntitiesForItem:item section:section];
+        HACellRenderStamp *stamp = [self.renderStamps objectForKey:cell];
+        if ([stamp isCurrentForItem:item section:(item.entitiesSection ?: section) entities:entities]) continue;
+        if ([cell isKindOfClass:[HATileEntityCell class]] &&
+            [stamp matchesConfigForItem:item section:(item.entitiesSection ?: section)]) {
+            [tilePaths addObject:ip];
+            continue;
+        }
 
         if ([cell isKindOfClass:[HABadgeRowCell class]]) {
             HADashboardConfigSection *entSection = item.entitiesSection ?: section;
-            [(HABadgeRowCell *)cell configureWithSection:entSection entities:allEntities];
+            [(HABadgeRowCell *)cell configureWithSection:entSection entities:entities];
         } else if ([cell isKindOfClass:[HAGraphCardCell class]]) {
             HADashboardConfigSection *entSection = item.entitiesSection ?: section;
             HAEntity *entity = [conn entityForId:item.entityId];
             if (entSection.entityIds.count > 0) {
-                [(HAGraphCardCell *)cell configureWithSection:entSection entities:allEntities];
+                [(HAGraphCardCell *)cell configureWithSection:entSection entities:entities];
             } else {
                 [(HAGraphCardCell *)cell configureWithEntity:entity item:item];
             }
         } else if ([cell isKindOfClass:[HAEntitiesCardCell class]]) {
             HADashboardConfigSection *entSection = item.entitiesSection ?: section;
-            [(HAEntitiesCardCell *)cell configureWithSection:entSection entities:allEntities configItem:item];
+            [(HAEntitiesCardCell *)cell configureWithSection:entSection entities:entities configItem:item];
         } else if ([cell isKindOfClass:[HAGaugeCardCell class]]) {
             HAEntity *entity = [conn entityForId:item.entityId];
             [(HAGaugeCardCell *)cell configureWithEntity:entity configItem:item];
         } else if ([cell isKindOfClass:[HABaseEntityCell class]]) {
             HAEntity *entity = [conn entityForId:item.entityId];
             [(HABaseEntityCell *)cell configureWithEntity:entity configItem:item];
+        } else {
+            [notReconfigured addObject:ip];
+            continue;
         }
+        [self recordRenderStampForCell:cell item:item section:section entities:entities];
+    }
+    if (tilePaths.count > 0) [self updateTileCellsAtIndexPaths:tilePaths];
+    return notReconfigured;
+}
+
+/// Tiles whose config is unchanged only need their entity-derived content.
+/// View models are built from entity copies on viewModelQueue; back on the
+/// main thread each tile applies just the properties that differ.
+- (void)updateTileCellsAtIndexPaths:(NSArray<NSIndexPath *> *)paths {
+    HAConnectionManager *conn = [HAConnectionManager sharedManager];
+    NSMutableArray<HADashboardConfigItem *> *items = [NSMutableArray arrayWithCapacity:paths.count];
+    NSMutableArray *snapshots = [NSMutableArray arrayWithCapacity:paths.count];
+    for (NSIndexPath *ip in paths) {
+        HADashboardConfigItem *item = [self itemAtIndexPath:ip];
+        [items addObject:item];
+        [snapshots addObject:[[conn entityForId:item.entityId] copy] ?: [NSNull null]];
+    }
+
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(self.viewModelQueue, ^{
+        NSMutableArray<HACellViewModel *> *viewModels = [NSMutableArray arrayWithCapacity:paths.count];
+        for (NSUInteger i = 0; i < paths.count; i++) {
+            HAEntity *snapshot = (snapshots[i] != [NSNull null]) ? snapshots[i] : nil;
+            [viewModels addObject:[HACellViewModel tileViewModelForEntity:snapshot configItem:items[i]]];
+        }
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf applyTileViewModels:viewModels atIndexPaths:paths items:items snapshots:snapshots];
+        });
+    });
+}
+
+/// Skips tiles that moved on while their view model was being built: the
+/// path now holds another item (the config diff handles it), the cell
+/// scrolled away (scroll-in configures it), or the entity changed again
+/// (that update's flush is already queued).
+- (void)applyTileViewModels:(NSArray<HACellViewModel *> *)viewModels
+               atIndexPaths:(NSArray<NSIndexPath *> *)paths
+                      items:(NSArray<HADashboardConfigItem *> *)items
+                  snapshots:(NSArray *)snapshots {
+    HAConnectionManager *conn = [HAConnectionManager sharedManager];
+    for (NSUInteger i = 0; i < paths.count; i++) {
+        NSIndexPath *ip = paths[i];
+        HADashboardConfigItem *item = items[i];
+        if ([self itemAtIndexPath:ip] != item) continue;
+        UICollectionViewCell *cell = [self.collectionView cellForItemAtIndexPath:ip];
+        if (![cell isKindOfClass:[HATileEntityCell class]]) continue;
+
+        HAEntity *snapshot = (snapshots[i] != [NSNull null]) ? snapshots[i] : nil;
+        HAEntity *entity = [conn entityForId:item.entityId];
+        if ((entity == nil) != (snapshot == nil) || entity.version != snapshot.version) continue;
+
+        HADashboardConfigSection *section = [self sectionAtIndex:ip.section];
+        NSDictionary *entities = [self renderedEntitiesForItem:item section:section];
+        HACellRenderStamp *stamp = [self.renderStamps objectForKey:cell];
+        if ([stamp isCurrentForItem:item section:(item.entitiesSection ?: section) entities:entities]) continue;
+
+        [(HATileEntityCell *)cell updateWithViewModel:viewModels[i] entity:entity];
+        [self recordRenderStampForCell:cell item:item section:section entities:entities];
     }
-    [[HAPerfMonitor sharedMonitor] markRebuildEnd];
+}
+
+/// The entities a card for item renders, keyed by ID: its own entity plus
+/// its section's entities, scene chips and the entities its special rows
+/// read. Looked up one by one rather than copying the whole entity store
+/// for every cell.
+- (NSDictionary<NSString *, HAEntity *> *)renderedEntitiesForItem:(HADashboardConfigItem *)item
+                                                          section:(HADashboardConfigSection *)section {
+    HAConnectionManager *conn = [HAConnectionManager sharedManager];
+    HADashboardConfigSection *entSection = item.entitiesSection ?: section;
+    NSMutableDictionary<NSString *, HAEntity *> *entities = [NSMutableDictionary dictionaryWithCapacity:entSection.entityIds.count + 1];
+    if (item.entityId) {
+        HAEntity *entity = [conn entityForId:item.entityId];
+        if (entity) entities[item.entityId] = entity;
+    }
+    NSMutableArray<NSString *> *ids = [NSMutableArray arrayWithArray:entSection.entityIds ?: @[]];
+    NSArray *sceneIds = entSection.customProperties[@"sceneEntityIds"];
+    if ([sceneIds isKindOfClass:[NSArray class]]) [ids addObjectsFromArray:sceneIds];
+    [ids addObjectsFromArray:[HAEntitiesCardCell orderedRowEntityIdsForSection:entSection]];
+    for (NSString *entityId in ids) {
+        if (![entityId isKindOfClass:[NSString class]] || entities[entityId]) continue;
+        HAEntity *entity = [conn entityForId:entityId];
+        if (entity) entities[entityId] = entity;
+    }
+    return entities;
+}
+
+/// Remember what cell was configured from. Cells that also look up
+/// entities the config doesn't name (area rooms, camera overlays, weather
+/// and clock sensors) or that load their own data get no stamp, so they
+/// are always configured again.
+- (void)recordRenderStampForCell:(UICollectionViewCell *)cell
+                            item:(HADashboardConfigItem *)item
+                         section:(HADashboardConfigSection *)section
+                        entities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    BOOL readsOtherEntities = [cell isKindOfClass:[HAAreaCardCell class]] ||
+                              [cell isKindOfClass:[HACameraEntityCell class]] ||
+                              [cell isKindOfClass:[HAWeatherEntityCell class]] ||
+                              [cell isKindOfClass:[HAClockWeatherCell class]] ||
+                              [cell isKindOfClass:[HACalendarCardCell class]] ||
+                              [cell isKindOfClass:[HALogbookCardCell class]];
+    if (!item || readsOtherEntities) {
+        [self.renderStamps removeObjectForKey:cell];
+        return;
+    }
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:item
+                                                               section:(item.entitiesSection ?: section)
+                                                              entities:entities];
+    [self.renderStamps setObject:stamp forKey:cell];
 }
 
 #pragma mark - HAConnectionManagerDelegate
@@ -2168,7 +2635,10 @@ heightForHeaderInSection:(NSInteger)section {
 - (void)connectionManager:(HAConnectionManager *)manager didReceiveAllStates:(NSDictionary<NSString *, HAEntity *> *)entities {
     self.statesLoaded = YES;
     [[HASunBasedTheme sharedInstance] start];
-    [self rebuildDashboard];
+    if ([self updateDashboard]) {
+        // A refresh: the layout is kept, but any visible card's state may be new
+        [self scheduleReloadForIndexPaths:self.collectionView.indexPathsForVisibleItems];
+    }
 }
 
 - (void)connectionManager:(HAConnectionManager *)manager didReceiveLovelaceDashboard:(HALovelaceDashboard *)dashboard {
@@ -2197,7 +2667,8 @@ heightForHeaderInSection:(NSInteger)section {
     }
 
     [self populateViewPicker];
-    [self rebuildDashboard];
+    // Same view re-delivered (edit in HA, reconnect): only changed cards update
+    [self updateDashboard];
 }
 
 - (void)connectionManagerDidFailToLoadLovelaceDashboard:(HAConnectionManager *)manager {
@@ -478,7 +478,13 @@ static const CGFloat kGraphHeight = 160.0;
                 __strong typeof(weakSelf) strongSelf = weakSelf;
                 if (!strongSelf) return;
                 [strongSelf.graphSpinner stopAnimating];
-                if (points.count > 0) strongSelf.graphView.dataPoints = points;
+                if (points.count > 0) {
+                    strongSelf.graphView.dataPoints = points;
+                    strongSelf.graphView.dataPyramid = [[HAHistoryManager sharedManager] pyramidForEntityId:entityId
+                                                                                                 startDate:strongSelf.customStartDate
+                                                                                                   endDate:strongSelf.customEndDate
+                                                                                                basePoints:points];
+                }
             }];
         }
         return;
@@ -505,6 +511,8 @@ static const CGFloat kGraphHeight = 160.0;
             }
         }];
     } else {
+        NSDate *endDate = [NSDate date];
+        NSDate *startDate = [endDate dateByAddingTimeInterval:-hours * 3600];
         [[HAHistoryManager sharedManager] fetchHistoryForEntityId:entityId
                                                        hoursBack:hours
                                                       completion:^(NSArray *points, NSError *error) {
@@ -514,6 +522,10 @@ static const CGFloat kGraphHeight = 160.0;
 
             if (points.count > 0) {
                 strongSelf.graphView.dataPoints = points;
+                strongSelf.graphView.dataPyramid = [[HAHistoryManager sharedManager] pyramidForEntityId:entityId
+                                                                                             startDate:startDate
+                                                                                               endDate:endDate
+                                                                                            basePoints:points];
             }
         }];
     }
@@ -541,6 +553,8 @@ static const CGFloat kGraphHeight = 160.0;
     }
 
     NSInteger hours = [self selectedHoursBack];
+    NSDate *pyramidEnd = endDate ?: [NSDate date];
+    NSDate *pyramidStart = startDate ?: [pyramidEnd dateByAddingTimeInterval:-hours * 3600];
 
     for (NSUInteger i = 0; i < graphEntities.count; i++) {
         NSDictionary *info = graphEntities[i];
@@ -614,6 +628,7 @@ static const CGFloat kGraphHeight = 160.0;
                     @"color": info[@"color"],
                     @"label": info[@"label"],
                     @"unit": info[@"unit"] ?: @"",
+                    @"pyramid": [mgr pyramidForEntityId:info[@"entityId"] startDate:pyramidStart endDate:pyramidEnd basePoints:points],
                 }];
             }
             if (dataSeries.count > 0) {
@@ -805,6 +820,8 @@ static const CGFloat kGraphHeight = 160.0;
 #pragma mark - Zoom Re-fetch (HAGraphViewDelegate)
 
 - (void)graphView:(HAGraphView *)graphView didZoomToStartTime:(NSTimeInterval)startTime endTime:(NSTimeInterval)endTime {
+    // Numeric graphs load finer data through their history pyramids
+    if (graphView.dataPyramid || graphView.dataSeries.firstObject[@"pyramid"]) return;
     [self.zoomFetchTimer invalidate];
     self.pendingZoomStart = startTime;
     self.pendingZoomEnd = endTime;
@@ -21,6 +21,15 @@
 
 - (instancetype)initWithDictionary:(NSDictionary *)dict;
 
+/// Identity that survives re-parsing: the same card in a reloaded config
+/// has the same key (card type, entity, sub-section title and first entity).
+/// Not unique on its own — HADashboardConfigDiff numbers repeats.
+- (NSString *)diffIdentity;
+
+/// Everything a cell renders from: entity, name, type, spans, properties,
+/// conditions and the sub-section's header and entity list.
+- (BOOL)isContentEqualToItem:(HADashboardConfigItem *)other;
+
 @end
 
 
@@ -35,6 +44,12 @@
 @property (nonatomic, copy) NSDictionary<NSString *, NSString *> *nameOverrides; // entity_id -> display name
 @property (nonatomic, copy) NSDictionary *customProperties; // Extra rendering hints (e.g. chipStyle)
 
+/// Identity across re-parses (card type and title); see HADashboardConfigItem.
+- (NSString *)diffIdentity;
+
+/// Same header and composite contents, ignoring items.
+- (BOOL)isHeaderEqualToSection:(HADashboardConfigSection *)other;
+
 @end
 
 
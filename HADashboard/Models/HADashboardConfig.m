@@ -1,6 +1,11 @@
 #import "HADashboardConfig.h"
 #import "HASafeDict.h"
 
+/// nil-safe isEqual: for the diff content checks.
+static BOOL ha_equalObjects(id a, id b) {
+    return (a == b) || [a isEqual:b];
+}
+
 #pragma mark - HADashboardConfigItem
 
 @implementation HADashboardConfigItem
@@ -18,12 +23,46 @@
     return self;
 }
 
+- (NSString *)diffIdentity {
+    return [NSString stringWithFormat:@"%@|%@|%@|%@", self.cardType ?: @"", self.entityId ?: @"",
+            self.entitiesSection.title ?: @"", self.entitiesSection.entityIds.firstObject ?: @""];
+}
+
+- (BOOL)isContentEqualToItem:(HADashboardConfigItem *)other {
+    if (!other) return NO;
+    if (self.column != other.column || self.row != other.row ||
+        self.columnSpan != other.columnSpan || self.rowSpan != other.rowSpan) return NO;
+    if (!ha_equalObjects(self.entityId, other.entityId) ||
+        !ha_equalObjects(self.displayName, other.displayName) ||
+        !ha_equalObjects(self.cardType, other.cardType) ||
+        !ha_equalObjects(self.customProperties, other.customProperties) ||
+        !ha_equalObjects(self.visibilityConditions, other.visibilityConditions)) return NO;
+    if (!self.entitiesSection || !other.entitiesSection) return self.entitiesSection == other.entitiesSection;
+    return [self.entitiesSection isHeaderEqualToSection:other.entitiesSection];
+}
+
 @end
 
 
 #pragma mark - HADashboardConfigSection
 
 @implementation HADashboardConfigSection
+
+- (NSString *)diffIdentity {
+    return [NSString stringWithFormat:@"%@|%@", self.cardType ?: @"", self.title ?: @""];
+}
+
+- (BOOL)isHeaderEqualToSection:(HADashboardConfigSection *)other {
+    if (!other) return NO;
+    // Not items: a flattened section's items point back at it
+    return ha_equalObjects(self.title, other.title) &&
+           ha_equalObjects(self.cardType, other.cardType) &&
+           ha_equalObjects(self.icon, other.icon) &&
+           ha_equalObjects(self.entityIds, other.entityIds) &&
+           ha_equalObjects(self.nameOverrides, other.nameOverrides) &&
+           ha_equalObjects(self.customProperties, other.customProperties);
+}
+
 @end
 
 
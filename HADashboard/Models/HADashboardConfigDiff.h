@@ -0,0 +1,39 @@
+#import <Foundation/Foundation.h>
+
+@class HADashboardConfig;
+
+/// Changes between two builds of the same dashboard view, in the form
+/// performBatchUpdates: wants. Items and sections are matched by
+/// diffIdentity (repeats numbered in order), so re-parsing an unchanged
+/// Lovelace config yields no changes at all.
+///
+/// Sections are only inserted or deleted, never moved: when sections
+/// present in both configs changed order, diffFromConfig:toConfig: returns
+/// nil and the caller reloads. Items move within their section; an item
+/// that changed section is deleted and inserted.
+@interface HADashboardConfigDiff : NSObject
+
+/// nil if the configs can't be expressed as batch updates (see above).
++ (instancetype)diffFromConfig:(HADashboardConfig *)oldConfig toConfig:(HADashboardConfig *)newConfig;
+
+/// Old section indexes (deleted) and new section indexes (inserted). A
+/// section whose header changed is deleted and inserted.
+@property (nonatomic, readonly) NSIndexSet *deletedSections;
+@property (nonatomic, readonly) NSIndexSet *insertedSections;
+
+/// Deletions in old index paths, insertions in new index paths; items of
+/// deleted or inserted sections aren't listed.
+@property (nonatomic, readonly) NSArray<NSIndexPath *> *deletedItems;
+@property (nonatomic, readonly) NSArray<NSIndexPath *> *insertedItems;
+
+/// Pairs of @[old index path, new index path].
+@property (nonatomic, readonly) NSArray<NSArray<NSIndexPath *> *> *movedItems;
+
+/// New index paths of items kept (moved or not) whose content changed:
+/// their cells need configuring again.
+@property (nonatomic, readonly) NSArray<NSIndexPath *> *updatedItems;
+
+/// Any insert, delete or move (updates alone don't change the layout).
+@property (nonatomic, readonly) BOOL hasStructuralChanges;
+
+@end
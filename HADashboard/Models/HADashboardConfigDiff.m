@@ -0,0 +1,146 @@
+#import "HADashboardConfigDiff.h"
+#import "HADashboardConfig.h"
+
+@interface HADashboardConfigDiff ()
+@property (nonatomic, strong) NSMutableIndexSet *deletedSectionSet;
+@property (nonatomic, strong) NSMutableIndexSet *insertedSectionSet;
+@property (nonatomic, strong) NSMutableArray<NSIndexPath *> *deletes;
+@property (nonatomic, strong) NSMutableArray<NSIndexPath *> *inserts;
+@property (nonatomic, strong) NSMutableArray<NSArray<NSIndexPath *> *> *moves;
+@property (nonatomic, strong) NSMutableArray<NSIndexPath *> *updates;
+@end
+
+/// Identities with repeats numbered ("x#0", "x#1", ...) so each is unique.
+static NSArray<NSString *> *ha_uniqueIdentities(NSArray *objects) {
+    NSMutableArray<NSString *> *identities = [NSMutableArray arrayWithCapacity:objects.count];
+    NSCountedSet *seen = [[NSCountedSet alloc] init];
+    for (id object in objects) {
+        NSString *identity = [object diffIdentity];
+        [identities addObject:[NSString stringWithFormat:@"%@#%lu", identity, (unsigned long)[seen countForObject:identity]]];
+        [seen addObject:identity];
+    }
+    return identities;
+}
+
+static NSDictionary<NSString *, NSNumber *> *ha_indexByIdentity(NSArray<NSString *> *identities) {
+    NSMutableDictionary<NSString *, NSNumber *> *map = [NSMutableDictionary dictionaryWithCapacity:identities.count];
+    [identities enumerateObjectsUsingBlock:^(NSString *identity, NSUInteger idx, BOOL *stop) {
+        map[identity] = @(idx);
+    }];
+    return map;
+}
+
+/// Positions (into values) of one longest strictly increasing subsequence.
+static NSIndexSet *ha_longestIncreasingSubsequence(NSArray<NSNumber *> *values) {
+    NSUInteger n = values.count;
+    if (n == 0) return [NSIndexSet indexSet];
+    NSMutableArray<NSNumber *> *tails = [NSMutableArray array];  // position ending each run length
+    NSMutableArray<NSNumber *> *previous = [NSMutableArray arrayWithCapacity:n];
+    for (NSUInteger i = 0; i < n; i++) {
+        NSInteger value = values[i].integerValue;
+        NSUInteger lo = 0, hi = tails.count;
+        while (lo < hi) {
+            NSUInteger mid = (lo + hi) / 2;
+            if (values[tails[mid].unsignedIntegerValue].integerValue < value) lo = mid + 1;
+            else hi = mid;
+        }
+        [previous addObject:@(lo > 0 ? tails[lo - 1].integerValue : -1)];
+        if (lo == tails.count) [tails addObject:@(i)];
+        else tails[lo] = @(i);
+    }
+    NSMutableIndexSet *result = [NSMutableIndexSet indexSet];
+    for (NSInteger i = tails.lastObject.integerValue; i >= 0; i = previous[i].integerValue) {
+        [result addIndex:(NSUInteger)i];
+    }
+    return result;
+}
+
+@implementation HADashboardConfigDiff
+
++ (instancetype)diffFromConfig:(HADashboardConfig *)oldConfig toConfig:(HADashboardConfig *)newConfig {
+    HADashboardConfigDiff *diff = [[HADashboardConfigDiff alloc] init];
+    diff.deletedSectionSet = [NSMutableIndexSet indexSet];
+    diff.insertedSectionSet = [NSMutableIndexSet indexSet];
+    diff.deletes = [NSMutableArray array];
+    diff.inserts = [NSMutableArray array];
+    diff.moves = [NSMutableArray array];
+    diff.updates = [NSMutableArray array];
+
+    NSArray<HADashboardConfigSection *> *oldSections = oldConfig.sections ?: @[];
+    NSArray<HADashboardConfigSection *> *newSections = newConfig.sections ?: @[];
+    NSArray<NSString *> *oldIds = ha_uniqueIdentities(oldSections);
+    NSDictionary<NSString *, NSNumber *> *newIndexById = ha_indexByIdentity(ha_uniqueIdentities(newSections));
+
+    // Match sections; kept ones must stay in order
+    NSMutableIndexSet *matchedNew = [NSMutableIndexSet indexSet];
+    NSInteger lastNewIndex = -1;
+    for (NSUInteger os = 0; os < oldSections.count; os++) {
+        NSNumber *match = newIndexById[oldIds[os]];
+        if (!match || ![oldSections[os] isHeaderEqualToSection:newSections[match.unsignedIntegerValue]]) {
+            [diff.deletedSectionSet addIndex:os];
+            continue;
+        }
+        NSUInteger ns = match.unsignedIntegerValue;
+        if ((NSInteger)ns < lastNewIndex) return nil; // sections reordered
+        lastNewIndex = (NSInteger)ns;
+        [matchedNew addIndex:ns];
+        [diff diffItemsOfSection:oldSections[os] atIndex:os withSection:newSections[ns] atIndex:ns];
+    }
+    for (NSUInteger ns = 0; ns < newSections.count; ns++) {
+        if (![matchedNew containsIndex:ns]) [diff.insertedSectionSet addIndex:ns];
+    }
+    return diff;
+}
+
+- (void)diffItemsOfSection:(HADashboardConfigSection *)oldSection atIndex:(NSUInteger)os
+               withSection:(HADashboardConfigSection *)newSection atIndex:(NSUInteger)ns {
+    NSArray<HADashboardConfigItem *> *oldItems = oldSection.items ?: @[];
+    NSArray<HADashboardConfigItem *> *newItems = newSection.items ?: @[];
+    NSArray<NSString *> *oldIds = ha_uniqueIdentities(oldItems);
+    NSArray<NSString *> *newIds = ha_uniqueIdentities(newItems);
+    NSDictionary<NSString *, NSNumber *> *oldIndexById = ha_indexByIdentity(oldIds);
+    NSDictionary<NSString *, NSNumber *> *newIndexById = ha_indexByIdentity(newIds);
+
+    for (NSUInteger i = 0; i < oldIds.count; i++) {
+        if (!newIndexById[oldIds[i]]) [self.deletes addObject:[NSIndexPath indexPathForItem:i inSection:os]];
+    }
+
+    // Kept items in new order, with their old positions: the longest run
+    // already in order stays put, the rest move
+    NSMutableArray<NSNumber *> *keptNew = [NSMutableArray array];
+    NSMutableArray<NSNumber *> *keptOld = [NSMutableArray array];
+    for (NSUInteger j = 0; j < newIds.count; j++) {
+        NSNumber *oldIndex = oldIndexById[newIds[j]];
+        if (!oldIndex) {
+            [self.inserts addObject:[NSIndexPath indexPathForItem:j inSection:ns]];
+            continue;
+        }
+        [keptNew addObject:@(j)];
+        [keptOld addObject:oldIndex];
+    }
+    NSIndexSet *stationary = ha_longestIncreasingSubsequence(keptOld);
+    for (NSUInteger k = 0; k < keptNew.count; k++) {
+        NSUInteger i = keptOld[k].unsignedIntegerValue, j = keptNew[k].unsignedIntegerValue;
+        NSIndexPath *newPath = [NSIndexPath indexPathForItem:j inSection:ns];
+        if (![stationary containsIndex:k]) {
+            [self.moves addObject:@[[NSIndexPath indexPathForItem:i inSection:os], newPath]];
+        }
+        if (![oldItems[i] isContentEqualToItem:newItems[j]]) {
+            [self.updates addObject:newPath];
+        }
+    }
+}
+
+- (NSIndexSet *)deletedSections { return [self.deletedSectionSet copy]; }
+- (NSIndexSet *)insertedSections { return [self.insertedSectionSet copy]; }
+- (NSArray<NSIndexPath *> *)deletedItems { return [self.deletes copy]; }
+- (NSArray<NSIndexPath *> *)insertedItems { return [self.inserts copy]; }
+- (NSArray<NSArray<NSIndexPath *> *> *)movedItems { return [self.moves copy]; }
+- (NSArray<NSIndexPath *> *)updatedItems { return [self.updates copy]; }
+
+- (BOOL)hasStructuralChanges {
+    return self.deletedSectionSet.count > 0 || self.insertedSectionSet.count > 0 ||
+           self.deletes.count > 0 || self.inserts.count > 0 || self.moves.count > 0;
+}
+
+@end
@@ -35,7 +35,7 @@ extern NSString *const HAEntityDomainSiren;
 extern NSString *const HAEntityDomainUpdate;
 extern NSString *const HAEntityDomainCalendar;
 
-@interface HAEntity : NSObject
+@interface HAEntity : NSObject <NSCopying>
 
 @property (nonatomic, copy) NSString *entityId;
 @property (nonatomic, copy) NSString *state;
@@ -43,6 +43,11 @@ extern NSString *const HAEntityDomainCalendar;
 @property (nonatomic, copy) NSString *lastChanged;
 @property (nonatomic, copy) NSString *lastUpdated;
 
+/// Changes whenever state or attributes change (entities are updated in
+/// place), so derived values can be cached against it. Unique across
+/// entity objects; a copy keeps the version of the entity it was taken from.
+@property (nonatomic, assign, readonly) NSUInteger version;
+
 /// Registry-sourced fields (populated from config/entity_registry/list)
 @property (nonatomic, copy) NSString *entityCategory; // "config", "diagnostic", or nil
 @property (nonatomic, copy) NSString *hiddenBy;        // "user", "integration", or nil
@@ -1,4 +1,5 @@
 #import "HAEntity.h"
+#import <stdatomic.h>
 
 NSString *const HAEntityDomainLight        = @"light";
 NSString *const HAEntityDomainSwitch       = @"switch";
@@ -33,10 +34,26 @@ NSString *const HAEntityDomainSiren        = @"siren";
 NSString *const HAEntityDomainUpdate       = @"update";
 NSString *const HAEntityDomainCalendar     = @"calendar";
 
+/// Versions come from one process-wide counter, so no two entity objects
+/// (e.g. one recreated after the store is cleared) ever share a value.
+static atomic_uint_fast64_t ha_entityVersionCounter;
+
+static NSUInteger ha_nextEntityVersion(void) {
+    return (NSUInteger)atomic_fetch_add(&ha_entityVersionCounter, 1) + 1;
+}
+
 @implementation HAEntity
 
-- (instancetype)initWithDictionary:(NSDictionary *)dict {
+- (instancetype)init {
     self = [super init];
+    if (self) {
+        _version = ha_nextEntityVersion();
+    }
+    return self;
+}
+
+- (instancetype)initWithDictionary:(NSDictionary *)dict {
+    self = [self init];
     if (self) {
         [self updateWithDictionary:dict];
     }
@@ -53,6 +70,36 @@ NSString *const HAEntityDomainCalendar     = @"calendar";
     self.lastUpdated = dict[@"last_updated"];
 }
 
+/// Snapshot for work off the main thread, where the store's entity may
+/// be updated in place underneath it.
+- (id)copyWithZone:(NSZone *)zone {
+    HAEntity *copy = [[[self class] allocWithZone:zone] init];
+    copy.entityId = self.entityId;
+    copy.state = self.state;
+    copy.attributes = self.attributes;
+    copy.lastChanged = self.lastChanged;
+    copy.lastUpdated = self.lastUpdated;
+    copy.entityCategory = self.entityCategory;
+    copy.hiddenBy = self.hiddenBy;
+    copy.disabledBy = self.disabledBy;
+    copy.platform = self.platform;
+    copy->_version = _version;
+    return copy;
+}
+
+// Refreshes set both on every update; only a real change is a new version
+- (void)setState:(NSString *)state {
+    if (state == _state || [state isEqual:_state]) return;
+    _state = [state copy];
+    _version = ha_nextEntityVersion();
+}
+
+- (void)setAttributes:(NSDictionary *)attributes {
+    if (attributes == _attributes || [attributes isEqual:_attributes]) return;
+    _attributes = [attributes copy];
+    _version = ha_nextEntityVersion();
+}
+
 #pragma mark - Derived Properties
 
 - (NSString *)domain {
@@ -48,6 +48,7 @@ extern NSString *const HAAttrFriendlyName;          // @"friendly_name"
 extern NSString *const HAAttrIcon;                   // @"icon"
 extern NSString *const HAAttrUnitOfMeasurement;      // @"unit_of_measurement"
 extern NSString *const HAAttrDeviceClass;            // @"device_class"
+extern NSString *const HAAttrStateClass;             // @"state_class"
 extern NSString *const HAAttrSupportedFeatures;      // @"supported_features"
 extern NSString *const HAAttrAttribution;            // @"attribution"
 
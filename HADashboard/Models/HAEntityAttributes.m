@@ -6,6 +6,7 @@ NSString *const HAAttrFriendlyName       = @"friendly_name";
 NSString *const HAAttrIcon               = @"icon";
 NSString *const HAAttrUnitOfMeasurement  = @"unit_of_measurement";
 NSString *const HAAttrDeviceClass        = @"device_class";
+NSString *const HAAttrStateClass         = @"state_class";
 NSString *const HAAttrSupportedFeatures  = @"supported_features";
 NSString *const HAAttrAttribution        = @"attribution";
 
@@ -0,0 +1,54 @@
+#import <UIKit/UIKit.h>
+
+@class HADashboardConfig;
+@class HADashboardConfigItem;
+@class HAEntity;
+
+/// Items whose visibility flipped in one update.
+@interface HAVisibilityChange : NSObject
+@property (nonatomic, copy, readonly) NSArray<HADashboardConfigItem *> *shownItems;
+@property (nonatomic, copy, readonly) NSArray<HADashboardConfigItem *> *hiddenItems;
+@property (nonatomic, readonly) BOOL hasChanges;
+@end
+
+/// Evaluates items' visibilityConditions (Lovelace conditional cards)
+/// incrementally. indexConfig: records which entities (and whether the
+/// screen size) each conditional item depends on; after a full
+/// evaluation, a state change re-evaluates only the items that read that
+/// entity and reports exactly which items appeared or disappeared.
+///
+/// Condition types: state (state / state_not, string or list; also the
+/// legacy form without "condition"), numeric_state (above / below, numbers
+/// or entity ids), screen (media_query with min-width, max-width and
+/// orientation, against the view width in points), and, or. Unknown
+/// types (user, location, ...) count as met. Main thread only.
+@interface HAVisibilityEngine : NSObject
+
+/// Forget the previous config and index this one's conditional items
+/// (section items and top-level items). Every item starts visible until
+/// evaluated.
+- (void)indexConfig:(HADashboardConfig *)config;
+
+/// Evaluate every indexed item.
+- (void)evaluateWithEntities:(NSDictionary<NSString *, HAEntity *> *)entities screenSize:(CGSize)screenSize;
+
+/// Re-evaluate just the items whose conditions read entityId.
+- (HAVisibilityChange *)updateForEntityId:(NSString *)entityId
+                                 entities:(NSDictionary<NSString *, HAEntity *> *)entities;
+
+/// Re-evaluate just the items with screen conditions.
+- (HAVisibilityChange *)updateForScreenSize:(CGSize)screenSize
+                                   entities:(NSDictionary<NSString *, HAEntity *> *)entities;
+
+/// YES for items without conditions.
+- (BOOL)isItemVisible:(HADashboardConfigItem *)item;
+
+/// Whether any indexed item's conditions read this entity.
+- (BOOL)dependsOnEntityId:(NSString *)entityId;
+
+/// One condition dictionary, as found in visibilityConditions.
++ (BOOL)isConditionMet:(NSDictionary *)condition
+          withEntities:(NSDictionary<NSString *, HAEntity *> *)entities
+            screenSize:(CGSize)screenSize;
+
+@end
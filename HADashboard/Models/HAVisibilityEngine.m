@@ -0,0 +1,271 @@
+#import "HAVisibilityEngine.h"
+#import "HADashboardConfig.h"
+#import "HAEntity.h"
+
+@interface HAVisibilityChange ()
+@property (nonatomic, copy, readwrite) NSArray<HADashboardConfigItem *> *shownItems;
+@property (nonatomic, copy, readwrite) NSArray<HADashboardConfigItem *> *hiddenItems;
+@end
+
+@implementation HAVisibilityChange
+
+- (BOOL)hasChanges {
+    return self.shownItems.count > 0 || self.hiddenItems.count > 0;
+}
+
+@end
+
+@interface HAVisibilityEngine ()
+/// Conditional item → current visibility (NSNumber BOOL), by object identity
+@property (nonatomic, strong) NSMapTable<HADashboardConfigItem *, NSNumber *> *visibility;
+/// Entity id → items whose conditions read it
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<HADashboardConfigItem *> *> *itemsByEntityId;
+@property (nonatomic, strong) NSMutableArray<HADashboardConfigItem *> *screenItems;
+@property (nonatomic, assign) CGSize screenSize;
+@end
+
+#pragma mark - Condition helpers
+
+/// A condition value as a string ("on", 5 → "5"), or nil.
+static NSString *ha_conditionString(id value) {
+    if ([value isKindOfClass:[NSString class]]) return value;
+    if ([value isKindOfClass:[NSNumber class]]) return [value stringValue];
+    return nil;
+}
+
+/// Whether state equals value, or one of value's entries if it's a list.
+static BOOL ha_stateMatches(NSString *state, id value) {
+    if ([value isKindOfClass:[NSArray class]]) {
+        for (id option in value) {
+            if ([state isEqualToString:ha_conditionString(option) ?: @""]) return YES;
+        }
+        return NO;
+    }
+    return [state isEqualToString:ha_conditionString(value) ?: @""];
+}
+
+/// numeric_state bound: a number, a numeric string, or an entity id whose state is numeric.
+static BOOL ha_numericBound(id value, NSDictionary<NSString *, HAEntity *> *entities, double *outBound) {
+    if ([value isKindOfClass:[NSNumber class]]) {
+        *outBound = [value doubleValue];
+        return YES;
+    }
+    if (![value isKindOfClass:[NSString class]]) return NO;
+    NSScanner *scanner = [NSScanner scannerWithString:value];
+    double number;
+    if ([scanner scanDouble:&number] && scanner.isAtEnd) {
+        *outBound = number;
+        return YES;
+    }
+    NSString *state = entities[value].state;
+    scanner = state ? [NSScanner scannerWithString:state] : nil;
+    if (scanner && [scanner scanDouble:&number] && scanner.isAtEnd) {
+        *outBound = number;
+        return YES;
+    }
+    return NO;
+}
+
+/// Evaluate the subset of CSS media queries dashboards use: (min-width: Npx),
+/// (max-width: Npx) and (orientation: portrait|landscape), joined by "and".
+static BOOL ha_mediaQueryMatches(NSString *query, CGSize size) {
+    if (query.length == 0) return YES;
+    NSString *lower = [query lowercaseString];
+    NSRegularExpression *feature = [NSRegularExpression regularExpressionWithPattern:
+        @"\\(\\s*(min-width|max-width|orientation)\\s*:\\s*([a-z0-9.]+)(?:px)?\\s*\\)" options:0 error:nil];
+    __block BOOL matches = YES;
+    [feature enumerateMatchesInString:lower options:0 range:NSMakeRange(0, lower.length)
+                           usingBlock:^(NSTextCheckingResult *result, NSMatchingFlags flags, BOOL *stop) {
+        NSString *name = [lower substringWithRange:[result rangeAtIndex:1]];
+        NSString *value = [lower substringWithRange:[result rangeAtIndex:2]];
+        BOOL ok = YES;
+        if ([name isEqualToString:@"min-width"]) {
+            ok = (size.width >= [value doubleValue]);
+        } else if ([name isEqualToString:@"max-width"]) {
+            ok = (size.width <= [value doubleValue]);
+        } else if ([value isEqualToString:@"landscape"]) {
+            ok = (size.width > size.height);
+        } else if ([value isEqualToString:@"portrait"]) {
+            ok = (size.width <= size.height);
+        }
+        if (!ok) {
+            matches = NO;
+            *stop = YES;
+        }
+    }];
+    return matches;
+}
+
+/// Entity ids a condition reads, and whether it reads the screen size.
+static void ha_collectDependencies(id condition, NSMutableSet<NSString *> *entityIds, BOOL *usesScreen) {
+    if ([condition isKindOfClass:[NSArray class]]) {
+        for (id sub in condition) ha_collectDependencies(sub, entityIds, usesScreen);
+        return;
+    }
+    if (![condition isKindOfClass:[NSDictionary class]]) return;
+    NSString *type = ha_conditionString(condition[@"condition"]);
+    if ([type isEqualToString:@"screen"]) {
+        *usesScreen = YES;
+        return;
+    }
+    if ([type isEqualToString:@"and"] || [type isEqualToString:@"or"]) {
+        ha_collectDependencies(condition[@"conditions"], entityIds, usesScreen);
+        return;
+    }
+    NSString *entityId = ha_conditionString(condition[@"entity"]);
+    if (entityId) [entityIds addObject:entityId];
+    // numeric_state bounds may name other entities
+    for (NSString *key in @[@"above", @"below"]) {
+        id bound = condition[key];
+        if ([bound isKindOfClass:[NSString class]] && [bound containsString:@"."]) {
+            [entityIds addObject:bound];
+        }
+    }
+}
+
+@implementation HAVisibilityEngine
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        [self reset];
+    }
+    return self;
+}
+
+- (void)reset {
+    self.visibility = [NSMapTable mapTableWithKeyOptions:NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality
+                                            valueOptions:NSPointerFunctionsStrongMemory];
+    self.itemsByEntityId = [NSMutableDictionary dictionary];
+    self.screenItems = [NSMutableArray array];
+}
+
+#pragma mark - Index
+
+- (void)indexConfig:(HADashboardConfig *)config {
+    [self reset];
+    for (HADashboardConfigSection *section in config.sections) {
+        for (HADashboardConfigItem *item in section.items) [self indexItem:item];
+    }
+    for (HADashboardConfigItem *item in config.items) [self indexItem:item];
+}
+
+- (void)indexItem:(HADashboardConfigItem *)item {
+    if (item.visibilityConditions.count == 0 || [self.visibility objectForKey:item]) return;
+    [self.visibility setObject:@YES forKey:item];
+
+    NSMutableSet<NSString *> *entityIds = [NSMutableSet set];
+    BOOL usesScreen = NO;
+    ha_collectDependencies(item.visibilityConditions, entityIds, &usesScreen);
+    for (NSString *entityId in entityIds) {
+        NSMutableArray *items = self.itemsByEntityId[entityId];
+        if (!items) {
+            items = [NSMutableArray array];
+            self.itemsByEntityId[entityId] = items;
+        }
+        [items addObject:item];
+    }
+    if (usesScreen) [self.screenItems addObject:item];
+}
+
+#pragma mark - Evaluate
+
+- (void)evaluateWithEntities:(NSDictionary<NSString *, HAEntity *> *)entities screenSize:(CGSize)screenSize {
+    self.screenSize = screenSize;
+    for (HADashboardConfigItem *item in [[self.visibility keyEnumerator] allObjects]) {
+        [self.visibility setObject:@([self evaluateItem:item entities:entities]) forKey:item];
+    }
+}
+
+- (HAVisibilityChange *)updateForEntityId:(NSString *)entityId
+                                 entities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    return [self reevaluateItems:entityId ? self.itemsByEntityId[entityId] : nil entities:entities];
+}
+
+- (HAVisibilityChange *)updateForScreenSize:(CGSize)screenSize
+                                   entities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    self.screenSize = screenSize;
+    return [self reevaluateItems:self.screenItems entities:entities];
+}
+
+- (HAVisibilityChange *)reevaluateItems:(NSArray<HADashboardConfigItem *> *)items
+                               entities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    NSMutableArray *shown = [NSMutableArray array];
+    NSMutableArray *hidden = [NSMutableArray array];
+    for (HADashboardConfigItem *item in items) {
+        BOOL wasVisible = [[self.visibility objectForKey:item] boolValue];
+        BOOL visible = [self evaluateItem:item entities:entities];
+        if (visible == wasVisible) continue;
+        [self.visibility setObject:@(visible) forKey:item];
+        [(visible ? shown : hidden) addObject:item];
+    }
+    HAVisibilityChange *change = [[HAVisibilityChange alloc] init];
+    change.shownItems = shown;
+    change.hiddenItems = hidden;
+    return change;
+}
+
+- (BOOL)evaluateItem:(HADashboardConfigItem *)item entities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    // Top-level list: all must hold
+    for (NSDictionary *condition in item.visibilityConditions) {
+        if (![HAVisibilityEngine isConditionMet:condition withEntities:entities screenSize:self.screenSize]) return NO;
+    }
+    return YES;
+}
+
+- (BOOL)isItemVisible:(HADashboardConfigItem *)item {
+    NSNumber *visible = [self.visibility objectForKey:item];
+    return visible ? visible.boolValue : YES;
+}
+
+- (BOOL)dependsOnEntityId:(NSString *)entityId {
+    return entityId && self.itemsByEntityId[entityId] != nil;
+}
+
+#pragma mark - Conditions
+
++ (BOOL)isConditionMet:(NSDictionary *)condition
+          withEntities:(NSDictionary<NSString *, HAEntity *> *)entities
+            screenSize:(CGSize)screenSize {
+    if (![condition isKindOfClass:[NSDictionary class]]) return YES;
+    NSString *type = ha_conditionString(condition[@"condition"]);
+
+    if ([type isEqualToString:@"and"] || [type isEqualToString:@"or"]) {
+        NSArray *conditions = condition[@"conditions"];
+        if (![conditions isKindOfClass:[NSArray class]] || conditions.count == 0) return YES;
+        BOOL isOr = [type isEqualToString:@"or"];
+        for (NSDictionary *sub in conditions) {
+            BOOL met = [self isConditionMet:sub withEntities:entities screenSize:screenSize];
+            if (isOr && met) return YES;
+            if (!isOr && !met) return NO;
+        }
+        return !isOr;
+    }
+
+    if ([type isEqualToString:@"screen"]) {
+        return ha_mediaQueryMatches(ha_conditionString(condition[@"media_query"]), screenSize);
+    }
+
+    NSString *entityId = ha_conditionString(condition[@"entity"]);
+
+    if ([type isEqualToString:@"numeric_state"]) {
+        if (!entityId) return YES;
+        NSScanner *scanner = [NSScanner scannerWithString:entities[entityId].state ?: @""];
+        double value;
+        if (![scanner scanDouble:&value] || !scanner.isAtEnd) return NO;
+        double bound;
+        if (condition[@"above"] && (!ha_numericBound(condition[@"above"], entities, &bound) || !(value > bound))) return NO;
+        if (condition[@"below"] && (!ha_numericBound(condition[@"below"], entities, &bound) || !(value < bound))) return NO;
+        return YES;
+    }
+
+    // "state", or the legacy form with no condition key
+    if (type && ![type isEqualToString:@"state"]) return YES; // user, location, ... not evaluated here
+    if (!entityId) return YES;
+    NSString *state = entities[entityId].state ?: @"";
+    if (condition[@"state"] && !ha_stateMatches(state, condition[@"state"])) return NO;
+    if (condition[@"state_not"] && ha_stateMatches(state, condition[@"state_not"])) return NO;
+    return YES;
+}
+
+@end
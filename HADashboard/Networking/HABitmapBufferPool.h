@@ -0,0 +1,37 @@
+#import <UIKit/UIKit.h>
+
+/// Recycles the pixel buffers decoded camera frames live in. Every frame of
+/// a stream has the same size, so instead of allocating a fresh backing
+/// store per frame (tens of MB a minute per camera), the buffer behind a
+/// frame goes back to the pool when its last image is released (the image
+/// view moved on to the next frame) and the next frame of that size is
+/// drawn into it. Free buffers are kept up to maxPooledBytes; buffers in
+/// use don't count. Thread-safe: frames are drawn on decode queues and
+/// usually released on main.
+@interface HABitmapBufferPool : NSObject
+
++ (instancetype)sharedPool;
+
+/// Hard cap on bytes held in free buffers. Device-dependent default
+/// (4 MB on 512 MB devices, up to 16 MB); lowering it trims immediately.
+@property (nonatomic, assign) NSUInteger maxPooledBytes;
+
+/// Bytes currently held in free buffers.
+@property (nonatomic, readonly) NSUInteger pooledBytes;
+
+/// Buffers handed out from the pool vs freshly allocated.
+@property (nonatomic, readonly) NSUInteger reuseCount;
+@property (nonatomic, readonly) NSUInteger allocationCount;
+
+/// Opaque 32-bit bitmap of the given pixel size, filled by drawing, backed
+/// by a pooled buffer. drawing must cover the whole context: a recycled
+/// buffer still holds the previous frame. nil if the size is empty or no
+/// context could be created.
+- (UIImage *)imageWithPixelWidth:(size_t)width
+                          height:(size_t)height
+                         drawing:(void (^)(CGContextRef context))drawing;
+
+/// Free every pooled buffer (memory warning).
+- (void)drain;
+
+@end
@@ -0,0 +1,197 @@
+#import "HABitmapBufferPool.h"
+#import "HALog.h"
+
+/// Rows are padded to this many bytes, as CoreGraphics prefers.
+static const size_t kRowAlignment = 64;
+
+@class HABitmapBufferPool;
+
+/// One malloc'd pixel buffer. While an image uses it, the image's data
+/// provider holds the only reference.
+@interface HAPooledBitmapBuffer : NSObject
+@property (nonatomic, assign, readonly) void *bytes;
+@property (nonatomic, assign, readonly) size_t length;
+@property (nonatomic, weak) HABitmapBufferPool *pool;
+@end
+
+@implementation HAPooledBitmapBuffer
+
+- (instancetype)initWithLength:(size_t)length {
+    void *bytes = malloc(length);
+    if (!bytes) return nil;
+    self = [super init];
+    if (self) {
+        _bytes = bytes;
+        _length = length;
+    } else {
+        free(bytes);
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_bytes);
+}
+
+@end
+
+@interface HABitmapBufferPool ()
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSMutableArray<HAPooledBitmapBuffer *> *> *freeBuffers;
+@property (nonatomic, assign, readwrite) NSUInteger pooledBytes;
+@property (nonatomic, assign, readwrite) NSUInteger reuseCount;
+@property (nonatomic, assign, readwrite) NSUInteger allocationCount;
+- (void)recycleBuffer:(HAPooledBitmapBuffer *)buffer;
+@end
+
+/// CGDataProvider release callback: the last image using the buffer is gone.
+static void ha_releasePooledBuffer(void *info, const void *data, size_t size) {
+    HAPooledBitmapBuffer *buffer = (__bridge_transfer HAPooledBitmapBuffer *)info;
+    [buffer.pool recycleBuffer:buffer];
+}
+
+@implementation HABitmapBufferPool
+
++ (instancetype)sharedPool {
+    static HABitmapBufferPool *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[HABitmapBufferPool alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _freeBuffers = [NSMutableDictionary dictionary];
+        unsigned long long memory = [NSProcessInfo processInfo].physicalMemory;
+        if (memory <= 512ULL * 1024 * 1024) {
+            _maxPooledBytes = 4 * 1024 * 1024;
+        } else if (memory < 2ULL * 1024 * 1024 * 1024) {
+            _maxPooledBytes = 8 * 1024 * 1024;
+        } else {
+            _maxPooledBytes = 16 * 1024 * 1024;
+        }
+    }
+    return self;
+}
+
+- (void)setMaxPooledBytes:(NSUInteger)maxPooledBytes {
+    @synchronized (self) {
+        _maxPooledBytes = maxPooledBytes;
+        [self trimToBytes:maxPooledBytes keepingLength:0];
+    }
+}
+
+#pragma mark - Images
+
+- (UIImage *)imageWithPixelWidth:(size_t)width
+                          height:(size_t)height
+                         drawing:(void (^)(CGContextRef context))drawing {
+    if (width == 0 || height == 0 || !drawing) return nil;
+    size_t bytesPerRow = ((width * 4) + kRowAlignment - 1) / kRowAlignment * kRowAlignment;
+    HAPooledBitmapBuffer *buffer = [self checkoutBufferOfLength:bytesPerRow * height];
+    if (!buffer) return nil;
+
+    // BGRX, the layout the display uses natively: no conversion when drawn
+    CGBitmapInfo bitmapInfo = kCGBitmapByteOrder32Little | kCGImageAlphaNoneSkipFirst;
+    CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+    CGContextRef context = CGBitmapContextCreate(buffer.bytes, width, height, 8, bytesPerRow, colorSpace, bitmapInfo);
+    if (!context) {
+        CGColorSpaceRelease(colorSpace);
+        [self recycleBuffer:buffer];
+        return nil;
+    }
+    drawing(context);
+    CGContextRelease(context);
+
+    // The provider owns the buffer from here; its release callback recycles it
+    void *info = (__bridge_retained void *)buffer;
+    CGDataProviderRef provider = CGDataProviderCreateWithData(info, buffer.bytes, buffer.length,
+                                                              ha_releasePooledBuffer);
+    if (!provider) {
+        // No provider to call back: take the reference back and recycle here
+        CFBridgingRelease(info);
+        CGColorSpaceRelease(colorSpace);
+        [self recycleBuffer:buffer];
+        return nil;
+    }
+    CGImageRef image = CGImageCreate(width, height, 8, 32, bytesPerRow, colorSpace, bitmapInfo,
+                                     provider, NULL, false, kCGRenderingIntentDefault);
+    CGDataProviderRelease(provider);
+    CGColorSpaceRelease(colorSpace);
+    if (!image) return nil;
+
+    UIImage *result = [UIImage imageWithCGImage:image scale:1.0 orientation:UIImageOrientationUp];
+    CGImageRelease(image);
+    return result;
+}
+
+#pragma mark - Buffers
+
+- (HAPooledBitmapBuffer *)checkoutBufferOfLength:(size_t)length {
+    @synchronized (self) {
+        NSMutableArray<HAPooledBitmapBuffer *> *buffers = self.freeBuffers[@(length)];
+        HAPooledBitmapBuffer *buffer = buffers.lastObject;
+        if (buffer) {
+            [buffers removeLastObject];
+            self.pooledBytes -= length;
+            self.reuseCount++;
+            return buffer;
+        }
+        self.allocationCount++;
+    }
+    HAPooledBitmapBuffer *buffer = [[HAPooledBitmapBuffer alloc] initWithLength:length];
+    buffer.pool = self;
+    return buffer;
+}
+
+- (void)recycleBuffer:(HAPooledBitmapBuffer *)buffer {
+    if (!buffer) return;
+    @synchronized (self) {
+        // Make room by dropping other sizes first: after a relayout or a
+        // fullscreen close those won't be asked for again
+        [self trimToBytes:self.maxPooledBytes - MIN(self.maxPooledBytes, buffer.length)
+            keepingLength:buffer.length];
+        if (self.pooledBytes + buffer.length > self.maxPooledBytes) return; // freed on return
+
+        NSNumber *key = @(buffer.length);
+        NSMutableArray<HAPooledBitmapBuffer *> *buffers = self.freeBuffers[key];
+        if (!buffers) {
+            buffers = [NSMutableArray array];
+            self.freeBuffers[key] = buffers;
+        }
+        [buffers addObject:buffer];
+        self.pooledBytes += buffer.length;
+    }
+}
+
+/// Free buffers until pooledBytes <= limit, sparing keepLength's size class
+/// unless nothing else is left. Caller holds the lock.
+- (void)trimToBytes:(NSUInteger)limit keepingLength:(size_t)keepLength {
+    if (self.pooledBytes <= limit) return;
+    NSMutableArray<NSNumber *> *keys = [[self.freeBuffers allKeys] mutableCopy];
+    [keys removeObject:@(keepLength)];
+    [keys addObject:@(keepLength)];
+    for (NSNumber *key in keys) {
+        NSMutableArray<HAPooledBitmapBuffer *> *buffers = self.freeBuffers[key];
+        while (buffers.count > 0 && self.pooledBytes > limit) {
+            self.pooledBytes -= buffers.lastObject.length;
+            [buffers removeLastObject];
+        }
+        if (buffers.count == 0) [self.freeBuffers removeObjectForKey:key];
+        if (self.pooledBytes <= limit) break;
+    }
+}
+
+- (void)drain {
+    NSUInteger freed;
+    @synchronized (self) {
+        freed = self.pooledBytes;
+        [self.freeBuffers removeAllObjects];
+        self.pooledBytes = 0;
+    }
+    HALogD(@"cam", @"Bitmap pool drained (%lu bytes)", (unsigned long)freed);
+}
+
+@end
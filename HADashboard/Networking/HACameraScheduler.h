@@ -0,0 +1,51 @@
+#import <UIKit/UIKit.h>
+
+@class HACameraScheduler;
+
+/// What a camera tile may run right now.
+typedef NS_ENUM(NSInteger, HACameraSlot) {
+    HACameraSlotPaused = 0, // off-screen: no stream, no polling
+    HACameraSlotSnapshot,   // over budget: snapshot polling at overflowSnapshotInterval
+    HACameraSlotLive,       // may stream (HLS/MJPEG)
+};
+
+@protocol HACameraSchedulerClient <NSObject>
+/// The scheduler moved this client to another slot (another camera came or
+/// went). Not called for the slot returned by requestSlotForClient:.
+- (void)cameraScheduler:(HACameraScheduler *)scheduler didAssignSlot:(HACameraSlot)slot;
+@end
+
+/// Global budget for camera tiles, so a camera-heavy dashboard on an iPad 2
+/// doesn't start a stream per tile. Visible tiles register; the largest get
+/// live slots up to maxLiveStreams, the rest are downgraded to slower
+/// snapshot polling, and tiles that leave the screen release their slot and
+/// stop. Snapshot fetches across all tiles share a per-second budget.
+/// Main thread only.
+@interface HACameraScheduler : NSObject
+
++ (instancetype)sharedScheduler;
+
+/// Defaults by device class: 1 / 2 per second on armv7 (iPad 2/3, iPhone 4S,
+/// iPod 5), 2 / 4 on other devices with under 2 GB RAM, 4 / 8 otherwise.
+@property (nonatomic, assign) NSUInteger maxLiveStreams;
+@property (nonatomic, assign) double maxSnapshotsPerSecond;
+
+/// Poll interval for tiles downgraded to snapshots by the budget.
+@property (nonatomic, assign) NSTimeInterval overflowSnapshotInterval;
+
+/// Register or update a visible tile. area is its on-screen size in points²
+/// (larger tiles win live slots); wantsLive NO (snapshot-only cameras)
+/// never takes a live slot. Other clients may be re-slotted as a result.
+- (HACameraSlot)requestSlotForClient:(id<HACameraSchedulerClient>)client area:(CGFloat)area wantsLive:(BOOL)wantsLive;
+
+/// The tile left the screen or stopped; its live slot goes to the next tile.
+- (void)releaseSlotForClient:(id<HACameraSchedulerClient>)client;
+
+/// Current slot (Paused if not registered).
+- (HACameraSlot)slotForClient:(id<HACameraSchedulerClient>)client;
+
+/// Take one snapshot fetch from the shared per-second budget. NO means the
+/// budget is spent; skip or retry shortly.
+- (BOOL)acquireSnapshotToken;
+
+@end
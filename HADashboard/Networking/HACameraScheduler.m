@@ -0,0 +1,167 @@
+#import "HACameraScheduler.h"
+#import "HADeviceRegistration.h"
+#import "HALog.h"
+#import <QuartzCore/QuartzCore.h>
+
+@interface HACameraSchedulerEntry : NSObject
+@property (nonatomic, assign) CGFloat area;
+@property (nonatomic, assign) BOOL wantsLive;
+@property (nonatomic, assign) NSUInteger sequence; // registration order breaks ties
+@property (nonatomic, assign) HACameraSlot slot;
+@end
+
+@implementation HACameraSchedulerEntry
+@end
+
+@interface HACameraScheduler ()
+@property (nonatomic, strong) NSMapTable<id<HACameraSchedulerClient>, HACameraSchedulerEntry *> *entries;
+@property (nonatomic, assign) NSUInteger nextSequence;
+@property (nonatomic, assign) NSUInteger assignedLiveCount; // live slots handed out by the last reassign
+@property (nonatomic, assign) double snapshotTokens;
+@property (nonatomic, assign) CFTimeInterval lastTokenRefill;
+@end
+
+@implementation HACameraScheduler
+
++ (instancetype)sharedScheduler {
+    static HACameraScheduler *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[HACameraScheduler alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _entries = [NSMapTable weakToStrongObjectsMapTable];
+
+        BOOL lightweight = HADeviceIsLowEnd();
+        unsigned long long memory = [NSProcessInfo processInfo].physicalMemory;
+        if (lightweight) {
+            _maxLiveStreams = 1;
+            _maxSnapshotsPerSecond = 2;
+            _overflowSnapshotInterval = 15.0;
+        } else if (memory < 2ULL * 1024 * 1024 * 1024) {
+            _maxLiveStreams = 2;
+            _maxSnapshotsPerSecond = 4;
+            _overflowSnapshotInterval = 10.0;
+        } else {
+            _maxLiveStreams = 4;
+            _maxSnapshotsPerSecond = 8;
+            _overflowSnapshotInterval = 10.0;
+        }
+        _snapshotTokens = MAX(1.0, _maxSnapshotsPerSecond);
+        _lastTokenRefill = CACurrentMediaTime();
+    }
+    return self;
+}
+
+- (void)setMaxSnapshotsPerSecond:(double)maxSnapshotsPerSecond {
+    _maxSnapshotsPerSecond = maxSnapshotsPerSecond;
+    self.snapshotTokens = MIN(self.snapshotTokens, MAX(1.0, maxSnapshotsPerSecond));
+}
+
+- (void)setMaxLiveStreams:(NSUInteger)maxLiveStreams {
+    _maxLiveStreams = maxLiveStreams;
+    [self reassignSlotsExcept:nil];
+}
+
+#pragma mark - Slots
+
+- (HACameraSlot)requestSlotForClient:(id<HACameraSchedulerClient>)client area:(CGFloat)area wantsLive:(BOOL)wantsLive {
+    if (!client) return HACameraSlotPaused;
+    HACameraSchedulerEntry *entry = [self.entries objectForKey:client];
+    if (!entry) {
+        entry = [[HACameraSchedulerEntry alloc] init];
+        entry.sequence = self.nextSequence++;
+        entry.slot = HACameraSlotPaused;
+        [self.entries setObject:entry forKey:client];
+    }
+    entry.area = area;
+    entry.wantsLive = wantsLive;
+    [self reassignSlotsExcept:client];
+    return entry.slot;
+}
+
+- (void)releaseSlotForClient:(id<HACameraSchedulerClient>)client {
+    if (!client || ![self.entries objectForKey:client]) {
+        // Released from dealloc, after the weak key was already cleared
+        [self reclaimLostSlots];
+        return;
+    }
+    [self.entries removeObjectForKey:client];
+    [self reassignSlotsExcept:nil];
+}
+
+- (HACameraSlot)slotForClient:(id<HACameraSchedulerClient>)client {
+    HACameraSchedulerEntry *entry = client ? [self.entries objectForKey:client] : nil;
+    return entry ? entry.slot : HACameraSlotPaused;
+}
+
+/// A client deallocated while live drops out of the weak-keyed table
+/// without releasing its slot; hand the slot to the next tile.
+- (void)reclaimLostSlots {
+    NSUInteger live = 0;
+    for (id<HACameraSchedulerClient> client in self.entries) {
+        if ([self.entries objectForKey:client].slot == HACameraSlotLive) live++;
+    }
+    if (live < self.assignedLiveCount) [self reassignSlotsExcept:nil];
+}
+
+/// Largest tiles first get the live slots; everyone else snapshots.
+/// Clients whose slot changed are told, except `requester`, which gets
+/// its slot as the return value.
+- (void)reassignSlotsExcept:(id<HACameraSchedulerClient>)requester {
+    NSMutableArray<id<HACameraSchedulerClient>> *clients = [NSMutableArray array];
+    for (id<HACameraSchedulerClient> client in self.entries) [clients addObject:client];
+    [clients sortUsingComparator:^NSComparisonResult(id a, id b) {
+        HACameraSchedulerEntry *ea = [self.entries objectForKey:a];
+        HACameraSchedulerEntry *eb = [self.entries objectForKey:b];
+        if (ea.area != eb.area) return ea.area > eb.area ? NSOrderedAscending : NSOrderedDescending;
+        if (ea.sequence == eb.sequence) return NSOrderedSame;
+        return ea.sequence < eb.sequence ? NSOrderedAscending : NSOrderedDescending;
+    }];
+
+    NSUInteger live = 0;
+    NSMutableArray<id<HACameraSchedulerClient>> *changed = [NSMutableArray array];
+    for (id<HACameraSchedulerClient> client in clients) {
+        HACameraSchedulerEntry *entry = [self.entries objectForKey:client];
+        HACameraSlot slot = HACameraSlotSnapshot;
+        if (entry.wantsLive && live < self.maxLiveStreams) {
+            slot = HACameraSlotLive;
+            live++;
+        }
+        if (entry.slot != slot) {
+            entry.slot = slot;
+            if (client != requester) [changed addObject:client];
+        }
+    }
+    self.assignedLiveCount = live;
+    if (changed.count > 0) {
+        HALogD(@"cam", @"Scheduler: %lu live of %lu cameras, %lu re-slotted",
+               (unsigned long)live, (unsigned long)clients.count, (unsigned long)changed.count);
+    }
+    for (id<HACameraSchedulerClient> client in changed) {
+        [client cameraScheduler:self didAssignSlot:[self.entries objectForKey:client].slot];
+    }
+}
+
+#pragma mark - Snapshot Budget
+
+- (BOOL)acquireSnapshotToken {
+    // Snapshot tiles poll here, so a slot lost to a deallocated tile is picked up
+    [self reclaimLostSlots];
+
+    // Token bucket: refills at maxSnapshotsPerSecond, bursts up to one second's worth
+    CFTimeInterval now = CACurrentMediaTime();
+    double capacity = MAX(1.0, self.maxSnapshotsPerSecond);
+    self.snapshotTokens = MIN(capacity, self.snapshotTokens + (now - self.lastTokenRefill) * self.maxSnapshotsPerSecond);
+    self.lastTokenRefill = now;
+    if (self.snapshotTokens < 1.0) return NO;
+    self.snapshotTokens -= 1.0;
+    return YES;
+}
+
+@end
@@ -0,0 +1,53 @@
+#import <UIKit/UIKit.h>
+
+@class HAMJPEGStreamParser;
+
+/// One consumer's attachment to a shared camera stream. Hold on to it for
+/// as long as frames are wanted; cancel (or release) it to detach.
+@interface HACameraStreamConsumer : NSObject
+
+@property (nonatomic, copy, readonly) NSString *entityId;
+
+/// Pixels this consumer wants frames decoded at (CGSizeZero = full
+/// resolution). The stream decodes once per frame, at the largest size any
+/// of its consumers asks for.
+@property (nonatomic, assign) CGSize pixelSize;
+
+/// Whether the shared stream this consumer is attached to is running.
+@property (nonatomic, readonly) BOOL isStreaming;
+
+/// Detach. The stream stops when its last consumer detaches. Idempotent.
+- (void)cancel;
+
+/// Tear the shared stream down for every consumer as if it had failed:
+/// each gets its errorHandler. For a stream that stopped delivering frames,
+/// where reconnecting just this consumer would rejoin the dead stream.
+- (void)failStreamWithError:(NSError *)error;
+
+@end
+
+/// Process-wide MJPEG streams keyed by camera entity. Two cards showing the
+/// same camera share one connection to HA and one decode per frame, with
+/// decoded frames fanned out to every consumer. Main thread only.
+@interface HACameraStreamRegistry : NSObject
+
++ (instancetype)sharedRegistry;
+
+/// Attach to the entity's stream, opening it from url if no other consumer
+/// has. frameHandler runs on main for every frame (first with the latest
+/// frame if the stream was already running). errorHandler runs on main
+/// once if the stream fails; the consumer is detached by then.
+- (HACameraStreamConsumer *)addConsumerForEntityId:(NSString *)entityId
+                                               url:(NSURL *)url
+                                         authToken:(NSString *)token
+                                         pixelSize:(CGSize)pixelSize
+                                      frameHandler:(void (^)(UIImage *frame))frameHandler
+                                      errorHandler:(void (^)(NSError *error))errorHandler;
+
+/// Running parser for an entity, or nil (for stats; don't stop it directly).
+- (HAMJPEGStreamParser *)parserForEntityId:(NSString *)entityId;
+
+/// Number of consumers attached to an entity's stream.
+- (NSUInteger)consumerCountForEntityId:(NSString *)entityId;
+
+@end
@@ -0,0 +1,214 @@
+#import "HACameraStreamRegistry.h"
+#import "HAMJPEGStreamParser.h"
+#import "HALog.h"
+
+/// One open stream and the consumers sharing it.
+@interface HACameraSharedStream : NSObject
+@property (nonatomic, copy) NSString *entityId;
+@property (nonatomic, strong) HAMJPEGStreamParser *parser;
+@property (nonatomic, strong) NSHashTable<HACameraStreamConsumer *> *consumers; // weak
+@property (nonatomic, strong) UIImage *latestFrame;
+@end
+
+@implementation HACameraSharedStream
+@end
+
+@interface HACameraStreamConsumer ()
+@property (nonatomic, copy, readwrite) NSString *entityId;
+@property (nonatomic, weak) HACameraSharedStream *stream;
+@property (nonatomic, copy) void (^frameHandler)(UIImage *frame);
+@property (nonatomic, copy) void (^errorHandler)(NSError *error);
+@end
+
+@interface HACameraStreamRegistry ()
+@property (nonatomic, strong) NSMutableDictionary<NSString *, HACameraSharedStream *> *streams;
+- (void)removeConsumer:(HACameraStreamConsumer *)consumer fromStream:(HACameraSharedStream *)stream;
+- (void)updatePixelSizeForStream:(HACameraSharedStream *)stream;
+- (void)failStream:(HACameraSharedStream *)stream error:(NSError *)error;
+@end
+
+@implementation HACameraStreamConsumer
+
+- (void)dealloc {
+    // A consumer released without cancel still has to let go of the stream
+    HACameraSharedStream *stream = _stream;
+    if (stream) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [[HACameraStreamRegistry sharedRegistry] removeConsumer:nil fromStream:stream];
+        });
+    }
+}
+
+- (void)setPixelSize:(CGSize)pixelSize {
+    if (CGSizeEqualToSize(_pixelSize, pixelSize)) return;
+    _pixelSize = pixelSize;
+    if (self.stream) [[HACameraStreamRegistry sharedRegistry] updatePixelSizeForStream:self.stream];
+}
+
+- (BOOL)isStreaming {
+    return self.stream.parser.isStreaming;
+}
+
+- (void)failStreamWithError:(NSError *)error {
+    HACameraSharedStream *stream = self.stream;
+    if (stream) [[HACameraStreamRegistry sharedRegistry] failStream:stream error:error];
+}
+
+- (void)cancel {
+    HACameraSharedStream *stream = self.stream;
+    self.frameHandler = nil;
+    self.errorHandler = nil;
+    if (!stream) return;
+    self.stream = nil;
+    [[HACameraStreamRegistry sharedRegistry] removeConsumer:self fromStream:stream];
+}
+
+@end
+
+@implementation HACameraStreamRegistry
+
++ (instancetype)sharedRegistry {
+    static HACameraStreamRegistry *instance = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        instance = [[HACameraStreamRegistry alloc] init];
+    });
+    return instance;
+}
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _streams = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - Consumers
+
+- (HACameraStreamConsumer *)addConsumerForEntityId:(NSString *)entityId
+                                               url:(NSURL *)url
+                                         authToken:(NSString *)token
+                                         pixelSize:(CGSize)pixelSize
+                                      frameHandler:(void (^)(UIImage *))frameHandler
+                                      errorHandler:(void (^)(NSError *))errorHandler {
+    if (!entityId || !url) return nil;
+
+    HACameraStreamConsumer *consumer = [[HACameraStreamConsumer alloc] init];
+    consumer.entityId = entityId;
+    consumer.frameHandler = frameHandler;
+    consumer.errorHandler = errorHandler;
+    consumer.pixelSize = pixelSize; // not attached yet, so the stream's size is set below
+
+    HACameraSharedStream *stream = self.streams[entityId];
+    BOOL isNew = (stream == nil);
+    if (isNew) {
+        stream = [[HACameraSharedStream alloc] init];
+        stream.entityId = entityId;
+        stream.consumers = [NSHashTable weakObjectsHashTable];
+        stream.parser = [[HAMJPEGStreamParser alloc] init];
+        stream.parser.metricsName = entityId;
+        self.streams[entityId] = stream;
+        [self attachHandlersToStream:stream];
+    }
+    [stream.consumers addObject:consumer];
+    consumer.stream = stream;
+    [self updatePixelSizeForStream:stream];
+
+    if (isNew) {
+        HALogD(@"cam", @"Opening shared stream for %@", entityId);
+        [stream.parser startWithURL:url authToken:token];
+    } else {
+        HALogD(@"cam", @"Joining shared stream for %@ (%lu consumers)", entityId, (unsigned long)stream.consumers.count);
+        // Paint the newcomer right away instead of waiting for the next frame
+        UIImage *latest = stream.latestFrame;
+        if (latest) {
+            __weak HACameraStreamConsumer *weakConsumer = consumer;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                HACameraStreamConsumer *c = weakConsumer;
+                if (c.stream == stream && c.frameHandler) c.frameHandler(latest);
+            });
+        }
+    }
+    return consumer;
+}
+
+- (void)attachHandlersToStream:(HACameraSharedStream *)stream {
+    __weak HACameraSharedStream *weakStream = stream;
+    __weak typeof(self) weakSelf = self;
+    stream.parser.frameHandler = ^(UIImage *frame) {
+        HACameraSharedStream *s = weakStream;
+        if (!s) return;
+        s.latestFrame = frame;
+        // Copy: a handler may cancel its consumer mid-iteration
+        for (HACameraStreamConsumer *consumer in s.consumers.allObjects) {
+            if (consumer.frameHandler) consumer.frameHandler(frame);
+        }
+    };
+    stream.parser.errorHandler = ^(NSError *error) {
+        HACameraSharedStream *s = weakStream;
+        if (s) [weakSelf failStream:s error:error];
+    };
+}
+
+- (void)failStream:(HACameraSharedStream *)stream error:(NSError *)error {
+    HALogW(@"cam", @"Shared stream for %@ failed: %@", stream.entityId, error.localizedDescription);
+    [self closeStream:stream];
+    NSArray<HACameraStreamConsumer *> *consumers = stream.consumers.allObjects;
+    [stream.consumers removeAllObjects];
+    for (HACameraStreamConsumer *consumer in consumers) {
+        void (^handler)(NSError *) = consumer.errorHandler;
+        consumer.stream = nil;
+        consumer.frameHandler = nil;
+        consumer.errorHandler = nil;
+        if (handler) handler(error);
+    }
+}
+
+/// consumer may be nil when it has already been deallocated (weak entry gone).
+- (void)removeConsumer:(HACameraStreamConsumer *)consumer fromStream:(HACameraSharedStream *)stream {
+    if (consumer) [stream.consumers removeObject:consumer];
+    if (self.streams[stream.entityId] != stream) return; // already closed
+    if (stream.consumers.allObjects.count == 0) {
+        HALogD(@"cam", @"Closing shared stream for %@ (no consumers)", stream.entityId);
+        [self closeStream:stream];
+    } else {
+        [self updatePixelSizeForStream:stream];
+    }
+}
+
+- (void)closeStream:(HACameraSharedStream *)stream {
+    if (self.streams[stream.entityId] == stream) {
+        [self.streams removeObjectForKey:stream.entityId];
+    }
+    [stream.parser stop];
+    stream.latestFrame = nil;
+}
+
+/// Full resolution if anyone wants it, else the largest requested size.
+- (void)updatePixelSizeForStream:(HACameraSharedStream *)stream {
+    CGSize size = CGSizeZero;
+    BOOL full = NO;
+    for (HACameraStreamConsumer *consumer in stream.consumers) {
+        CGSize wanted = consumer.pixelSize;
+        if (wanted.width <= 0 || wanted.height <= 0) {
+            full = YES;
+            break;
+        }
+        size.width = MAX(size.width, wanted.width);
+        size.height = MAX(size.height, wanted.height);
+    }
+    stream.parser.targetPixelSize = full ? CGSizeZero : size;
+}
+
+#pragma mark - Inspection
+
+- (HAMJPEGStreamParser *)parserForEntityId:(NSString *)entityId {
+    return entityId ? self.streams[entityId].parser : nil;
+}
+
+- (NSUInteger)consumerCountForEntityId:(NSString *)entityId {
+    return entityId ? self.streams[entityId].consumers.allObjects.count : 0;
+}
+
+@end
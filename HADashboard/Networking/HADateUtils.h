@@ -1,5 +1,22 @@
 #import <Foundation/Foundation.h>
 
+/**
+ * Parse an ISO 8601 timestamp from raw ASCII bytes straight to seconds
+ * since 1970, without allocating or touching NSDateFormatter.
+ *
+ * Accepts the shapes Home Assistant emits:
+ *   yyyy-MM-ddTHH:mm:ss[.f{1,9}](Z | ±hh:mm | ±hhmm)
+ * Fraction digits beyond microseconds are ignored. Strings without an
+ * explicit timezone are rejected (their meaning depends on the device
+ * timezone, which the formatter fallback handles).
+ *
+ * @param bytes ASCII bytes (need not be NUL-terminated)
+ * @param length Number of bytes to parse; must cover the whole timestamp
+ * @param outEpoch Receives the parsed epoch on success
+ * @return YES if the bytes were a complete, valid timestamp
+ */
+FOUNDATION_EXPORT BOOL HAParseISO8601Epoch(const char *bytes, size_t length, NSTimeInterval *outEpoch);
+
 /**
  * Shared ISO 8601 date parsing with fallback for iOS versions
  * where ZZZZZ (colon-separated timezone, e.g. +00:00) is unsupported.
@@ -11,7 +28,7 @@
 
 /**
  * Parse an ISO 8601 datetime string.
- * Tries formats in order:
+ * Uses HAParseISO8601Epoch first, then tries formats in order:
  *   1. yyyy-MM-dd'T'HH:mm:ssZZZZZ
  *   2. yyyy-MM-dd'T'HH:mm:ss.SSSZZZZZ
  *   3. yyyy-MM-dd'T'HH:mm:ss.SSSSSSZZZZZ
@@ -23,4 +40,16 @@
  */
 + (NSDate *)dateFromISO8601String:(NSString *)string;
 
+/**
+ * Parse an ISO 8601 datetime string to seconds since 1970.
+ * Hot-path variant for history and logbook parsing: avoids creating
+ * an NSDate, and only falls back to the formatter chain for shapes
+ * HAParseISO8601Epoch does not handle.
+ *
+ * @param string ISO 8601 datetime string from Home Assistant
+ * @param outEpoch Receives the parsed epoch on success
+ * @return YES if the string was parsed
+ */
++ (BOOL)epochFromISO8601String:(NSString *)string epoch:(NSTimeInterval *)outEpoch;
+
 @end
@@ -1,10 +1,146 @@
 #import "HADateUtils.h"
 
+#pragma mark - Fast Path
+
+/// Reads `count` ASCII digits at `p` into *out. Returns NO on any non-digit.
+static inline BOOL ha_readDigits(const char *p, int count, int *out) {
+    int v = 0;
+    for (int i = 0; i < count; i++) {
+        unsigned d = (unsigned)(p[i] - '0');
+        if (d > 9) return NO;
+        v = v * 10 + (int)d;
+    }
+    *out = v;
+    return YES;
+}
+
+/// Days since 1970-01-01 for a proleptic Gregorian date (Hinnant's days_from_civil).
+static inline int64_t ha_daysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = (unsigned)(y - era * 400);
+    const unsigned doy = (153 * (unsigned)(m + (m > 2 ? -3 : 9)) + 2) / 5 + (unsigned)d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int64_t)doe - 719468;
+}
+
+static inline int ha_daysInMonth(int y, int m) {
+    static const int kDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    if (m == 2 && ((y % 4 == 0 && y % 100 != 0) || y % 400 == 0)) return 29;
+    return kDays[m - 1];
+}
+
+BOOL HAParseISO8601Epoch(const char *s, size_t len, NSTimeInterval *outEpoch) {
+    // Fixed prefix: yyyy-MM-ddTHH:mm:ss (19 chars) + at least "Z"
+    if (!s || len < 20) return NO;
+
+    int year, month, day, hour, minute, second;
+    if (!ha_readDigits(s, 4, &year) || s[4] != '-' ||
+        !ha_readDigits(s + 5, 2, &month) || s[7] != '-' ||
+        !ha_readDigits(s + 8, 2, &day) || s[10] != 'T' ||
+        !ha_readDigits(s + 11, 2, &hour) || s[13] != ':' ||
+        !ha_readDigits(s + 14, 2, &minute) || s[16] != ':' ||
+        !ha_readDigits(s + 17, 2, &second)) {
+        return NO;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > ha_daysInMonth(year, month) ||
+        hour > 23 || minute > 59 || second > 59) {
+        return NO;
+    }
+
+    size_t i = 19;
+
+    // Optional fraction — keep up to microsecond precision, ignore the rest
+    double fraction = 0;
+    if (s[i] == '.') {
+        i++;
+        size_t fracStart = i;
+        int micros = 0, scale = 100000;
+        while (i < len && (unsigned)(s[i] - '0') <= 9) {
+            if (i - fracStart < 6) {
+                micros += (s[i] - '0') * scale;
+                scale /= 10;
+            }
+            i++;
+        }
+        if (i == fracStart || i - fracStart > 9) return NO;
+        fraction = micros / 1000000.0;
+    }
+
+    // Timezone designator is mandatory
+    if (i >= len) return NO;
+    int offsetSeconds = 0;
+    if (s[i] == 'Z') {
+        i++;
+    } else if (s[i] == '+' || s[i] == '-') {
+        int sign = (s[i] == '-') ? -1 : 1;
+        int tzh, tzm;
+        i++;
+        if (len - i == 5 && s[i + 2] == ':') {
+            if (!ha_readDigits(s + i, 2, &tzh) || !ha_readDigits(s + i + 3, 2, &tzm)) return NO;
+            i += 5;
+        } else if (len - i == 4) {
+            if (!ha_readDigits(s + i, 2, &tzh) || !ha_readDigits(s + i + 2, 2, &tzm)) return NO;
+            i += 4;
+        } else {
+            return NO;
+        }
+        if (tzh > 23 || tzm > 59) return NO;
+        offsetSeconds = sign * (tzh * 3600 + tzm * 60);
+    } else {
+        return NO;
+    }
+    if (i != len) return NO;
+
+    int64_t days = ha_daysFromCivil(year, month, day);
+    int64_t secs = days * 86400 + hour * 3600 + minute * 60 + second - offsetSeconds;
+    if (outEpoch) *outEpoch = (NSTimeInterval)secs + fraction;
+    return YES;
+}
+
+/// Runs HAParseISO8601Epoch over the string's bytes without allocating.
+/// Most NSStrings from NSJSONSerialization expose a direct ASCII pointer;
+/// otherwise the (short) timestamp is copied into a stack buffer.
+static BOOL ha_fastEpochFromString(NSString *string, NSTimeInterval *outEpoch) {
+    const char *ptr = CFStringGetCStringPtr((__bridge CFStringRef)string, kCFStringEncodingASCII);
+    if (ptr) return HAParseISO8601Epoch(ptr, strlen(ptr), outEpoch);
+
+    char stackBuf[48];
+    if (string.length >= sizeof(stackBuf)) return NO;
+    if (![string getCString:stackBuf maxLength:sizeof(stackBuf) encoding:NSASCIIStringEncoding]) return NO;
+    return HAParseISO8601Epoch(stackBuf, strlen(stackBuf), outEpoch);
+}
+
 @implementation HADateUtils
 
++ (BOOL)epochFromISO8601String:(NSString *)string epoch:(NSTimeInterval *)outEpoch {
+    if (!string || ![string isKindOfClass:[NSString class]]) return NO;
+    if (ha_fastEpochFromString(string, outEpoch)) return YES;
+
+    NSDate *date = [self formatterDateFromISO8601String:string];
+    if (!date) return NO;
+    if (outEpoch) *outEpoch = [date timeIntervalSince1970];
+    return YES;
+}
+
 + (NSDate *)dateFromISO8601String:(NSString *)string {
     if (!string || ![string isKindOfClass:[NSString class]]) return nil;
 
+    NSTimeInterval epoch;
+    if (ha_fastEpochFromString(string, &epoch)) {
+        return [NSDate dateWithTimeIntervalSince1970:epoch];
+    }
+    return [self formatterDateFromISO8601String:string];
+}
+
+#pragma mark - Formatter Fallback
+
+/// The original NSDateFormatter chain. Only reached for shapes the fast
+/// path rejects (no timezone, odd fractions) — kept as the reference
+/// implementation the fast path is tested against.
++ (NSDate *)formatterDateFromISO8601String:(NSString *)string {
+    if (!string || ![string isKindOfClass:[NSString class]]) return nil;
+
     static NSDateFormatter *fmtNoFrac, *fmtFrac3, *fmtFrac6, *fmtNoTZ;
     static NSDateFormatter *fmtNoFracCompat, *fmtFrac3Compat, *fmtFrac6Compat;
     static dispatch_once_t onceToken;
@@ -6,6 +6,13 @@ extern NSString *const HADeviceRegistrationDidCompleteNotification;
 /// Posted when HA returns 410 Gone — webhook is invalid, registration must be redone.
 extern NSString *const HADeviceRegistrationDidInvalidateNotification;
 
+/// Hardware model from uname (e.g. "iPad2,1"), or "Simulator".
+extern NSString *HADeviceMachineModel(void);
+
+/// YES on armv7 hardware (iPad2,x / iPad3,x / iPhone4,x / iPod5,x), where
+/// views and schedulers pick their lighter settings. NO in the simulator.
+extern BOOL HADeviceIsLowEnd(void);
+
 @interface HADeviceRegistration : NSObject
 
 + (instancetype)sharedManager;
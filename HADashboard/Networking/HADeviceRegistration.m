@@ -9,6 +9,31 @@
 NSString *const HADeviceRegistrationDidCompleteNotification  = @"HADeviceRegistrationDidComplete";
 NSString *const HADeviceRegistrationDidInvalidateNotification = @"HADeviceRegistrationDidInvalidate";
 
+NSString *HADeviceMachineModel(void) {
+#if TARGET_OS_SIMULATOR
+    return @"Simulator";
+#else
+    struct utsname systemInfo;
+    if (uname(&systemInfo) == 0) {
+        return [NSString stringWithCString:systemInfo.machine encoding:NSUTF8StringEncoding];
+    }
+    return @"Unknown";
+#endif
+}
+
+BOOL HADeviceIsLowEnd(void) {
+    static BOOL lowEnd = NO;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+#if !TARGET_OS_SIMULATOR
+        NSString *machine = HADeviceMachineModel();
+        lowEnd = ([machine hasPrefix:@"iPad2"] || [machine hasPrefix:@"iPad3"] ||
+                  [machine hasPrefix:@"iPhone4"] || [machine hasPrefix:@"iPod5"]);
+#endif
+    });
+    return lowEnd;
+}
+
 static NSString *const kKeychainWebhookId   = @"ha_webhook_id";
 static NSString *const kKeychainCloudhookURL = @"ha_cloudhook_url";
 static NSString *const kKeychainRemoteUIURL  = @"ha_remote_ui_url";
@@ -298,15 +323,7 @@ static NSString *const kDeviceNameOverride   = @"ha_device_name_override";
 }
 
 - (NSString *)machineModel {
-#if TARGET_OS_SIMULATOR
-    return @"Simulator";
-#else
-    struct utsname systemInfo;
-    if (uname(&systemInfo) == 0) {
-        return [NSString stringWithCString:systemInfo.machine encoding:NSUTF8StringEncoding];
-    }
-    return @"Unknown";
-#endif
+    return HADeviceMachineModel();
 }
 
 @end
@@ -0,0 +1,27 @@
+#import <Foundation/Foundation.h>
+
+/// Streaming downsampler for numeric history.
+///
+/// Points are pushed one at a time in timestamp order (as the history
+/// response is parsed) and reduced on the fly: the requested window is
+/// split into maxPoints equal time buckets and the first point of each
+/// bucket is kept, plus the most recent point overall. Memory is bounded
+/// by maxPoints regardless of how many points are fed in.
+@interface HAHistoryDownsampler : NSObject
+
+- (instancetype)initWithStartTime:(NSTimeInterval)startTime
+                          endTime:(NSTimeInterval)endTime
+                        maxPoints:(NSUInteger)maxPoints NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Feed one point. Points older than the last kept point are ignored.
+- (void)addValue:(double)value timestamp:(NSTimeInterval)timestamp;
+
+/// Number of points fed in (before reduction).
+@property (nonatomic, readonly) NSUInteger inputCount;
+
+/// Reduced points as @{@"value": NSNumber, @"timestamp": NSNumber (epoch)},
+/// the same shape HAHistoryManager has always returned.
+- (NSArray<NSDictionary *> *)points;
+
+@end
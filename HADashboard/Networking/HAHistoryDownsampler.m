@@ -0,0 +1,79 @@
+#import "HAHistoryDownsampler.h"
+
+@implementation HAHistoryDownsampler {
+    NSTimeInterval _startTime;
+    NSTimeInterval _span;
+    NSUInteger _maxPoints;
+
+    // Kept points: one per bucket, at most _maxPoints
+    double *_values;
+    double *_timestamps;
+    NSUInteger _count;
+    NSInteger _lastBucket;
+
+    // Most recent point seen, appended at the end if it was not kept
+    double _latestValue;
+    NSTimeInterval _latestTimestamp;
+    BOOL _hasLatest;
+}
+
+- (instancetype)initWithStartTime:(NSTimeInterval)startTime
+                          endTime:(NSTimeInterval)endTime
+                        maxPoints:(NSUInteger)maxPoints {
+    self = [super init];
+    if (self) {
+        _startTime = startTime;
+        _span = (endTime > startTime) ? (endTime - startTime) : 1.0;
+        _maxPoints = (maxPoints == 0) ? 100 : maxPoints;
+        _values = calloc(_maxPoints, sizeof(double));
+        _timestamps = calloc(_maxPoints, sizeof(double));
+        _lastBucket = -1;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_values);
+    free(_timestamps);
+}
+
+- (void)addValue:(double)value timestamp:(NSTimeInterval)timestamp {
+    _inputCount++;
+    if (_hasLatest && timestamp < _latestTimestamp) return;
+
+    _latestValue = value;
+    _latestTimestamp = timestamp;
+    _hasLatest = YES;
+
+    // HA includes the state at start_time, which may predate the window — clamp to bucket 0
+    double position = (timestamp - _startTime) / _span;
+    NSInteger bucket = (NSInteger)floor(position * (double)_maxPoints);
+    if (bucket < 0) bucket = 0;
+    if (bucket >= (NSInteger)_maxPoints) bucket = (NSInteger)_maxPoints - 1;
+
+    if (bucket > _lastBucket && _count < _maxPoints) {
+        _values[_count] = value;
+        _timestamps[_count] = timestamp;
+        _count++;
+        _lastBucket = bucket;
+    }
+}
+
+- (NSArray<NSDictionary *> *)points {
+    NSMutableArray *points = [NSMutableArray arrayWithCapacity:_count + 1];
+    for (NSUInteger i = 0; i < _count; i++) {
+        [points addObject:@{
+            @"value": @(_values[i]),
+            @"timestamp": @(_timestamps[i])
+        }];
+    }
+    if (_hasLatest && (_count == 0 || _latestTimestamp > _timestamps[_count - 1])) {
+        [points addObject:@{
+            @"value": @(_latestValue),
+            @"timestamp": @(_latestTimestamp)
+        }];
+    }
+    return [points copy];
+}
+
+@end
@@ -1,8 +1,21 @@
 #import <Foundation/Foundation.h>
 
+@class HAHistoryPyramid;
+@class HARequestInterest;
+
 /// Shared history data manager, extracted from HAGraphCardCell.
-/// Fetches entity history via the HA REST API, parses responses,
-/// downsamples to 100 points, and caches results.
+/// Fetches entity history via the HA REST API, parses responses as they
+/// stream in (HAHistoryStreamParser), downsamples to 100 points, and
+/// caches results. Numeric ranges over 48 h for measurement sensors come
+/// from recorder statistics instead (HAHistoryStatistics).
+///
+/// Windows ending now ("last N hours") are also kept on disk
+/// (HAHistoryDiskCache): after a relaunch only the part of the window
+/// since the series was written is requested and merged in.
+///
+/// The hoursBack methods share loads: asking for a window that is already
+/// being fetched joins that request, and a result is reused for a minute.
+/// They must be called on the main thread.
 @interface HAHistoryManager : NSObject
 
 + (instancetype)sharedManager;
@@ -16,25 +29,54 @@
 
 /// Fetch numeric history for explicit date range.
 /// maxPoints controls downsample limit (pass 0 for default 100).
+/// Points from statistics also carry @"min" and @"max" (NSNumber) for the
+/// bucket's envelope; falls back to raw history if statistics are empty.
 - (void)fetchHistoryForEntityId:(NSString *)entityId
                       startDate:(NSDate *)startDate
                         endDate:(NSDate *)endDate
                       maxPoints:(NSUInteger)maxPoints
                      completion:(void (^)(NSArray *points, NSError *error))completion;
 
+/// Disk-cached points for a "last N hours" window, without touching the
+/// network; nil if there are none. Lets a card paint immediately on launch
+/// while fetchHistoryForEntityId:hoursBack:completion: brings it up to date.
+- (void)cachedHistoryForEntityId:(NSString *)entityId
+                       hoursBack:(NSInteger)hours
+                      completion:(void (^)(NSArray *points))completion;
+
 /// Fetch state timeline segments for a state-based entity.
 /// Returns array of @{@"state": NSString, @"start": NSNumber (epoch), @"end": NSNumber (epoch)}.
 - (void)fetchTimelineForEntityId:(NSString *)entityId
                        hoursBack:(NSInteger)hours
                       completion:(void (^)(NSArray *segments, NSError *error))completion;
 
+/// Start loading a "last N hours" window (timeline segments if timeline,
+/// otherwise numeric history) for a card about to scroll into view, so its
+/// own fetch finds the load under way or finished. completion runs on main
+/// when the load ends, not if the interest is cancelled first. Cancel the
+/// returned interest if the card is no longer coming: the request is
+/// cancelled once nothing else is waiting on it. Main thread only.
+- (HARequestInterest *)prefetchWindowForEntityId:(NSString *)entityId
+                                       hoursBack:(NSInteger)hours
+                                        timeline:(BOOL)timeline
+                                      completion:(void (^)(void))completion;
+
 /// Fetch timeline for explicit date range.
 - (void)fetchTimelineForEntityId:(NSString *)entityId
                        startDate:(NSDate *)startDate
                          endDate:(NSDate *)endDate
                       completion:(void (^)(NSArray *segments, NSError *error))completion;
 
-/// Clear all cached history data.
+/// Resolution pyramid for zooming a numeric graph loaded with basePoints
+/// over [startDate, endDate]. Finer tiles are fetched through
+/// fetchHistoryForEntityId:startDate:endDate:maxPoints:, so they share
+/// this manager's cache and statistics selection.
+- (HAHistoryPyramid *)pyramidForEntityId:(NSString *)entityId
+                               startDate:(NSDate *)startDate
+                                 endDate:(NSDate *)endDate
+                              basePoints:(NSArray *)basePoints;
+
+/// Clear in-memory history (the disk copy goes with HACacheManager clearAllCaches).
 - (void)clearCache;
 
 @end
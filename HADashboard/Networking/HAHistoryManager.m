@@ -1,12 +1,58 @@
 #import "HAHistoryManager.h"
-#import "HADateUtils.h"
+#import "HAHistoryStreamParser.h"
+#import "HAHistoryStatistics.h"
+#import "HAHistoryPyramid.h"
+#import "HAHistoryDiskCache.h"
+#import "HARequestCoalescer.h"
 #import "HALog.h"
 #import "HAAuthManager.h"
+#import "HAConnectionManager.h"
+#import "HAEntity.h"
+#import "HAEntityAttributes.h"
 #import "HADemoDataProvider.h"
 #import "NSMutableURLRequest+HAHelpers.h"
 
-@interface HAHistoryManager ()
+/// In-flight history request: the streaming parser fed by the data
+/// delegate, plus what to do with its result.
+@interface HAHistoryFetch : NSObject
+@property (nonatomic, strong) HAHistoryStreamParser *parser;
+@property (nonatomic, copy) NSString *cacheKey;
+@property (nonatomic, strong) NSURLSessionTask *task;
+@property (nonatomic, copy) void (^completion)(NSArray *, NSError *);
+@property (nonatomic, assign) BOOL rejected; // non-2xx response, body ignored
+@end
+
+@implementation HAHistoryFetch
+@end
+
+/// A window ending this close to now is "live" (last N hours) and resumes from disk.
+static const NSTimeInterval kLiveWindowSlack = 60.0;
+/// Disk series written this recently are shown without fetching a tail.
+static const NSTimeInterval kTailFreshness = 60.0;
+
+/// Same reduction as HAHistoryDownsampler (first point per time bucket,
+/// plus the latest) over already-parsed points, keeping any min/max bands.
+static NSArray<NSDictionary *> *HAHistoryRebucket(NSArray<NSDictionary *> *points, NSTimeInterval start,
+                                                  NSTimeInterval end, NSUInteger maxPoints) {
+    if (points.count <= maxPoints || end <= start) return points;
+    double bucketWidth = (end - start) / (double)maxPoints;
+    NSMutableArray<NSDictionary *> *result = [NSMutableArray arrayWithCapacity:maxPoints + 1];
+    long lastBucket = LONG_MIN;
+    for (NSDictionary *pt in points) {
+        long bucket = (long)floor(([pt[@"timestamp"] doubleValue] - start) / bucketWidth);
+        if (bucket == lastBucket) continue;
+        [result addObject:pt];
+        lastBucket = bucket;
+    }
+    if (result.lastObject != points.lastObject) [result addObject:points.lastObject];
+    return result;
+}
+
+@interface HAHistoryManager () <NSURLSessionDataDelegate>
 @property (nonatomic, strong) NSCache *cache;
+@property (nonatomic, strong) NSURLSession *session;
+@property (nonatomic, strong) NSMutableDictionary<NSNumber *, HAHistoryFetch *> *fetches;
+@property (nonatomic, strong) HARequestCoalescer *liveWindows; // "last N hours" loads, main thread
 @end
 
 @implementation HAHistoryManager
@@ -26,6 +72,17 @@
         _cache = [[NSCache alloc] init];
         _cache.countLimit = 30;
         _cache.totalCostLimit = 2 * 1024 * 1024; // 2MB limit
+        _fetches = [NSMutableDictionary dictionary];
+        _liveWindows = [[HARequestCoalescer alloc] initWithFreshness:kTailFreshness];
+
+        // Serial delegate queue: response bytes are parsed as they arrive,
+        // off the main thread, one chunk at a time
+        NSOperationQueue *parseQueue = [[NSOperationQueue alloc] init];
+        parseQueue.maxConcurrentOperationCount = 1;
+        parseQueue.name = @"com.hadashboard.history.parse";
+        _session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]
+                                                 delegate:self
+                                            delegateQueue:parseQueue];
     }
     return self;
 }
@@ -35,24 +92,79 @@
 - (void)fetchHistoryForEntityId:(NSString *)entityId
                       hoursBack:(NSInteger)hours
                      completion:(void (^)(NSArray *, NSError *))completion {
-    NSDate *endDate = [NSDate date];
-    NSDate *startDate = [NSDate dateWithTimeIntervalSinceNow:-hours * 3600];
-    [self fetchHistoryForEntityId:entityId
-                        startDate:startDate
-                          endDate:endDate
-                        maxPoints:100
-                       completion:completion];
+    if (!entityId || !completion) return;
+    [self loadWindowForEntityId:entityId hoursBack:hours timeline:NO completion:completion];
+}
+
+- (void)cachedHistoryForEntityId:(NSString *)entityId
+                       hoursBack:(NSInteger)hours
+                      completion:(void (^)(NSArray *))completion {
+    if (!completion) return;
+    if (!entityId || [[HAAuthManager sharedManager] isDemoMode]) {
+        ha_dispatchMainCompletion(^(NSArray *points, NSError *error) { completion(points); }, nil, nil);
+        return;
+    }
+    NSTimeInterval end = [[NSDate date] timeIntervalSince1970];
+    NSTimeInterval start = end - hours * 3600;
+    NSString *diskKey = [HAHistoryDiskCache keyForEntityId:entityId range:end - start maxPoints:100];
+    [[HAHistoryDiskCache sharedCache] readSeriesForKey:diskKey completion:^(NSArray *points, NSTimeInterval coveredStart, NSTimeInterval coveredEnd) {
+        NSUInteger first = 0;
+        while (first < points.count && [points[first][@"timestamp"] doubleValue] < start) first++;
+        completion(first < points.count ? [points subarrayWithRange:NSMakeRange(first, points.count - first)] : nil);
+    }];
 }
 
 - (void)fetchTimelineForEntityId:(NSString *)entityId
                        hoursBack:(NSInteger)hours
                       completion:(void (^)(NSArray *, NSError *))completion {
-    NSDate *endDate = [NSDate date];
-    NSDate *startDate = [NSDate dateWithTimeIntervalSinceNow:-hours * 3600];
-    [self fetchTimelineForEntityId:entityId
-                         startDate:startDate
-                           endDate:endDate
-                        completion:completion];
+    if (!entityId || !completion) return;
+    [self loadWindowForEntityId:entityId hoursBack:hours timeline:YES completion:completion];
+}
+
+- (HARequestInterest *)prefetchWindowForEntityId:(NSString *)entityId
+                                       hoursBack:(NSInteger)hours
+                                        timeline:(BOOL)timeline
+                                      completion:(void (^)(void))completion {
+    if (!entityId) {
+        if (completion) dispatch_async(dispatch_get_main_queue(), completion);
+        return nil;
+    }
+    return [self loadWindowForEntityId:entityId hoursBack:hours timeline:timeline
+                            completion:^(NSArray *result, NSError *error) {
+        if (completion) completion();
+    }];
+}
+
+/// "Last N hours" loads are shared per entity and window: a card asking
+/// while one is in flight (prefetched, or a second card on the same
+/// sensor) joins it, and the result is reused for kTailFreshness — the
+/// same age at which the disk series is served without a tail.
+- (HARequestInterest *)loadWindowForEntityId:(NSString *)entityId
+                                   hoursBack:(NSInteger)hours
+                                    timeline:(BOOL)timeline
+                                  completion:(void (^)(NSArray *, NSError *))completion {
+    NSString *key = [NSString stringWithFormat:@"%@|%@|%ld", timeline ? @"tl" : @"h", entityId, (long)hours];
+    __weak typeof(self) weakSelf = self;
+    return [self.liveWindows loadKey:key start:^dispatch_block_t(HARequestFinishBlock finish) {
+        NSDate *endDate = [NSDate date];
+        NSDate *startDate = [NSDate dateWithTimeIntervalSinceNow:-hours * 3600];
+        // Empty results aren't worth reusing: the next card should ask again
+        void (^done)(NSArray *, NSError *) = ^(NSArray *result, NSError *error) {
+            finish(result.count > 0 ? result : nil, error);
+        };
+        if (timeline) {
+            [weakSelf fetchTimelineForEntityId:entityId startDate:startDate endDate:endDate completion:done];
+        } else {
+            [weakSelf fetchHistoryForEntityId:entityId startDate:startDate endDate:endDate maxPoints:100 completion:done];
+        }
+        // Cancels the window's main request; a disk read, tail or
+        // statistics command already under way completes into the caches
+        NSString *cacheKey = [HAHistoryManager cacheKeyForEntityId:entityId startDate:startDate
+                                                           endDate:endDate timeline:timeline];
+        return ^{
+            [weakSelf cancelFetchesWithCacheKey:cacheKey];
+        };
+    } completion:completion];
 }
 
 #pragma mark - Public API (absolute date range)
@@ -74,9 +186,7 @@
     }
 
     NSUInteger effectiveMax = (maxPoints == 0) ? 100 : maxPoints;
-    long startEpoch = (long)[startDate timeIntervalSince1970];
-    long endEpoch = (long)[endDate timeIntervalSince1970];
-    NSString *cacheKey = [NSString stringWithFormat:@"%@_%ld_%ld", entityId, startEpoch, endEpoch];
+    NSString *cacheKey = [HAHistoryManager cacheKeyForEntityId:entityId startDate:startDate endDate:endDate timeline:NO];
 
     NSArray *cached = [self.cache objectForKey:cacheKey];
     if (cached) {
@@ -84,27 +194,123 @@
         return;
     }
 
-    NSURLRequest *request = [self requestForEntityId:entityId startDate:startDate endDate:endDate minimal:YES];
-    if (!request) {
-        ha_dispatchMainCompletion(completion, nil, [self errorWithMessage:@"Not configured"]);
+    // "Last N hours" windows resume from the disk copy and fetch only the tail
+    if (fabs([endDate timeIntervalSinceNow]) < kLiveWindowSlack) {
+        [self fetchLiveHistoryForEntityId:entityId startDate:startDate endDate:endDate
+                                maxPoints:effectiveMax cacheKey:cacheKey completion:completion];
         return;
     }
 
-    NSUInteger capturedMax = effectiveMax;
-    NSURLSessionDataTask *task = [[NSURLSession sharedSession] dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error || !data) {
-            ha_dispatchMainCompletion(completion, nil, error);
+    [self fetchRemoteHistoryForEntityId:entityId startDate:startDate endDate:endDate
+                              maxPoints:effectiveMax cacheKey:cacheKey completion:completion];
+}
+
+/// Network fetch for a window; cacheKey may be nil (tails aren't cached on their own).
+- (void)fetchRemoteHistoryForEntityId:(NSString *)entityId
+                            startDate:(NSDate *)startDate
+                              endDate:(NSDate *)endDate
+                            maxPoints:(NSUInteger)maxPoints
+                             cacheKey:(NSString *)cacheKey
+                           completion:(void (^)(NSArray *, NSError *))completion {
+    // Multi-day ranges for measurement sensors: recorder statistics are
+    // kilobytes where raw history is megabytes, and carry min/max bands
+    HAEntity *entity = [[HAConnectionManager sharedManager] entityForId:entityId];
+    NSString *stateClass = HAAttrString(entity.attributes, HAAttrStateClass);
+    if ([HAHistoryStatistics shouldUseStatisticsForStateClass:stateClass range:[endDate timeIntervalSinceDate:startDate]]) {
+        [self fetchStatisticsForEntityId:entityId startDate:startDate endDate:endDate
+                               maxPoints:maxPoints cacheKey:cacheKey completion:completion];
+        return;
+    }
+
+    [self fetchRawHistoryForEntityId:entityId startDate:startDate endDate:endDate
+                           maxPoints:maxPoints cacheKey:cacheKey completion:completion];
+}
+
+#pragma mark - Disk Cache
+
+/// Live window: serve the disk series if it covers the window start, fetch
+/// from where it ends, and write the merged result back. Offline, the disk
+/// series alone is better than an empty card.
+- (void)fetchLiveHistoryForEntityId:(NSString *)entityId
+                          startDate:(NSDate *)startDate
+                            endDate:(NSDate *)endDate
+                          maxPoints:(NSUInteger)maxPoints
+                           cacheKey:(NSString *)cacheKey
+                         completion:(void (^)(NSArray *, NSError *))completion {
+    NSTimeInterval start = [startDate timeIntervalSince1970];
+    NSTimeInterval end = [endDate timeIntervalSince1970];
+    HAHistoryDiskCache *disk = [HAHistoryDiskCache sharedCache];
+    NSString *diskKey = [HAHistoryDiskCache keyForEntityId:entityId range:end - start maxPoints:maxPoints];
+
+    [disk readSeriesForKey:diskKey completion:^(NSArray *diskPoints, NSTimeInterval coveredStart, NSTimeInterval coveredEnd) {
+        double bucketWidth = (end - start) / (double)maxPoints;
+        BOOL usable = diskPoints.count > 0 && coveredStart <= start + bucketWidth
+                      && coveredEnd > start && coveredEnd <= end + kLiveWindowSlack;
+        if (!usable) {
+            [self fetchRemoteHistoryForEntityId:entityId startDate:startDate endDate:endDate
+                                      maxPoints:maxPoints cacheKey:cacheKey
+                                     completion:^(NSArray *points, NSError *error) {
+                if (points.count > 0) [disk writeSeries:points coveredStart:start coveredEnd:end forKey:diskKey];
+                completion(points, error);
+            }];
             return;
         }
 
-        NSArray *points = [HAHistoryManager parseHistoryData:data maxPoints:capturedMax];
-        if (points.count > 0) {
-            [self.cache setObject:points forKey:cacheKey];
+        // Drop what has scrolled out of the window
+        NSUInteger first = 0;
+        while (first < diskPoints.count && [diskPoints[first][@"timestamp"] doubleValue] < start) first++;
+        NSArray *kept = [diskPoints subarrayWithRange:NSMakeRange(first, diskPoints.count - first)];
+
+        if (end - coveredEnd < kTailFreshness && kept.count > 0) {
+            [self.cache setObject:kept forKey:cacheKey];
+            completion(kept, nil);
+            return;
         }
 
-        ha_dispatchMainCompletion(completion, points, nil);
+        // Tail at the same density as the rest of the series
+        NSUInteger tailMax = MAX((NSUInteger)2, (NSUInteger)ceil(maxPoints * (end - coveredEnd) / (end - start)));
+        [self fetchRemoteHistoryForEntityId:entityId startDate:[NSDate dateWithTimeIntervalSince1970:coveredEnd]
+                                    endDate:endDate maxPoints:tailMax cacheKey:nil
+                                 completion:^(NSArray *tail, NSError *error) {
+            if (error || !tail) {
+                HALogD(@"history", @"Tail fetch for %@ failed (%@), showing cached series",
+                       entityId, error.localizedDescription ?: @"no data");
+                completion(kept, nil);
+                return;
+            }
+            double lastKept = [[kept.lastObject objectForKey:@"timestamp"] doubleValue];
+            NSMutableArray *merged = [kept mutableCopy];
+            for (NSDictionary *pt in tail) {
+                if (kept.count == 0 || [pt[@"timestamp"] doubleValue] > lastKept) [merged addObject:pt];
+            }
+            // Frequent refreshes add short, dense tails: keep the series at maxPoints
+            NSArray *points = HAHistoryRebucket(merged, start, end, maxPoints);
+            if (points.count > 0) {
+                [self.cache setObject:points forKey:cacheKey];
+                [disk writeSeries:points coveredStart:start coveredEnd:end forKey:diskKey];
+            }
+            completion(points, nil);
+        }];
     }];
-    [task resume];
+}
+
+- (void)fetchRawHistoryForEntityId:(NSString *)entityId
+                         startDate:(NSDate *)startDate
+                           endDate:(NSDate *)endDate
+                         maxPoints:(NSUInteger)maxPoints
+                          cacheKey:(NSString *)cacheKey
+                        completion:(void (^)(NSArray *, NSError *))completion {
+    NSURLRequest *request = [self requestForEntityId:entityId startDate:startDate endDate:endDate minimal:YES];
+    if (!request) {
+        ha_dispatchMainCompletion(completion, nil, [self errorWithMessage:@"Not configured"]);
+        return;
+    }
+
+    HAHistoryStreamParser *parser = [[HAHistoryStreamParser alloc] initWithMode:HAHistoryStreamModePoints
+                                                                       startTime:[startDate timeIntervalSince1970]
+                                                                         endTime:[endDate timeIntervalSince1970]
+                                                                       maxPoints:maxPoints];
+    [self startFetchWithRequest:request parser:parser cacheKey:cacheKey completion:completion];
 }
 
 - (void)fetchTimelineForEntityId:(NSString *)entityId
@@ -122,9 +328,7 @@
         return;
     }
 
-    long startEpoch = (long)[startDate timeIntervalSince1970];
-    long endEpoch = (long)[endDate timeIntervalSince1970];
-    NSString *cacheKey = [NSString stringWithFormat:@"tl_%@_%ld_%ld", entityId, startEpoch, endEpoch];
+    NSString *cacheKey = [HAHistoryManager cacheKeyForEntityId:entityId startDate:startDate endDate:endDate timeline:YES];
 
     NSArray *cached = [self.cache objectForKey:cacheKey];
     if (cached) {
@@ -138,24 +342,82 @@
         return;
     }
 
-    NSURLSessionDataTask *task = [[NSURLSession sharedSession] dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error || !data) {
-            ha_dispatchMainCompletion(completion, nil, error);
-            return;
-        }
-
-        NSArray *segments = [HAHistoryManager parseHistoryStateData:data];
-        if (segments.count > 0) {
-            [self.cache setObject:segments forKey:cacheKey];
-        }
+    HAHistoryStreamParser *parser = [[HAHistoryStreamParser alloc] initWithMode:HAHistoryStreamModeTimeline
+                                                                       startTime:[startDate timeIntervalSince1970]
+                                                                         endTime:[endDate timeIntervalSince1970]
+                                                                       maxPoints:0];
+    [self startFetchWithRequest:request parser:parser cacheKey:cacheKey completion:completion];
+}
 
-        ha_dispatchMainCompletion(completion, segments, nil);
-    }];
-    [task resume];
+- (HAHistoryPyramid *)pyramidForEntityId:(NSString *)entityId
+                               startDate:(NSDate *)startDate
+                                 endDate:(NSDate *)endDate
+                              basePoints:(NSArray *)basePoints {
+    HAHistoryPyramid *pyramid = [[HAHistoryPyramid alloc] initWithStartTime:[startDate timeIntervalSince1970]
+                                                                    endTime:[endDate timeIntervalSince1970]
+                                                                 basePoints:basePoints];
+    // Demo data is synthesised per request, not per range — no finer tiles
+    if (!entityId || [[HAAuthManager sharedManager] isDemoMode]) return pyramid;
+
+    __weak typeof(self) weakSelf = self;
+    pyramid.tileLoader = ^(NSTimeInterval start, NSTimeInterval end, NSUInteger maxPoints, void (^done)(NSArray *)) {
+        [weakSelf fetchHistoryForEntityId:entityId
+                                startDate:[NSDate dateWithTimeIntervalSince1970:start]
+                                  endDate:[NSDate dateWithTimeIntervalSince1970:end]
+                                maxPoints:maxPoints
+                               completion:^(NSArray *points, NSError *error) {
+            done(error ? nil : (points ?: @[]));
+        }];
+    };
+    return pyramid;
 }
 
 - (void)clearCache {
     [self.cache removeAllObjects];
+    [self.liveWindows removeAllResults];
+}
+
+/// Memory cache key for a window, to the second.
++ (NSString *)cacheKeyForEntityId:(NSString *)entityId startDate:(NSDate *)startDate
+                          endDate:(NSDate *)endDate timeline:(BOOL)timeline {
+    long startEpoch = (long)[startDate timeIntervalSince1970];
+    long endEpoch = (long)[endDate timeIntervalSince1970];
+    return [NSString stringWithFormat:@"%@%@_%ld_%ld", timeline ? @"tl_" : @"", entityId, startEpoch, endEpoch];
+}
+
+#pragma mark - Long-Term Statistics
+
+- (void)fetchStatisticsForEntityId:(NSString *)entityId
+                         startDate:(NSDate *)startDate
+                           endDate:(NSDate *)endDate
+                         maxPoints:(NSUInteger)maxPoints
+                          cacheKey:(NSString *)cacheKey
+                        completion:(void (^)(NSArray *, NSError *))completion {
+    NSString *period = [HAHistoryStatistics periodForStartDate:startDate endDate:endDate maxPoints:maxPoints];
+    NSDictionary *command = [HAHistoryStatistics commandForEntityId:entityId startDate:startDate endDate:endDate period:period];
+    NSOperationQueue *parseQueue = self.session.delegateQueue;
+
+    [[HAConnectionManager sharedManager] sendCommand:command completion:^(id result, NSError *error) {
+        // Reduce off the main thread, alongside the streaming history parser
+        [parseQueue addOperationWithBlock:^{
+            NSArray *points = error ? nil : [HAHistoryStatistics pointsFromResult:result
+                                                                        entityId:entityId
+                                                                       startTime:[startDate timeIntervalSince1970]
+                                                                         endTime:[endDate timeIntervalSince1970]
+                                                                       maxPoints:maxPoints];
+            if (points.count < 2) {
+                // Not connected, recorder excludes the entity, or statistics
+                // not compiled yet for a new sensor — raw history still works
+                HALogD(@"history", @"No %@ statistics for %@ (%@), using history", period, entityId,
+                       error.localizedDescription ?: @"empty");
+                [self fetchRawHistoryForEntityId:entityId startDate:startDate endDate:endDate
+                                       maxPoints:maxPoints cacheKey:cacheKey completion:completion];
+                return;
+            }
+            if (cacheKey) [self.cache setObject:points forKey:cacheKey];
+            ha_dispatchMainCompletion(completion, points, nil);
+        }];
+    }];
 }
 
 #pragma mark - Request Building
@@ -198,126 +460,84 @@
                            userInfo:@{NSLocalizedDescriptionKey: message}];
 }
 
-#pragma mark - Parsing (extracted from HAGraphCardCell)
-
-+ (NSArray *)parseHistoryData:(NSData *)data {
-    return [self parseHistoryData:data maxPoints:100];
+#pragma mark - Streaming Fetch
+
+- (void)startFetchWithRequest:(NSURLRequest *)request
+                       parser:(HAHistoryStreamParser *)parser
+                     cacheKey:(NSString *)cacheKey
+                   completion:(void (^)(NSArray *, NSError *))completion {
+    HAHistoryFetch *fetch = [[HAHistoryFetch alloc] init];
+    fetch.parser = parser;
+    fetch.cacheKey = cacheKey;
+    fetch.completion = completion;
+
+    NSURLSessionDataTask *task = [self.session dataTaskWithRequest:request];
+    fetch.task = task;
+    @synchronized (self.fetches) {
+        self.fetches[@(task.taskIdentifier)] = fetch;
+    }
+    [task resume];
 }
 
-+ (NSArray *)parseHistoryData:(NSData *)data maxPoints:(NSUInteger)maxPoints {
-    if (maxPoints == 0) maxPoints = 100;
-    if (!data || data.length == 0) return @[];
-
-    NSError *jsonError = nil;
-    NSArray *result = nil;
-    @try {
-        result = [NSJSONSerialization JSONObjectWithData:data options:0 error:&jsonError];
-    } @catch (NSException *e) {
-        HALogE(@"history", @"JSON parse exception: %@", e.reason);
-        return @[];
+/// Cancel the network requests for a window; their completions get NSURLErrorCancelled.
+- (void)cancelFetchesWithCacheKey:(NSString *)cacheKey {
+    if (!cacheKey) return;
+    @synchronized (self.fetches) {
+        for (HAHistoryFetch *fetch in self.fetches.allValues) {
+            if ([fetch.cacheKey isEqualToString:cacheKey]) [fetch.task cancel];
+        }
     }
-    if (jsonError || ![result isKindOfClass:[NSArray class]] || result.count == 0) return @[];
-
-    NSArray *states = result.firstObject;
-    if (![states isKindOfClass:[NSArray class]]) return @[];
-
-    NSMutableArray *points = [NSMutableArray arrayWithCapacity:states.count];
-
-    for (NSDictionary *entry in states) {
-        if (![entry isKindOfClass:[NSDictionary class]]) continue;
-        NSString *stateStr = entry[@"state"];
-        if (!stateStr || [stateStr isEqualToString:@"unknown"] || [stateStr isEqualToString:@"unavailable"]) continue;
-
-        double value = [stateStr doubleValue];
-        if (value == 0 && ![stateStr isEqualToString:@"0"] && ![stateStr hasPrefix:@"0."]) continue;
-
-        id rawTime = entry[@"last_changed"];
-        if (![rawTime isKindOfClass:[NSString class]]) rawTime = entry[@"last_updated"];
-        NSString *timeStr = [rawTime isKindOfClass:[NSString class]] ? rawTime : nil;
-        if (!timeStr) continue;
-
-        NSDate *date = [HADateUtils dateFromISO8601String:timeStr];
-        if (!date) continue;
+}
 
-        [points addObject:@{
-            @"value": @(value),
-            @"timestamp": @([date timeIntervalSince1970])
-        }];
+- (HAHistoryFetch *)fetchForTask:(NSURLSessionTask *)task {
+    @synchronized (self.fetches) {
+        return self.fetches[@(task.taskIdentifier)];
     }
+}
 
-    // Downsample to maxPoints for performance on older devices
-    if (points.count > maxPoints) {
-        NSMutableArray *sampled = [NSMutableArray arrayWithCapacity:maxPoints];
-        double step = (double)points.count / (double)maxPoints;
-        for (NSUInteger i = 0; i < maxPoints; i++) {
-            NSUInteger idx = (NSUInteger)(i * step);
-            if (idx < points.count) {
-                [sampled addObject:points[idx]];
-            }
-        }
-        [sampled addObject:points.lastObject];
-        return [sampled copy];
+#pragma mark - NSURLSessionDataDelegate
+
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask
+    didReceiveResponse:(NSURLResponse *)response
+     completionHandler:(void (^)(NSURLSessionResponseDisposition))completionHandler {
+    HAHistoryFetch *fetch = [self fetchForTask:dataTask];
+    NSInteger status = [response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)response).statusCode : 200;
+    if (fetch && (status < 200 || status >= 300)) {
+        // Error bodies aren't history JSON — treat as an empty result, as before
+        HALogW(@"history", @"History request failed: HTTP %ld", (long)status);
+        fetch.rejected = YES;
+        completionHandler(NSURLSessionResponseCancel);
+        return;
     }
-
-    return [points copy];
+    completionHandler(NSURLSessionResponseAllow);
 }
 
-+ (NSArray *)parseHistoryStateData:(NSData *)data {
-    if (!data || data.length == 0) return @[];
+- (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    [[self fetchForTask:dataTask].parser appendData:data];
+}
 
-    NSError *jsonError = nil;
-    NSArray *result = nil;
-    @try {
-        result = [NSJSONSerialization JSONObjectWithData:data options:0 error:&jsonError];
-    } @catch (NSException *e) {
-        HALogE(@"history", @"Timeline JSON parse exception: %@", e.reason);
-        return @[];
+- (void)URLSession:(NSURLSession *)session task:(NSURLSessionTask *)task didCompleteWithError:(NSError *)error {
+    HAHistoryFetch *fetch = nil;
+    @synchronized (self.fetches) {
+        fetch = self.fetches[@(task.taskIdentifier)];
+        [self.fetches removeObjectForKey:@(task.taskIdentifier)];
     }
-    if (jsonError || ![result isKindOfClass:[NSArray class]] || result.count == 0) return @[];
-
-    NSArray *states = result.firstObject;
-    if (![states isKindOfClass:[NSArray class]] || states.count == 0) return @[];
-
-    NSMutableArray *segments = [NSMutableArray array];
-    NSString *prevState = nil;
-    NSTimeInterval prevTimestamp = 0;
+    if (!fetch) return;
 
-    for (NSDictionary *entry in states) {
-        if (![entry isKindOfClass:[NSDictionary class]]) continue;
-        NSString *stateStr = entry[@"state"];
-        if (!stateStr) continue;
-
-        id rawTime2 = entry[@"last_changed"];
-        if (![rawTime2 isKindOfClass:[NSString class]]) rawTime2 = entry[@"last_updated"];
-        NSString *timeStr = [rawTime2 isKindOfClass:[NSString class]] ? rawTime2 : nil;
-        if (!timeStr) continue;
-
-        NSDate *date = [HADateUtils dateFromISO8601String:timeStr];
-        if (!date) continue;
-
-        NSTimeInterval timestamp = [date timeIntervalSince1970];
-
-        if (prevState && prevTimestamp > 0) {
-            [segments addObject:@{
-                @"state": prevState,
-                @"start": @(prevTimestamp),
-                @"end": @(timestamp),
-            }];
-        }
-
-        prevState = stateStr;
-        prevTimestamp = timestamp;
+    if (fetch.rejected) {
+        ha_dispatchMainCompletion(fetch.completion, @[], nil);
+        return;
     }
-
-    if (prevState && prevTimestamp > 0) {
-        [segments addObject:@{
-            @"state": prevState,
-            @"start": @(prevTimestamp),
-            @"end": @([[NSDate date] timeIntervalSince1970]),
-        }];
+    if (error) {
+        ha_dispatchMainCompletion(fetch.completion, nil, error);
+        return;
     }
 
-    return [segments copy];
+    NSArray *result = [fetch.parser finish];
+    if (result.count > 0 && fetch.cacheKey) {
+        [self.cache setObject:result forKey:fetch.cacheKey];
+    }
+    ha_dispatchMainCompletion(fetch.completion, result, nil);
 }
 
 @end
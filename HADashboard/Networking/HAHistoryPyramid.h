@@ -0,0 +1,66 @@
+#import <Foundation/Foundation.h>
+#import <CoreGraphics/CoreGraphics.h>
+
+/// Fetches points for [startTime, endTime] reduced to at most maxPoints,
+/// calling done on the main queue: empty if the range has no data, nil if
+/// the fetch failed (the tile is asked for again on a later load).
+typedef void (^HAHistoryTileLoader)(NSTimeInterval startTime, NSTimeInterval endTime, NSUInteger maxPoints,
+                                    void (^done)(NSArray<NSDictionary *> *points));
+
+/// Multi-resolution history for one graph series, used by HAGraphView to
+/// zoom without stretching the initial 100-point download.
+///
+/// Level 0 is the base points the graph was loaded with. Coarser levels
+/// are decimated from it once, at init, for graphs wider than their data
+/// is dense. Finer levels are fixed-grid tiles: at level L the full range
+/// is split into 2^L tiles of kHistoryPyramidTilePoints points each, so
+/// a tile's resolution doubles with every level. Tiles are fetched on
+/// demand through the tileLoader for the visible window only, kept in an
+/// NSCache (evicted under memory pressure), and missing tiles fall back
+/// to the nearest coarser data so there is always something to draw.
+///
+/// Main thread only.
+@interface HAHistoryPyramid : NSObject
+
+- (instancetype)initWithStartTime:(NSTimeInterval)startTime
+                          endTime:(NSTimeInterval)endTime
+                       basePoints:(NSArray<NSDictionary *> *)basePoints NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) NSTimeInterval startTime;
+@property (nonatomic, readonly) NSTimeInterval endTime;
+@property (nonatomic, copy, readonly) NSArray<NSDictionary *> *basePoints;
+
+/// Source of fine tiles. Without one the pyramid only serves level 0 and coarser.
+@property (nonatomic, copy) HAHistoryTileLoader tileLoader;
+
+/// Called on the main queue when a fetched tile makes finer data available.
+@property (nonatomic, copy) void (^changeHandler)(HAHistoryPyramid *pyramid);
+
+/// Best points currently available for the window at about one point per
+/// pixel, in timestamp order. Includes the nearest point on either side
+/// of the window (when there is one) so lines reach the edges. Never fetches.
+- (NSArray<NSDictionary *> *)pointsForStartTime:(NSTimeInterval)startTime
+                                        endTime:(NSTimeInterval)endTime
+                                     pixelWidth:(CGFloat)pixelWidth;
+
+/// Fetch the tiles needed to show the window at one point per pixel, if
+/// the loaded data is coarser than that. changeHandler fires as they land.
+- (void)loadTilesForStartTime:(NSTimeInterval)startTime
+                      endTime:(NSTimeInterval)endTime
+                   pixelWidth:(CGFloat)pixelWidth;
+
+/// Level needed for a window (0 = base/coarse data suffices).
+- (NSUInteger)levelForStartTime:(NSTimeInterval)startTime
+                        endTime:(NSTimeInterval)endTime
+                     pixelWidth:(CGFloat)pixelWidth;
+
+/// Drop every fetched tile (level ≥ 1). Coarse levels are kept.
+- (void)evictTiles;
+
+@end
+
+/// Points per fine tile.
+FOUNDATION_EXPORT const NSUInteger kHistoryPyramidTilePoints;
+/// Deepest tile level (2^12 tiles across the full range).
+FOUNDATION_EXPORT const NSUInteger kHistoryPyramidMaxLevel;
@@ -0,0 +1,265 @@
+#import "HAHistoryPyramid.h"
+
+const NSUInteger kHistoryPyramidTilePoints = 256;
+const NSUInteger kHistoryPyramidMaxLevel = 12;
+
+// Coarse levels stop halving below this many points
+static const NSUInteger kMinCoarsePoints = 32;
+// Rough per-point footprint for NSCache cost accounting (dict + 2–4 NSNumbers)
+static const NSUInteger kApproxBytesPerPoint = 96;
+
+static inline NSTimeInterval HAPointTime(NSDictionary *pt) {
+    return [pt[@"timestamp"] doubleValue];
+}
+
+/// Index of the first point with timestamp >= t.
+static NSUInteger HALowerBound(NSArray<NSDictionary *> *points, NSTimeInterval t) {
+    NSUInteger lo = 0, hi = points.count;
+    while (lo < hi) {
+        NSUInteger mid = lo + (hi - lo) / 2;
+        if (HAPointTime(points[mid]) < t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/// Points with from <= timestamp < to.
+static NSArray<NSDictionary *> *HASlice(NSArray<NSDictionary *> *points, NSTimeInterval from, NSTimeInterval to) {
+    NSUInteger lo = HALowerBound(points, from);
+    NSUInteger hi = HALowerBound(points, to);
+    if (lo == 0 && hi == points.count) return points;
+    return (hi > lo) ? [points subarrayWithRange:NSMakeRange(lo, hi - lo)] : @[];
+}
+
+/// Points inside [from, to] plus the nearest neighbour on each side.
+static NSArray<NSDictionary *> *HASliceWithMargin(NSArray<NSDictionary *> *points, NSTimeInterval from, NSTimeInterval to) {
+    NSUInteger lo = HALowerBound(points, from);
+    NSUInteger hi = HALowerBound(points, to);
+    if (lo > 0) lo--;
+    if (hi < points.count) hi++;
+    if (lo == 0 && hi == points.count) return points;
+    return (hi > lo) ? [points subarrayWithRange:NSMakeRange(lo, hi - lo)] : @[];
+}
+
+/// Halve a level, keeping from each pair the point that moves furthest
+/// from the previous kept value so spikes survive. The first and last
+/// points are always kept; min/max bands are merged across the pair.
+static NSArray<NSDictionary *> *HADecimate(NSArray<NSDictionary *> *points) {
+    NSUInteger n = points.count;
+    NSMutableArray *out = [NSMutableArray arrayWithCapacity:(n + 1) / 2];
+    double previous = (n > 0) ? [points[0][@"value"] doubleValue] : 0;
+    for (NSUInteger i = 0; i < n; i += 2) {
+        NSDictionary *a = points[i];
+        NSDictionary *b = (i + 1 < n) ? points[i + 1] : nil;
+        NSDictionary *keep = a;
+        if (b) {
+            double av = [a[@"value"] doubleValue];
+            double bv = [b[@"value"] doubleValue];
+            BOOL lastPair = (i + 2 >= n);
+            if (lastPair || (i > 0 && fabs(bv - previous) > fabs(av - previous))) keep = b;
+            if (a[@"min"] && b[@"min"]) {
+                NSMutableDictionary *merged = [keep mutableCopy];
+                merged[@"min"] = @(MIN([a[@"min"] doubleValue], [b[@"min"] doubleValue]));
+                merged[@"max"] = @(MAX([a[@"max"] doubleValue], [b[@"max"] doubleValue]));
+                keep = merged;
+            }
+        }
+        previous = [keep[@"value"] doubleValue];
+        [out addObject:keep];
+    }
+    return [out copy];
+}
+
+@interface HAHistoryPyramid ()
+@property (nonatomic, copy) NSArray<NSArray<NSDictionary *> *> *coarseLevels; // [0] = base, each next one halved
+@property (nonatomic, strong) NSCache<NSString *, NSArray<NSDictionary *> *> *tiles;
+@property (nonatomic, strong) NSMutableSet<NSString *> *loadingTiles;
+@property (nonatomic, strong) NSMutableSet<NSString *> *emptyTiles; // fetched but too sparse — don't refetch
+@end
+
+@implementation HAHistoryPyramid
+
+- (instancetype)initWithStartTime:(NSTimeInterval)startTime
+                          endTime:(NSTimeInterval)endTime
+                       basePoints:(NSArray<NSDictionary *> *)basePoints {
+    self = [super init];
+    if (self) {
+        _startTime = startTime;
+        _endTime = MAX(endTime, startTime + 1.0);
+        _basePoints = [basePoints copy] ?: @[];
+
+        NSMutableArray *levels = [NSMutableArray arrayWithObject:_basePoints];
+        NSArray *level = _basePoints;
+        while (level.count / 2 >= kMinCoarsePoints) {
+            level = HADecimate(level);
+            [levels addObject:level];
+        }
+        _coarseLevels = [levels copy];
+
+        _tiles = [[NSCache alloc] init];
+        _tiles.countLimit = 48;
+        _tiles.totalCostLimit = 48 * kHistoryPyramidTilePoints * kApproxBytesPerPoint;
+        _loadingTiles = [NSMutableSet set];
+        _emptyTiles = [NSMutableSet set];
+    }
+    return self;
+}
+
+#pragma mark - Levels
+
+- (NSUInteger)levelForStartTime:(NSTimeInterval)startTime
+                        endTime:(NSTimeInterval)endTime
+                     pixelWidth:(CGFloat)pixelWidth {
+    NSTimeInterval window = endTime - startTime;
+    if (window <= 0 || pixelWidth < 1.0) return 0;
+
+    NSTimeInterval span = self.endTime - self.startTime;
+    double secondsPerPixel = window / pixelWidth;
+    double baseResolution = span / (double)MAX(self.basePoints.count, (NSUInteger)1);
+    // Base data is within ~1.3 px per point: nothing finer to fetch
+    if (secondsPerPixel >= baseResolution * 0.75) return 0;
+
+    double tilesAcross = span / ((double)kHistoryPyramidTilePoints * secondsPerPixel);
+    if (tilesAcross <= 2.0) return 1;
+    NSUInteger level = (NSUInteger)ceil(log2(tilesAcross));
+    return MIN(level, kHistoryPyramidMaxLevel);
+}
+
+- (NSTimeInterval)tileSpanAtLevel:(NSUInteger)level {
+    return (self.endTime - self.startTime) / (double)(1UL << level);
+}
+
+- (NSString *)keyForLevel:(NSUInteger)level index:(NSUInteger)index {
+    return [NSString stringWithFormat:@"%lu/%lu", (unsigned long)level, (unsigned long)index];
+}
+
+/// Tile bounds; the outer tiles are open-ended so pre-range and end-of-range points are kept.
+- (void)boundsForLevel:(NSUInteger)level index:(NSUInteger)index
+                 start:(NSTimeInterval *)outStart end:(NSTimeInterval *)outEnd {
+    NSTimeInterval tileSpan = [self tileSpanAtLevel:level];
+    NSUInteger lastIndex = (1UL << level) - 1;
+    *outStart = (index == 0) ? -DBL_MAX : self.startTime + index * tileSpan;
+    *outEnd = (index >= lastIndex) ? DBL_MAX : self.startTime + (index + 1) * tileSpan;
+}
+
+- (void)tileIndexRangeForLevel:(NSUInteger)level
+                     startTime:(NSTimeInterval)startTime
+                       endTime:(NSTimeInterval)endTime
+                         first:(NSUInteger *)outFirst
+                          last:(NSUInteger *)outLast {
+    NSTimeInterval tileSpan = [self tileSpanAtLevel:level];
+    double lastIndex = (double)((1UL << level) - 1);
+    double first = floor((startTime - self.startTime) / tileSpan);
+    double last = floor((endTime - self.startTime) / tileSpan);
+    *outFirst = (NSUInteger)MAX(0.0, MIN(lastIndex, first));
+    *outLast = (NSUInteger)MAX(0.0, MIN(lastIndex, last));
+}
+
+#pragma mark - Points
+
+- (NSArray<NSDictionary *> *)pointsForStartTime:(NSTimeInterval)startTime
+                                        endTime:(NSTimeInterval)endTime
+                                     pixelWidth:(CGFloat)pixelWidth {
+    NSUInteger level = [self levelForStartTime:startTime endTime:endTime pixelWidth:pixelWidth];
+    if (level == 0) {
+        return HASliceWithMargin([self coarseLevelForStartTime:startTime endTime:endTime pixelWidth:pixelWidth],
+                                 startTime, endTime);
+    }
+
+    NSUInteger first, last;
+    [self tileIndexRangeForLevel:level startTime:startTime endTime:endTime first:&first last:&last];
+
+    NSMutableArray *points = [NSMutableArray array];
+    for (NSUInteger index = first; index <= last; index++) {
+        [points addObjectsFromArray:[self bestPointsForLevel:level index:index]];
+    }
+
+    // Base neighbours outside the tile span, so the margin slice has them
+    NSTimeInterval spanStart, spanEnd, unused;
+    [self boundsForLevel:level index:first start:&spanStart end:&unused];
+    [self boundsForLevel:level index:last start:&unused end:&spanEnd];
+    NSUInteger before = HALowerBound(self.basePoints, spanStart);
+    if (before > 0) [points insertObject:self.basePoints[before - 1] atIndex:0];
+    NSUInteger after = HALowerBound(self.basePoints, spanEnd);
+    if (after < self.basePoints.count) [points addObject:self.basePoints[after]];
+
+    return HASliceWithMargin(points, startTime, endTime);
+}
+
+/// Coarsest precomputed level that still has a point per pixel in the window.
+- (NSArray<NSDictionary *> *)coarseLevelForStartTime:(NSTimeInterval)startTime
+                                             endTime:(NSTimeInterval)endTime
+                                          pixelWidth:(CGFloat)pixelWidth {
+    double fraction = (endTime - startTime) / (self.endTime - self.startTime);
+    for (NSInteger i = (NSInteger)self.coarseLevels.count - 1; i > 0; i--) {
+        NSArray *level = self.coarseLevels[i];
+        if ((double)level.count * fraction >= pixelWidth) return level;
+    }
+    return self.basePoints;
+}
+
+/// Points for one tile: its own data if loaded, else the covering slice of
+/// the nearest loaded ancestor tile, else of the base points.
+- (NSArray<NSDictionary *> *)bestPointsForLevel:(NSUInteger)level index:(NSUInteger)index {
+    NSTimeInterval tileStart, tileEnd;
+    [self boundsForLevel:level index:index start:&tileStart end:&tileEnd];
+    for (NSUInteger l = level; l >= 1; l--) {
+        NSArray *points = [self.tiles objectForKey:[self keyForLevel:l index:(index >> (level - l))]];
+        if (points) return (l == level) ? points : HASlice(points, tileStart, tileEnd);
+    }
+    return HASlice(self.basePoints, tileStart, tileEnd);
+}
+
+#pragma mark - Loading
+
+- (void)loadTilesForStartTime:(NSTimeInterval)startTime
+                      endTime:(NSTimeInterval)endTime
+                   pixelWidth:(CGFloat)pixelWidth {
+    if (!self.tileLoader) return;
+    NSUInteger level = [self levelForStartTime:startTime endTime:endTime pixelWidth:pixelWidth];
+    if (level == 0) return;
+
+    NSUInteger first, last;
+    [self tileIndexRangeForLevel:level startTime:startTime endTime:endTime first:&first last:&last];
+    NSTimeInterval tileSpan = [self tileSpanAtLevel:level];
+
+    for (NSUInteger index = first; index <= last; index++) {
+        NSString *key = [self keyForLevel:level index:index];
+        if ([self.tiles objectForKey:key] || [self.loadingTiles containsObject:key] ||
+            [self.emptyTiles containsObject:key]) continue;
+
+        NSTimeInterval fetchStart = self.startTime + index * tileSpan;
+        NSTimeInterval fetchEnd = fetchStart + tileSpan;
+        NSTimeInterval keepStart, keepEnd;
+        [self boundsForLevel:level index:index start:&keepStart end:&keepEnd];
+
+        [self.loadingTiles addObject:key];
+        __weak typeof(self) weakSelf = self;
+        self.tileLoader(fetchStart, fetchEnd, kHistoryPyramidTilePoints, ^(NSArray<NSDictionary *> *points) {
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf) return;
+            [strongSelf.loadingTiles removeObject:key];
+            // Failed: leave the tile unmarked so the next pan retries it
+            if (!points) return;
+
+            NSArray *tile = HASlice(points, keepStart, keepEnd);
+            if (tile.count < 2) {
+                // Nothing changed in this slice; the coarser data already says so
+                [strongSelf.emptyTiles addObject:key];
+                return;
+            }
+            [strongSelf.tiles setObject:tile forKey:key cost:tile.count * kApproxBytesPerPoint];
+            if (strongSelf.changeHandler) strongSelf.changeHandler(strongSelf);
+        });
+    }
+}
+
+- (void)evictTiles {
+    [self.tiles removeAllObjects];
+    [self.emptyTiles removeAllObjects];
+}
+
+@end
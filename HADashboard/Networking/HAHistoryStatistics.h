@@ -0,0 +1,47 @@
+#import <Foundation/Foundation.h>
+
+/// Minimum range for which long-term statistics replace raw history (48 h).
+/// Shorter ranges keep raw state history so every change stays visible.
+FOUNDATION_EXPORT const NSTimeInterval HAHistoryStatisticsMinimumRange;
+
+/// Long-term statistics source for numeric history graphs.
+///
+/// Home Assistant's recorder keeps 5-minute and hourly mean/min/max rows
+/// for every sensor with state_class "measurement". For multi-day graphs
+/// these rows are a few kilobytes where the raw state history is
+/// megabytes, and already carry the min/max envelope HAGraphView draws as
+/// a band. This class decides when to use them, builds the
+/// recorder/statistics_during_period command and reduces the result to
+/// HAHistoryManager's point format. Stateless and thread-safe.
+@interface HAHistoryStatistics : NSObject
+
+/// YES if an entity with this state_class should be graphed from
+/// statistics over a range of this length. Only "measurement" sensors
+/// have mean/min/max rows (totals only record sum/state).
++ (BOOL)shouldUseStatisticsForStateClass:(NSString *)stateClass range:(NSTimeInterval)range;
+
+/// "5minute" or "hour". Hourly rows are used once they alone give
+/// maxPoints samples, or when the range reaches back past the recorder's
+/// default 10-day short-term retention.
++ (NSString *)periodForStartDate:(NSDate *)startDate
+                         endDate:(NSDate *)endDate
+                       maxPoints:(NSUInteger)maxPoints;
+
+/// WebSocket command requesting mean/min/max for one entity.
++ (NSDictionary *)commandForEntityId:(NSString *)entityId
+                           startDate:(NSDate *)startDate
+                             endDate:(NSDate *)endDate
+                              period:(NSString *)period;
+
+/// Reduce a statistics_during_period result to at most maxPoints points
+/// (0 = 100) of @{@"value": mean, @"timestamp": epoch, @"min", @"max"}.
+/// Rows falling in the same time bucket are merged (mean of means, min of
+/// mins, max of maxes). Rows without a mean are skipped; an unexpected
+/// result shape yields an empty array.
++ (NSArray<NSDictionary *> *)pointsFromResult:(id)result
+                                     entityId:(NSString *)entityId
+                                    startTime:(NSTimeInterval)startTime
+                                      endTime:(NSTimeInterval)endTime
+                                    maxPoints:(NSUInteger)maxPoints;
+
+@end
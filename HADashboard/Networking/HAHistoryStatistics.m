@@ -0,0 +1,124 @@
+#import "HAHistoryStatistics.h"
+#import "HADateUtils.h"
+
+const NSTimeInterval HAHistoryStatisticsMinimumRange = 48 * 3600;
+
+// Recorder default purge_keep_days: 5-minute rows older than this are gone
+static const NSTimeInterval kShortTermRetention = 10 * 86400;
+
+@implementation HAHistoryStatistics
+
++ (BOOL)shouldUseStatisticsForStateClass:(NSString *)stateClass range:(NSTimeInterval)range {
+    if (![stateClass isKindOfClass:[NSString class]]) return NO;
+    return range > HAHistoryStatisticsMinimumRange && [stateClass isEqualToString:@"measurement"];
+}
+
++ (NSString *)periodForStartDate:(NSDate *)startDate
+                         endDate:(NSDate *)endDate
+                       maxPoints:(NSUInteger)maxPoints {
+    NSUInteger effectiveMax = (maxPoints == 0) ? 100 : maxPoints;
+    NSTimeInterval hours = [endDate timeIntervalSinceDate:startDate] / 3600.0;
+    BOOL beyondShortTerm = [startDate timeIntervalSinceNow] < -kShortTermRetention;
+    return (hours >= effectiveMax || beyondShortTerm) ? @"hour" : @"5minute";
+}
+
++ (NSDictionary *)commandForEntityId:(NSString *)entityId
+                           startDate:(NSDate *)startDate
+                             endDate:(NSDate *)endDate
+                              period:(NSString *)period {
+    static NSDateFormatter *fmt;
+    static dispatch_once_t fmtOnce;
+    dispatch_once(&fmtOnce, ^{
+        fmt = [[NSDateFormatter alloc] init];
+        fmt.dateFormat = @"yyyy-MM-dd'T'HH:mm:ss'Z'";
+        fmt.timeZone = [NSTimeZone timeZoneWithAbbreviation:@"UTC"];
+        fmt.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+    });
+    return @{
+        @"type": @"recorder/statistics_during_period",
+        @"start_time": [fmt stringFromDate:startDate],
+        @"end_time": [fmt stringFromDate:endDate],
+        @"statistic_ids": @[entityId],
+        @"period": period,
+        @"types": @[@"mean", @"min", @"max"],
+    };
+}
+
+/// Row start: epoch milliseconds since HA 2023.3, ISO 8601 string before.
+static BOOL HAStatisticsRowStart(NSDictionary *row, NSTimeInterval *outStart) {
+    id start = row[@"start"];
+    if ([start isKindOfClass:[NSNumber class]]) {
+        *outStart = [start doubleValue] / 1000.0;
+        return YES;
+    }
+    if ([start isKindOfClass:[NSString class]]) {
+        return [HADateUtils epochFromISO8601String:start epoch:outStart];
+    }
+    return NO;
+}
+
++ (NSArray<NSDictionary *> *)pointsFromResult:(id)result
+                                     entityId:(NSString *)entityId
+                                    startTime:(NSTimeInterval)startTime
+                                      endTime:(NSTimeInterval)endTime
+                                    maxPoints:(NSUInteger)maxPoints {
+    if (![result isKindOfClass:[NSDictionary class]] || !entityId) return @[];
+    NSArray *rows = result[entityId];
+    if (![rows isKindOfClass:[NSArray class]]) return @[];
+
+    NSUInteger buckets = (maxPoints == 0) ? 100 : maxPoints;
+    double span = (endTime > startTime) ? (endTime - startTime) : 1.0;
+    NSMutableArray *points = [NSMutableArray arrayWithCapacity:MIN(rows.count, buckets)];
+
+    // Running aggregate for the current bucket
+    NSInteger currentBucket = -1;
+    __block NSUInteger count = 0;
+    __block double meanSum = 0, lo = 0, hi = 0;
+    __block NSTimeInterval bucketStart = 0;
+
+    void (^flush)(void) = ^{
+        if (count == 0) return;
+        [points addObject:@{
+            @"value": @(meanSum / (double)count),
+            @"timestamp": @(bucketStart),
+            @"min": @(lo),
+            @"max": @(hi),
+        }];
+    };
+
+    for (NSDictionary *row in rows) {
+        if (![row isKindOfClass:[NSDictionary class]]) continue;
+        NSTimeInterval t = 0;
+        if (!HAStatisticsRowStart(row, &t)) continue;
+        id mean = row[@"mean"];
+        if (![mean isKindOfClass:[NSNumber class]]) continue;
+
+        double m = [mean doubleValue];
+        double rowMin = [row[@"min"] isKindOfClass:[NSNumber class]] ? [row[@"min"] doubleValue] : m;
+        double rowMax = [row[@"max"] isKindOfClass:[NSNumber class]] ? [row[@"max"] doubleValue] : m;
+        if (!isfinite(m) || !isfinite(rowMin) || !isfinite(rowMax)) continue;
+
+        NSInteger bucket = (NSInteger)floor((t - startTime) / span * (double)buckets);
+        if (bucket < 0) bucket = 0;
+        if (bucket >= (NSInteger)buckets) bucket = (NSInteger)buckets - 1;
+
+        if (bucket != currentBucket) {
+            flush();
+            currentBucket = bucket;
+            count = 0;
+            meanSum = 0;
+            lo = rowMin;
+            hi = rowMax;
+            bucketStart = t;
+        }
+        meanSum += m;
+        count++;
+        if (rowMin < lo) lo = rowMin;
+        if (rowMax > hi) hi = rowMax;
+    }
+    flush();
+
+    return [points copy];
+}
+
+@end
@@ -0,0 +1,41 @@
+#import <Foundation/Foundation.h>
+
+typedef NS_ENUM(NSInteger, HAHistoryStreamMode) {
+    HAHistoryStreamModePoints = 0,  // Numeric points, downsampled as they arrive
+    HAHistoryStreamModeTimeline,    // State segments (start/end per state change)
+};
+
+/// Incremental parser for /api/history/period responses.
+///
+/// Bytes are fed as they arrive from the NSURLSession data delegate and
+/// scanned with a small state machine that only understands the history
+/// shape ([[{"state": …, "last_changed": …}, …], …]). Values are pulled
+/// straight out of the byte stream — no NSJSONSerialization object graph
+/// is built — so peak memory is bounded by the output, not the response.
+///
+/// Only the first entity's array is read, matching the single
+/// filter_entity_id requests HAHistoryManager makes.
+///
+/// Not thread-safe: feed from one queue.
+@interface HAHistoryStreamParser : NSObject
+
+/// Points mode: maxPoints bounds the output (0 = 100), see HAHistoryDownsampler.
+- (instancetype)initWithMode:(HAHistoryStreamMode)mode
+                   startTime:(NSTimeInterval)startTime
+                     endTime:(NSTimeInterval)endTime
+                   maxPoints:(NSUInteger)maxPoints NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// Feed the next chunk of the response body.
+- (void)appendData:(NSData *)data;
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length;
+
+/// Number of history entries seen so far (before filtering/downsampling).
+@property (nonatomic, readonly) NSUInteger entryCount;
+
+/// Finish parsing and return the result in HAHistoryManager's formats:
+/// points mode → @[@{@"value", @"timestamp"}], timeline mode →
+/// @[@{@"state", @"start", @"end"}] with the last segment ending now.
+- (NSArray<NSDictionary *> *)finish;
+
+@end
@@ -0,0 +1,403 @@
+#import "HAHistoryStreamParser.h"
+#import "HAHistoryDownsampler.h"
+#import "HADateUtils.h"
+
+#pragma mark - Byte Scanner
+
+/// Entry fields the scanner extracts from each history object.
+typedef NS_ENUM(int, HAHistoryField) {
+    HAHistoryFieldNone = -1,
+    HAHistoryFieldState = 0,
+    HAHistoryFieldLastChanged,
+    HAHistoryFieldLastUpdated,
+    HAHistoryFieldCount,
+};
+
+enum {
+    /// Nesting depth of entry objects: outer array → entity array → entry object.
+    kEntryDepth = 3,
+    kMaxTrackedDepth = 32,
+    kMaxKeyLength = 15,
+    /// HA caps states at 255 chars; anything longer is truncated rather than grown unbounded.
+    kMaxFieldLength = 1024,
+};
+
+typedef struct {
+    char *bytes;            // NUL-terminated
+    size_t length;
+    size_t capacity;
+    BOOL present;
+} HAHistoryFieldBuffer;
+
+typedef struct {
+    int depth;
+    char containers[kMaxTrackedDepth];
+    BOOL expectKey[kMaxTrackedDepth];
+    NSUInteger topLevelIndex;       // index within the outermost array
+
+    BOOL inString;
+    BOOL escape;
+    BOOL stringIsKey;
+    int unicodeDigits;              // >0 while reading \uXXXX
+    uint32_t unicodeValue;
+    uint32_t highSurrogate;
+
+    char key[kMaxKeyLength + 1];
+    size_t keyLength;
+    HAHistoryField pendingField;    // field named by the last key
+    HAHistoryField captureField;    // field the current string is written to
+
+    HAHistoryFieldBuffer fields[HAHistoryFieldCount];
+} HAHistoryScanner;
+
+static inline BOOL ha_scannerInEntry(const HAHistoryScanner *s) {
+    return s->depth == kEntryDepth && s->topLevelIndex == 0 &&
+           s->containers[0] == '[' && s->containers[1] == '[' && s->containers[2] == '{';
+}
+
+static void ha_fieldAppend(HAHistoryFieldBuffer *f, const char *bytes, size_t length) {
+    if (f->length + length > kMaxFieldLength) {
+        length = (f->length < kMaxFieldLength) ? kMaxFieldLength - f->length : 0;
+        if (length == 0) return;
+    }
+    if (f->length + length + 1 > f->capacity) {
+        size_t cap = f->capacity ? f->capacity : 32;
+        while (cap < f->length + length + 1) cap *= 2;
+        char *grown = realloc(f->bytes, cap);
+        if (!grown) return;
+        f->bytes = grown;
+        f->capacity = cap;
+    }
+    memcpy(f->bytes + f->length, bytes, length);
+    f->length += length;
+    f->bytes[f->length] = '\0';
+}
+
+static void ha_scannerAppendCodepoint(HAHistoryScanner *s, uint32_t cp) {
+    char utf8[4];
+    size_t n;
+    if (cp < 0x80) {
+        utf8[0] = (char)cp; n = 1;
+    } else if (cp < 0x800) {
+        utf8[0] = (char)(0xC0 | (cp >> 6));
+        utf8[1] = (char)(0x80 | (cp & 0x3F)); n = 2;
+    } else if (cp < 0x10000) {
+        utf8[0] = (char)(0xE0 | (cp >> 12));
+        utf8[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[2] = (char)(0x80 | (cp & 0x3F)); n = 3;
+    } else {
+        utf8[0] = (char)(0xF0 | (cp >> 18));
+        utf8[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        utf8[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        utf8[3] = (char)(0x80 | (cp & 0x3F)); n = 4;
+    }
+    if (s->stringIsKey) {
+        // Keys we care about are plain ASCII — mark escaped keys as unmatched
+        s->keyLength = kMaxKeyLength + 1;
+    } else if (s->captureField != HAHistoryFieldNone) {
+        ha_fieldAppend(&s->fields[s->captureField], utf8, n);
+    }
+}
+
+static void ha_scannerAppendByte(HAHistoryScanner *s, char c) {
+    if (s->stringIsKey) {
+        if (s->keyLength < kMaxKeyLength) s->key[s->keyLength] = c;
+        s->keyLength++;
+    } else if (s->captureField != HAHistoryFieldNone) {
+        ha_fieldAppend(&s->fields[s->captureField], &c, 1);
+    }
+}
+
+static HAHistoryField ha_fieldForKey(const HAHistoryScanner *s) {
+    if (s->keyLength > kMaxKeyLength) return HAHistoryFieldNone;
+    if (s->keyLength == 5 && memcmp(s->key, "state", 5) == 0) return HAHistoryFieldState;
+    if (s->keyLength == 12 && memcmp(s->key, "last_changed", 12) == 0) return HAHistoryFieldLastChanged;
+    if (s->keyLength == 12 && memcmp(s->key, "last_updated", 12) == 0) return HAHistoryFieldLastUpdated;
+    return HAHistoryFieldNone;
+}
+
+static void ha_scannerResetEntry(HAHistoryScanner *s) {
+    for (int i = 0; i < HAHistoryFieldCount; i++) {
+        s->fields[i].length = 0;
+        s->fields[i].present = NO;
+        if (s->fields[i].bytes) s->fields[i].bytes[0] = '\0';
+    }
+    s->pendingField = HAHistoryFieldNone;
+}
+
+static void ha_scannerFree(HAHistoryScanner *s) {
+    for (int i = 0; i < HAHistoryFieldCount; i++) {
+        free(s->fields[i].bytes);
+        s->fields[i].bytes = NULL;
+    }
+}
+
+/// Scan a chunk. Calls onEntry(ctx, scanner) each time an entry object closes;
+/// any partial token at the end of the chunk is carried over to the next call.
+static void ha_scannerConsume(HAHistoryScanner *s, const uint8_t *bytes, size_t length,
+                              void (*onEntry)(void *ctx, HAHistoryScanner *s), void *ctx) {
+    for (size_t i = 0; i < length; i++) {
+        char c = (char)bytes[i];
+
+        if (s->inString) {
+            if (s->unicodeDigits > 0) {
+                int digit;
+                if (c >= '0' && c <= '9') digit = c - '0';
+                else if (c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+                else digit = 0;
+                s->unicodeValue = (s->unicodeValue << 4) | (uint32_t)digit;
+                if (--s->unicodeDigits == 0) {
+                    uint32_t cp = s->unicodeValue;
+                    if (cp >= 0xD800 && cp <= 0xDBFF) {
+                        s->highSurrogate = cp;
+                    } else if (cp >= 0xDC00 && cp <= 0xDFFF && s->highSurrogate) {
+                        ha_scannerAppendCodepoint(s, 0x10000 + ((s->highSurrogate - 0xD800) << 10) + (cp - 0xDC00));
+                        s->highSurrogate = 0;
+                    } else {
+                        ha_scannerAppendCodepoint(s, (cp >= 0xD800 && cp <= 0xDFFF) ? 0xFFFD : cp);
+                        s->highSurrogate = 0;
+                    }
+                }
+                continue;
+            }
+            if (s->escape) {
+                s->escape = NO;
+                switch (c) {
+                    case 'u': s->unicodeDigits = 4; s->unicodeValue = 0; continue;
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    default: break; // \" \\ \/ map to themselves
+                }
+                ha_scannerAppendByte(s, c);
+                continue;
+            }
+            if (c == '\\') {
+                s->escape = YES;
+                continue;
+            }
+            if (c == '"') {
+                s->inString = NO;
+                if (s->highSurrogate) {
+                    ha_scannerAppendCodepoint(s, 0xFFFD);
+                    s->highSurrogate = 0;
+                }
+                if (s->stringIsKey) {
+                    s->pendingField = ha_scannerInEntry(s) ? ha_fieldForKey(s) : HAHistoryFieldNone;
+                } else if (s->captureField != HAHistoryFieldNone) {
+                    s->fields[s->captureField].present = YES;
+                }
+                continue;
+            }
+            if (!s->stringIsKey && s->captureField == HAHistoryFieldNone) {
+                // Fast-forward through strings we don't care about
+                const uint8_t *end = bytes + length;
+                const uint8_t *p = bytes + i + 1;
+                while (p < end && *p != '"' && *p != '\\') p++;
+                i = (size_t)(p - bytes) - 1;
+                continue;
+            }
+            ha_scannerAppendByte(s, c);
+            continue;
+        }
+
+        int top = s->depth - 1;
+        BOOL inObject = (top >= 0 && top < kMaxTrackedDepth && s->containers[top] == '{');
+
+        switch (c) {
+            case '"':
+                s->inString = YES;
+                s->escape = NO;
+                s->unicodeDigits = 0;
+                s->highSurrogate = 0;
+                s->stringIsKey = inObject && s->expectKey[top];
+                s->keyLength = 0;
+                s->captureField = HAHistoryFieldNone;
+                if (!s->stringIsKey && inObject && s->pendingField != HAHistoryFieldNone) {
+                    s->captureField = s->pendingField;
+                    s->fields[s->captureField].length = 0;
+                    if (s->fields[s->captureField].bytes) s->fields[s->captureField].bytes[0] = '\0';
+                    s->pendingField = HAHistoryFieldNone;
+                }
+                break;
+            case '{':
+            case '[':
+                s->pendingField = HAHistoryFieldNone;
+                if (s->depth < kMaxTrackedDepth) {
+                    s->containers[s->depth] = c;
+                    s->expectKey[s->depth] = (c == '{');
+                }
+                s->depth++;
+                if (c == '{' && ha_scannerInEntry(s)) ha_scannerResetEntry(s);
+                break;
+            case '}':
+            case ']':
+                if (c == '}' && ha_scannerInEntry(s)) onEntry(ctx, s);
+                if (s->depth > 0) s->depth--;
+                s->pendingField = HAHistoryFieldNone;
+                break;
+            case ',':
+                if (s->depth == 1) s->topLevelIndex++;
+                if (inObject) s->expectKey[top] = YES;
+                s->pendingField = HAHistoryFieldNone;
+                break;
+            case ':':
+                if (inObject) s->expectKey[top] = NO;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+#pragma mark - HAHistoryStreamParser
+
+@interface HAHistoryStreamParser () {
+    HAHistoryScanner _scanner;
+    HAHistoryFieldBuffer _previousStateBytes;
+}
+@property (nonatomic, assign) HAHistoryStreamMode mode;
+@property (nonatomic, strong) HAHistoryDownsampler *downsampler;
+@property (nonatomic, strong) NSMutableArray<NSDictionary *> *segments;
+@property (nonatomic, strong) NSString *previousState;
+@property (nonatomic, assign) NSTimeInterval previousTimestamp;
+@property (nonatomic, assign) NSUInteger entryCount;
+@end
+
+static void ha_historyEntryCallback(void *ctx, HAHistoryScanner *s);
+
+@implementation HAHistoryStreamParser
+
+- (instancetype)initWithMode:(HAHistoryStreamMode)mode
+                   startTime:(NSTimeInterval)startTime
+                     endTime:(NSTimeInterval)endTime
+                   maxPoints:(NSUInteger)maxPoints {
+    self = [super init];
+    if (self) {
+        _mode = mode;
+        _scanner.pendingField = HAHistoryFieldNone;
+        _scanner.captureField = HAHistoryFieldNone;
+        if (mode == HAHistoryStreamModePoints) {
+            _downsampler = [[HAHistoryDownsampler alloc] initWithStartTime:startTime
+                                                                   endTime:endTime
+                                                                 maxPoints:maxPoints];
+        } else {
+            _segments = [NSMutableArray array];
+        }
+    }
+    return self;
+}
+
+- (void)dealloc {
+    ha_scannerFree(&_scanner);
+    free(_previousStateBytes.bytes);
+}
+
+- (void)appendData:(NSData *)data {
+    // NSURLSession hands us dispatch_data-backed NSData — walk its regions
+    // instead of flattening it with -bytes
+    [data enumerateByteRangesUsingBlock:^(const void *bytes, NSRange byteRange, BOOL *stop) {
+        [self appendBytes:bytes length:byteRange.length];
+    }];
+}
+
+- (void)appendBytes:(const void *)bytes length:(NSUInteger)length {
+    if (!bytes || length == 0) return;
+    ha_scannerConsume(&_scanner, bytes, length, ha_historyEntryCallback, (__bridge void *)self);
+}
+
+- (NSArray<NSDictionary *> *)finish {
+    if (self.mode == HAHistoryStreamModePoints) {
+        return [self.downsampler points];
+    }
+
+    if (self.previousState && self.previousTimestamp > 0) {
+        [self.segments addObject:@{
+            @"state": self.previousState,
+            @"start": @(self.previousTimestamp),
+            @"end": @([[NSDate date] timeIntervalSince1970]),
+        }];
+        self.previousState = nil;
+    }
+    return [self.segments copy];
+}
+
+#pragma mark - Entry Handling
+
+- (void)handleEntry:(HAHistoryScanner *)s {
+    self.entryCount++;
+
+    HAHistoryFieldBuffer *state = &s->fields[HAHistoryFieldState];
+    if (!state->present) return;
+
+    HAHistoryFieldBuffer *time = &s->fields[HAHistoryFieldLastChanged];
+    if (!time->present) time = &s->fields[HAHistoryFieldLastUpdated];
+    if (!time->present) return;
+
+    NSTimeInterval timestamp;
+    if (!HAParseISO8601Epoch(time->bytes, time->length, &timestamp)) {
+        // Unusual shape — let the formatter chain have a go
+        NSString *timeStr = [[NSString alloc] initWithBytes:time->bytes ?: "" length:time->length encoding:NSUTF8StringEncoding];
+        if (![HADateUtils epochFromISO8601String:timeStr epoch:&timestamp]) return;
+    }
+
+    if (self.mode == HAHistoryStreamModePoints) {
+        [self handleNumericState:state timestamp:timestamp];
+    } else {
+        [self handleTimelineState:state timestamp:timestamp];
+    }
+}
+
+- (void)handleNumericState:(HAHistoryFieldBuffer *)state timestamp:(NSTimeInterval)timestamp {
+    const char *str = state->bytes;
+    size_t len = state->length;
+    if (len == 0) return;
+    if ((len == 7 && memcmp(str, "unknown", 7) == 0) ||
+        (len == 11 && memcmp(str, "unavailable", 11) == 0)) {
+        return;
+    }
+
+    double value = strtod(str, NULL);
+    if (!isfinite(value)) return;
+    // Same rule as the old NSString path: a 0 parse is only real if the state says so
+    if (value == 0 && !(len == 1 && str[0] == '0') && !(len >= 2 && str[0] == '0' && str[1] == '.')) return;
+
+    [self.downsampler addValue:value timestamp:timestamp];
+}
+
+- (void)handleTimelineState:(HAHistoryFieldBuffer *)state timestamp:(NSTimeInterval)timestamp {
+    // Reuse the previous NSString when the state repeats (common with
+    // attribute-only updates) rather than allocating a new one
+    NSString *previous = self.previousState;
+    NSString *stateStr = nil;
+    if (previous && _previousStateBytes.length == state->length &&
+        (state->length == 0 || memcmp(_previousStateBytes.bytes, state->bytes, state->length) == 0)) {
+        stateStr = previous;
+    } else {
+        stateStr = [[NSString alloc] initWithBytes:state->bytes ?: "" length:state->length encoding:NSUTF8StringEncoding];
+        if (!stateStr) return;
+        _previousStateBytes.length = 0;
+        ha_fieldAppend(&_previousStateBytes, state->bytes ?: "", state->length);
+    }
+
+    if (previous && self.previousTimestamp > 0) {
+        [self.segments addObject:@{
+            @"state": previous,
+            @"start": @(self.previousTimestamp),
+            @"end": @(timestamp),
+        }];
+    }
+
+    self.previousState = stateStr;
+    self.previousTimestamp = timestamp;
+}
+
+@end
+
+static void ha_historyEntryCallback(void *ctx, HAHistoryScanner *s) {
+    HAHistoryStreamParser *parser = (__bridge HAHistoryStreamParser *)ctx;
+    [parser handleEntry:s];
+}
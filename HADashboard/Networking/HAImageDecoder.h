@@ -0,0 +1,16 @@
+#import <UIKit/UIKit.h>
+
+/// Turns camera JPEG data into bitmaps that are ready to draw, off the main
+/// thread. When the target is smaller than the source, ImageIO downsamples
+/// while it decodes (JPEG can decode directly at 1/2, 1/4 or 1/8 scale), so
+/// a 2560x1440 frame for a 320x240 tile never exists at full size.
+/// The result's pixels live in a HABitmapBufferPool buffer, reused for a
+/// later frame of the same size once this image is released.
+@interface HAImageDecoder : NSObject
+
+/// Decoded image just large enough to aspect-fill targetPixelSize, or at
+/// full resolution when targetPixelSize is CGSizeZero or not smaller than
+/// the source. nil if the data isn't a decodable image.
++ (UIImage *)decodedImageWithData:(NSData *)data fillingPixelSize:(CGSize)targetPixelSize;
+
+@end
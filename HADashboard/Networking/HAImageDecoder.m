@@ -0,0 +1,58 @@
+#import "HAImageDecoder.h"
+#import "HABitmapBufferPool.h"
+#import <ImageIO/ImageIO.h>
+
+@implementation HAImageDecoder
+
++ (UIImage *)decodedImageWithData:(NSData *)data fillingPixelSize:(CGSize)targetPixelSize {
+    if (data.length == 0) return nil;
+    CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)data,
+        (__bridge CFDictionaryRef)@{(id)kCGImageSourceShouldCache: @NO});
+    if (!source) return nil;
+
+    // Images are created undecoded; the pixels land in a pooled buffer below
+    CGImageRef image = NULL;
+    if (targetPixelSize.width > 0 && targetPixelSize.height > 0) {
+        // Header only — the pixels aren't touched yet
+        NSDictionary *properties = CFBridgingRelease(CGImageSourceCopyPropertiesAtIndex(source, 0, NULL));
+        CGFloat sourceWidth = [properties[(id)kCGImagePropertyPixelWidth] doubleValue];
+        CGFloat sourceHeight = [properties[(id)kCGImagePropertyPixelHeight] doubleValue];
+        if (sourceWidth > 0 && sourceHeight > 0) {
+            // Aspect fill: the scaled image must cover the target on both axes
+            CGFloat factor = MAX(targetPixelSize.width / sourceWidth, targetPixelSize.height / sourceHeight);
+            if (factor < 1.0) {
+                CGFloat maxPixelSize = ceil(MAX(sourceWidth, sourceHeight) * factor);
+                image = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)@{
+                    (id)kCGImageSourceCreateThumbnailFromImageAlways: @YES,
+                    (id)kCGImageSourceCreateThumbnailWithTransform: @YES,
+                    (id)kCGImageSourceThumbnailMaxPixelSize: @(maxPixelSize),
+                    (id)kCGImageSourceShouldCacheImmediately: @NO,
+                });
+            }
+        }
+    }
+    if (!image) {
+        image = CGImageSourceCreateImageAtIndex(source, 0, (__bridge CFDictionaryRef)@{
+            (id)kCGImageSourceShouldCache: @NO,
+        });
+    }
+    CFRelease(source);
+    if (!image) return nil;
+
+    // Decode now, on this thread, rather than lazily on first render (main),
+    // into a buffer recycled from an earlier frame of the same size
+    size_t width = CGImageGetWidth(image);
+    size_t height = CGImageGetHeight(image);
+    UIImage *result = [[HABitmapBufferPool sharedPool] imageWithPixelWidth:width height:height drawing:^(CGContextRef context) {
+        CGContextSetBlendMode(context, kCGBlendModeCopy);
+        CGContextDrawImage(context, CGRectMake(0, 0, width, height), image);
+    }];
+    if (!result) {
+        // No buffer (out of memory): let UIKit decode it when drawn
+        result = [UIImage imageWithCGImage:image scale:1.0 orientation:UIImageOrientationUp];
+    }
+    CGImageRelease(image);
+    return result;
+}
+
+@end
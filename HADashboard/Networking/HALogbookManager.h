@@ -1,7 +1,12 @@
 #import <Foundation/Foundation.h>
 
+@class HARequestInterest;
+
 /// Fetches logbook (activity) entries from the HA REST API.
 /// Entries include state changes, automations triggered, scripts run, etc.
+/// fetchRecentEntries: and fetchEntriesForEntityIds: share loads: a fetch
+/// matching one in flight joins it, and results are reused for a minute.
+/// Call them on the main thread.
 @interface HALogbookManager : NSObject
 
 + (instancetype)sharedManager;
@@ -22,4 +27,12 @@
                        hoursBack:(NSInteger)hours
                       completion:(void (^)(NSArray *entries, NSError *error))completion;
 
+/// Start loading what a logbook card filtered to entityIds (none: recent
+/// entries) will ask for when it appears. completion runs on main when the
+/// load ends, unless the interest was cancelled first; cancelling only
+/// detaches, the request itself runs to completion. Main thread only.
+- (HARequestInterest *)prefetchEntriesForEntityIds:(NSArray<NSString *> *)entityIds
+                                         hoursBack:(NSInteger)hours
+                                        completion:(void (^)(void))completion;
+
 @end
@@ -3,6 +3,11 @@
 #import "HAConnectionManager.h"
 #import "NSMutableURLRequest+HAHelpers.h"
 #import "HALog.h"
+#import "HARequestCoalescer.h"
+
+@interface HALogbookManager ()
+@property (nonatomic, strong) HARequestCoalescer *loads; // main thread
+@end
 
 @implementation HALogbookManager
 
@@ -15,9 +20,49 @@
     return instance;
 }
 
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _loads = [[HARequestCoalescer alloc] initWithFreshness:60.0];
+    }
+    return self;
+}
+
 - (void)fetchRecentEntries:(NSInteger)hours
                 completion:(void (^)(NSArray *, NSError *))completion {
-    [self fetchEntriesForEntityId:nil hoursBack:hours completion:completion];
+    if (!completion) return;
+    [self loadEntriesForEntityIds:nil hoursBack:hours completion:completion];
+}
+
+- (HARequestInterest *)prefetchEntriesForEntityIds:(NSArray<NSString *> *)entityIds
+                                         hoursBack:(NSInteger)hours
+                                        completion:(void (^)(void))completion {
+    // Mirrors HALogbookCardCell: no filter means the recent entries
+    NSArray *filter = entityIds.count > 0 ? entityIds : nil;
+    return [self loadEntriesForEntityIds:filter hoursBack:hours completion:^(NSArray *entries, NSError *error) {
+        if (completion) completion();
+    }];
+}
+
+/// Shared by card fetches and prefetches. nil entityIds is
+/// fetchRecentEntries: (REST), anything else fetchEntriesForEntityIds:'s
+/// WebSocket-first path. Neither request is cancellable, so a withdrawn
+/// prefetch still completes into the reuse window.
+- (HARequestInterest *)loadEntriesForEntityIds:(NSArray<NSString *> *)entityIds
+                                     hoursBack:(NSInteger)hours
+                                    completion:(void (^)(NSArray *, NSError *))completion {
+    NSString *key = entityIds
+        ? [NSString stringWithFormat:@"ids|%@|%ld", [entityIds componentsJoinedByString:@","], (long)hours]
+        : [NSString stringWithFormat:@"recent|%ld", (long)hours];
+    __weak typeof(self) weakSelf = self;
+    return [self.loads loadKey:key start:^dispatch_block_t(HARequestFinishBlock finish) {
+        if (entityIds) {
+            [weakSelf requestEntriesForEntityIds:entityIds hoursBack:hours completion:finish];
+        } else {
+            [weakSelf fetchEntriesForEntityId:nil hoursBack:hours completion:finish];
+        }
+        return nil;
+    } completion:completion];
 }
 
 - (void)fetchEntriesForEntityId:(NSString *)entityId
@@ -95,7 +140,12 @@
                        hoursBack:(NSInteger)hours
                       completion:(void (^)(NSArray *, NSError *))completion {
     if (!completion) return;
+    [self loadEntriesForEntityIds:entityIds ?: @[] hoursBack:hours completion:completion];
+}
 
+- (void)requestEntriesForEntityIds:(NSArray<NSString *> *)entityIds
+                         hoursBack:(NSInteger)hours
+                        completion:(void (^)(NSArray *, NSError *))completion {
     // Demo mode
     if ([HAAuthManager sharedManager].isDemoMode) {
         NSMutableArray *entries = [NSMutableArray array];
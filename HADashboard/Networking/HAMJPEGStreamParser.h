@@ -5,10 +5,20 @@
 ///
 /// The MJPEG format is: multipart/x-mixed-replace with each part
 /// containing a JPEG image. This parser accumulates data from the
-/// streaming HTTP response, detects frame boundaries, and decodes
-/// each JPEG on a background thread.
+/// streaming HTTP response in one reusable buffer, slices each frame by
+/// its part's Content-Length (or at the next boundary when there is
+/// none), and decodes each JPEG on a background thread.
 @interface HAMJPEGStreamParser : NSObject
 
+/// Frames are decoded just large enough to aspect-fill this many pixels
+/// (see HAImageDecoder); CGSizeZero decodes at full resolution. Can be
+/// changed from main while streaming — the next frame uses the new size.
+@property (atomic, assign) CGSize targetPixelSize;
+
+/// Camera the stream's bytes, decode times, drops and frames are recorded
+/// under in HAPerfMonitor (the entity id); nil records nothing.
+@property (nonatomic, copy) NSString *metricsName;
+
 /// Called on main thread with each decoded frame image.
 @property (nonatomic, copy) void (^frameHandler)(UIImage *frame);
 
@@ -24,4 +34,11 @@
 /// Whether the stream is currently active.
 @property (nonatomic, readonly) BOOL isStreaming;
 
+/// Frames decoded since start, and frames dropped because a newer one
+/// superseded them before they were decoded or handed to frameHandler.
+/// At most one frame waits for the decoder, so a slow decoder drops
+/// frames instead of falling behind. Safe to read from any thread.
+@property (nonatomic, readonly) NSUInteger decodedFrameCount;
+@property (nonatomic, readonly) NSUInteger droppedFrameCount;
+
 @end
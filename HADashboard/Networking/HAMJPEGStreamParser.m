@@ -1,23 +1,73 @@
 #import "HAMJPEGStreamParser.h"
+#import "HAImageDecoder.h"
+#import "HAPerfMonitor.h"
 #import "HALog.h"
+#import <QuartzCore/QuartzCore.h>
 
 /// Queue for JPEG decoding — avoid blocking main thread with image decompression.
 static dispatch_queue_t _decodeQueue;
 
 static const NSTimeInterval kFirstFrameTimeout = 10.0;
 
+/// Part headers longer than this are treated as absent (JPEG bytes follow directly).
+static const NSUInteger kMaxPartHeaderLength = 1024;
+/// Content-Length values above this are not trusted; the part is scanned instead.
+static const long long kMaxFrameLength = 16 * 1024 * 1024;
+
+/// First occurrence of needle in haystack, or NSNotFound.
+static NSUInteger ha_findBytes(const uint8_t *haystack, NSUInteger length, const uint8_t *needle, NSUInteger needleLength) {
+    if (needleLength == 0 || length < needleLength) return NSNotFound;
+    const uint8_t *p = haystack;
+    const uint8_t *last = haystack + length - needleLength;
+    while (p <= last) {
+        p = memchr(p, needle[0], (size_t)(last - p) + 1);
+        if (!p) return NSNotFound;
+        if (memcmp(p, needle, needleLength) == 0) return (NSUInteger)(p - haystack);
+        p++;
+    }
+    return NSNotFound;
+}
+
+/// Value of a Content-Length line in a part's header block, or -1.
+static long long ha_contentLength(const uint8_t *headers, NSUInteger length) {
+    static const char kName[] = "content-length:";
+    const NSUInteger nameLength = sizeof(kName) - 1;
+    for (NSUInteger i = 0; i + nameLength < length; i++) {
+        if ((i > 0 && headers[i - 1] != '\n') || strncasecmp((const char *)headers + i, kName, nameLength) != 0) continue;
+        NSUInteger j = i + nameLength;
+        while (j < length && (headers[j] == ' ' || headers[j] == '\t')) j++;
+        long long value = -1;
+        while (j < length && headers[j] >= '0' && headers[j] <= '9' && value <= kMaxFrameLength) {
+            value = (value < 0 ? 0 : value * 10) + (headers[j] - '0');
+            j++;
+        }
+        return value;
+    }
+    return -1;
+}
+
 @interface HAMJPEGStreamParser () <NSURLSessionDataDelegate>
 @property (nonatomic, strong) NSURLSession *session;
 @property (nonatomic, strong) NSURLSessionDataTask *task;
 @property (nonatomic, strong) NSMutableData *buffer;
+@property (nonatomic, assign) NSUInteger readOffset; // start of the unparsed part in buffer
+@property (nonatomic, assign) NSUInteger scanOffset; // boundary search resumes here
 @property (nonatomic, copy) NSData *boundaryData;
 @property (nonatomic, assign) BOOL streaming;
 @property (nonatomic, assign) BOOL receivedFirstFrame;
 @property (nonatomic, strong) NSTimer *firstFrameTimer;
 @property (nonatomic, assign) BOOL usePartAccumulation; // NSURLSession splits multipart for us
+// Latest-frame-wins hand-offs, guarded by @synchronized(self)
+@property (nonatomic, strong) NSData *pendingJPEG;   // waiting for the decoder
+@property (nonatomic, strong) UIImage *pendingFrame; // waiting for main
+@property (nonatomic, assign) BOOL decodeScheduled;
+@property (nonatomic, assign) BOOL deliveryScheduled;
 @end
 
-@implementation HAMJPEGStreamParser
+@implementation HAMJPEGStreamParser {
+    NSUInteger _decodedFrameCount;
+    NSUInteger _droppedFrameCount;
+}
 
 + (void)initialize {
     if (self == [HAMJPEGStreamParser class]) {
@@ -35,7 +85,13 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
     [self stop]; // Cancel any existing stream
 
     self.buffer = [NSMutableData data];
+    self.readOffset = 0;
+    self.scanOffset = 0;
     self.boundaryData = nil; // Will be extracted from Content-Type header
+    @synchronized (self) {
+        _decodedFrameCount = 0;
+        _droppedFrameCount = 0;
+    }
     self.streaming = YES;
 
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
@@ -54,7 +110,15 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
 }
 
 - (void)stop {
+    if (self.streaming) {
+        HALogD(@"cam", @"Stream stopped: %lu frames decoded, %lu dropped",
+               (unsigned long)self.decodedFrameCount, (unsigned long)self.droppedFrameCount);
+    }
     self.streaming = NO;
+    @synchronized (self) {
+        _pendingJPEG = nil;
+        _pendingFrame = nil;
+    }
     [self.firstFrameTimer invalidate];
     self.firstFrameTimer = nil;
     [self.task cancel];
@@ -62,6 +126,8 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
     [self.session invalidateAndCancel];
     self.session = nil;
     self.buffer = nil;
+    self.readOffset = 0;
+    self.scanOffset = 0;
     self.boundaryData = nil;
     self.receivedFirstFrame = NO;
     self.usePartAccumulation = NO;
@@ -71,6 +137,14 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
     return _streaming;
 }
 
+- (NSUInteger)decodedFrameCount {
+    @synchronized (self) { return _decodedFrameCount; }
+}
+
+- (NSUInteger)droppedFrameCount {
+    @synchronized (self) { return _droppedFrameCount; }
+}
+
 #pragma mark - NSURLSessionDataDelegate
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask
@@ -99,11 +173,15 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
     // When we detect a subsequent part, flush the accumulated buffer as a frame.
     if (self.boundaryData) {
         self.usePartAccumulation = YES;
-        // Flush previous part's data as a JPEG frame
-        if (self.buffer.length > 100) {
-            [self decodeJPEGFromChunk:[self.buffer copy]];
+        // Hand the previous part over as a JPEG frame and start a fresh
+        // buffer, rather than copying it out and clearing this one
+        NSMutableData *part = self.buffer;
+        self.buffer = [NSMutableData dataWithCapacity:part.length];
+        self.readOffset = 0;
+        self.scanOffset = 0;
+        if (part.length > 100) {
+            [self decodeJPEGFromChunk:part];
         }
-        [self.buffer setLength:0];
         completionHandler(NSURLSessionResponseAllow);
         return;
     }
@@ -133,7 +211,12 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
 }
 
 - (void)URLSession:(NSURLSession *)session dataTask:(NSURLSessionDataTask *)dataTask didReceiveData:(NSData *)data {
+    [self consumeData:data];
+}
+
+- (void)consumeData:(NSData *)data {
     if (!self.streaming) return;
+    [[HAPerfMonitor sharedMonitor] recordCameraBytes:data.length forEntityId:self.metricsName];
     [self.buffer appendData:data];
     // In part accumulation mode, NSURLSession splits parts for us — frames are flushed
     // in didReceiveResponse when the next part starts. Only use boundary extraction
@@ -178,81 +261,198 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
 
 #pragma mark - Frame Extraction
 
+/// Slices every complete part out of buffer without copying what remains.
+/// Parts whose headers carry Content-Length are cut at that length (no
+/// scanning of the JPEG bytes); others run to the next boundary, and the
+/// boundary search resumes where the previous one left off.
 - (void)extractFrames {
     if (!self.boundaryData || self.buffer.length == 0) return;
 
-    // Search for JPEG data between boundaries.
-    // JPEG frames start after headers (Content-Type + Content-Length + empty line)
-    // and end at the next boundary marker.
-
-    while (self.streaming) {
-        NSRange boundaryRange = [self rangeOfData:self.boundaryData inData:self.buffer];
-        if (boundaryRange.location == NSNotFound) break;
+    const uint8_t *bytes = self.buffer.bytes;
+    NSUInteger length = self.buffer.length;
+    const uint8_t *boundary = self.boundaryData.bytes;
+    NSUInteger boundaryLength = self.boundaryData.length;
+    static const uint8_t kHeaderEnd[] = {'\r', '\n', '\r', '\n'};
+
+    while (self.streaming && self.readOffset < length) {
+        NSUInteger partStart = self.readOffset;
+        NSUInteger available = length - partStart;
+
+        // Headers (and, for the first part, the opening boundary line)
+        NSUInteger headerWindow = MIN(available, kMaxPartHeaderLength);
+        NSUInteger headerEnd = ha_findBytes(bytes + partStart, headerWindow, kHeaderEnd, sizeof(kHeaderEnd));
+        if (headerEnd == NSNotFound && available < kMaxPartHeaderLength) break; // wait for the rest
+
+        if (headerEnd != NSNotFound) {
+            long long contentLength = ha_contentLength(bytes + partStart, headerEnd);
+            NSUInteger bodyStart = partStart + headerEnd + sizeof(kHeaderEnd);
+            if (contentLength > 0 && contentLength <= kMaxFrameLength) {
+                if (length - bodyStart < 2) break;
+                if (bytes[bodyStart] == 0xFF && bytes[bodyStart + 1] == 0xD8) {
+                    if (length - bodyStart < (NSUInteger)contentLength) break; // frame still arriving
+                    NSUInteger bodyEnd = bodyStart + (NSUInteger)contentLength;
+                    [self decodeJPEGData:[self.buffer subdataWithRange:NSMakeRange(bodyStart, (NSUInteger)contentLength)]];
+                    // The trailing boundary is read as the next part's first header line
+                    self.readOffset = bodyEnd;
+                    self.scanOffset = bodyEnd;
+                    continue;
+                }
+                // Content-Length doesn't point at a JPEG — fall back to the boundary
+            }
+        }
 
-        // Everything before the boundary is part of the current frame (headers + JPEG)
-        NSData *chunk = [self.buffer subdataWithRange:NSMakeRange(0, boundaryRange.location)];
-
-        // Remove processed data + boundary from buffer
-        NSUInteger consumed = NSMaxRange(boundaryRange);
-        if (consumed < self.buffer.length) {
-            NSData *remaining = [self.buffer subdataWithRange:NSMakeRange(consumed, self.buffer.length - consumed)];
-            self.buffer = [remaining mutableCopy];
-        } else {
-            [self.buffer setLength:0];
+        NSUInteger from = MAX(self.scanOffset, partStart);
+        NSUInteger found = ha_findBytes(bytes + from, length - from, boundary, boundaryLength);
+        if (found == NSNotFound) {
+            // Only the last boundaryLength - 1 bytes can still start a match
+            self.scanOffset = (length - from >= boundaryLength) ? length - boundaryLength + 1 : from;
+            break;
         }
+        NSUInteger boundaryStart = from + found;
+        // Everything before the boundary is part of the current frame (headers + JPEG)
+        [self decodeJPEGFromChunk:[self.buffer subdataWithRange:NSMakeRange(partStart, boundaryStart - partStart)]];
+        self.readOffset = boundaryStart + boundaryLength;
+        self.scanOffset = self.readOffset;
+    }
+
+    [self compactBuffer];
+}
 
-        // Extract JPEG from chunk (skip HTTP headers to find JPEG data)
-        [self decodeJPEGFromChunk:chunk];
+/// Drop consumed bytes from the front of buffer. The shift waits until the
+/// consumed prefix is at least as long as what's left, so each byte moves
+/// at most about once and the buffer stays within about two frames.
+- (void)compactBuffer {
+    NSUInteger consumed = self.readOffset;
+    if (consumed == 0) return;
+    NSUInteger length = self.buffer.length;
+    if (consumed >= length) {
+        [self.buffer setLength:0];
+    } else if (consumed >= length - consumed) {
+        [self.buffer replaceBytesInRange:NSMakeRange(0, consumed) withBytes:NULL length:0];
+    } else {
+        return;
     }
+    self.scanOffset = (self.scanOffset > consumed) ? self.scanOffset - consumed : 0;
+    self.readOffset = 0;
 }
 
 - (void)decodeJPEGFromChunk:(NSData *)chunk {
     if (chunk.length < 10) return;
 
     // Find JPEG start marker (0xFF 0xD8) — skip any preceding HTTP headers
-    const uint8_t *bytes = chunk.bytes;
-    NSUInteger jpegStart = NSNotFound;
-    for (NSUInteger i = 0; i + 1 < chunk.length; i++) {
-        if (bytes[i] == 0xFF && bytes[i + 1] == 0xD8) {
-            jpegStart = i;
-            break;
-        }
-    }
+    static const uint8_t kSOI[] = {0xFF, 0xD8};
+    NSUInteger jpegStart = ha_findBytes(chunk.bytes, chunk.length, kSOI, sizeof(kSOI));
     if (jpegStart == NSNotFound) return;
 
-    NSData *jpegData = [chunk subdataWithRange:NSMakeRange(jpegStart, chunk.length - jpegStart)];
+    NSData *jpegData = (jpegStart == 0) ? chunk : [chunk subdataWithRange:NSMakeRange(jpegStart, chunk.length - jpegStart)];
+    [self decodeJPEGData:jpegData];
+}
+
+- (void)decodeJPEGData:(NSData *)jpegData {
     if (jpegData.length < 100) return; // Too small for a valid JPEG
 
+    // Latest frame wins: a frame arriving while another still waits for the
+    // decoder replaces it. When decoding is slower than the camera (A5 with
+    // a 1080p stream) the tile shows the newest picture with one frame of
+    // memory, instead of working through a growing backlog.
+    BOOL schedule = NO, dropped = NO;
+    @synchronized (self) {
+        if (_pendingJPEG) {
+            _droppedFrameCount++;
+            dropped = YES;
+        }
+        _pendingJPEG = jpegData;
+        if (!_decodeScheduled) {
+            _decodeScheduled = YES;
+            schedule = YES;
+        }
+    }
+    if (dropped) [[HAPerfMonitor sharedMonitor] recordCameraDroppedFrameForEntityId:self.metricsName];
+    if (schedule) [self scheduleDecode];
+}
+
+- (void)scheduleDecode {
     // Decode on background thread to avoid main thread stalls.
     // Use weak/strong to prevent crash if parser is deallocated mid-decode (iPad 2 iOS 9).
     __weak typeof(self) weakSelf = self;
     dispatch_async(_decodeQueue, ^{
         __strong typeof(weakSelf) strongSelf = weakSelf;
-        if (!strongSelf || !strongSelf.streaming) return;
+        [strongSelf decodePendingFrame];
+    });
+}
+
+/// Decode queue only. One frame per block, so streams sharing the queue take turns.
+- (void)decodePendingFrame {
+    NSData *jpegData;
+    @synchronized (self) {
+        jpegData = _pendingJPEG;
+        _pendingJPEG = nil;
+    }
 
+    if (jpegData && self.streaming) {
         // Autoreleasepool per frame prevents memory accumulation on A5 (iPad 2)
         @autoreleasepool {
-            UIImage *lazyImage = [UIImage imageWithData:jpegData];
-            if (!lazyImage) return;
-
-            UIGraphicsBeginImageContextWithOptions(lazyImage.size, YES, 1.0);
-            [lazyImage drawAtPoint:CGPointZero];
-            UIImage *decoded = UIGraphicsGetImageFromCurrentImageContext();
-            UIGraphicsEndImageContext();
-
-            if (!decoded || !strongSelf.streaming) return;
-
-            dispatch_async(dispatch_get_main_queue(), ^{
-                __strong typeof(weakSelf) mainSelf = weakSelf;
-                if (!mainSelf || !mainSelf.streaming || !mainSelf.frameHandler) return;
-                if (!mainSelf.receivedFirstFrame) {
-                    mainSelf.receivedFirstFrame = YES;
-                    [mainSelf.firstFrameTimer invalidate];
-                    mainSelf.firstFrameTimer = nil;
-                }
-                mainSelf.frameHandler(decoded);
-            });
+            CFTimeInterval decodeStart = CACurrentMediaTime();
+            UIImage *decoded = [self decodedImageFromJPEGData:jpegData];
+            if (decoded) {
+                [[HAPerfMonitor sharedMonitor] recordCameraDecodeMs:(CACurrentMediaTime() - decodeStart) * 1000.0
+                                                        forEntityId:self.metricsName];
+            }
+            if (decoded && self.streaming) {
+                @synchronized (self) { _decodedFrameCount++; }
+                [self deliverFrame:decoded];
+            }
         }
+    }
+
+    BOOL more;
+    @synchronized (self) {
+        more = (_pendingJPEG != nil);
+        if (!more) _decodeScheduled = NO;
+    }
+    if (more) [self scheduleDecode];
+}
+
+- (UIImage *)decodedImageFromJPEGData:(NSData *)jpegData {
+    return [HAImageDecoder decodedImageWithData:jpegData fillingPixelSize:self.targetPixelSize];
+}
+
+/// Same rule on the way to main: a decoded frame main hasn't picked up yet
+/// is replaced by the next one.
+- (void)deliverFrame:(UIImage *)frame {
+    BOOL schedule = NO, dropped = NO;
+    @synchronized (self) {
+        if (_pendingFrame) {
+            _droppedFrameCount++;
+            dropped = YES;
+        }
+        _pendingFrame = frame;
+        if (!_deliveryScheduled) {
+            _deliveryScheduled = YES;
+            schedule = YES;
+        }
+    }
+    if (dropped) [[HAPerfMonitor sharedMonitor] recordCameraDroppedFrameForEntityId:self.metricsName];
+    if (!schedule) return;
+
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        __strong typeof(weakSelf) mainSelf = weakSelf;
+        if (!mainSelf) return;
+        UIImage *latest;
+        @synchronized (mainSelf) {
+            latest = mainSelf->_pendingFrame;
+            mainSelf->_pendingFrame = nil;
+            mainSelf->_deliveryScheduled = NO;
+        }
+        if (!latest || !mainSelf.streaming || !mainSelf.frameHandler) return;
+        if (!mainSelf.receivedFirstFrame) {
+            mainSelf.receivedFirstFrame = YES;
+            [mainSelf.firstFrameTimer invalidate];
+            mainSelf.firstFrameTimer = nil;
+        }
+        [[HAPerfMonitor sharedMonitor] recordCameraFrameForEntityId:mainSelf.metricsName];
+        mainSelf.frameHandler(latest);
     });
 }
 
@@ -268,14 +468,6 @@ static const NSTimeInterval kFirstFrameTimeout = 10.0;
 
 #pragma mark - Helpers
 
-- (NSRange)rangeOfData:(NSData *)needle inData:(NSData *)haystack {
-    if (needle.length == 0 || haystack.length < needle.length) {
-        return NSMakeRange(NSNotFound, 0);
-    }
-    // Use NSData's rangeOfData if available (iOS 4+)
-    return [haystack rangeOfData:needle options:0 range:NSMakeRange(0, haystack.length)];
-}
-
 - (void)reportError:(NSError *)error {
     dispatch_async(dispatch_get_main_queue(), ^{
         if (self.errorHandler) {
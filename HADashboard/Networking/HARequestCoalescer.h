@@ -0,0 +1,53 @@
+#import <Foundation/Foundation.h>
+
+/// Delivers a load's result. Call exactly once, from any thread.
+typedef void (^HARequestFinishBlock)(id result, NSError *error);
+
+/// Starts the underlying request for a key. Returns a block that cancels
+/// it, or nil if it can't be cancelled once started.
+typedef dispatch_block_t (^HARequestStartBlock)(HARequestFinishBlock finish);
+
+/// One caller's interest in a coalesced load. Hold on to it while the
+/// result is still wanted; cancel it to detach.
+@interface HARequestInterest : NSObject
+
+@property (nonatomic, copy, readonly) NSString *key;
+
+/// Detach without a callback. The underlying request is cancelled when its
+/// last interest detaches. Idempotent.
+- (void)cancel;
+
+@end
+
+/// Shares loads of the same resource: callers asking for a key that is
+/// already loading join that request instead of starting another, and a
+/// successful result is served to later callers for `freshness` seconds.
+/// Lets a load started ahead of time (collection view prefetch) be picked
+/// up by the cell that needed it. Main thread only; completions run on main.
+@interface HARequestCoalescer : NSObject
+
+- (instancetype)initWithFreshness:(NSTimeInterval)freshness;
+
+@property (nonatomic, readonly) NSTimeInterval freshness;
+
+/// Result for key delivered within the last `freshness` seconds, or nil.
+- (id)freshResultForKey:(NSString *)key;
+
+/// Whether a load for key is in flight.
+- (BOOL)isLoadingKey:(NSString *)key;
+
+/// Deliver key's result to completion: a fresh one straight away, the
+/// in-flight load's when it lands, or a new load's from start. Returns the
+/// interest to cancel if the result stops being wanted (nil when served
+/// from the fresh result).
+- (HARequestInterest *)loadKey:(NSString *)key
+                         start:(HARequestStartBlock)start
+                    completion:(void (^)(id result, NSError *error))completion;
+
+/// Join key's in-flight load, if there is one; nil otherwise.
+- (HARequestInterest *)joinKey:(NSString *)key completion:(void (^)(id result, NSError *error))completion;
+
+/// Forget fresh results (in-flight loads carry on).
+- (void)removeAllResults;
+
+@end
@@ -0,0 +1,167 @@
+#import "HARequestCoalescer.h"
+
+/// A result and when it landed.
+@interface HARequestResult : NSObject
+@property (nonatomic, strong) id value;
+@property (nonatomic, assign) NSTimeInterval receivedAt;
+@end
+
+@implementation HARequestResult
+@end
+
+/// One underlying request and the interests waiting on it.
+@interface HARequestLoad : NSObject
+@property (nonatomic, copy) NSString *key;
+@property (nonatomic, strong) NSMutableArray<HARequestInterest *> *interests;
+@property (nonatomic, copy) dispatch_block_t cancelBlock;
+@end
+
+@implementation HARequestLoad
+@end
+
+@interface HARequestInterest ()
+@property (nonatomic, copy, readwrite) NSString *key;
+@property (nonatomic, weak) HARequestCoalescer *coalescer;
+@property (nonatomic, strong) HARequestLoad *load;
+@property (nonatomic, copy) void (^completion)(id result, NSError *error);
+@end
+
+@interface HARequestCoalescer ()
+@property (nonatomic, assign, readwrite) NSTimeInterval freshness;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, HARequestLoad *> *loads;
+@property (nonatomic, strong) NSCache<NSString *, HARequestResult *> *results;
+- (void)detachInterest:(HARequestInterest *)interest;
+@end
+
+@implementation HARequestInterest
+
+- (void)cancel {
+    self.completion = nil;
+    if (!self.load) return;
+    [self.coalescer detachInterest:self];
+}
+
+@end
+
+@implementation HARequestCoalescer
+
+- (instancetype)init {
+    return [self initWithFreshness:60.0];
+}
+
+- (instancetype)initWithFreshness:(NSTimeInterval)freshness {
+    self = [super init];
+    if (self) {
+        _freshness = freshness;
+        _loads = [NSMutableDictionary dictionary];
+        _results = [[NSCache alloc] init];
+        _results.countLimit = 64;
+    }
+    return self;
+}
+
+- (id)freshResultForKey:(NSString *)key {
+    if (!key) return nil;
+    HARequestResult *result = [self.results objectForKey:key];
+    if (!result) return nil;
+    if ([NSDate timeIntervalSinceReferenceDate] - result.receivedAt >= self.freshness) {
+        [self.results removeObjectForKey:key];
+        return nil;
+    }
+    return result.value;
+}
+
+- (BOOL)isLoadingKey:(NSString *)key {
+    return key && self.loads[key] != nil;
+}
+
+- (HARequestInterest *)loadKey:(NSString *)key
+                         start:(HARequestStartBlock)start
+                    completion:(void (^)(id, NSError *))completion {
+    if (!key || !start) return nil;
+
+    id fresh = [self freshResultForKey:key];
+    if (fresh) {
+        if (completion) {
+            dispatch_async(dispatch_get_main_queue(), ^{ completion(fresh, nil); });
+        }
+        return nil;
+    }
+
+    HARequestInterest *interest = [self joinKey:key completion:completion];
+    if (interest) return interest;
+
+    HARequestLoad *load = [[HARequestLoad alloc] init];
+    load.key = key;
+    load.interests = [NSMutableArray array];
+    self.loads[key] = load;
+    interest = [self addInterestToLoad:load completion:completion];
+
+    // Delivered on main after start returns, whatever thread finish is called on
+    __weak typeof(self) weakSelf = self;
+    load.cancelBlock = start(^(id result, NSError *error) {
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf finishLoad:load result:result error:error];
+        });
+    });
+    return interest;
+}
+
+- (HARequestInterest *)joinKey:(NSString *)key completion:(void (^)(id, NSError *))completion {
+    HARequestLoad *load = key ? self.loads[key] : nil;
+    if (!load) return nil;
+    return [self addInterestToLoad:load completion:completion];
+}
+
+- (HARequestInterest *)addInterestToLoad:(HARequestLoad *)load completion:(void (^)(id, NSError *))completion {
+    HARequestInterest *interest = [[HARequestInterest alloc] init];
+    interest.key = load.key;
+    interest.coalescer = self;
+    interest.load = load;
+    interest.completion = completion;
+    [load.interests addObject:interest];
+    return interest;
+}
+
+- (void)detachInterest:(HARequestInterest *)interest {
+    HARequestLoad *load = interest.load;
+    interest.load = nil;
+    [load.interests removeObject:interest];
+    if (load.interests.count > 0 || self.loads[load.key] != load) return;
+
+    // Nobody is waiting any more. A request that can't be cancelled stays
+    // registered so a later caller joins it and its result is still kept.
+    if (!load.cancelBlock) return;
+    [self.loads removeObjectForKey:load.key];
+    dispatch_block_t cancelBlock = load.cancelBlock;
+    load.cancelBlock = nil;
+    cancelBlock();
+}
+
+- (void)finishLoad:(HARequestLoad *)load result:(id)result error:(NSError *)error {
+    if (self.loads[load.key] == load) {
+        [self.loads removeObjectForKey:load.key];
+    }
+    load.cancelBlock = nil;
+    if (result && !error) {
+        HARequestResult *entry = [[HARequestResult alloc] init];
+        entry.value = result;
+        entry.receivedAt = [NSDate timeIntervalSinceReferenceDate];
+        [self.results setObject:entry forKey:load.key];
+    }
+
+    NSArray<HARequestInterest *> *interests = [load.interests copy];
+    [load.interests removeAllObjects];
+    for (HARequestInterest *interest in interests) {
+        void (^completion)(id, NSError *) = interest.completion;
+        interest.completion = nil;
+        interest.load = nil;
+        if (completion) completion(result, error);
+    }
+}
+
+- (void)removeAllResults {
+    [self.results removeAllObjects];
+}
+
+@end
@@ -0,0 +1,33 @@
+#import <Foundation/Foundation.h>
+
+/// Change detection and polling backoff for one camera's snapshots.
+/// Sends If-None-Match when the server gave an ETag, otherwise compares a
+/// digest of the downloaded bytes, so an unchanged image is neither decoded
+/// nor redrawn. Every unchanged fetch doubles the poll interval (up to
+/// maxInterval); a changed one drops it back to the base. Thread-safe:
+/// responses are recorded on the session's queue, intervals read on main.
+@interface HASnapshotChangeTracker : NSObject
+
+/// Ceiling for the backed-off poll interval. Default 60 s.
+@property (nonatomic, assign) NSTimeInterval maxInterval;
+
+/// Add If-None-Match for the last ETag, if there was one.
+- (void)applyToRequest:(NSMutableURLRequest *)request;
+
+/// Record a successful response (200 or 304). Returns YES if the image
+/// differs from the last one recorded, i.e. it needs decoding.
+- (BOOL)recordResponse:(NSHTTPURLResponse *)response data:(NSData *)data;
+
+/// Poll interval for a camera normally polled every baseInterval.
+- (NSTimeInterval)intervalForBaseInterval:(NSTimeInterval)baseInterval;
+
+/// Fetches in a row that came back unchanged.
+@property (nonatomic, readonly) NSUInteger unchangedStreak;
+
+/// Forget the last image (new entity, or someone is watching closely).
+- (void)reset;
+
+/// 64-bit FNV-1a over the bytes: cheap next to a JPEG decode.
++ (uint64_t)digestOfData:(NSData *)data;
+
+@end
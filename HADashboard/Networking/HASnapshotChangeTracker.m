@@ -0,0 +1,78 @@
+#import "HASnapshotChangeTracker.h"
+
+@interface HASnapshotChangeTracker ()
+@property (nonatomic, copy) NSString *etag;
+@property (nonatomic, assign) uint64_t digest;
+@property (nonatomic, assign) NSUInteger length;   // 0 = nothing recorded yet
+@property (nonatomic, assign, readwrite) NSUInteger unchangedStreak;
+@end
+
+@implementation HASnapshotChangeTracker
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _maxInterval = 60.0;
+    }
+    return self;
+}
+
+- (void)applyToRequest:(NSMutableURLRequest *)request {
+    NSString *etag;
+    @synchronized (self) { etag = self.etag; }
+    if (etag.length > 0) {
+        [request setValue:etag forHTTPHeaderField:@"If-None-Match"];
+    }
+}
+
+- (BOOL)recordResponse:(NSHTTPURLResponse *)response data:(NSData *)data {
+    if (response.statusCode == 304) {
+        @synchronized (self) { self.unchangedStreak++; }
+        return NO;
+    }
+
+    NSString *etag = response.allHeaderFields[@"ETag"];
+    uint64_t digest = [HASnapshotChangeTracker digestOfData:data];
+    @synchronized (self) {
+        BOOL unchanged = (self.length > 0 && self.length == data.length && self.digest == digest);
+        self.etag = etag;
+        self.digest = digest;
+        self.length = data.length;
+        if (unchanged) {
+            self.unchangedStreak++;
+            return NO;
+        }
+        self.unchangedStreak = 0;
+        return YES;
+    }
+}
+
+- (NSTimeInterval)intervalForBaseInterval:(NSTimeInterval)baseInterval {
+    NSUInteger streak;
+    @synchronized (self) { streak = self.unchangedStreak; }
+    NSTimeInterval ceiling = MAX(baseInterval, self.maxInterval);
+    NSTimeInterval interval = baseInterval * (double)(1ULL << MIN(streak, (NSUInteger)16));
+    return MIN(interval, ceiling);
+}
+
+- (void)reset {
+    @synchronized (self) {
+        self.etag = nil;
+        self.digest = 0;
+        self.length = 0;
+        self.unchangedStreak = 0;
+    }
+}
+
++ (uint64_t)digestOfData:(NSData *)data {
+    const uint8_t *bytes = data.bytes;
+    NSUInteger length = data.length;
+    uint64_t hash = 14695981039346656037ULL;
+    for (NSUInteger i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+@end
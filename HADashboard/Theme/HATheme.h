@@ -56,6 +56,8 @@ extern NSString *const HAThemeDidChangeNotification;
 // Effective dark mode (accounts for manual override)
 + (BOOL)effectiveDarkMode;
 + (BOOL)isDarkMode;
+// Differs whenever the mode or effective dark mode does; for caches of rendered output
++ (NSInteger)appearanceKey;
 
 // Utility
 + (UIColor *)colorFromHex:(NSString *)hex;
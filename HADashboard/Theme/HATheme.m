@@ -323,6 +323,10 @@ static UIImage *_blurredGradientCache = nil;
     return [self effectiveDarkMode];
 }
 
++ (NSInteger)appearanceKey {
+    return (NSInteger)[self currentMode] * 2 + ([self effectiveDarkMode] ? 1 : 0);
+}
+
 + (BOOL)effectiveDarkMode {
     HAThemeMode mode = [self currentMode];
     if (mode == HAThemeModeDark) return YES;
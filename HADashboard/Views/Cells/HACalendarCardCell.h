@@ -1,6 +1,7 @@
 #import <UIKit/UIKit.h>
 
 @class HADashboardConfigItem, HADashboardConfigSection;
+@class HARequestInterest;
 
 typedef NS_ENUM(NSInteger, HACalendarViewMode) {
     HACalendarViewModeList,      // listWeek / list
@@ -20,4 +21,16 @@ typedef NS_ENUM(NSInteger, HACalendarViewMode) {
 
 + (CGFloat)preferredHeightForMode:(HACalendarViewMode)mode;
 
+/// View a card opens in, from its initial_view.
++ (HACalendarViewMode)viewModeForConfigItem:(HADashboardConfigItem *)configItem;
+
+/// Start loading the events a card configured with these will show first,
+/// for a cell about to scroll into view; beginLoading joins the load or
+/// reuses its result. completion runs on main when the load ends, unless
+/// the interest was cancelled first. Cancel the interest if the card is no
+/// longer coming. Main thread only.
++ (HARequestInterest *)prefetchEventsForEntityIds:(NSArray<NSString *> *)entityIds
+                                       configItem:(HADashboardConfigItem *)configItem
+                                       completion:(void (^)(void))completion;
+
 @end
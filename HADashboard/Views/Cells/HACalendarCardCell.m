@@ -4,6 +4,7 @@
 #import "HADateUtils.h"
 #import "HATheme.h"
 #import "HAIconMapper.h"
+#import "HARequestCoalescer.h"
 
 static const CGFloat kListHeight  = 280.0;
 static const CGFloat kMonthHeight = 380.0;
@@ -34,7 +35,7 @@ static UIColor *sDefaultEventColor;
 @property (nonatomic, assign) HACalendarViewMode viewMode;
 @property (nonatomic, copy) NSArray<NSString *> *entityIds;
 @property (nonatomic, strong) NSArray<HACalendarEvent *> *events;
-@property (nonatomic, strong) NSURLSessionDataTask *fetchTask;
+@property (nonatomic, strong) HARequestInterest *eventsInterest;
 @property (nonatomic, assign) BOOL needsEventsLoad;
 
 // Navigation state
@@ -234,14 +235,7 @@ static UIColor *sDefaultEventColor;
     self.entityIds = entityIds;
     self.displayStartDate = [self.calendar startOfDayForDate:[NSDate date]];
 
-    NSString *initialView = configItem.customProperties[@"initial_view"];
-    if ([initialView hasPrefix:@"list"]) {
-        self.viewMode = HACalendarViewModeList;
-    } else if ([initialView isEqualToString:@"dayGridMonth"]) {
-        self.viewMode = HACalendarViewModeMonth;
-    } else {
-        self.viewMode = initialView ? HACalendarViewModeMonth : HACalendarViewModeList;
-    }
+    self.viewMode = [HACalendarCardCell viewModeForConfigItem:configItem];
 
     [self updateViewModeButtons];
     [self updateDateRangeLabel];
@@ -249,6 +243,16 @@ static UIColor *sDefaultEventColor;
     self.needsEventsLoad = YES;
 }
 
++ (HACalendarViewMode)viewModeForConfigItem:(HADashboardConfigItem *)configItem {
+    NSString *initialView = configItem.customProperties[@"initial_view"];
+    if ([initialView hasPrefix:@"list"]) {
+        return HACalendarViewModeList;
+    } else if ([initialView isEqualToString:@"dayGridMonth"]) {
+        return HACalendarViewModeMonth;
+    }
+    return initialView ? HACalendarViewModeMonth : HACalendarViewModeList;
+}
+
 #pragma mark - Navigation
 
 - (void)todayTapped {
@@ -345,8 +349,25 @@ static UIColor *sDefaultEventColor;
 }
 
 - (void)cancelLoading {
-    [self.fetchTask cancel];
-    self.fetchTask = nil;
+    [self.eventsInterest cancel];
+    self.eventsInterest = nil;
+}
+
++ (HARequestInterest *)prefetchEventsForEntityIds:(NSArray<NSString *> *)entityIds
+                                       configItem:(HADashboardConfigItem *)configItem
+                                       completion:(void (^)(void))completion {
+    NSCalendar *calendar = [NSCalendar currentCalendar];
+    NSURLRequest *request = [self eventsRequestForEntityId:entityIds.firstObject
+                                                  viewMode:[self viewModeForConfigItem:configItem]
+                                          displayStartDate:[calendar startOfDayForDate:[NSDate date]]
+                                                  calendar:calendar];
+    if (!request) {
+        if (completion) dispatch_async(dispatch_get_main_queue(), completion);
+        return nil;
+    }
+    return [self loadEventsWithRequest:request completion:^(NSArray<HACalendarEvent *> *events, NSError *error) {
+        if (completion) completion();
+    }];
 }
 
 #pragma mark - Event Fetching
@@ -359,17 +380,59 @@ static UIColor *sDefaultEventColor;
         return;
     }
 
+    NSURLRequest *request = [HACalendarCardCell eventsRequestForEntityId:self.entityIds.firstObject
+                                                                viewMode:self.viewMode
+                                                        displayStartDate:self.displayStartDate
+                                                                calendar:self.calendar];
+    if (!request) {
+        [self showPlaceholder:@"Invalid URL"];
+        return;
+    }
+
+    // Navigating away from a window that is still loading drops it
+    [self.eventsInterest cancel];
+    __weak typeof(self) weakSelf = self;
+    self.eventsInterest = [HACalendarCardCell loadEventsWithRequest:request
+                                                         completion:^(NSArray<HACalendarEvent *> *events, NSError *error) {
+        __strong typeof(weakSelf) self = weakSelf;
+        if (!self) return;
+        self.eventsInterest = nil;
+        if (error) {
+            if ([error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled) return;
+            [self showPlaceholder:@"Failed to load"];
+            return;
+        }
+        self.events = events;
+        if (self.viewMode == HACalendarViewModeMonth) {
+            [self renderMonthView];
+        } else {
+            [self renderListView];
+        }
+    }];
+}
+
+/// Events request for the window a cell in viewMode shows from
+/// displayStartDate: the whole month, or the 7 days from it. nil if auth
+/// isn't configured or the URL is invalid.
++ (NSURLRequest *)eventsRequestForEntityId:(NSString *)entityId
+                                  viewMode:(HACalendarViewMode)viewMode
+                          displayStartDate:(NSDate *)displayStartDate
+                                  calendar:(NSCalendar *)calendar {
+    NSString *serverURL = [[HAAuthManager sharedManager] serverURL];
+    NSString *token = [[HAAuthManager sharedManager] accessToken];
+    if (!serverURL || !token || !entityId) return nil;
+
     NSDate *startDate;
     NSDate *endDate;
 
-    if (self.viewMode == HACalendarViewModeMonth) {
-        NSDateComponents *comp = [self.calendar components:(NSCalendarUnitYear | NSCalendarUnitMonth) fromDate:self.displayStartDate];
-        startDate = [self.calendar dateFromComponents:comp];
+    if (viewMode == HACalendarViewModeMonth) {
+        NSDateComponents *comp = [calendar components:(NSCalendarUnitYear | NSCalendarUnitMonth) fromDate:displayStartDate];
+        startDate = [calendar dateFromComponents:comp];
         comp.month += 1;
-        endDate = [self.calendar dateFromComponents:comp];
+        endDate = [calendar dateFromComponents:comp];
     } else {
-        startDate = self.displayStartDate;
-        endDate = [self.calendar dateByAddingUnit:NSCalendarUnitDay value:7 toDate:startDate options:0];
+        startDate = displayStartDate;
+        endDate = [calendar dateByAddingUnit:NSCalendarUnitDay value:7 toDate:startDate options:0];
     }
 
     static NSDateFormatter *isoFmt;
@@ -384,50 +447,49 @@ static UIColor *sDefaultEventColor;
     NSString *startStr = [isoFmt stringFromDate:startDate];
     NSString *endStr = [isoFmt stringFromDate:endDate];
 
-    NSString *entityId = self.entityIds.firstObject;
     NSString *urlStr = [NSString stringWithFormat:@"%@/api/calendars/%@?start=%@&end=%@",
                         serverURL, entityId, startStr, endStr];
     NSURL *url = [NSURL URLWithString:urlStr];
-    if (!url) {
-        [self showPlaceholder:@"Invalid URL"];
-        return;
-    }
+    if (!url) return nil;
 
     NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
     request.HTTPMethod = @"GET";
     [request setValue:[NSString stringWithFormat:@"Bearer %@", token] forHTTPHeaderField:@"Authorization"];
     [request setValue:@"application/json" forHTTPHeaderField:@"Content-Type"];
     request.timeoutInterval = 15.0;
+    return request;
+}
 
-    __weak typeof(self) weakSelf = self;
-    self.fetchTask = [[NSURLSession sharedSession] dataTaskWithRequest:request completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
-        if (error) {
-            if ([error.domain isEqualToString:NSURLErrorDomain] && error.code == NSURLErrorCancelled) return;
-            dispatch_async(dispatch_get_main_queue(), ^{
-                [weakSelf showPlaceholder:@"Failed to load"];
-            });
-            return;
-        }
-
-        NSArray *parsed = nil;
-        if (data.length > 0) {
-            parsed = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
-        }
-
-        NSArray<HACalendarEvent *> *events = [HACalendarCardCell parseEvents:parsed];
+/// Event loads are shared by URL between cells and prefetches, and a
+/// window's events are reused for a minute. The request is cancelled when
+/// the last cell or prefetch waiting on it lets go.
++ (HARequestInterest *)loadEventsWithRequest:(NSURLRequest *)request
+                                  completion:(void (^)(NSArray<HACalendarEvent *> *events, NSError *error))completion {
+    static HARequestCoalescer *eventLoads;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        eventLoads = [[HARequestCoalescer alloc] initWithFreshness:60.0];
+    });
 
-        dispatch_async(dispatch_get_main_queue(), ^{
-            __strong typeof(weakSelf) self = weakSelf;
-            if (!self) return;
-            self.events = events;
-            if (self.viewMode == HACalendarViewModeMonth) {
-                [self renderMonthView];
-            } else {
-                [self renderListView];
+    return [eventLoads loadKey:request.URL.absoluteString start:^dispatch_block_t(HARequestFinishBlock finish) {
+        NSURLSessionDataTask *task = [[NSURLSession sharedSession] dataTaskWithRequest:request
+            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            if (error) {
+                finish(nil, error);
+                return;
             }
-        });
-    }];
-    [self.fetchTask resume];
+            NSArray *parsed = nil;
+            if (data.length > 0) {
+                parsed = [NSJSONSerialization JSONObjectWithData:data options:0 error:nil];
+            }
+            // Parsed here, off the main thread, once for every waiting cell
+            finish([HACalendarCardCell parseEvents:parsed], nil);
+        }];
+        [task resume];
+        return ^{
+            [task cancel];
+        };
+    } completion:completion];
 }
 
 #pragma mark - Event Parsing
@@ -1,14 +1,24 @@
 #import "HABaseEntityCell.h"
 
+@class HARequestInterest;
+
 @interface HACameraEntityCell : HABaseEntityCell
 
 /// Stop the periodic snapshot refresh (call when cell goes off-screen)
 - (void)stopRefresh;
 
-/// Deferred loading: call when cell becomes visible to start snapshot fetching
+/// Deferred loading: call when cell becomes visible. Requests a slot from
+/// HACameraScheduler, which decides between streaming and snapshot polling.
 - (void)beginLoading;
 
-/// Cancel pending fetches when cell scrolls off screen
+/// Cancel pending fetches and give the slot back when cell scrolls off screen
 - (void)cancelLoading;
 
+/// Fetch a snapshot for a camera tile about to scroll into view, if the
+/// scheduler's snapshot budget allows; a tile with nothing on screen shows
+/// it (decoded at its own size) instead of waiting for its first fetch.
+/// completion runs on main when done, unless the interest was cancelled
+/// first. Cancel the interest if the tile is no longer coming. Main thread only.
++ (HARequestInterest *)prefetchSnapshotForEntity:(HAEntity *)entity completion:(void (^)(void))completion;
+
 @end
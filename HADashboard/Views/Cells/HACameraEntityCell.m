@@ -5,13 +5,20 @@
 #import "HAConnectionManager.h"
 #import "HAEntityDisplayHelper.h"
 #import "HAIconMapper.h"
-#import "HAMJPEGStreamParser.h"
+#import "HACameraStreamRegistry.h"
+#import "HACameraScheduler.h"
+#import "HAImageDecoder.h"
+#import "HASnapshotChangeTracker.h"
+#import "HAPerfMonitor.h"
+#import "HARequestCoalescer.h"
 #import "HALog.h"
 #import <AVFoundation/AVFoundation.h>
 #import <objc/runtime.h>
 
 static const NSTimeInterval kSnapshotRefreshInterval = 5.0;
 static const NSInteger kMaxConsecutiveFailuresBeforeClear = 3;
+/// A prefetched snapshot older than this isn't shown in place of a fetch.
+static const NSTimeInterval kPrefetchedSnapshotFreshness = 10.0;
 
 
 // Overlay button layout constants
@@ -24,7 +31,7 @@ static const CGFloat kOverlayIconFontSize   = 14.0;
 /// Tag base for overlay buttons so we can identify them
 static const NSInteger kOverlayButtonTagBase = 9000;
 
-@interface HACameraEntityCell ()
+@interface HACameraEntityCell () <HACameraSchedulerClient>
 @property (nonatomic, strong) UIImageView *snapshotView;
 @property (nonatomic, strong) UIActivityIndicatorView *loadingSpinner;
 @property (nonatomic, strong) UILabel *errorLabel;
@@ -32,9 +39,13 @@ static const NSInteger kOverlayButtonTagBase = 9000;
 @property (nonatomic, strong) NSTimer *refreshTimer;
 @property (nonatomic, strong) NSURLSession *imageSession;
 @property (nonatomic, strong) NSURLSessionDataTask *currentTask;
+@property (nonatomic, strong) HASnapshotChangeTracker *snapshotTracker; // skips unchanged snapshots
 @property (nonatomic, copy)   NSString *currentEntityId;
 @property (nonatomic, assign) BOOL needsSnapshotLoad;
 @property (nonatomic, assign) NSInteger consecutiveFailures;
+@property (nonatomic, assign) HACameraSlot cameraSlot;         // granted by HACameraScheduler
+@property (nonatomic, assign) BOOL snapshotRetryScheduled;    // waiting for snapshot budget
+@property (nonatomic, strong) HARequestInterest *prefetchInterest; // joined snapshot prefetch
 
 // Camera service buttons (power toggle + snapshot + fullscreen + volume)
 @property (nonatomic, strong) UIButton *cameraPowerButton;
@@ -50,8 +61,8 @@ static const NSInteger kOverlayButtonTagBase = 9000;
 @property (nonatomic, strong) NSLayoutConstraint *snapshotTopWithName;
 @property (nonatomic, strong) NSLayoutConstraint *snapshotTopNoName;
 
-// MJPEG streaming
-@property (nonatomic, strong) HAMJPEGStreamParser *streamParser;
+// MJPEG streaming — shared with other consumers of the same camera
+@property (nonatomic, strong) HACameraStreamConsumer *streamConsumer;
 @property (nonatomic, assign) BOOL useStreaming;       // default YES
 @property (nonatomic, assign) BOOL streamFailed;       // fell back to snapshot polling
 
@@ -290,6 +301,7 @@ static HACameraStreamMode currentStreamMode(void) {
     config.timeoutIntervalForRequest = 8.0;
     config.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
     self.imageSession = [NSURLSession sessionWithConfiguration:config];
+    self.snapshotTracker = [[HASnapshotChangeTracker alloc] init];
 }
 
 - (void)configureWithEntity:(HAEntity *)entity configItem:(HADashboardConfigItem *)configItem {
@@ -318,6 +330,7 @@ static HACameraStreamMode currentStreamMode(void) {
 
     if (!entity.isAvailable) {
         [self stopRefresh];
+        [self releaseCameraSlot];
         self.snapshotView.image = nil;
         self.errorLabel.text = @"Unavailable";
         self.errorLabel.hidden = NO;
@@ -345,6 +358,7 @@ static HACameraStreamMode currentStreamMode(void) {
         // Different entity — tear down existing stream and reset
         [self stopRefresh];
         self.snapshotView.image = nil;
+        [self.snapshotTracker reset];
         self.consecutiveFailures = 0;
         self.streamFailed = NO;
         // On iOS <10, HLS is permanently disabled (crashes AVFoundation).
@@ -440,11 +454,20 @@ static HACameraStreamMode currentStreamMode(void) {
         [imageView.layer addSublayer:fsLayer];
     }
 
-    // MJPEG/snapshot: mirror frames
+    // MJPEG/snapshot: mirror frames, now at full resolution
     self.fullscreenImageView = imageView;
+    [self updateDecodePixelSize];
+    [self requestCameraSlot]; // fullscreen outranks every tile
+    if (!self.streamConsumer && !self.hlsPlayer) {
+        // The tile's copy is tile-sized: take the next one at full resolution
+        // even if it hasn't changed, and poll at the base rate while watched
+        [self.snapshotTracker reset];
+        [self fetchSnapshot];
+        [self updateRefreshInterval];
+    }
     HALogD(@"cam", @"Fullscreen opened for %@ — imageView=%p weak=%p streaming=%d hlsPlayer=%@",
           self.currentEntityId, imageView, self.fullscreenImageView,
-          self.streamParser.isStreaming, self.hlsPlayer ? @"YES" : @"NO");
+          self.streamConsumer.isStreaming, self.hlsPlayer ? @"YES" : @"NO");
 
     // Close button — top-right
     UIButton *closeButton = [UIButton buttonWithType:UIButtonTypeCustom];
@@ -530,6 +553,11 @@ static HACameraStreamMode currentStreamMode(void) {
 
 - (void)dismissFullscreenButton:(UIButton *)sender {
     self.fullscreenImageView = nil;
+    [self updateDecodePixelSize];
+    [self updateRefreshInterval];
+    if (self.window) {
+        [self requestCameraSlot];
+    }
     // Always re-mute when returning to grid view
     if (self.hlsPlayer) {
         self.hlsPlayer.volume = 0;
@@ -824,12 +852,29 @@ static HACameraStreamMode currentStreamMode(void) {
 - (void)layoutSubviews {
     [super layoutSubviews];
     [self layoutOverlayBar];
+    [self updateDecodePixelSize];
     // Keep HLS player layer frame in sync with snapshot view
     if (self.hlsPlayerLayer) {
         self.hlsPlayerLayer.frame = self.snapshotView.bounds;
     }
 }
 
+/// Pixels to decode camera images at: enough to fill the tile, or full
+/// resolution (CGSizeZero) while the fullscreen mirror is up or before
+/// the tile has been laid out.
+- (CGSize)decodePixelSize {
+    if (self.fullscreenImageView) return CGSizeZero;
+    CGSize size = self.snapshotView.bounds.size;
+    if (size.width <= 0 || size.height <= 0) return CGSizeZero;
+    CGFloat scale = self.window.screen.scale ?: [UIScreen mainScreen].scale;
+    return CGSizeMake(ceil(size.width * scale), ceil(size.height * scale));
+}
+
+- (void)updateDecodePixelSize {
+    if (!self.streamConsumer) return;
+    self.streamConsumer.pixelSize = [self decodePixelSize];
+}
+
 #pragma mark - Snapshot Fetching
 
 - (void)fetchSnapshot {
@@ -879,17 +924,23 @@ static HACameraStreamMode currentStreamMode(void) {
     [self.currentTask cancel];
 
     if (!self.snapshotView.image) {
+        // Nothing on screen to keep: the next image must be decoded
+        [self.snapshotTracker reset];
         [self.loadingSpinner startAnimating];
     }
+    [self.snapshotTracker applyToRequest:request];
 
     __weak typeof(self) weakSelf = self;
     NSString *expectedEntityId = [self.currentEntityId copy];
+    CGSize decodeSize = [self decodePixelSize];
+    HASnapshotChangeTracker *tracker = self.snapshotTracker;
     self.currentTask = [self.imageSession dataTaskWithRequest:request
         completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
             if (error && error.code == NSURLErrorCancelled) return;
 
             NSHTTPURLResponse *httpResponse = (NSHTTPURLResponse *)response;
-            BOOL fetchFailed = (error != nil) || (httpResponse.statusCode != 200) || !data;
+            BOOL notModified = (error == nil) && (httpResponse.statusCode == 304);
+            BOOL fetchFailed = !notModified && ((error != nil) || (httpResponse.statusCode != 200) || !data);
 
             if (fetchFailed) {
                 HALogE(@"cam", @"fetchSnapshot FAILED for %@: HTTP %ld, error=%@, dataLen=%lu",
@@ -913,17 +964,33 @@ static HACameraStreamMode currentStreamMode(void) {
                 return;
             }
 
-            // Force-decode JPEG on this background thread. UIImage imageWithData:
-            // creates a lazily-decoded image — actual pixel decode happens on first
-            // render (main thread). Drawing into a throwaway context forces immediate
-            // decode here, so the main thread just blits pre-decoded pixels.
-            UIImage *lazyImage = [UIImage imageWithData:data];
-            UIImage *image = nil;
-            if (lazyImage) {
-                UIGraphicsBeginImageContextWithOptions(lazyImage.size, YES, lazyImage.scale);
-                [lazyImage drawAtPoint:CGPointZero];
-                image = UIGraphicsGetImageFromCurrentImageContext();
-                UIGraphicsEndImageContext();
+            // Same picture as last time (304, or identical bytes): no decode,
+            // no redraw, and the poll interval backs off
+            if (![tracker recordResponse:httpResponse data:data]) {
+                [[HAPerfMonitor sharedMonitor] recordCameraBytes:data.length forEntityId:expectedEntityId];
+                HALogD(@"cam", @"fetchSnapshot: %@ unchanged (%lu in a row)",
+                      expectedEntityId, (unsigned long)tracker.unchangedStreak);
+                dispatch_async(dispatch_get_main_queue(), ^{
+                    __strong typeof(weakSelf) strongSelf = weakSelf;
+                    if (!strongSelf) return;
+                    if (![strongSelf.currentEntityId isEqualToString:expectedEntityId]) return;
+                    [strongSelf.loadingSpinner stopAnimating];
+                    strongSelf.consecutiveFailures = 0;
+                    strongSelf.errorLabel.hidden = YES;
+                    [strongSelf updateRefreshInterval];
+                });
+                return;
+            }
+
+            // Decode on this background thread, at tile size. UIImage imageWithData:
+            // would decode lazily on first render (main thread) and at the camera's
+            // full resolution; the main thread now just blits pre-decoded pixels.
+            HAPerfMonitor *perf = [HAPerfMonitor sharedMonitor];
+            [perf recordCameraBytes:data.length forEntityId:expectedEntityId];
+            CFTimeInterval decodeStart = CACurrentMediaTime();
+            UIImage *image = [HAImageDecoder decodedImageWithData:data fillingPixelSize:decodeSize];
+            if (image) {
+                [perf recordCameraDecodeMs:(CACurrentMediaTime() - decodeStart) * 1000.0 forEntityId:expectedEntityId];
             }
 
             dispatch_async(dispatch_get_main_queue(), ^{
@@ -932,6 +999,7 @@ static HACameraStreamMode currentStreamMode(void) {
                 if (![strongSelf.currentEntityId isEqualToString:expectedEntityId]) return;
                 [strongSelf.loadingSpinner stopAnimating];
                 if (image) {
+                    [perf recordCameraFrameForEntityId:expectedEntityId];
                     strongSelf.consecutiveFailures = 0;
                     strongSelf.snapshotView.image = image;
                     if (strongSelf.fullscreenImageView) {
@@ -940,6 +1008,7 @@ static HACameraStreamMode currentStreamMode(void) {
                     strongSelf.errorLabel.hidden = YES;
                     [strongSelf layoutOverlayBar];
                 }
+                [strongSelf updateRefreshInterval];
             });
         }];
     [self.currentTask resume];
@@ -969,16 +1038,15 @@ static HACameraStreamMode currentStreamMode(void) {
     HALogI(@"cam", @"Starting MJPEG stream: %@ (cell %p)", url, self);
     [self.loadingSpinner startAnimating];
 
-    self.streamParser = [[HAMJPEGStreamParser alloc] init];
     __weak typeof(self) weakSelf = self;
     NSString *expectedEntityId = [self.currentEntityId copy];
-    HAMJPEGStreamParser *expectedParser = self.streamParser;
+    __block __weak HACameraStreamConsumer *expectedConsumer = nil;
 
-    self.streamParser.frameHandler = ^(UIImage *frame) {
+    void (^frameHandler)(UIImage *) = ^(UIImage *frame) {
         __strong typeof(weakSelf) strongSelf = weakSelf;
         if (!strongSelf) return;
-        // Guard: reject frames from a stale parser (cell was reused for a different entity)
-        if (strongSelf.streamParser != expectedParser) return;
+        // Guard: reject frames from a stale consumer (cell was reused for a different entity)
+        if (!expectedConsumer || strongSelf.streamConsumer != expectedConsumer) return;
         if (![strongSelf.currentEntityId isEqualToString:expectedEntityId]) {
             HALogD(@"cam", @"Rejecting stale frame: expected %@ but cell is now %@ (cell %p)",
                   expectedEntityId, strongSelf.currentEntityId, strongSelf);
@@ -998,7 +1066,7 @@ static HACameraStreamMode currentStreamMode(void) {
         if (fsIV || strongSelf.frameCount % 30 == 1) {
             HALogD(@"cam", @"Frame %lu for %@ — fs=%p card=%p streaming=%d",
                   (unsigned long)strongSelf.frameCount, expectedEntityId,
-                  fsIV, strongSelf.snapshotView, strongSelf.streamParser.isStreaming);
+                  fsIV, strongSelf.snapshotView, strongSelf.streamConsumer.isStreaming);
         }
         [strongSelf.loadingSpinner stopAnimating];
         strongSelf.errorLabel.hidden = YES;
@@ -1032,18 +1100,26 @@ static HACameraStreamMode currentStreamMode(void) {
         }
     };
 
-    self.streamParser.errorHandler = ^(NSError *error) {
+    void (^errorHandler)(NSError *) = ^(NSError *error) {
         __strong typeof(weakSelf) strongSelf = weakSelf;
         if (!strongSelf) return;
-        if (strongSelf.streamParser != expectedParser) return;
+        if (!expectedConsumer || strongSelf.streamConsumer != expectedConsumer) return;
         HALogW(@"cam", @"MJPEG stream failed: %@ — attempting reconnect (cell %p)", error.localizedDescription, strongSelf);
-        strongSelf.streamParser = nil;
+        strongSelf.streamConsumer = nil;
         strongSelf.receivingFrames = NO;
         [strongSelf updateLiveBadge];
         [strongSelf attemptStreamReconnect];
     };
 
-    [self.streamParser startWithURL:url authToken:auth.accessToken];
+    // Another card (or this camera's previous cell) may already have it open
+    self.streamConsumer = [[HACameraStreamRegistry sharedRegistry] addConsumerForEntityId:self.entity.entityId
+                                                                                      url:url
+                                                                                authToken:auth.accessToken
+                                                                                pixelSize:[self decodePixelSize]
+                                                                             frameHandler:frameHandler
+                                                                             errorHandler:errorHandler];
+    expectedConsumer = self.streamConsumer;
+    [[HAPerfMonitor sharedMonitor] recordCameraMode:@"mjpeg" forEntityId:self.currentEntityId];
 }
 
 #pragma mark - HLS Streaming (AVPlayer)
@@ -1180,7 +1256,7 @@ static HACameraStreamMode currentStreamMode(void) {
                 [self stopHLSPlayer];
                 self.hlsFailed = YES;
                 // If MJPEG is still running in parallel, let it continue
-                if (self.streamParser.isStreaming) {
+                if (self.streamConsumer.isStreaming) {
                     HALogI(@"cam", @"HLS failed but MJPEG still active — keeping MJPEG");
                     return;
                 }
@@ -1208,13 +1284,14 @@ static HACameraStreamMode currentStreamMode(void) {
                     [self.snapshotView.layer insertSublayer:self.hlsPlayerLayer atIndex:0];
                 }
                 // Stop MJPEG if it was running in parallel
-                if (self.streamParser) {
+                if (self.streamConsumer) {
                     HALogI(@"cam", @"HLS confirmed — stopping parallel MJPEG for %@", self.currentEntityId);
-                    [self.streamParser stop];
-                    self.streamParser = nil;
+                    [self.streamConsumer cancel];
+                    self.streamConsumer = nil;
                 }
                 self.receivingFrames = YES;
                 self.hlsLive = YES;
+                [[HAPerfMonitor sharedMonitor] recordCameraMode:@"hls" forEntityId:self.currentEntityId];
                 self.lastFrameTime = [NSDate date];
                 self.reconnectAttempts = 0;
                 [self updateLiveBadge];
@@ -1230,7 +1307,7 @@ static HACameraStreamMode currentStreamMode(void) {
     [self stopHLSPlayer];
     self.hlsFailed = YES;
     // If MJPEG is still running in parallel, let it continue — don't reconnect
-    if (self.streamParser.isStreaming) {
+    if (self.streamConsumer.isStreaming) {
         HALogI(@"cam", @"HLS failed but MJPEG still active for %@ — keeping MJPEG", self.currentEntityId);
         return;
     }
@@ -1317,12 +1394,13 @@ static HACameraStreamMode currentStreamMode(void) {
             self.hlsPlayerLayer.frame = self.snapshotView.bounds;
             [self.snapshotView.layer insertSublayer:self.hlsPlayerLayer atIndex:0];
         }
-        if (self.streamParser) {
-            [self.streamParser stop];
-            self.streamParser = nil;
+        if (self.streamConsumer) {
+            [self.streamConsumer cancel];
+            self.streamConsumer = nil;
         }
         self.receivingFrames = YES;
         self.hlsLive = YES;
+        [[HAPerfMonitor sharedMonitor] recordCameraMode:@"hls" forEntityId:self.currentEntityId];
         self.lastFrameTime = [NSDate date];
         self.reconnectAttempts = 0;
         [self updateLiveBadge];
@@ -1368,12 +1446,16 @@ static HACameraStreamMode currentStreamMode(void) {
     }
 
     // Check MJPEG health: parser claims streaming but no frames recently
-    if (self.streamParser.isStreaming && self.lastFrameTime) {
+    if (self.streamConsumer.isStreaming && self.lastFrameTime) {
         NSTimeInterval age = -[self.lastFrameTime timeIntervalSinceNow];
         if (age > 30.0) {
             HALogW(@"cam", @"Health check: MJPEG stale for %@ (%.0fs since last frame) — reconnecting",
                   self.currentEntityId, age);
-            [self attemptStreamReconnect];
+            // The stream is shared: fail it for every consumer, and reconnect
+            // from our errorHandler like the others, rather than rejoining it
+            NSError *error = [NSError errorWithDomain:@"HAMJPEGStreamParser" code:-5
+                userInfo:@{NSLocalizedDescriptionKey: @"MJPEG stream stopped delivering frames"}];
+            [self.streamConsumer failStreamWithError:error];
         }
     }
 }
@@ -1392,8 +1474,8 @@ static HACameraStreamMode currentStreamMode(void) {
         HALogW(@"cam", @"Max reconnect attempts (%ld) for %@ — falling back to snapshot polling",
               (long)maxAttempts, self.currentEntityId);
         [self stopHLSPlayer];
-        [self.streamParser stop];
-        self.streamParser = nil;
+        [self.streamConsumer cancel];
+        self.streamConsumer = nil;
         self.receivingFrames = NO;
         [self updateLiveBadge];
         // Mark BOTH stream modes as failed so beginLoading falls through to snapshot polling
@@ -1417,8 +1499,8 @@ static HACameraStreamMode currentStreamMode(void) {
 
         // Tear down current stream
         [strongSelf stopHLSPlayer];
-        [strongSelf.streamParser stop];
-        strongSelf.streamParser = nil;
+        [strongSelf.streamConsumer cancel];
+        strongSelf.streamConsumer = nil;
         strongSelf.receivingFrames = NO;
         [strongSelf updateLiveBadge];
 
@@ -1461,17 +1543,65 @@ static HACameraStreamMode currentStreamMode(void) {
     }
 }
 
+#pragma mark - Fallbacks
+
+// Giving up a mode for a lesser one shows up in the perf log. iOS 9 never
+// tries HLS, so marking it failed there is not a fallback.
+- (void)setHlsFailed:(BOOL)hlsFailed {
+    if (hlsFailed && !_hlsFailed &&
+        [[[UIDevice currentDevice] systemVersion] compare:@"10.0" options:NSNumericSearch] != NSOrderedAscending) {
+        [[HAPerfMonitor sharedMonitor] recordCameraFallbackForEntityId:self.currentEntityId];
+    }
+    _hlsFailed = hlsFailed;
+}
+
+- (void)setStreamFailed:(BOOL)streamFailed {
+    if (streamFailed && !_streamFailed) {
+        [[HAPerfMonitor sharedMonitor] recordCameraFallbackForEntityId:self.currentEntityId];
+    }
+    _streamFailed = streamFailed;
+}
+
 #pragma mark - Refresh Timer
 
 - (void)startRefreshTimer {
     [self stopRefresh];
-    self.refreshTimer = [NSTimer scheduledTimerWithTimeInterval:kSnapshotRefreshInterval
+    [self scheduleRefreshTimer];
+    [[HAPerfMonitor sharedMonitor] recordCameraMode:@"snapshot" forEntityId:self.currentEntityId];
+}
+
+/// (Re)create just the polling timer, leaving any fetch or stream alone.
+- (void)scheduleRefreshTimer {
+    [self.refreshTimer invalidate];
+    self.refreshTimer = [NSTimer scheduledTimerWithTimeInterval:[self snapshotRefreshInterval]
                                                         target:self
                                                       selector:@selector(refreshTimerFired)
                                                       userInfo:nil
                                                        repeats:YES];
 }
 
+- (NSTimeInterval)snapshotRefreshInterval {
+    // Cameras that could stream but were downgraded by the budget poll slower
+    NSTimeInterval interval = kSnapshotRefreshInterval;
+    if (self.cameraSlot == HACameraSlotSnapshot && [self wantsLiveStream]) {
+        interval = [HACameraScheduler sharedScheduler].overflowSnapshotInterval;
+    }
+    // Someone is watching fullscreen: no backoff
+    if (self.fullscreenImageView) return interval;
+    // Static scenes back off (doubling per unchanged snapshot, capped)
+    return [self.snapshotTracker intervalForBaseInterval:interval];
+}
+
+/// Follow the tracker after each snapshot: back off while the picture
+/// holds still, snap back to the base rate as soon as it changes.
+- (void)updateRefreshInterval {
+    if (!self.refreshTimer) return;
+    NSTimeInterval interval = [self snapshotRefreshInterval];
+    if (fabs(interval - self.refreshTimer.timeInterval) < 0.01) return;
+    HALogD(@"cam", @"Snapshot interval for %@ → %.0fs", self.currentEntityId, interval);
+    [self scheduleRefreshTimer];
+}
+
 - (void)refreshTimerFired {
     // Self-invalidate when removed from window (matches healthCheckFired pattern).
     // Breaks the NSTimer → self retain cycle on section removal.
@@ -1480,15 +1610,225 @@ static HACameraStreamMode currentStreamMode(void) {
         self.refreshTimer = nil;
         return;
     }
-    [self fetchSnapshot];
+    [self fetchSnapshotWithinBudget];
 }
 
+/// Scheduled fetches share the scheduler's per-second budget; when it's
+/// spent, retry shortly instead of adding to the burst.
+- (void)fetchSnapshotWithinBudget {
+    // Nothing on screen yet: a snapshot prefetched as the tile approached
+    // stands in for the first fetch
+    if (!self.snapshotView.image && [self takePrefetchedSnapshot]) return;
+    if ([[HACameraScheduler sharedScheduler] acquireSnapshotToken]) {
+        [self fetchSnapshot];
+        return;
+    }
+    if (self.snapshotRetryScheduled) return;
+    self.snapshotRetryScheduled = YES;
+    __weak typeof(self) weakSelf = self;
+    NSString *expectedEntityId = [self.currentEntityId copy];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.25 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf) return;
+        strongSelf.snapshotRetryScheduled = NO;
+        if (![strongSelf.currentEntityId isEqualToString:expectedEntityId] || !strongSelf.window) return;
+        if (strongSelf.cameraSlot == HACameraSlotPaused) return;
+        [strongSelf fetchSnapshotWithinBudget];
+    });
+}
+
+#pragma mark - Snapshot Prefetch
+
+/// Prefetched snapshot bytes by entity ID, shared by every camera tile.
++ (HARequestCoalescer *)snapshotLoads {
+    static HARequestCoalescer *loads;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        loads = [[HARequestCoalescer alloc] initWithFreshness:kPrefetchedSnapshotFreshness];
+    });
+    return loads;
+}
+
++ (HARequestInterest *)prefetchSnapshotForEntity:(HAEntity *)entity completion:(void (^)(void))completion {
+    HARequestCoalescer *loads = [self snapshotLoads];
+    NSString *entityId = entity.entityId;
+    HAAuthManager *auth = [HAAuthManager sharedManager];
+    NSString *proxyPath = [entity cameraProxyPath];
+    NSURL *url = (entityId && proxyPath && auth.isConfigured)
+        ? [NSURL URLWithString:[NSString stringWithFormat:@"%@%@", auth.serverURL, proxyPath]] : nil;
+    // Demo cameras draw a placeholder; a spent budget means tiles are
+    // already fetching, so the prefetch just steps aside
+    BOOL isDemo = [HAAttrString(entity.attributes, @"entity_picture") hasPrefix:@"demo://"];
+    BOOL haveOne = [loads freshResultForKey:entityId] != nil || [loads isLoadingKey:entityId];
+    if (!url || isDemo || (!haveOne && ![[HACameraScheduler sharedScheduler] acquireSnapshotToken])) {
+        if (completion) dispatch_async(dispatch_get_main_queue(), completion);
+        return nil;
+    }
+
+    static NSURLSession *session;
+    static dispatch_once_t sessionOnce;
+    dispatch_once(&sessionOnce, ^{
+        // Same freshness rules as the tiles' own snapshot sessions
+        NSURLSessionConfiguration *config = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+        config.timeoutIntervalForRequest = 8.0;
+        config.requestCachePolicy = NSURLRequestReloadIgnoringLocalCacheData;
+        session = [NSURLSession sessionWithConfiguration:config];
+    });
+
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:url];
+    [request setValue:[NSString stringWithFormat:@"Bearer %@", auth.accessToken] forHTTPHeaderField:@"Authorization"];
+    return [loads loadKey:entityId start:^dispatch_block_t(HARequestFinishBlock finish) {
+        NSURLSessionDataTask *task = [session dataTaskWithRequest:request
+            completionHandler:^(NSData *data, NSURLResponse *response, NSError *error) {
+            NSInteger status = [response isKindOfClass:[NSHTTPURLResponse class]] ? ((NSHTTPURLResponse *)response).statusCode : 0;
+            if (error || status != 200 || data.length == 0) {
+                finish(nil, error);
+                return;
+            }
+            [[HAPerfMonitor sharedMonitor] recordCameraBytes:data.length forEntityId:entityId];
+            finish(data, nil);
+        }];
+        [task resume];
+        return ^{
+            [task cancel];
+        };
+    } completion:^(id result, NSError *error) {
+        if (completion) completion();
+    }];
+}
+
+/// Show a prefetched snapshot if there is a fresh one, or wait for one
+/// still loading. NO if there is neither and the tile should fetch.
+- (BOOL)takePrefetchedSnapshot {
+    NSString *entityId = self.currentEntityId;
+    if (!entityId) return NO;
+    HARequestCoalescer *loads = [HACameraEntityCell snapshotLoads];
+    NSData *data = [loads freshResultForKey:entityId];
+    if (data) {
+        [self showPrefetchedSnapshotData:data];
+        return YES;
+    }
+    if (self.prefetchInterest) return YES;
+
+    __weak typeof(self) weakSelf = self;
+    self.prefetchInterest = [loads joinKey:entityId completion:^(NSData *joined, NSError *error) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (!strongSelf || ![strongSelf.currentEntityId isEqualToString:entityId]) return;
+        strongSelf.prefetchInterest = nil;
+        if (joined) {
+            [strongSelf showPrefetchedSnapshotData:joined];
+        } else if (!strongSelf.snapshotView.image) {
+            [strongSelf fetchSnapshotWithinBudget];
+        }
+    }];
+    return self.prefetchInterest != nil;
+}
+
+/// Decode at tile size off the main thread, as fetchSnapshot does.
+- (void)showPrefetchedSnapshotData:(NSData *)data {
+    NSString *expectedEntityId = [self.currentEntityId copy];
+    CGSize decodeSize = [self decodePixelSize];
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        UIImage *image = [HAImageDecoder decodedImageWithData:data fillingPixelSize:decodeSize];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            __strong typeof(weakSelf) strongSelf = weakSelf;
+            if (!strongSelf || ![strongSelf.currentEntityId isEqualToString:expectedEntityId]) return;
+            if (!image) {
+                if (!strongSelf.snapshotView.image) [strongSelf fetchSnapshot];
+                return;
+            }
+            // A live frame may have beaten the decode
+            if (strongSelf.snapshotView.image) return;
+            [[HAPerfMonitor sharedMonitor] recordCameraFrameForEntityId:expectedEntityId];
+            [strongSelf.loadingSpinner stopAnimating];
+            strongSelf.snapshotView.image = image;
+            strongSelf.errorLabel.hidden = YES;
+            [strongSelf layoutOverlayBar];
+        });
+    });
+}
+
+#pragma mark - Camera Scheduling
+
+/// Slot priority: on-screen size, with the fullscreen mirror counting as the screen.
+- (CGFloat)scheduleArea {
+    CGSize size = self.fullscreenImageView ? self.fullscreenImageView.bounds.size : self.snapshotView.bounds.size;
+    if (size.width <= 0 || size.height <= 0) size = self.bounds.size;
+    return size.width * size.height;
+}
+
+/// Snapshot-only cameras don't take a live slot from ones that can stream.
+- (BOOL)wantsLiveStream {
+    return currentStreamMode() != HACameraStreamModeSnapshot && !(self.streamFailed && self.hlsFailed);
+}
+
+- (void)requestCameraSlot {
+    HACameraSlot slot = [[HACameraScheduler sharedScheduler] requestSlotForClient:self
+                                                                            area:[self scheduleArea]
+                                                                       wantsLive:[self wantsLiveStream]];
+    [self applyCameraSlot:slot];
+}
+
+- (void)releaseCameraSlot {
+    [[HACameraScheduler sharedScheduler] releaseSlotForClient:self];
+    self.cameraSlot = HACameraSlotPaused;
+}
+
+- (void)cameraScheduler:(HACameraScheduler *)scheduler didAssignSlot:(HACameraSlot)slot {
+    if (!self.currentEntityId) return;
+    HALogD(@"cam", @"Scheduler moved %@ to slot %ld", self.currentEntityId, (long)slot);
+    [self applyCameraSlot:slot];
+}
+
+- (void)applyCameraSlot:(HACameraSlot)slot {
+    HACameraSlot previous = self.cameraSlot;
+    self.cameraSlot = slot;
+
+    if (slot == HACameraSlotPaused) {
+        [self stopRefresh];
+        return;
+    }
+
+    if (slot == HACameraSlotSnapshot) {
+        // Downgraded: give the stream up to a larger or visible tile
+        if (self.streamConsumer || self.hlsPlayer || self.hlsRequestInFlight) {
+            [self stopRefresh];
+            [self updateLiveBadge];
+        }
+        // Timer first: starting it cancels any in-flight fetch
+        if (!self.refreshTimer || previous != HACameraSlotSnapshot) {
+            [self startRefreshTimer];
+        }
+        if (!self.snapshotView.image) {
+            self.needsSnapshotLoad = NO;
+            [self fetchSnapshotWithinBudget];
+        }
+        return;
+    }
+
+    // Promoted from snapshots: the live path restarts polling only if it can't stream
+    if (previous == HACameraSlotSnapshot) {
+        [self.refreshTimer invalidate];
+        self.refreshTimer = nil;
+    }
+    [self startLiveLoading];
+}
+
+#pragma mark - Loading
+
 - (void)beginLoading {
     if (!self.currentEntityId) return;
+    // The scheduler decides whether this tile streams, polls, or waits
+    [self requestCameraSlot];
+}
+
+- (void)startLiveLoading {
+    if (!self.currentEntityId) return;
 
     HALogD(@"cam", @"beginLoading %@ hlsPlayer=%d hlsReq=%d mjpeg=%d hlsFail=%d streamFail=%d",
               self.currentEntityId, self.hlsPlayer != nil, self.hlsRequestInFlight,
-              self.streamParser.isStreaming, self.hlsFailed, self.streamFailed);
+              self.streamConsumer.isStreaming, self.hlsFailed, self.streamFailed);
 
     // Already have HLS or requesting — don't restart anything
     if (self.hlsPlayer || self.hlsRequestInFlight) return;
@@ -1496,11 +1836,11 @@ static HACameraStreamMode currentStreamMode(void) {
     // 1. Snapshot immediately for fast initial display
     if (!self.snapshotView.image && self.needsSnapshotLoad) {
         self.needsSnapshotLoad = NO;
-        [self fetchSnapshot];
+        [self fetchSnapshotWithinBudget];
     }
 
     // Already have MJPEG — don't start another (HLS upgrade handled by wsDidConnect)
-    if (self.streamParser.isStreaming) return;
+    if (self.streamConsumer.isStreaming) return;
 
     HACameraStreamMode mode = currentStreamMode();
     BOOL entitySupportsStream = ([self.entity supportedFeatures] & 2) != 0;
@@ -1529,6 +1869,7 @@ static HACameraStreamMode currentStreamMode(void) {
 
 - (void)cancelLoading {
     [self stopRefresh];
+    [self releaseCameraSlot];
 }
 
 - (void)stopRefresh {
@@ -1538,8 +1879,10 @@ static HACameraStreamMode currentStreamMode(void) {
     self.healthCheckTimer = nil;
     [self.currentTask cancel];
     self.currentTask = nil;
-    [self.streamParser stop];
-    self.streamParser = nil;
+    [self.prefetchInterest cancel];
+    self.prefetchInterest = nil;
+    [self.streamConsumer cancel];
+    self.streamConsumer = nil;
     [self stopHLSPlayer];
     self.receivingFrames = NO;
     self.hlsLive = NO;
@@ -1554,6 +1897,8 @@ static HACameraStreamMode currentStreamMode(void) {
     if (!self.currentEntityId || !self.window) return;
     // Already on HLS — nothing to do
     if (self.hlsPlayer) return;
+    // Tiles the scheduler keeps on snapshots don't upgrade
+    if (self.cameraSlot != HACameraSlotLive) return;
 
     // WS reconnect clears HLS failure flag — allows fresh attempt.
     // But NOT on iOS 9 where HLS is permanently disabled.
@@ -1572,7 +1917,7 @@ static HACameraStreamMode currentStreamMode(void) {
     if (!shouldTryHLS) return;
 
     HALogI(@"cam", @"WS connected — attempting HLS upgrade for %@ (MJPEG streaming=%d)",
-          self.currentEntityId, self.streamParser.isStreaming);
+          self.currentEntityId, self.streamConsumer.isStreaming);
     // Don't stop MJPEG yet — let HLS start in parallel. Once HLS confirms
     // readyForDisplay, we'll stop MJPEG. If HLS fails, MJPEG continues uninterrupted.
     [self startHLSStream];
@@ -1589,6 +1934,7 @@ static HACameraStreamMode currentStreamMode(void) {
             return;
         }
         [self stopRefresh];
+        [self releaseCameraSlot];
     }
 }
 
@@ -1603,6 +1949,8 @@ static HACameraStreamMode currentStreamMode(void) {
     self.refreshTimer = nil;
     [self.currentTask cancel];
     self.currentTask = nil;
+    [self.prefetchInterest cancel];
+    self.prefetchInterest = nil;
     self.errorLabel.hidden = YES;
     self.errorLabel.text = nil;
     self.consecutiveFailures = 0;
@@ -1626,6 +1974,8 @@ static HACameraStreamMode currentStreamMode(void) {
 - (void)dealloc {
     [self.healthCheckTimer invalidate];
     [self stopRefresh];
+    // The scheduler's weak key is already gone; this hands a live slot on
+    [self releaseCameraSlot];
     [[NSNotificationCenter defaultCenter] removeObserver:self];
 }
 
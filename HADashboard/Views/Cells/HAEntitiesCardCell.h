@@ -18,6 +18,18 @@
 + (CGFloat)preferredHeightForSection:(HADashboardConfigSection *)section
                             entities:(NSDictionary *)entityDict;
 
+/// Entities that special rows in section's orderedRows read but that are
+/// not rows themselves: buttons rows' entities and conditional rows'
+/// condition and inner-row entities. Pass them in entityDict with the rest.
++ (NSArray<NSString *> *)orderedRowEntityIdsForSection:(HADashboardConfigSection *)section;
+
+/// Row views made ahead of time (at dashboard load, in idle time) for
+/// cells that need more rows than they have. Shared by all cells.
++ (NSUInteger)spareRowViewCount;
++ (void)addSpareRowView;
+/// On memory warnings, and theme changes (spares keep the colors they were made with).
++ (void)removeAllSpareRowViews;
+
 /// Called when an entity row is tapped (non-control area). Used to open entity detail.
 @property (nonatomic, copy) void(^entityTapBlock)(HAEntity *entity);
 
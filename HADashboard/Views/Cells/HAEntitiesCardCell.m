@@ -37,8 +37,56 @@ static const CGFloat kSceneChipRowHeight = 44.0; // chip height + padding
 @property (nonatomic, strong) NSLayoutConstraint *chipScrollHeight;
 @end
 
+static NSMutableArray<HAEntityRowView *> *ha_spareRowViews(void) {
+    static NSMutableArray *spares;
+    if (!spares) spares = [NSMutableArray array];
+    return spares;
+}
+
 @implementation HAEntitiesCardCell
 
++ (NSArray<NSString *> *)orderedRowEntityIdsForSection:(HADashboardConfigSection *)section {
+    NSArray *orderedRows = section.customProperties[@"orderedRows"];
+    if (![orderedRows isKindOfClass:[NSArray class]]) return @[];
+    NSMutableOrderedSet<NSString *> *ids = [NSMutableOrderedSet orderedSet];
+    void (^addId)(id) = ^(id entityId) {
+        if ([entityId isKindOfClass:[NSString class]]) [ids addObject:entityId];
+    };
+    for (NSDictionary *rowInfo in orderedRows) {
+        if (![rowInfo isKindOfClass:[NSDictionary class]]) continue;
+        NSString *rowType = rowInfo[@"row_type"];
+        if ([rowType isEqualToString:@"buttons"]) {
+            NSArray *entries = rowInfo[@"entities"];
+            if (![entries isKindOfClass:[NSArray class]]) continue;
+            for (id entry in entries) {
+                addId([entry isKindOfClass:[NSDictionary class]] ? entry[@"entity"] : entry);
+            }
+        } else if ([rowType isEqualToString:@"conditional"]) {
+            NSArray *conditions = rowInfo[@"conditions"];
+            if ([conditions isKindOfClass:[NSArray class]]) {
+                for (NSDictionary *cond in conditions) {
+                    if ([cond isKindOfClass:[NSDictionary class]]) addId(cond[@"entity"]);
+                }
+            }
+            NSDictionary *innerRow = rowInfo[@"row"];
+            if ([innerRow isKindOfClass:[NSDictionary class]]) addId(innerRow[@"entity"]);
+        }
+    }
+    return ids.array;
+}
+
++ (NSUInteger)spareRowViewCount {
+    return ha_spareRowViews().count;
+}
+
++ (void)addSpareRowView {
+    [ha_spareRowViews() addObject:[[HAEntityRowView alloc] initWithFrame:CGRectZero]];
+}
+
++ (void)removeAllSpareRowViews {
+    [ha_spareRowViews() removeAllObjects];
+}
+
 - (instancetype)initWithFrame:(CGRect)frame {
     self = [super initWithFrame:frame];
     if (self) {
@@ -335,9 +383,14 @@ static const CGFloat kSceneChipRowHeight = 44.0; // chip height + padding
     // Pool-based row view management: reuse hidden views instead of creating/destroying.
     // Each HAEntityRowView allocates 10+ subviews with 30+ constraints — expensive on iPad 2.
     NSInteger poolSize = (NSInteger)self.rowViews.count;
-    // Create only the deficit
+    // Create only the deficit, taking spares made at dashboard load first
     for (NSInteger i = poolSize; i < rowCount; i++) {
-        HAEntityRowView *rowView = [[HAEntityRowView alloc] initWithFrame:CGRectZero];
+        HAEntityRowView *rowView = ha_spareRowViews().lastObject;
+        if (rowView) {
+            [ha_spareRowViews() removeLastObject];
+        } else {
+            rowView = [[HAEntityRowView alloc] initWithFrame:CGRectZero];
+        }
         [self.rowViews addObject:rowView];
         [self.stackView addArrangedSubview:rowView];
     }
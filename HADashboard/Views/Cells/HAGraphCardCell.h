@@ -18,4 +18,13 @@
 
 + (CGFloat)preferredHeight;
 
+/// What beginLoading will fetch for a card configured from item and the
+/// section it reads (item.entitiesSection or its own): the graphed entity
+/// IDs, the "last N hours" window, and whether they load as timelines.
+/// Lets the dashboard prefetch the history before the cell exists.
++ (NSArray<NSString *> *)historyEntityIdsForItem:(HADashboardConfigItem *)item
+                                         section:(HADashboardConfigSection *)section
+                                       hoursBack:(NSInteger *)hours
+                                        timeline:(BOOL *)timeline;
+
 @end
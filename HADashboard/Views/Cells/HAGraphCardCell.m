@@ -11,6 +11,11 @@
 /// Default color palette for multi-entity graphs (matches HA web ordering)
 static NSArray<UIColor *> *sColorPalette;
 
+/// Composite cards graph every entity unless its config says show_graph: false.
+static BOOL ha_entityShowsGraph(NSDictionary *entityConfig) {
+    return entityConfig[@"show_graph"] ? [entityConfig[@"show_graph"] boolValue] : YES;
+}
+
 @interface HAGraphCardCell ()
 @property (nonatomic, strong) UILabel *iconLabel;
 @property (nonatomic, strong) UILabel *nameLabel;
@@ -267,12 +272,9 @@ static NSArray<UIColor *> *sColorPalette;
         NSString *eid = section.entityIds[i];
         NSDictionary *cfg = (i < entityConfigs.count) ? entityConfigs[i] : nil;
 
-        BOOL showGraph = YES; // default: show graph
+        BOOL showGraph = ha_entityShowsGraph(cfg);
         BOOL showState = NO;  // default: don't show state as secondary text
-        if (cfg) {
-            if (cfg[@"show_graph"]) showGraph = [cfg[@"show_graph"] boolValue];
-            if (cfg[@"show_state"]) showState = [cfg[@"show_state"] boolValue];
-        }
+        if (cfg[@"show_state"]) showState = [cfg[@"show_state"] boolValue];
 
         if (showGraph) {
             [graphEntityIds addObject:eid];
@@ -495,6 +497,40 @@ static NSArray<UIColor *> *sColorPalette;
     return [stateBasedDomains containsObject:domain];
 }
 
++ (NSArray<NSString *> *)historyEntityIdsForItem:(HADashboardConfigItem *)item
+                                         section:(HADashboardConfigSection *)section
+                                       hoursBack:(NSInteger *)hours
+                                        timeline:(BOOL *)timeline {
+    NSMutableArray<NSString *> *entityIds = [NSMutableArray array];
+    NSInteger hoursBack = 24;
+    if (section.entityIds.count > 0) {
+        // Same selection as configureWithSection:entities:
+        NSArray *entityConfigs = section.customProperties[@"entityConfigs"];
+        for (NSUInteger i = 0; i < section.entityIds.count; i++) {
+            NSDictionary *cfg = (i < entityConfigs.count) ? entityConfigs[i] : nil;
+            if (ha_entityShowsGraph(cfg)) [entityIds addObject:section.entityIds[i]];
+        }
+        if (entityIds.count == 0) [entityIds addObject:section.entityIds.firstObject];
+        NSNumber *configHours = section.customProperties[@"hours_to_show"];
+        if ([configHours isKindOfClass:[NSNumber class]] && [configHours integerValue] > 0) {
+            hoursBack = [configHours integerValue];
+        }
+    } else if (item.entityId) {
+        [entityIds addObject:item.entityId];
+    }
+
+    BOOL allStateBased = (entityIds.count > 0);
+    for (NSString *eid in entityIds) {
+        if (![HAGraphCardCell isStateBasedDomain:eid]) {
+            allStateBased = NO;
+            break;
+        }
+    }
+    if (hours) *hours = hoursBack;
+    if (timeline) *timeline = allStateBased;
+    return entityIds;
+}
+
 #pragma mark - Deferred Loading
 
 - (void)beginLoading {
@@ -522,9 +558,23 @@ static NSArray<UIColor *> *sColorPalette;
 
     __weak typeof(self) weakSelf = self;
     NSString *capturedEntityId = [entityId copy];
-    [[HAHistoryManager sharedManager] fetchHistoryForEntityId:entityId
-                                                   hoursBack:hours
-                                                  completion:^(NSArray *points, NSError *error) {
+    HAHistoryManager *mgr = [HAHistoryManager sharedManager];
+
+    // Paint last session's series from disk while the fetch catches up
+    __block BOOL fetched = NO;
+    [mgr cachedHistoryForEntityId:entityId hoursBack:hours completion:^(NSArray *points) {
+        __strong typeof(weakSelf) strongSelf = weakSelf;
+        if (fetched || !strongSelf || ![strongSelf.currentEntityId isEqualToString:capturedEntityId]) return;
+        if (points.count > 0) {
+            strongSelf.graphView.dataPoints = points;
+            [strongSelf updateStatsFromPoints:points];
+        }
+    }];
+
+    [mgr fetchHistoryForEntityId:entityId
+                       hoursBack:hours
+                      completion:^(NSArray *points, NSError *error) {
+        fetched = YES;
         __strong typeof(weakSelf) strongSelf = weakSelf;
         if (!strongSelf || ![strongSelf.currentEntityId isEqualToString:capturedEntityId]) return;
         if (points.count > 0) {
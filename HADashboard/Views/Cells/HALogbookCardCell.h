@@ -14,6 +14,14 @@
 /// Begin loading logbook data (called from willDisplayCell).
 - (void)beginLoading;
 
+/// hours_to_show from the card config (24 by default).
++ (NSInteger)hoursToShowForConfigItem:(HADashboardConfigItem *)configItem;
+
+/// Entities the card's entries are filtered to: the config's entities
+/// list, else the section's. Empty means all recent entries.
++ (NSArray<NSString *> *)entityFilterForSection:(HADashboardConfigSection *)section
+                                     configItem:(HADashboardConfigItem *)configItem;
+
 /// Preferred height for the logbook card.
 + (CGFloat)preferredHeightForHours:(NSInteger)hours;
 
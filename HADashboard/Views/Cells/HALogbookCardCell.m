@@ -84,13 +84,28 @@ static const NSInteger kMaxEntries = 10;
     }
     self.titleLabel.text = title ?: @"Logbook";
 
-    self.hoursToShow = 24;
-    if ([props[@"hours_to_show"] isKindOfClass:[NSNumber class]]) {
-        self.hoursToShow = [props[@"hours_to_show"] integerValue];
+    self.hoursToShow = [HALogbookCardCell hoursToShowForConfigItem:configItem];
+    self.entityFilter = [HALogbookCardCell entityFilterForSection:section configItem:configItem];
+
+    self.loaded = NO;
+
+    // Clear previous entries
+    for (UIView *v in [self.entryStack.arrangedSubviews copy]) {
+        [self.entryStack removeArrangedSubview:v];
+        [v removeFromSuperview];
     }
+    self.emptyLabel.hidden = YES;
+}
+
++ (NSInteger)hoursToShowForConfigItem:(HADashboardConfigItem *)configItem {
+    id hours = configItem.customProperties[@"hours_to_show"];
+    return [hours isKindOfClass:[NSNumber class]] ? [hours integerValue] : 24;
+}
 
++ (NSArray<NSString *> *)entityFilterForSection:(HADashboardConfigSection *)section
+                                     configItem:(HADashboardConfigItem *)configItem {
     // Entity filter: config entities array > section entityIds
-    NSArray *configEntities = props[@"entities"];
+    NSArray *configEntities = configItem.customProperties[@"entities"];
     if ([configEntities isKindOfClass:[NSArray class]] && configEntities.count > 0) {
         // Logbook card entities can be strings or dicts with "entity" key
         NSMutableArray *ids = [NSMutableArray array];
@@ -101,19 +116,9 @@ static const NSInteger kMaxEntries = 10;
                 [ids addObject:item[@"entity"]];
             }
         }
-        self.entityFilter = ids;
-    } else {
-        self.entityFilter = section.entityIds;
-    }
-
-    self.loaded = NO;
-
-    // Clear previous entries
-    for (UIView *v in [self.entryStack.arrangedSubviews copy]) {
-        [self.entryStack removeArrangedSubview:v];
-        [v removeFromSuperview];
+        return ids;
     }
-    self.emptyLabel.hidden = YES;
+    return section.entityIds;
 }
 
 - (void)beginLoading {
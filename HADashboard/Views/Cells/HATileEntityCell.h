@@ -1,6 +1,7 @@
 #import "HABaseEntityCell.h"
 
 @class HADashboardConfigItem;
+@class HACellViewModel;
 
 /// Tile card: large centered icon with entity name, tap to toggle.
 /// Used for cover, switch, light, scene, script entities in tile card layout.
@@ -23,4 +24,10 @@
 /// block and body taps go through collection view selection.
 @property (nonatomic, copy) void(^iconTapBlock)(void);
 
+/// Entity-state update for a tile whose config hasn't changed: applies
+/// the properties of viewModel that differ from what is shown and
+/// refreshes the tile features. entity is the live entity viewModel was
+/// built from (or from a copy of).
+- (void)updateWithViewModel:(HACellViewModel *)viewModel entity:(HAEntity *)entity;
+
 @end
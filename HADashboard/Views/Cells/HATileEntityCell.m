@@ -6,7 +6,7 @@
 #import "HATheme.h"
 #import "HAHaptics.h"
 #import "HAIconMapper.h"
-#import "HAEntityDisplayHelper.h"
+#import "HACellViewModel.h"
 #import "HATileFeatureView.h"
 #import "HATileFeatureFactory.h"
 
@@ -28,6 +28,8 @@
 @property (nonatomic, strong) UIStackView *featuresStack;
 @property (nonatomic, strong) NSArray<HATileFeatureView *> *featureViews;
 @property (nonatomic, strong) NSLayoutConstraint *featuresTopConstraint;
+/// What the labels currently show, so updates only touch what changed
+@property (nonatomic, strong) HACellViewModel *viewModel;
 @end
 
 @implementation HATileEntityCell
@@ -261,197 +263,12 @@
         }
     }
 
-    NSString *name = [HAEntityDisplayHelper displayNameForEntity:entity configItem:configItem nameOverride:nil];
-    self.tileNameLabel.text = name;
-
-    // Attribute override: show a specific attribute value instead of state
-    NSString *attributeOverride = configItem.customProperties[@"attribute"];
-    NSString *displayState;
-    if (attributeOverride.length > 0) {
-        id attrVal = entity.attributes[attributeOverride];
-        displayState = (attrVal && attrVal != [NSNull null]) ? [NSString stringWithFormat:@"%@", attrVal] : @"—";
-    } else {
-        // State: formatted state with human-readable text + unit
-        NSString *formattedState = [HAEntityDisplayHelper formattedStateForEntity:entity decimals:2];
-        displayState = [HAEntityDisplayHelper humanReadableState:formattedState];
-        NSString *unit = entity.unitOfMeasurement;
-        // Append unit unless binary_sensor or duration (already includes units)
-        if (unit.length > 0 &&
-            ![[entity domain] isEqualToString:@"binary_sensor"] &&
-            ![unit isEqualToString:@"h"] && ![unit isEqualToString:@"min"] &&
-            ![unit isEqualToString:@"s"] && ![unit isEqualToString:@"d"]) {
-            displayState = [NSString stringWithFormat:@"%@ %@", displayState, unit];
-        }
-    }
-
-    // Domain-specific secondary detail (e.g. "71%", "Open · 70%", "Heat · 22°C")
-    // Skip domain overrides when attribute override is active
-    NSString *domain = [entity domain];
-    if (attributeOverride.length > 0) {
-        // attribute override — skip domain-specific formatting
-    } else if ([domain isEqualToString:@"light"]) {
-        if ([entity isOn]) {
-            NSInteger pct = [entity brightnessPercent];
-            if (pct > 0) {
-                displayState = [NSString stringWithFormat:@"%ld%%", (long)pct];
-            }
-        }
-    } else if ([domain isEqualToString:@"humidifier"]) {
-        NSNumber *targetHumidity = [entity humidifierTargetHumidity];
-        if (targetHumidity) {
-            displayState = [NSString stringWithFormat:@"%@ · %@%%", displayState, targetHumidity];
-        }
-    } else if ([domain isEqualToString:@"cover"]) {
-        NSInteger pos = [entity coverPosition];
-        // coverPosition returns 0 as default; check if attribute actually exists
-        if (HAAttrNumber(entity.attributes, HAAttrCurrentPosition)) {
-            displayState = [NSString stringWithFormat:@"%@ · %ld%%", displayState, (long)pos];
-        }
-    } else if ([domain isEqualToString:@"climate"]) {
-        // Format HVAC mode with "/" separator: "heat_cool" → "Heat/Cool"
-        NSString *hvacMode = entity.state;
-        NSString *formattedMode = [[hvacMode stringByReplacingOccurrencesOfString:@"_" withString:@"/"] capitalizedString];
-        displayState = formattedMode;
-        NSNumber *targetTemp = [entity targetTemperature];
-        if (targetTemp) {
-            NSString *tempUnit = [entity weatherTemperatureUnit];
-            if (!tempUnit || tempUnit.length == 0) {
-                tempUnit = @"°C";
-            }
-            displayState = [NSString stringWithFormat:@"%@ · %@%@", displayState, targetTemp, tempUnit];
-        }
-    } else if ([domain isEqualToString:@"fan"]) {
-        if ([entity isOn]) {
-            NSInteger pct = [entity fanSpeedPercent];
-            if (pct > 0) {
-                displayState = [NSString stringWithFormat:@"%ld%%", (long)pct];
-            }
-        }
-    } else if ([domain isEqualToString:@"media_player"]) {
-        NSString *title = [entity mediaTitle];
-        NSString *artist = [entity mediaArtist];
-        if (title.length > 0 && artist.length > 0) {
-            displayState = [NSString stringWithFormat:@"%@ · %@", artist, title];
-        } else if (title.length > 0) {
-            displayState = title;
-        }
-    }
-
-    // state_content override: display last_changed, last_updated, or attribute values
-    id stateContent = configItem.customProperties[@"state_content"];
-    if (stateContent) {
-        NSArray *contentItems = [stateContent isKindOfClass:[NSArray class]]
-            ? (NSArray *)stateContent
-            : @[stateContent];
-        NSMutableArray *parts = [NSMutableArray arrayWithCapacity:contentItems.count];
-        for (id item in contentItems) {
-            NSString *key = [item isKindOfClass:[NSString class]] ? (NSString *)item : nil;
-            if (!key) continue;
-            NSString *value = nil;
-            if ([key isEqualToString:@"last_changed"] || [key isEqualToString:@"last-changed"]) {
-                value = [HAEntityDisplayHelper relativeTimeFromISO8601:entity.lastChanged];
-            } else if ([key isEqualToString:@"last_updated"] || [key isEqualToString:@"last-updated"]) {
-                value = [HAEntityDisplayHelper relativeTimeFromISO8601:entity.lastUpdated];
-            } else if ([key isEqualToString:@"state"]) {
-                value = displayState;
-            } else {
-                // Attribute name lookup
-                id attrVal = entity.attributes[key];
-                if (attrVal && attrVal != [NSNull null]) {
-                    value = [NSString stringWithFormat:@"%@", attrVal];
-                }
-            }
-            if (value.length > 0) [parts addObject:value];
-        }
-        if (parts.count > 0) {
-            displayState = [parts componentsJoinedByString:@" · "];
-        }
-    }
-
-    // Respect show_state / show_name / show_icon from card config.
-    // HA button card defaults: show_name=YES, show_icon=YES, show_state=NO.
-    // HA tile card defaults: show_name=YES, show_icon=YES, show_state=YES.
-    NSDictionary *props = configItem.customProperties;
-    BOOL isButtonCard = [configItem.cardType isEqualToString:@"button"];
-    BOOL defaultShowState = !isButtonCard; // button cards hide state by default
-    BOOL hideState = [props[@"hide_state"] boolValue]; // tile-specific hide_state field
-    BOOL showState = hideState ? NO : (props[@"show_state"] ? [props[@"show_state"] boolValue] : defaultShowState);
-    BOOL showName  = props[@"show_name"]  ? [props[@"show_name"] boolValue]  : YES;
-    BOOL showIcon  = props[@"show_icon"]  ? [props[@"show_icon"] boolValue]  : YES;
-    self.tileStateLabel.text = showState ? displayState : nil;
-    self.tileStateLabel.hidden = !showState;
-    self.tileNameLabel.hidden = !showName;
-    self.tileIconLabel.hidden = !showIcon;
-
-    // Icon: from card config override, else centralized entity icon resolution
-    NSString *iconName = configItem.customProperties[@"icon"];
-    NSString *glyph = nil;
-    if (iconName) {
-        if ([iconName hasPrefix:@"mdi:"]) iconName = [iconName substringFromIndex:4];
-        glyph = [HAIconMapper glyphForIconName:iconName];
-    }
-    if (!glyph) glyph = [HAEntityDisplayHelper iconGlyphForEntity:entity];
-    self.tileIconLabel.text = glyph ?: @"?";
-
-    // Entity picture: show circular image instead of icon when configured
-    [self.pictureTask cancel];
-    BOOL showEntityPicture = [configItem.customProperties[@"show_entity_picture"] boolValue];
-    NSString *entityPicture = entity.attributes[@"entity_picture"];
-    if (showEntityPicture && entityPicture.length > 0) {
-        self.tileIconLabel.hidden = YES;
-        if (!self.entityPictureView) {
-            self.entityPictureView = [[UIImageView alloc] init];
-            self.entityPictureView.translatesAutoresizingMaskIntoConstraints = NO;
-            self.entityPictureView.contentMode = UIViewContentModeScaleAspectFill;
-            self.entityPictureView.clipsToBounds = YES;
-            self.entityPictureView.layer.cornerRadius = 16;
-            [self.contentView addSubview:self.entityPictureView];
-            [NSLayoutConstraint activateConstraints:@[
-                [self.entityPictureView.leadingAnchor constraintEqualToAnchor:self.contentView.leadingAnchor constant:12],
-                [self.entityPictureView.centerYAnchor constraintEqualToAnchor:self.contentView.topAnchor constant:36],
-                [self.entityPictureView.widthAnchor constraintEqualToConstant:32],
-                [self.entityPictureView.heightAnchor constraintEqualToConstant:32],
-            ]];
-        }
-        self.entityPictureView.hidden = NO;
-        self.entityPictureView.image = nil;
-        // Build full URL from HA server base + entity_picture path
-        NSString *serverURL = [[HAAuthManager sharedManager] serverURL];
-        if (serverURL && [entityPicture hasPrefix:@"/"]) {
-            NSURL *url = [NSURL URLWithString:[serverURL stringByAppendingString:entityPicture]];
-            NSMutableURLRequest *req = [NSMutableURLRequest requestWithURL:url];
-            NSString *token = [[HAAuthManager sharedManager] accessToken];
-            if (token) [req setValue:[NSString stringWithFormat:@"Bearer %@", token] forHTTPHeaderField:@"Authorization"];
-            __weak typeof(self) weakSelf = self;
-            self.pictureTask = [[NSURLSession sharedSession] dataTaskWithRequest:req completionHandler:^(NSData *data, NSURLResponse *resp, NSError *err) {
-                if (!data) return;
-                UIImage *img = [UIImage imageWithData:data];
-                if (!img) return;
-                dispatch_async(dispatch_get_main_queue(), ^{
-                    __strong typeof(weakSelf) strongSelf = weakSelf;
-                    if (strongSelf) strongSelf.entityPictureView.image = img;
-                });
-            }];
-            [self.pictureTask resume];
-        }
-    } else {
-        self.entityPictureView.hidden = YES;
-    }
-
-    // Color: domain+state-aware icon color from centralized helper
-    UIColor *iconColor = [HAEntityDisplayHelper iconColorForEntity:entity];
-    self.tileIconLabel.textColor = iconColor;
-    // State label matches icon color when entity is active, secondary otherwise
-    BOOL isActive = [entity isOn] ||
-                    [entity.state isEqualToString:@"open"] ||
-                    [entity.state isEqualToString:@"opening"] ||
-                    [entity.state isEqualToString:@"locked"] ||
-                    [entity.state isEqualToString:@"playing"] ||
-                    [entity.state hasPrefix:@"armed"];
-    self.tileStateLabel.textColor = isActive ? iconColor : [HATheme secondaryTextColor];
-
     self.contentView.backgroundColor = [HATheme cellBackgroundColor];
 
+    // Everything derived from entity state; a fresh configure applies all of it
+    self.viewModel = nil;
+    [self applyViewModel:[HACellViewModel tileViewModelForEntity:entity configItem:configItem]];
+
     // --- Tile Features ---
     // Clear previous feature views
     for (UIView *v in self.featuresStack.arrangedSubviews) {
@@ -489,6 +306,79 @@
     }
 }
 
+- (void)updateWithViewModel:(HACellViewModel *)viewModel entity:(HAEntity *)entity {
+    self.entity = entity;
+    [self applyViewModel:viewModel];
+    for (HATileFeatureView *featureView in self.featureViews) {
+        [featureView updateWithEntity:entity];
+    }
+}
+
+/// Set only what differs from the view model currently shown.
+- (void)applyViewModel:(HACellViewModel *)viewModel {
+    HACellViewModel *old = self.viewModel;
+    if ([old isEqualToViewModel:viewModel]) return;
+    self.viewModel = viewModel;
+
+    if (!old || old.contentAlpha != viewModel.contentAlpha) self.contentView.alpha = viewModel.contentAlpha;
+    if (!old || ![old.name isEqualToString:viewModel.name]) self.tileNameLabel.text = viewModel.name;
+    if (!old || old.showsName != viewModel.showsName) self.tileNameLabel.hidden = !viewModel.showsName;
+    if (!old || !(old.stateText == viewModel.stateText || [old.stateText isEqualToString:viewModel.stateText])) {
+        self.tileStateLabel.text = viewModel.stateText;
+    }
+    if (!old || old.showsState != viewModel.showsState) self.tileStateLabel.hidden = !viewModel.showsState;
+    if (!old || ![old.iconGlyph isEqualToString:viewModel.iconGlyph]) self.tileIconLabel.text = viewModel.iconGlyph;
+    if (!old || ![old.iconColor isEqual:viewModel.iconColor]) self.tileIconLabel.textColor = viewModel.iconColor;
+    if (!old || ![old.stateColor isEqual:viewModel.stateColor]) self.tileStateLabel.textColor = viewModel.stateColor;
+
+    NSString *picturePath = viewModel.entityPicturePath;
+    self.tileIconLabel.hidden = !viewModel.showsIcon || picturePath != nil;
+    if (old && (old.entityPicturePath == picturePath || [old.entityPicturePath isEqualToString:picturePath])) return;
+
+    // Entity picture: show circular image instead of icon when configured
+    [self.pictureTask cancel];
+    self.pictureTask = nil;
+    if (!picturePath) {
+        self.entityPictureView.hidden = YES;
+        return;
+    }
+    if (!self.entityPictureView) {
+        self.entityPictureView = [[UIImageView alloc] init];
+        self.entityPictureView.translatesAutoresizingMaskIntoConstraints = NO;
+        self.entityPictureView.contentMode = UIViewContentModeScaleAspectFill;
+        self.entityPictureView.clipsToBounds = YES;
+        self.entityPictureView.layer.cornerRadius = 16;
+        [self.contentView addSubview:self.entityPictureView];
+        [NSLayoutConstraint activateConstraints:@[
+            [self.entityPictureView.leadingAnchor constraintEqualToAnchor:self.contentView.leadingAnchor constant:12],
+            [self.entityPictureView.centerYAnchor constraintEqualToAnchor:self.contentView.topAnchor constant:36],
+            [self.entityPictureView.widthAnchor constraintEqualToConstant:32],
+            [self.entityPictureView.heightAnchor constraintEqualToConstant:32],
+        ]];
+    }
+    self.entityPictureView.hidden = NO;
+    self.entityPictureView.image = nil;
+    // Build full URL from HA server base + entity_picture path
+    NSString *serverURL = [[HAAuthManager sharedManager] serverURL];
+    if (serverURL && [picturePath hasPrefix:@"/"]) {
+        NSURL *url = [NSURL URLWithString:[serverURL stringByAppendingString:picturePath]];
+        NSMutableURLRequest *req = [NSMutableURLRequest requestWithURL:url];
+        NSString *token = [[HAAuthManager sharedManager] accessToken];
+        if (token) [req setValue:[NSString stringWithFormat:@"Bearer %@", token] forHTTPHeaderField:@"Authorization"];
+        __weak typeof(self) weakSelf = self;
+        self.pictureTask = [[NSURLSession sharedSession] dataTaskWithRequest:req completionHandler:^(NSData *data, NSURLResponse *resp, NSError *err) {
+            if (!data) return;
+            UIImage *img = [UIImage imageWithData:data];
+            if (!img) return;
+            dispatch_async(dispatch_get_main_queue(), ^{
+                __strong typeof(weakSelf) strongSelf = weakSelf;
+                if (strongSelf) strongSelf.entityPictureView.image = img;
+            });
+        }];
+        [self.pictureTask resume];
+    }
+}
+
 - (void)tileLongPressed:(UILongPressGestureRecognizer *)gesture {
     if (gesture.state != UIGestureRecognizerStateBegan) return;
     if (!self.entity || !self.entity.isAvailable) return;
@@ -535,6 +425,7 @@
     self.tileIconLabel.hidden = NO;
     self.tileNameLabel.hidden = NO;
     self.tileStateLabel.hidden = NO;
+    self.viewModel = nil;
     // Force reset to normal mode — set flags to YES first so the guards
     // in apply*Mode: don't short-circuit when already NO.
     self.isVertical = YES;
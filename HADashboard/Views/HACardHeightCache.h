@@ -0,0 +1,29 @@
+#import <UIKit/UIKit.h>
+
+@class HADashboardConfigItem;
+@class HADashboardConfigSection;
+
+/// Memoized card heights for the dashboard layouts. An entry belongs to
+/// the item's content (and its section's header, for cards that read it),
+/// found via the item's diffIdentity, and stays valid while the width, the theme
+/// and the versions of the entities the height reads are all unchanged,
+/// so rebuilt configs and state updates that don't touch those hit the
+/// cache. Main thread only.
+@interface HACardHeightCache : NSObject
+
+/// The cached height, or compute's result (stored) if anything differs.
+/// section is the containing section if compute reads it, else nil.
+/// entityIds are the entities compute reads; their HAEntity versions are
+/// checked on every lookup.
+- (CGFloat)heightForItem:(HADashboardConfigItem *)item
+                 section:(HADashboardConfigSection *)section
+                   width:(CGFloat)width
+               entityIds:(NSArray<NSString *> *)entityIds
+              computedBy:(CGFloat (^)(void))compute;
+
+- (void)removeAllHeights;
+
+@property (nonatomic, readonly) NSUInteger hitCount;
+@property (nonatomic, readonly) NSUInteger missCount;
+
+@end
@@ -0,0 +1,117 @@
+#import "HACardHeightCache.h"
+#import "HADashboardConfig.h"
+#import "HAConnectionManager.h"
+#import "HAEntity.h"
+#import "HATheme.h"
+
+/// Caps entries across view switches; a dashboard view has far fewer cards
+static const NSUInteger kMaxEntries = 2000;
+
+@interface HACardHeightEntry : NSObject
+@property (nonatomic, strong) HADashboardConfigItem *item; // content the height was computed for
+@property (nonatomic, strong) HADashboardConfigSection *section;
+@property (nonatomic, assign) CGFloat width;
+@property (nonatomic, assign) NSInteger themeKey;
+@property (nonatomic, copy) NSArray<NSString *> *entityIds;
+@property (nonatomic, strong) NSArray<NSNumber *> *entityVersions; // NSNotFound for missing entities
+@property (nonatomic, assign) CGFloat height;
+@end
+
+@implementation HACardHeightEntry
+@end
+
+@interface HACardHeightCache ()
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray<HACardHeightEntry *> *> *entries; // by diffIdentity
+@property (nonatomic, assign) NSUInteger entryCount;
+@property (nonatomic, assign, readwrite) NSUInteger hitCount;
+@property (nonatomic, assign, readwrite) NSUInteger missCount;
+@end
+
+@implementation HACardHeightCache
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _entries = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+- (NSArray<NSNumber *> *)versionsForEntityIds:(NSArray<NSString *> *)entityIds {
+    HAConnectionManager *conn = [HAConnectionManager sharedManager];
+    NSMutableArray<NSNumber *> *versions = [NSMutableArray arrayWithCapacity:entityIds.count];
+    for (NSString *entityId in entityIds) {
+        HAEntity *entity = [conn entityForId:entityId];
+        [versions addObject:@(entity ? entity.version : NSNotFound)];
+    }
+    return versions;
+}
+
+/// The entry for this item's content and section header, if any. A
+/// rebuilt config has new item objects; same content is as good.
+- (HACardHeightEntry *)entryInBucket:(NSArray<HACardHeightEntry *> *)bucket
+                             forItem:(HADashboardConfigItem *)item
+                             section:(HADashboardConfigSection *)section {
+    for (HACardHeightEntry *entry in bucket) {
+        if (entry.item != item && ![entry.item isContentEqualToItem:item]) continue;
+        if (entry.section != section &&
+            (!entry.section || !section || ![entry.section isHeaderEqualToSection:section])) continue;
+        entry.item = item;
+        entry.section = section;
+        return entry;
+    }
+    return nil;
+}
+
+- (BOOL)entry:(HACardHeightEntry *)entry isValidForWidth:(CGFloat)width themeKey:(NSInteger)themeKey
+    entityIds:(NSArray<NSString *> *)entityIds {
+    if (entry.width != width || entry.themeKey != themeKey) return NO;
+    if (![entry.entityIds isEqualToArray:entityIds]) return NO;
+    return [entry.entityVersions isEqualToArray:[self versionsForEntityIds:entityIds]];
+}
+
+- (CGFloat)heightForItem:(HADashboardConfigItem *)item
+                 section:(HADashboardConfigSection *)section
+                   width:(CGFloat)width
+               entityIds:(NSArray<NSString *> *)entityIds
+              computedBy:(CGFloat (^)(void))compute {
+    if (!item) return compute();
+    entityIds = entityIds ?: @[];
+    // Identities repeat (every markdown card is "markdown|||"), so an
+    // identity holds one entry per distinct content
+    NSString *key = [item diffIdentity];
+    NSInteger themeKey = [HATheme appearanceKey];
+    HACardHeightEntry *entry = [self entryInBucket:self.entries[key] forItem:item section:section];
+    if (entry && [self entry:entry isValidForWidth:width themeKey:themeKey entityIds:entityIds]) {
+        self.hitCount++;
+        return entry.height;
+    }
+
+    self.missCount++;
+    if (!entry) {
+        if (self.entryCount >= kMaxEntries) [self removeAllHeights];
+        entry = [[HACardHeightEntry alloc] init];
+        NSMutableArray<HACardHeightEntry *> *bucket = self.entries[key];
+        if (!bucket) {
+            bucket = [NSMutableArray arrayWithCapacity:1];
+            self.entries[key] = bucket;
+        }
+        [bucket addObject:entry];
+        self.entryCount++;
+    }
+    entry.item = item;
+    entry.section = section;
+    entry.width = width;
+    entry.themeKey = themeKey;
+    entry.entityIds = entityIds;
+    entry.entityVersions = [self versionsForEntityIds:entityIds];
+    entry.height = compute();
+    return entry.height;
+}
+
+- (void)removeAllHeights {
+    [self.entries removeAllObjects];
+    self.entryCount = 0;
+}
+
+@end
@@ -0,0 +1,34 @@
+#import <Foundation/Foundation.h>
+
+@class HARequestInterest;
+
+/// Starts one card's prefetch. Call done (on main) when its loads have
+/// finished; return the interests to cancel if it is withdrawn first.
+typedef NSArray<HARequestInterest *> *(^HACardPrefetchStartBlock)(dispatch_block_t done);
+
+/// Runs the network loads for cards about to scroll into view, a few at a
+/// time so they don't crowd out the cells already on screen. Prefetches
+/// start in the order they were asked for (the collection view asks
+/// nearest first). Withdrawing one that hasn't started just drops it; one
+/// that is running has its interests cancelled, which cancels the request
+/// unless a cell has joined it meanwhile. Main thread only.
+@interface HACardPrefetcher : NSObject
+
+/// Prefetches running at once. Default 2, or 1 on armv7 devices.
+@property (nonatomic, assign) NSUInteger maxConcurrentLoads;
+
+/// Waiting to start.
+@property (nonatomic, readonly) NSUInteger pendingCount;
+/// Started and not yet done.
+@property (nonatomic, readonly) NSUInteger runningCount;
+
+/// Queue a prefetch for key; ignored if one for key is already queued or running.
+- (void)prefetchKey:(id<NSCopying>)key start:(HACardPrefetchStartBlock)start;
+
+/// Withdraw key's prefetch, whether waiting or running.
+- (void)cancelPrefetchForKey:(id<NSCopying>)key;
+
+/// Withdraw everything (the keys went stale).
+- (void)cancelAll;
+
+@end
@@ -0,0 +1,108 @@
+#import "HACardPrefetcher.h"
+#import "HARequestCoalescer.h"
+#import "HADeviceRegistration.h"
+
+/// One card's prefetch.
+@interface HACardPrefetchJob : NSObject
+@property (nonatomic, copy) id<NSCopying> key;
+@property (nonatomic, copy) HACardPrefetchStartBlock start;
+@property (nonatomic, copy) NSArray<HARequestInterest *> *interests;
+@property (nonatomic, assign) BOOL running;
+@property (nonatomic, assign) BOOL finished;
+@end
+
+@implementation HACardPrefetchJob
+@end
+
+@interface HACardPrefetcher ()
+@property (nonatomic, strong) NSMutableDictionary<id<NSCopying>, HACardPrefetchJob *> *jobs;
+@property (nonatomic, strong) NSMutableArray<HACardPrefetchJob *> *pending;
+@property (nonatomic, assign, readwrite) NSUInteger runningCount;
+@end
+
+@implementation HACardPrefetcher
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _jobs = [NSMutableDictionary dictionary];
+        _pending = [NSMutableArray array];
+
+        BOOL lightweight = HADeviceIsLowEnd();
+        _maxConcurrentLoads = lightweight ? 1 : 2;
+    }
+    return self;
+}
+
+- (NSUInteger)pendingCount {
+    return self.pending.count;
+}
+
+- (void)setMaxConcurrentLoads:(NSUInteger)maxConcurrentLoads {
+    _maxConcurrentLoads = MAX((NSUInteger)1, maxConcurrentLoads);
+    [self startPending];
+}
+
+#pragma mark - Queue
+
+- (void)prefetchKey:(id<NSCopying>)key start:(HACardPrefetchStartBlock)start {
+    if (!key || !start || self.jobs[key]) return;
+    HACardPrefetchJob *job = [[HACardPrefetchJob alloc] init];
+    job.key = key;
+    job.start = start;
+    self.jobs[key] = job;
+    [self.pending addObject:job];
+    [self startPending];
+}
+
+- (void)startPending {
+    while (self.runningCount < self.maxConcurrentLoads && self.pending.count > 0) {
+        HACardPrefetchJob *job = self.pending.firstObject;
+        [self.pending removeObjectAtIndex:0];
+        job.running = YES;
+        self.runningCount++;
+
+        HACardPrefetchStartBlock start = job.start;
+        job.start = nil;
+        __weak typeof(self) weakSelf = self;
+        NSArray<HARequestInterest *> *interests = start(^{
+            [weakSelf finishJob:job];
+        });
+        // done may already have run (everything was fresh)
+        if (!job.finished) job.interests = interests;
+    }
+}
+
+- (void)finishJob:(HACardPrefetchJob *)job {
+    if (job.finished) return;
+    job.finished = YES;
+    job.interests = nil;
+    if (self.jobs[job.key] == job) [self.jobs removeObjectForKey:job.key];
+    if (job.running) {
+        job.running = NO;
+        self.runningCount--;
+    }
+    [self startPending];
+}
+
+#pragma mark - Cancel
+
+- (void)cancelPrefetchForKey:(id<NSCopying>)key {
+    HACardPrefetchJob *job = key ? self.jobs[key] : nil;
+    if (!job) return;
+    [self.pending removeObjectIdenticalTo:job];
+    for (HARequestInterest *interest in job.interests) {
+        [interest cancel];
+    }
+    [self finishJob:job];
+}
+
+- (void)cancelAll {
+    // Nothing queued may start just to be cancelled
+    [self.pending removeAllObjects];
+    for (HACardPrefetchJob *job in self.jobs.allValues) {
+        [self cancelPrefetchForKey:job.key];
+    }
+}
+
+@end
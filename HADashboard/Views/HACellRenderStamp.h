@@ -0,0 +1,31 @@
+#import <Foundation/Foundation.h>
+
+@class HADashboardConfigItem;
+@class HADashboardConfigSection;
+@class HAEntity;
+
+/// What a dashboard cell was last configured from: the config item, the
+/// section it read, the theme and the HAEntity version of every entity it
+/// rendered. A cell whose stamp is still current shows exactly what
+/// configuring it again would, so the configure can be skipped.
+@interface HACellRenderStamp : NSObject
+
+/// entities are the ones the cell reads, keyed by entity ID; IDs with no
+/// entity yet are simply absent (and appearing later makes the stamp stale).
+- (instancetype)initWithItem:(HADashboardConfigItem *)item
+                     section:(HADashboardConfigSection *)section
+                    entities:(NSDictionary<NSString *, HAEntity *> *)entities;
+
+/// YES if configuring from these inputs would render the same thing:
+/// same (or content-equal) item and section, same theme, and every entity
+/// at the version it was rendered at.
+- (BOOL)isCurrentForItem:(HADashboardConfigItem *)item
+                 section:(HADashboardConfigSection *)section
+                entities:(NSDictionary<NSString *, HAEntity *> *)entities;
+
+/// YES if the item, section and theme are still what the cell rendered,
+/// whatever the entities did since: the cell only needs its
+/// entity-derived content updated.
+- (BOOL)matchesConfigForItem:(HADashboardConfigItem *)item section:(HADashboardConfigSection *)section;
+
+@end
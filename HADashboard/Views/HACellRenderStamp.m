@@ -0,0 +1,62 @@
+#import "HACellRenderStamp.h"
+#import "HADashboardConfig.h"
+#import "HAEntity.h"
+#import "HATheme.h"
+
+@interface HACellRenderStamp ()
+@property (nonatomic, strong) HADashboardConfigItem *item;
+@property (nonatomic, strong) HADashboardConfigSection *section;
+@property (nonatomic, assign) NSInteger themeKey;
+@property (nonatomic, copy) NSDictionary<NSString *, NSNumber *> *entityVersions;
+@end
+
+@implementation HACellRenderStamp
+
+- (instancetype)initWithItem:(HADashboardConfigItem *)item
+                     section:(HADashboardConfigSection *)section
+                    entities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    self = [super init];
+    if (self) {
+        _item = item;
+        _section = section;
+        _themeKey = [HATheme appearanceKey];
+        _entityVersions = [HACellRenderStamp versionsForEntities:entities];
+    }
+    return self;
+}
+
++ (NSDictionary<NSString *, NSNumber *> *)versionsForEntities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    NSMutableDictionary<NSString *, NSNumber *> *versions = [NSMutableDictionary dictionaryWithCapacity:entities.count];
+    [entities enumerateKeysAndObjectsUsingBlock:^(NSString *entityId, HAEntity *entity, BOOL *stop) {
+        versions[entityId] = @(entity.version);
+    }];
+    return versions;
+}
+
+- (BOOL)matchesConfigForItem:(HADashboardConfigItem *)item section:(HADashboardConfigSection *)section {
+    if (!item || self.themeKey != [HATheme appearanceKey]) return NO;
+    if (self.item != item) {
+        // A rebuilt config has new item objects; same content renders the same
+        if (![self.item isContentEqualToItem:item]) return NO;
+        self.item = item;
+    }
+    if (self.section != section) {
+        if (!self.section || !section || ![self.section isHeaderEqualToSection:section]) return NO;
+        self.section = section;
+    }
+    return YES;
+}
+
+- (BOOL)isCurrentForItem:(HADashboardConfigItem *)item
+                 section:(HADashboardConfigSection *)section
+                entities:(NSDictionary<NSString *, HAEntity *> *)entities {
+    if (![self matchesConfigForItem:item section:section]) return NO;
+    if (self.entityVersions.count != entities.count) return NO;
+    for (NSString *entityId in entities) {
+        NSNumber *version = self.entityVersions[entityId];
+        if (!version || version.unsignedIntegerValue != entities[entityId].version) return NO;
+    }
+    return YES;
+}
+
+@end
@@ -0,0 +1,30 @@
+#import <UIKit/UIKit.h>
+
+@class HAEntity;
+@class HADashboardConfigItem;
+
+/// Immutable snapshot of what a tile card shows for one entity state:
+/// display strings, icon glyph, colors and visibility flags. Built by a
+/// pure function of (entity, config item, theme) that touches no views,
+/// so it can run off the main thread against an entity copy; the cell
+/// then only applies the properties that differ from what it shows.
+@interface HACellViewModel : NSObject
+
+@property (nonatomic, copy, readonly) NSString *name;
+@property (nonatomic, copy, readonly) NSString *stateText;      // nil when the state is hidden
+@property (nonatomic, copy, readonly) NSString *iconGlyph;
+@property (nonatomic, strong, readonly) UIColor *iconColor;
+@property (nonatomic, strong, readonly) UIColor *stateColor;
+@property (nonatomic, copy, readonly) NSString *entityPicturePath; // nil unless show_entity_picture
+@property (nonatomic, assign, readonly) BOOL showsName;
+@property (nonatomic, assign, readonly) BOOL showsState;
+@property (nonatomic, assign, readonly) BOOL showsIcon;
+@property (nonatomic, assign, readonly) CGFloat contentAlpha;
+
+/// Tile and button card content. Safe on any thread as long as entity is
+/// not being mutated meanwhile (pass a copy off the main thread).
++ (instancetype)tileViewModelForEntity:(HAEntity *)entity configItem:(HADashboardConfigItem *)configItem;
+
+- (BOOL)isEqualToViewModel:(HACellViewModel *)other;
+
+@end
@@ -0,0 +1,205 @@
+#import "HACellViewModel.h"
+#import "HAEntity.h"
+#import "HADashboardConfig.h"
+#import "HATheme.h"
+#import "HAIconMapper.h"
+#import "HAEntityDisplayHelper.h"
+
+/// nil-safe isEqual: for the view-model comparison.
+static BOOL ha_equalObjects(id a, id b) {
+    return (a == b) || [a isEqual:b];
+}
+
+@interface HACellViewModel ()
+@property (nonatomic, copy, readwrite) NSString *name;
+@property (nonatomic, copy, readwrite) NSString *stateText;
+@property (nonatomic, copy, readwrite) NSString *iconGlyph;
+@property (nonatomic, strong, readwrite) UIColor *iconColor;
+@property (nonatomic, strong, readwrite) UIColor *stateColor;
+@property (nonatomic, copy, readwrite) NSString *entityPicturePath;
+@property (nonatomic, assign, readwrite) BOOL showsName;
+@property (nonatomic, assign, readwrite) BOOL showsState;
+@property (nonatomic, assign, readwrite) BOOL showsIcon;
+@property (nonatomic, assign, readwrite) CGFloat contentAlpha;
+@end
+
+@implementation HACellViewModel
+
++ (instancetype)tileViewModelForEntity:(HAEntity *)entity configItem:(HADashboardConfigItem *)configItem {
+    HACellViewModel *vm = [[HACellViewModel alloc] init];
+    NSDictionary *props = configItem.customProperties;
+
+    vm.contentAlpha = (entity && entity.isAvailable) ? 1.0 : 0.5;
+    vm.name = [HAEntityDisplayHelper displayNameForEntity:entity configItem:configItem nameOverride:nil];
+
+    // Attribute override: show a specific attribute value instead of state
+    NSString *attributeOverride = props[@"attribute"];
+    NSString *displayState;
+    if (attributeOverride.length > 0) {
+        id attrVal = entity.attributes[attributeOverride];
+        displayState = (attrVal && attrVal != [NSNull null]) ? [NSString stringWithFormat:@"%@", attrVal] : @"—";
+    } else {
+        // State: formatted state with human-readable text + unit
+        NSString *formattedState = [HAEntityDisplayHelper formattedStateForEntity:entity decimals:2];
+        displayState = [HAEntityDisplayHelper humanReadableState:formattedState];
+        NSString *unit = entity.unitOfMeasurement;
+        // Append unit unless binary_sensor or duration (already includes units)
+        if (unit.length > 0 &&
+            ![[entity domain] isEqualToString:@"binary_sensor"] &&
+            ![unit isEqualToString:@"h"] && ![unit isEqualToString:@"min"] &&
+            ![unit isEqualToString:@"s"] && ![unit isEqualToString:@"d"]) {
+            displayState = [NSString stringWithFormat:@"%@ %@", displayState, unit];
+        }
+    }
+
+    // Domain-specific secondary detail (e.g. "71%", "Open · 70%", "Heat · 22°C")
+    // Skip domain overrides when attribute override is active
+    NSString *domain = [entity domain];
+    if (attributeOverride.length > 0) {
+        // attribute override — skip domain-specific formatting
+    } else if ([domain isEqualToString:@"light"]) {
+        if ([entity isOn]) {
+            NSInteger pct = [entity brightnessPercent];
+            if (pct > 0) {
+                displayState = [NSString stringWithFormat:@"%ld%%", (long)pct];
+            }
+        }
+    } else if ([domain isEqualToString:@"humidifier"]) {
+        NSNumber *targetHumidity = [entity humidifierTargetHumidity];
+        if (targetHumidity) {
+            displayState = [NSString stringWithFormat:@"%@ · %@%%", displayState, targetHumidity];
+        }
+    } else if ([domain isEqualToString:@"cover"]) {
+        NSInteger pos = [entity coverPosition];
+        // coverPosition returns 0 as default; check if attribute actually exists
+        if (HAAttrNumber(entity.attributes, HAAttrCurrentPosition)) {
+            displayState = [NSString stringWithFormat:@"%@ · %ld%%", displayState, (long)pos];
+        }
+    } else if ([domain isEqualToString:@"climate"]) {
+        // Format HVAC mode with "/" separator: "heat_cool" → "Heat/Cool"
+        NSString *hvacMode = entity.state;
+        NSString *formattedMode = [[hvacMode stringByReplacingOccurrencesOfString:@"_" withString:@"/"] capitalizedString];
+        displayState = formattedMode;
+        NSNumber *targetTemp = [entity targetTemperature];
+        if (targetTemp) {
+            NSString *tempUnit = [entity weatherTemperatureUnit];
+            if (!tempUnit || tempUnit.length == 0) {
+                tempUnit = @"°C";
+            }
+            displayState = [NSString stringWithFormat:@"%@ · %@%@", displayState, targetTemp, tempUnit];
+        }
+    } else if ([domain isEqualToString:@"fan"]) {
+        if ([entity isOn]) {
+            NSInteger pct = [entity fanSpeedPercent];
+            if (pct > 0) {
+                displayState = [NSString stringWithFormat:@"%ld%%", (long)pct];
+            }
+        }
+    } else if ([domain isEqualToString:@"media_player"]) {
+        NSString *title = [entity mediaTitle];
+        NSString *artist = [entity mediaArtist];
+        if (title.length > 0 && artist.length > 0) {
+            displayState = [NSString stringWithFormat:@"%@ · %@", artist, title];
+        } else if (title.length > 0) {
+            displayState = title;
+        }
+    }
+
+    // state_content override: display last_changed, last_updated, or attribute values
+    id stateContent = props[@"state_content"];
+    if (stateContent) {
+        NSArray *contentItems = [stateContent isKindOfClass:[NSArray class]]
+            ? (NSArray *)stateContent
+            : @[stateContent];
+        NSMutableArray *parts = [NSMutableArray arrayWithCapacity:contentItems.count];
+        for (id item in contentItems) {
+            NSString *key = [item isKindOfClass:[NSString class]] ? (NSString *)item : nil;
+            if (!key) continue;
+            NSString *value = nil;
+            if ([key isEqualToString:@"last_changed"] || [key isEqualToString:@"last-changed"]) {
+                value = [HAEntityDisplayHelper relativeTimeFromISO8601:entity.lastChanged];
+            } else if ([key isEqualToString:@"last_updated"] || [key isEqualToString:@"last-updated"]) {
+                value = [HAEntityDisplayHelper relativeTimeFromISO8601:entity.lastUpdated];
+            } else if ([key isEqualToString:@"state"]) {
+                value = displayState;
+            } else {
+                // Attribute name lookup
+                id attrVal = entity.attributes[key];
+                if (attrVal && attrVal != [NSNull null]) {
+                    value = [NSString stringWithFormat:@"%@", attrVal];
+                }
+            }
+            if (value.length > 0) [parts addObject:value];
+        }
+        if (parts.count > 0) {
+            displayState = [parts componentsJoinedByString:@" · "];
+        }
+    }
+
+    // Respect show_state / show_name / show_icon from card config.
+    // HA button card defaults: show_name=YES, show_icon=YES, show_state=NO.
+    // HA tile card defaults: show_name=YES, show_icon=YES, show_state=YES.
+    BOOL isButtonCard = [configItem.cardType isEqualToString:@"button"];
+    BOOL defaultShowState = !isButtonCard; // button cards hide state by default
+    BOOL hideState = [props[@"hide_state"] boolValue]; // tile-specific hide_state field
+    vm.showsState = hideState ? NO : (props[@"show_state"] ? [props[@"show_state"] boolValue] : defaultShowState);
+    vm.showsName  = props[@"show_name"]  ? [props[@"show_name"] boolValue]  : YES;
+    vm.showsIcon  = props[@"show_icon"]  ? [props[@"show_icon"] boolValue]  : YES;
+    vm.stateText = vm.showsState ? displayState : nil;
+
+    // Icon: from card config override, else centralized entity icon resolution
+    NSString *iconName = props[@"icon"];
+    NSString *glyph = nil;
+    if (iconName) {
+        if ([iconName hasPrefix:@"mdi:"]) iconName = [iconName substringFromIndex:4];
+        glyph = [HAIconMapper glyphForIconName:iconName];
+    }
+    if (!glyph) glyph = [HAEntityDisplayHelper iconGlyphForEntity:entity];
+    vm.iconGlyph = glyph ?: @"?";
+
+    // Entity picture replaces the icon when configured
+    NSString *entityPicture = entity.attributes[@"entity_picture"];
+    if ([props[@"show_entity_picture"] boolValue] &&
+        [entityPicture isKindOfClass:[NSString class]] && entityPicture.length > 0) {
+        vm.entityPicturePath = entityPicture;
+    }
+
+    // Color: domain+state-aware icon color from centralized helper
+    vm.iconColor = [HAEntityDisplayHelper iconColorForEntity:entity];
+    // State label matches icon color when entity is active, secondary otherwise
+    BOOL isActive = [entity isOn] ||
+                    [entity.state isEqualToString:@"open"] ||
+                    [entity.state isEqualToString:@"opening"] ||
+                    [entity.state isEqualToString:@"locked"] ||
+                    [entity.state isEqualToString:@"playing"] ||
+                    [entity.state hasPrefix:@"armed"];
+    vm.stateColor = isActive ? vm.iconColor : [HATheme secondaryTextColor];
+
+    return vm;
+}
+
+- (BOOL)isEqualToViewModel:(HACellViewModel *)other {
+    if (!other) return NO;
+    if (other == self) return YES;
+    return self.showsName == other.showsName &&
+           self.showsState == other.showsState &&
+           self.showsIcon == other.showsIcon &&
+           self.contentAlpha == other.contentAlpha &&
+           ha_equalObjects(self.name, other.name) &&
+           ha_equalObjects(self.stateText, other.stateText) &&
+           ha_equalObjects(self.iconGlyph, other.iconGlyph) &&
+           ha_equalObjects(self.iconColor, other.iconColor) &&
+           ha_equalObjects(self.stateColor, other.stateColor) &&
+           ha_equalObjects(self.entityPicturePath, other.entityPicturePath);
+}
+
+- (BOOL)isEqual:(id)object {
+    if (![object isKindOfClass:[HACellViewModel class]]) return NO;
+    return [self isEqualToViewModel:object];
+}
+
+- (NSUInteger)hash {
+    return self.name.hash ^ self.stateText.hash ^ self.iconGlyph.hash;
+}
+
+@end
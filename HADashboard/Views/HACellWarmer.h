@@ -0,0 +1,30 @@
+#import <Foundation/Foundation.h>
+
+/// Runs small pieces of set-up work (creating the cells and row views a
+/// dashboard will need once it scrolls) in the main run loop's idle time.
+///
+/// A pass runs when the run loop is about to sleep in the default mode,
+/// after Core Animation has committed, so it never runs while a scroll
+/// view is tracking and never holds up a frame already built. Each pass
+/// runs tasks in order until passBudget is spent (at least one), then
+/// wakes the run loop for another pass if any are left; input that
+/// arrived meanwhile is handled between passes. The run loop observer is
+/// removed while nothing is queued. Main thread only.
+@interface HACellWarmer : NSObject
+
+/// Main-thread time per pass. Default 4 ms.
+@property (nonatomic, assign) NSTimeInterval passBudget;
+
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/// Queue a task for idle time. Tasks may enqueue more.
+- (void)enqueueTask:(dispatch_block_t)task;
+
+/// Drop everything that hasn't run (the user is interacting, or what was
+/// planned went stale).
+- (void)stop;
+
+/// Run one pass now; for tests.
+- (void)runPass;
+
+@end
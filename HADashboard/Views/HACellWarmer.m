@@ -0,0 +1,84 @@
+#import "HACellWarmer.h"
+#import <QuartzCore/QuartzCore.h>
+
+/// Core Animation commits in a before-waiting observer of order 2000000;
+/// running after it keeps warm-up work out of the frame being built.
+static const CFIndex kIdleObserverOrder = 2000000 + 1;
+
+@interface HACellWarmer () {
+    CFRunLoopObserverRef _observer;
+}
+@property (nonatomic, strong) NSMutableArray<dispatch_block_t> *tasks;
+@end
+
+@implementation HACellWarmer
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _tasks = [NSMutableArray array];
+        _passBudget = 0.004;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [self removeObserver];
+}
+
+- (NSUInteger)pendingCount {
+    return self.tasks.count;
+}
+
+#pragma mark - Queue
+
+- (void)enqueueTask:(dispatch_block_t)task {
+    if (!task) return;
+    [self.tasks addObject:[task copy]];
+    [self installObserver];
+}
+
+- (void)stop {
+    [self.tasks removeAllObjects];
+    [self removeObserver];
+}
+
+- (void)runPass {
+    CFTimeInterval deadline = CACurrentMediaTime() + self.passBudget;
+    do {
+        if (self.tasks.count == 0) break;
+        dispatch_block_t task = self.tasks.firstObject;
+        [self.tasks removeObjectAtIndex:0];
+        task();
+    } while (CACurrentMediaTime() < deadline);
+
+    if (self.tasks.count == 0) {
+        [self removeObserver];
+        return;
+    }
+    // Nothing else may wake the run loop; come back for the rest
+    CFRunLoopWakeUp(CFRunLoopGetMain());
+}
+
+#pragma mark - Run Loop
+
+- (void)installObserver {
+    if (_observer) return;
+    __weak typeof(self) weakSelf = self;
+    _observer = CFRunLoopObserverCreateWithHandler(kCFAllocatorDefault, kCFRunLoopBeforeWaiting, true,
+                                                   kIdleObserverOrder,
+                                                   ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+        [weakSelf runPass];
+    });
+    CFRunLoopAddObserver(CFRunLoopGetMain(), _observer, kCFRunLoopDefaultMode);
+    CFRunLoopWakeUp(CFRunLoopGetMain());
+}
+
+- (void)removeObserver {
+    if (!_observer) return;
+    CFRunLoopObserverInvalidate(_observer);
+    CFRelease(_observer);
+    _observer = NULL;
+}
+
+@end
@@ -1,42 +1,132 @@
 #import "HAColumnarLayout.h"
+#import "HALayoutAttributesIndex.h"
+#import "HALayoutInvalidationContext.h"
+
+static const NSInteger kSubGridColumns = 12;
+static const CGFloat kSubGridSpacing = 8.0;
+
+/// One section (one column of one section row) as last laid out: the
+/// delegate's answers and the attributes built from them, so a height
+/// change re-lays out just this section and moves the rows below.
+@interface HAColumnarSectionCache : NSObject
+@property (nonatomic, assign) NSInteger column;
+@property (nonatomic, assign) CGFloat columnX;
+@property (nonatomic, strong) UICollectionViewLayoutAttributes *header; // nil if hidden
+@property (nonatomic, strong) NSMutableArray<UICollectionViewLayoutAttributes *> *items;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *gridColumns; // per item, 1...12
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *heights;     // per item
+@property (nonatomic, assign) CGFloat originY;
+@property (nonatomic, assign) CGFloat height; // header through the spacing after the last item row
+@end
+
+@implementation HAColumnarSectionCache
+@end
 
 @interface HAColumnarLayout ()
-@property (nonatomic, strong) NSMutableArray<UICollectionViewLayoutAttributes *> *itemAttributes;
-@property (nonatomic, strong) NSMutableArray<UICollectionViewLayoutAttributes *> *headerAttributes;
+@property (nonatomic, strong) HALayoutAttributesIndex *attributesIndex; // headers and items, one lane per column
+@property (nonatomic, strong) NSMutableArray<HAColumnarSectionCache *> *sectionCaches;
 @property (nonatomic, strong) NSMutableDictionary<NSIndexPath *, UICollectionViewLayoutAttributes *> *itemAttributesByIndexPath;
 @property (nonatomic, strong) NSMutableDictionary<NSIndexPath *, UICollectionViewLayoutAttributes *> *headerAttributesByIndexPath;
 @property (nonatomic, assign) CGSize cachedContentSize;
+@property (nonatomic, assign) NSInteger effectiveColumns;
+@property (nonatomic, assign) CGFloat columnWidth;
+@property (nonatomic, assign) BOOL needsFullLayout;
+@property (nonatomic, strong) NSMutableSet<NSIndexPath *> *pendingHeightIndexPaths;
 @end
 
 @implementation HAColumnarLayout
 
++ (Class)invalidationContextClass {
+    return [HALayoutInvalidationContext class];
+}
+
 - (instancetype)init {
     self = [super init];
     if (self) {
         _interColumnSpacing = 6.0;
         _interItemSpacing = 6.0;
         _contentInsets = UIEdgeInsetsMake(8, 8, 8, 8);
-        _itemAttributes = [NSMutableArray array];
-        _headerAttributes = [NSMutableArray array];
+        _attributesIndex = [[HALayoutAttributesIndex alloc] init];
+        _sectionCaches = [NSMutableArray array];
         _itemAttributesByIndexPath = [NSMutableDictionary dictionary];
         _headerAttributesByIndexPath = [NSMutableDictionary dictionary];
+        _needsFullLayout = YES;
+        _pendingHeightIndexPaths = [NSMutableSet set];
     }
     return self;
 }
 
+- (void)setInterColumnSpacing:(CGFloat)interColumnSpacing {
+    _interColumnSpacing = interColumnSpacing;
+    self.needsFullLayout = YES;
+}
+
+- (void)setInterItemSpacing:(CGFloat)interItemSpacing {
+    _interItemSpacing = interItemSpacing;
+    self.needsFullLayout = YES;
+}
+
+- (void)setContentInsets:(UIEdgeInsets)contentInsets {
+    _contentInsets = contentInsets;
+    self.needsFullLayout = YES;
+}
+
+- (void)setMaxColumns:(NSInteger)maxColumns {
+    _maxColumns = maxColumns;
+    self.needsFullLayout = YES;
+}
+
+- (void)invalidateLayoutWithContext:(UICollectionViewLayoutInvalidationContext *)context {
+    [super invalidateLayoutWithContext:context];
+    if (context.invalidateEverything || context.invalidateDataSourceCounts) {
+        self.needsFullLayout = YES;
+    } else if ([context isKindOfClass:[HALayoutInvalidationContext class]]) {
+        [self.pendingHeightIndexPaths unionSet:((HALayoutInvalidationContext *)context).invalidatedHeightIndexPaths];
+    }
+}
+
 - (void)prepareLayout {
     [super prepareLayout];
 
-    [self.itemAttributes removeAllObjects];
-    [self.headerAttributes removeAllObjects];
+    UICollectionView *cv = self.collectionView;
+    if (!cv) return;
+
+    if ([self canReuseCachedLayout]) {
+        [self updatePendingHeights];
+    } else {
+        [self prepareFullLayout];
+    }
+    [self.pendingHeightIndexPaths removeAllObjects];
+}
+
+/// Same width and the same item counts as the cached pass, and nothing
+/// but heights invalidated since.
+- (BOOL)canReuseCachedLayout {
+    UICollectionView *cv = self.collectionView;
+    if (self.needsFullLayout || self.cachedContentSize.width != cv.bounds.size.width) return NO;
+    NSInteger sectionCount = [cv numberOfSections];
+    if (sectionCount != (NSInteger)self.sectionCaches.count) return NO;
+    for (NSInteger section = 0; section < sectionCount; section++) {
+        if ([cv numberOfItemsInSection:section] != (NSInteger)self.sectionCaches[section].items.count) return NO;
+    }
+    return YES;
+}
+
+#pragma mark - Full Layout
+
+- (void)prepareFullLayout {
+    self.needsFullLayout = NO;
+    [self.sectionCaches removeAllObjects];
     [self.itemAttributesByIndexPath removeAllObjects];
     [self.headerAttributesByIndexPath removeAllObjects];
+    [self.attributesIndex removeAllAttributes];
 
     UICollectionView *cv = self.collectionView;
-    if (!cv) return;
-
     NSInteger sectionCount = [cv numberOfSections];
     if (sectionCount == 0) {
+        // Nothing from the previous build may be handed out again
+        self.effectiveColumns = 0;
+        self.columnWidth = 0;
         self.cachedContentSize = CGSizeZero;
         return;
     }
@@ -59,140 +149,236 @@
     }
 
     CGFloat columnWidth = floor((totalWidth - self.interColumnSpacing * (effectiveCols - 1)) / effectiveCols);
+    self.effectiveColumns = effectiveCols;
+    self.columnWidth = columnWidth;
+
+    for (NSInteger section = 0; section < sectionCount; section++) {
+        HAColumnarSectionCache *cache = [[HAColumnarSectionCache alloc] init];
+        cache.column = section % effectiveCols; // column index within its section row
+        cache.columnX = self.contentInsets.left + cache.column * (columnWidth + self.interColumnSpacing);
+
+        // Section header
+        CGFloat headerHeight = 0;
+        if ([self.delegate respondsToSelector:@selector(collectionView:layout:heightForHeaderInSection:)]) {
+            headerHeight = [self.delegate collectionView:cv layout:self heightForHeaderInSection:section];
+        }
+        if (headerHeight > 0) {
+            NSIndexPath *headerIndexPath = [NSIndexPath indexPathForItem:0 inSection:section];
+            UICollectionViewLayoutAttributes *headerAttr =
+                [UICollectionViewLayoutAttributes layoutAttributesForSupplementaryViewOfKind:UICollectionElementKindSectionHeader
+                                                                              withIndexPath:headerIndexPath];
+            headerAttr.frame = CGRectMake(cache.columnX, 0, columnWidth, headerHeight);
+            cache.header = headerAttr;
+            self.headerAttributesByIndexPath[headerIndexPath] = headerAttr;
+        }
+
+        NSInteger itemCount = [cv numberOfItemsInSection:section];
+        cache.items = [NSMutableArray arrayWithCapacity:itemCount];
+        cache.gridColumns = [NSMutableArray arrayWithCapacity:itemCount];
+        cache.heights = [NSMutableArray arrayWithCapacity:itemCount];
+        for (NSInteger item = 0; item < itemCount; item++) {
+            NSIndexPath *indexPath = [NSIndexPath indexPathForItem:item inSection:section];
+            NSInteger gridCols = [self gridColumnsForItemAtIndexPath:indexPath];
+            CGFloat itemHeight = [self heightForItemAtIndexPath:indexPath gridColumns:gridCols];
+
+            UICollectionViewLayoutAttributes *attr =
+                [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
+            [cache.items addObject:attr];
+            [cache.gridColumns addObject:@(gridCols)];
+            [cache.heights addObject:@(itemHeight)];
+            self.itemAttributesByIndexPath[indexPath] = attr;
+        }
+        [self.sectionCaches addObject:cache];
+    }
+
+    [self placeSectionsFromRow:0 relayout:nil];
+}
 
-    // Number of section rows needed
+#pragma mark - Incremental Layout
+
+/// Re-query the invalidated items; sections whose answers changed are
+/// laid out again and everything below them moves, the rest is kept.
+- (void)updatePendingHeights {
+    if (self.pendingHeightIndexPaths.count == 0) return;
+
+    NSMutableIndexSet *changedSections = [NSMutableIndexSet indexSet];
+    for (NSIndexPath *indexPath in self.pendingHeightIndexPaths) {
+        if (indexPath.section < 0 || indexPath.section >= (NSInteger)self.sectionCaches.count) continue;
+        HAColumnarSectionCache *cache = self.sectionCaches[indexPath.section];
+        if (indexPath.item < 0 || indexPath.item >= (NSInteger)cache.items.count) continue;
+
+        NSInteger gridCols = [self gridColumnsForItemAtIndexPath:indexPath];
+        CGFloat itemHeight = [self heightForItemAtIndexPath:indexPath gridColumns:gridCols];
+        if (gridCols == cache.gridColumns[indexPath.item].integerValue &&
+            itemHeight == cache.heights[indexPath.item].doubleValue) continue;
+        cache.gridColumns[indexPath.item] = @(gridCols);
+        cache.heights[indexPath.item] = @(itemHeight);
+        [changedSections addIndex:indexPath.section];
+    }
+    if (changedSections.count == 0) return;
+
+    [self placeSectionsFromRow:changedSections.firstIndex / self.effectiveColumns relayout:changedSections];
+}
+
+#pragma mark - Placement
+
+/// Position section rows from firstRow down. Sections in `relayout` (or
+/// all of them when nil) get their frames recomputed from the cached
+/// heights; the others are only moved if their row moved.
+- (void)placeSectionsFromRow:(NSInteger)firstRow relayout:(NSIndexSet *)relayout {
+    NSInteger sectionCount = (NSInteger)self.sectionCaches.count;
+    NSInteger effectiveCols = self.effectiveColumns;
     NSInteger sectionRowCount = (sectionCount + effectiveCols - 1) / effectiveCols;
 
     // Track Y offset across section rows
     CGFloat sectionRowStartY = self.contentInsets.top;
+    if (firstRow > 0) {
+        // The row above is unchanged: start below its tallest column
+        CGFloat aboveMaxY = 0;
+        for (NSInteger section = (firstRow - 1) * effectiveCols; section < firstRow * effectiveCols; section++) {
+            HAColumnarSectionCache *cache = self.sectionCaches[section];
+            aboveMaxY = MAX(aboveMaxY, cache.originY + cache.height);
+        }
+        sectionRowStartY = aboveMaxY + self.interColumnSpacing;
+    }
 
-    for (NSInteger sectionRow = 0; sectionRow < sectionRowCount; sectionRow++) {
+    for (NSInteger sectionRow = firstRow; sectionRow < sectionRowCount; sectionRow++) {
         NSInteger firstSection = sectionRow * effectiveCols;
         NSInteger lastSection = MIN(firstSection + effectiveCols, sectionCount);
-        NSInteger colsInRow = lastSection - firstSection;
 
-        // Track the Y offset for each column within this section row
-        CGFloat *columnY = calloc(colsInRow, sizeof(CGFloat));
-        for (NSInteger c = 0; c < colsInRow; c++) {
-            columnY[c] = sectionRowStartY;
+        // Find the tallest column in this section row to determine the row height
+        CGFloat sectionRowMaxY = sectionRowStartY;
+        for (NSInteger section = firstSection; section < lastSection; section++) {
+            HAColumnarSectionCache *cache = self.sectionCaches[section];
+            if (!relayout || [relayout containsIndex:section]) {
+                if (relayout) [self detachSection:cache];
+                [self layoutSection:cache atY:sectionRowStartY];
+            } else if (cache.originY != sectionRowStartY) {
+                [self detachSection:cache];
+                [self moveSection:cache toY:sectionRowStartY];
+            }
+            sectionRowMaxY = MAX(sectionRowMaxY, cache.originY + cache.height);
+        }
+
+        // Next section row starts after the tallest column in this row
+        // Add inter-column spacing as inter-row spacing between section rows
+        sectionRowStartY = sectionRowMaxY + (sectionRow < sectionRowCount - 1 ? self.interColumnSpacing : 0);
+    }
+
+    [self.attributesIndex removeAllAttributes];
+    for (HAColumnarSectionCache *cache in self.sectionCaches) {
+        if (cache.header) [self.attributesIndex addAttributes:cache.header toLane:cache.column];
+        for (UICollectionViewLayoutAttributes *attr in cache.items) {
+            [self.attributesIndex addAttributes:attr toLane:cache.column];
         }
+    }
+    [self.attributesIndex build];
+    self.cachedContentSize = CGSizeMake(self.collectionView.bounds.size.width, sectionRowStartY + self.contentInsets.bottom);
+}
 
-        for (NSInteger section = firstSection; section < lastSection; section++) {
-            NSInteger col = section - firstSection; // column index within this row
-            CGFloat columnX = self.contentInsets.left + col * (columnWidth + self.interColumnSpacing);
+/// Swap a section's attributes for copies before changing their frames:
+/// the collection view may still hold the ones it was given.
+- (void)detachSection:(HAColumnarSectionCache *)cache {
+    if (cache.header) {
+        cache.header = [cache.header copy];
+        self.headerAttributesByIndexPath[cache.header.indexPath] = cache.header;
+    }
+    for (NSUInteger item = 0; item < cache.items.count; item++) {
+        UICollectionViewLayoutAttributes *attr = [cache.items[item] copy];
+        cache.items[item] = attr;
+        self.itemAttributesByIndexPath[attr.indexPath] = attr;
+    }
+}
 
-            // Section header
-            CGFloat headerHeight = 0;
-            if ([self.delegate respondsToSelector:@selector(collectionView:layout:heightForHeaderInSection:)]) {
-                headerHeight = [self.delegate collectionView:cv layout:self heightForHeaderInSection:section];
-            }
+/// Frames for one section from its cached header and item answers.
+/// Items are packed into rows of a 12-column sub-grid within the column.
+- (void)layoutSection:(HAColumnarSectionCache *)cache atY:(CGFloat)originY {
+    CGFloat columnWidth = self.columnWidth;
+    CGFloat columnY = originY;
+
+    if (cache.header) {
+        CGRect frame = cache.header.frame;
+        frame.origin.y = columnY;
+        cache.header.frame = frame;
+        columnY += frame.size.height;
+    }
 
-            if (headerHeight > 0) {
-                NSIndexPath *headerIndexPath = [NSIndexPath indexPathForItem:0 inSection:section];
-                UICollectionViewLayoutAttributes *headerAttr =
-                    [UICollectionViewLayoutAttributes layoutAttributesForSupplementaryViewOfKind:UICollectionElementKindSectionHeader
-                                                                                  withIndexPath:headerIndexPath];
-                headerAttr.frame = CGRectMake(columnX, columnY[col], columnWidth, headerHeight);
-                [self.headerAttributes addObject:headerAttr];
-                self.headerAttributesByIndexPath[headerIndexPath] = headerAttr;
-                columnY[col] += headerHeight;
-            }
+    NSInteger rowUsed = 0;     // sub-grid columns consumed in current row
+    CGFloat rowStartY = columnY;
+    CGFloat rowMaxHeight = 0;  // tallest item in current row
 
-            // Items in this section — sub-grid row packing (12-column grid within each column)
-            static const NSInteger kSubGridColumns = 12;
-            CGFloat subGridSpacing = 8.0;
-            NSInteger itemCount = [cv numberOfItemsInSection:section];
-            NSInteger rowUsed = 0;     // sub-grid columns consumed in current row
-            CGFloat rowStartY = columnY[col];
-            CGFloat rowMaxHeight = 0;  // tallest item in current row
-
-            for (NSInteger item = 0; item < itemCount; item++) {
-                NSIndexPath *indexPath = [NSIndexPath indexPathForItem:item inSection:section];
-
-                // Get this item's sub-grid span (out of 12)
-                NSInteger gridCols = kSubGridColumns; // default full width
-                if ([self.delegate respondsToSelector:@selector(collectionView:layout:gridColumnsForItemAtIndexPath:)]) {
-                    gridCols = [self.delegate collectionView:cv layout:self gridColumnsForItemAtIndexPath:indexPath];
-                }
-                gridCols = MAX(1, MIN(gridCols, kSubGridColumns));
-
-                // Check if this item fits in the current row
-                if (rowUsed > 0 && rowUsed + gridCols > kSubGridColumns) {
-                    // Start a new row
-                    columnY[col] = rowStartY + rowMaxHeight + self.interItemSpacing;
-                    rowStartY = columnY[col];
-                    rowUsed = 0;
-                    rowMaxHeight = 0;
-                }
-
-                // Calculate item width from sub-grid fraction
-                CGFloat itemWidth;
-                if (gridCols >= kSubGridColumns) {
-                    itemWidth = columnWidth;
-                } else {
-                    // Proportional width minus spacing between sub-grid items
-                    CGFloat usableWidth = columnWidth;
-                    itemWidth = floor((usableWidth * gridCols) / kSubGridColumns - subGridSpacing * 0.5);
-                }
-
-                CGFloat itemX = columnX + (columnWidth * rowUsed) / kSubGridColumns;
-                if (rowUsed > 0) itemX += subGridSpacing * 0.5;
-
-                CGFloat itemHeight = 100.0;
-                if ([self.delegate respondsToSelector:@selector(collectionView:layout:heightForItemAtIndexPath:itemWidth:)]) {
-                    itemHeight = [self.delegate collectionView:cv layout:self heightForItemAtIndexPath:indexPath itemWidth:itemWidth];
-                }
-
-                UICollectionViewLayoutAttributes *attr =
-                    [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
-                attr.frame = CGRectMake(itemX, rowStartY, itemWidth, itemHeight);
-                [self.itemAttributes addObject:attr];
-                self.itemAttributesByIndexPath[indexPath] = attr;
-
-                rowUsed += gridCols;
-                if (itemHeight > rowMaxHeight) rowMaxHeight = itemHeight;
-            }
+    for (NSUInteger item = 0; item < cache.items.count; item++) {
+        NSInteger gridCols = cache.gridColumns[item].integerValue;
 
-            // Finalize the last row
-            if (rowMaxHeight > 0) {
-                columnY[col] = rowStartY + rowMaxHeight + self.interItemSpacing;
-            }
+        // Check if this item fits in the current row
+        if (rowUsed > 0 && rowUsed + gridCols > kSubGridColumns) {
+            // Start a new row
+            columnY = rowStartY + rowMaxHeight + self.interItemSpacing;
+            rowStartY = columnY;
+            rowUsed = 0;
+            rowMaxHeight = 0;
         }
 
-        // Find the tallest column in this section row to determine the row height
-        CGFloat sectionRowMaxY = sectionRowStartY;
-        for (NSInteger c = 0; c < colsInRow; c++) {
-            if (columnY[c] > sectionRowMaxY) sectionRowMaxY = columnY[c];
-        }
-        free(columnY);
+        CGFloat itemWidth = [self itemWidthForGridColumns:gridCols];
+        CGFloat itemX = cache.columnX + (columnWidth * rowUsed) / kSubGridColumns;
+        if (rowUsed > 0) itemX += kSubGridSpacing * 0.5;
 
-        // Next section row starts after the tallest column in this row
-        // Add inter-column spacing as inter-row spacing between section rows
-        sectionRowStartY = sectionRowMaxY + (sectionRow < sectionRowCount - 1 ? self.interColumnSpacing : 0);
+        CGFloat itemHeight = cache.heights[item].doubleValue;
+        cache.items[item].frame = CGRectMake(itemX, rowStartY, itemWidth, itemHeight);
+
+        rowUsed += gridCols;
+        if (itemHeight > rowMaxHeight) rowMaxHeight = itemHeight;
     }
 
-    self.cachedContentSize = CGSizeMake(cv.bounds.size.width, sectionRowStartY + self.contentInsets.bottom);
+    // Finalize the last row
+    if (rowMaxHeight > 0) {
+        columnY = rowStartY + rowMaxHeight + self.interItemSpacing;
+    }
+    cache.originY = originY;
+    cache.height = columnY - originY;
 }
 
-- (CGSize)collectionViewContentSize {
-    return self.cachedContentSize;
+- (void)moveSection:(HAColumnarSectionCache *)cache toY:(CGFloat)originY {
+    CGFloat delta = originY - cache.originY;
+    if (cache.header) cache.header.frame = CGRectOffset(cache.header.frame, 0, delta);
+    for (UICollectionViewLayoutAttributes *attr in cache.items) {
+        attr.frame = CGRectOffset(attr.frame, 0, delta);
+    }
+    cache.originY = originY;
 }
 
-- (NSArray<UICollectionViewLayoutAttributes *> *)layoutAttributesForElementsInRect:(CGRect)rect {
-    NSMutableArray *result = [NSMutableArray array];
+#pragma mark - Delegate
 
-    for (UICollectionViewLayoutAttributes *attr in self.headerAttributes) {
-        if (CGRectIntersectsRect(attr.frame, rect)) {
-            [result addObject:attr];
-        }
+/// This item's sub-grid span (out of 12), default full width.
+- (NSInteger)gridColumnsForItemAtIndexPath:(NSIndexPath *)indexPath {
+    NSInteger gridCols = kSubGridColumns;
+    if ([self.delegate respondsToSelector:@selector(collectionView:layout:gridColumnsForItemAtIndexPath:)]) {
+        gridCols = [self.delegate collectionView:self.collectionView layout:self gridColumnsForItemAtIndexPath:indexPath];
     }
-    for (UICollectionViewLayoutAttributes *attr in self.itemAttributes) {
-        if (CGRectIntersectsRect(attr.frame, rect)) {
-            [result addObject:attr];
-        }
+    return MAX(1, MIN(gridCols, kSubGridColumns));
+}
+
+- (CGFloat)itemWidthForGridColumns:(NSInteger)gridCols {
+    if (gridCols >= kSubGridColumns) return self.columnWidth;
+    // Proportional width minus spacing between sub-grid items
+    return floor((self.columnWidth * gridCols) / kSubGridColumns - kSubGridSpacing * 0.5);
+}
+
+- (CGFloat)heightForItemAtIndexPath:(NSIndexPath *)indexPath gridColumns:(NSInteger)gridCols {
+    CGFloat itemHeight = 100.0;
+    if ([self.delegate respondsToSelector:@selector(collectionView:layout:heightForItemAtIndexPath:itemWidth:)]) {
+        itemHeight = [self.delegate collectionView:self.collectionView layout:self
+                          heightForItemAtIndexPath:indexPath itemWidth:[self itemWidthForGridColumns:gridCols]];
     }
+    return itemHeight;
+}
 
-    return result;
+- (CGSize)collectionViewContentSize {
+    return self.cachedContentSize;
+}
+
+- (NSArray<UICollectionViewLayoutAttributes *> *)layoutAttributesForElementsInRect:(CGRect)rect {
+    return [self.attributesIndex attributesInRect:rect];
 }
 
 - (UICollectionViewLayoutAttributes *)layoutAttributesForItemAtIndexPath:(NSIndexPath *)indexPath {
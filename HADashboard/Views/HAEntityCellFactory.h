@@ -14,4 +14,7 @@
 /// cardType overrides domain-based lookup for specific card types (entities, thermostat).
 + (NSString *)reuseIdentifierForEntity:(HAEntity *)entity cardType:(NSString *)cardType;
 
+/// Cell class that reuseIdentifierForEntity:cardType: dequeues.
++ (Class)cellClassForEntity:(HAEntity *)entity cardType:(NSString *)cardType;
+
 @end
@@ -308,4 +308,9 @@ static NSString *const kLogbookCardCellId   = @"HALogbookCardCell";
     return [self reuseIdentifierForEntity:entity];
 }
 
++ (Class)cellClassForEntity:(HAEntity *)entity cardType:(NSString *)cardType {
+    // Every reuse identifier is its cell's class name
+    return NSClassFromString([self reuseIdentifierForEntity:entity cardType:cardType]) ?: [HABaseEntityCell class];
+}
+
 @end
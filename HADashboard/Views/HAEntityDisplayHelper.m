@@ -181,15 +181,22 @@
 
 #pragma mark - Number Formatting
 
-+ (NSString *)formattedNumberString:(double)value decimals:(NSInteger)decimals {
-    static NSNumberFormatter *formatter = nil;
-    static dispatch_once_t onceToken;
-    dispatch_once(&onceToken, ^{
+/// The digit limits are set per call, so a shared formatter would race
+/// between main and the view model queue: one per thread.
+static NSNumberFormatter *HANumberFormatter(void) {
+    NSMutableDictionary *threadDict = [NSThread currentThread].threadDictionary;
+    NSNumberFormatter *formatter = threadDict[@"HAEntityDisplayNumberFormatter"];
+    if (!formatter) {
         formatter = [[NSNumberFormatter alloc] init];
         formatter.numberStyle = NSNumberFormatterDecimalStyle;
         formatter.usesGroupingSeparator = YES;
-    });
+        threadDict[@"HAEntityDisplayNumberFormatter"] = formatter;
+    }
+    return formatter;
+}
 
++ (NSString *)formattedNumberString:(double)value decimals:(NSInteger)decimals {
+    NSNumberFormatter *formatter = HANumberFormatter();
     formatter.minimumFractionDigits = 0;
     formatter.maximumFractionDigits = decimals;
 
@@ -248,10 +255,10 @@
 + (NSString *)relativeTimeFromISO8601:(NSString *)isoString {
     if (!isoString || isoString.length < 19) return nil;
 
-    NSDate *date = [HADateUtils dateFromISO8601String:isoString];
-    if (!date) return nil;
+    NSTimeInterval epoch;
+    if (![HADateUtils epochFromISO8601String:isoString epoch:&epoch]) return nil;
 
-    NSTimeInterval elapsed = -[date timeIntervalSinceNow];
+    NSTimeInterval elapsed = [[NSDate date] timeIntervalSince1970] - epoch;
     BOOL isFuture = elapsed < 0;
     NSTimeInterval absElapsed = fabs(elapsed);
 
@@ -279,7 +286,7 @@
             shortFormatter.dateStyle = NSDateFormatterShortStyle;
             shortFormatter.timeStyle = NSDateFormatterShortStyle;
         });
-        return [shortFormatter stringFromDate:date];
+        return [shortFormatter stringFromDate:[NSDate dateWithTimeIntervalSince1970:epoch]];
     }
 
     return isFuture
@@ -0,0 +1,94 @@
+#import <UIKit/UIKit.h>
+
+/// One axis label: text plus where it goes in graph view coordinates.
+@interface HAGraphAxisTick : NSObject
+@property (nonatomic, copy, readonly) NSString *text;
+@property (nonatomic, assign, readonly) CGRect frame;
+@property (nonatomic, assign, readonly) NSTextAlignment alignment;
+@property (nonatomic, assign, readonly) BOOL isUnit; // Unit caption above a value axis
+@end
+
+/// One drawable stretch of a compacted timeline row. Positions are in
+/// points from the start of the bar area.
+@interface HAGraphTimelineRun : NSObject
+/// nil for a mixed run: several states flapping within one pixel column.
+@property (nonatomic, copy, readonly) NSString *state;
+@property (nonatomic, assign, readonly) CGFloat x;
+@property (nonatomic, assign, readonly) CGFloat width;
+@end
+
+/// Snapshot of everything the line-graph geometry stage needs, captured on
+/// the main thread. Treat as immutable once handed to HAGraphGeometry.
+@interface HAGraphGeometryInput : NSObject
+/// Points to draw per series, already windowed (@[] = hidden or no data).
+@property (nonatomic, copy) NSArray<NSArray<NSDictionary *> *> *seriesPoints;
+/// Axis group index per series; groups share Y scaling.
+@property (nonatomic, copy) NSArray<NSNumber *> *seriesGroups;
+/// Unit per axis group ("" = none), drawn above that group's value axis.
+@property (nonatomic, copy) NSArray<NSString *> *groupUnits;
+/// Series that gets the gradient fill, or -1.
+@property (nonatomic, assign) NSInteger fillSeries;
+@property (nonatomic, assign) CGSize size;
+@property (nonatomic, assign) CGFloat leftPadding;
+@property (nonatomic, assign) CGFloat rightPadding;
+@property (nonatomic, assign) CGFloat bottomPadding;
+@property (nonatomic, assign) CGFloat legendHeight;
+/// Drawn time range (the visible window when zoomed).
+@property (nonatomic, assign) NSTimeInterval minTime;
+@property (nonatomic, assign) NSTimeInterval maxTime;
+@property (nonatomic, assign) BOOL axisLabels;
+/// Bumped by the view whenever the data behind seriesPoints changes.
+@property (nonatomic, assign) NSUInteger generation;
+
+/// (generation, size, window, axes) — identical keys give identical geometry.
+- (NSString *)cacheKey;
+@end
+
+/// Pure geometry for a line graph: paths, per-group Y ranges and axis ticks.
+/// Built from an HAGraphGeometryInput on any thread (HAGraphView uses a
+/// background queue); applying it to layers is left to the view.
+@interface HAGraphGeometry : NSObject
+
++ (instancetype)geometryWithInput:(HAGraphGeometryInput *)input;
+
+@property (nonatomic, assign, readonly) NSUInteger generation;
+@property (nonatomic, assign, readonly) NSTimeInterval minTime;
+@property (nonatomic, assign, readonly) NSTimeInterval maxTime;
+
+/// Per series: line path, or nil when there is nothing to draw.
+- (CGPathRef)linePathAtIndex:(NSUInteger)index;
+/// Per series: min/max band path, or nil when the points carry no band.
+- (CGPathRef)bandPathAtIndex:(NSUInteger)index;
+/// Gradient mask for fillSeries, or nil.
+@property (nonatomic, assign, readonly) CGPathRef fillPath;
+@property (nonatomic, assign, readonly) NSInteger fillSeries;
+
+/// Padded Y range per axis group.
+@property (nonatomic, copy, readonly) NSArray<NSNumber *> *groupMins;
+@property (nonatomic, copy, readonly) NSArray<NSNumber *> *groupMaxes;
+
+@property (nonatomic, copy, readonly) NSArray<HAGraphAxisTick *> *valueTicks;
+@property (nonatomic, copy, readonly) NSArray<HAGraphAxisTick *> *timeTicks;
+
+/// Time axis ticks for [minTime, maxTime] across a drawing area. Shared
+/// with the timeline renderer, which lays out its own bars.
++ (NSArray<HAGraphAxisTick *> *)timeTicksForMinTime:(NSTimeInterval)minTime
+                                            maxTime:(NSTimeInterval)maxTime
+                                              areaX:(CGFloat)areaX
+                                          areaWidth:(CGFloat)areaWidth
+                                          baselineY:(CGFloat)baselineY
+                                          viewWidth:(CGFloat)viewWidth;
+
+/// Compacts one timeline row for drawing across areaWidth points at
+/// pixelScale pixels per point. Adjacent segments in the same state merge;
+/// runs narrower than a pixel are pooled until they fill one, and become a
+/// single mixed run if they disagree. The result never has more runs than
+/// the row has pixel columns (times two), however many segments come in.
+/// Segments are @{@"state", @"start", @"end"} in time order.
++ (NSArray<HAGraphTimelineRun *> *)timelineRunsForSegments:(NSArray<NSDictionary *> *)segments
+                                                   minTime:(NSTimeInterval)minTime
+                                                   maxTime:(NSTimeInterval)maxTime
+                                                 areaWidth:(CGFloat)areaWidth
+                                                pixelScale:(CGFloat)pixelScale;
+
+@end
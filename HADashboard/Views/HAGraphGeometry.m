@@ -0,0 +1,452 @@
+#import "HAGraphGeometry.h"
+
+static const CGFloat kGraphInsetY = 2.0;
+static const NSUInteger kGraphValueTickCount = 5;
+
+/// NSDateFormatter is not safe to share across threads, and geometry runs
+/// on a background queue while timelines label on main: one per thread.
+static NSDateFormatter *HAGraphTimeFormatter(void) {
+    NSMutableDictionary *threadDict = [NSThread currentThread].threadDictionary;
+    NSDateFormatter *fmt = threadDict[@"HAGraphGeometryTimeFormatter"];
+    if (!fmt) {
+        fmt = [[NSDateFormatter alloc] init];
+        threadDict[@"HAGraphGeometryTimeFormatter"] = fmt;
+    }
+    return fmt;
+}
+
+/// Value extent of a point, widened by its @"min"/@"max" band when present.
+static inline void HAGraphPointExtent(NSDictionary *pt, double *lo, double *hi) {
+    double v = [pt[@"value"] doubleValue];
+    NSNumber *bandMin = pt[@"min"];
+    NSNumber *bandMax = pt[@"max"];
+    *lo = bandMin ? MIN(v, [bandMin doubleValue]) : v;
+    *hi = bandMax ? MAX(v, [bandMax doubleValue]) : v;
+}
+
+/// Maps (time, value) into view coordinates for one axis group.
+typedef struct {
+    double minTime, xRange, minVal, yRange;
+    CGFloat left, width, drawH;
+} HAGraphProjection;
+
+static inline CGPoint HAGraphProject(const HAGraphProjection *pr, double t, double v) {
+    return CGPointMake(pr->left + (CGFloat)((t - pr->minTime) / pr->xRange) * pr->width,
+                       kGraphInsetY + pr->drawH - (CGFloat)((v - pr->minVal) / pr->yRange) * pr->drawH);
+}
+
+/// Min/max envelope for statistics points: along the maxima left to right,
+/// back along the minima. NULL when no point carries a band.
+static CGPathRef HAGraphCreateBandPath(NSArray<NSDictionary *> *points, const HAGraphProjection *pr) {
+    if (points.count < 2 || !points.firstObject[@"min"]) return NULL;
+    CGMutablePathRef path = CGPathCreateMutable();
+    BOOL first = YES;
+    for (NSDictionary *pt in points) {
+        double lo, hi;
+        HAGraphPointExtent(pt, &lo, &hi);
+        CGPoint p = HAGraphProject(pr, [pt[@"timestamp"] doubleValue], hi);
+        if (first) {
+            CGPathMoveToPoint(path, NULL, p.x, p.y);
+            first = NO;
+        } else {
+            CGPathAddLineToPoint(path, NULL, p.x, p.y);
+        }
+    }
+    for (NSDictionary *pt in points.reverseObjectEnumerator) {
+        double lo, hi;
+        HAGraphPointExtent(pt, &lo, &hi);
+        CGPoint p = HAGraphProject(pr, [pt[@"timestamp"] doubleValue], lo);
+        CGPathAddLineToPoint(path, NULL, p.x, p.y);
+    }
+    CGPathCloseSubpath(path);
+    return path;
+}
+
+#pragma mark - HAGraphAxisTick
+
+@interface HAGraphAxisTick ()
+@property (nonatomic, copy, readwrite) NSString *text;
+@property (nonatomic, assign, readwrite) CGRect frame;
+@property (nonatomic, assign, readwrite) NSTextAlignment alignment;
+@property (nonatomic, assign, readwrite) BOOL isUnit;
+@end
+
+@implementation HAGraphAxisTick
+
++ (instancetype)tickWithText:(NSString *)text frame:(CGRect)frame alignment:(NSTextAlignment)alignment {
+    HAGraphAxisTick *tick = [[self alloc] init];
+    tick.text = text;
+    tick.frame = frame;
+    tick.alignment = alignment;
+    return tick;
+}
+
+@end
+
+#pragma mark - HAGraphTimelineRun
+
+@interface HAGraphTimelineRun ()
+@property (nonatomic, copy, readwrite) NSString *state;
+@property (nonatomic, assign, readwrite) CGFloat x;
+@property (nonatomic, assign, readwrite) CGFloat width;
+@end
+
+@implementation HAGraphTimelineRun
+@end
+
+#pragma mark - HAGraphGeometryInput
+
+@implementation HAGraphGeometryInput
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _seriesPoints = @[];
+        _seriesGroups = @[];
+        _groupUnits = @[];
+        _fillSeries = -1;
+    }
+    return self;
+}
+
+- (NSString *)cacheKey {
+    // Hidden series arrive as empty point arrays; the mask keeps a legend
+    // toggle from reusing geometry drawn with that series in it.
+    NSMutableString *mask = [NSMutableString stringWithCapacity:self.seriesPoints.count];
+    for (NSArray *points in self.seriesPoints) {
+        [mask appendString:(points.count > 0) ? @"1" : @"0"];
+    }
+    return [NSString stringWithFormat:@"%lu|%.1fx%.1f|%.3f-%.3f|%.1f,%.1f,%.1f,%.1f|%d|%ld|%@",
+            (unsigned long)self.generation, self.size.width, self.size.height,
+            self.minTime, self.maxTime,
+            self.leftPadding, self.rightPadding, self.bottomPadding, self.legendHeight,
+            self.axisLabels, (long)self.fillSeries, mask];
+}
+
+@end
+
+#pragma mark - HAGraphGeometry
+
+@interface HAGraphGeometry ()
+@property (nonatomic, assign, readwrite) NSUInteger generation;
+@property (nonatomic, assign, readwrite) NSTimeInterval minTime;
+@property (nonatomic, assign, readwrite) NSTimeInterval maxTime;
+@property (nonatomic, assign, readwrite) NSInteger fillSeries;
+@property (nonatomic, strong) NSArray *linePaths; // CGPathRef or NSNull per series
+@property (nonatomic, strong) NSArray *bandPaths;
+@property (nonatomic, copy, readwrite) NSArray<NSNumber *> *groupMins;
+@property (nonatomic, copy, readwrite) NSArray<NSNumber *> *groupMaxes;
+@property (nonatomic, copy, readwrite) NSArray<HAGraphAxisTick *> *valueTicks;
+@property (nonatomic, copy, readwrite) NSArray<HAGraphAxisTick *> *timeTicks;
+@end
+
+@implementation HAGraphGeometry
+
+- (void)dealloc {
+    CGPathRelease(_fillPath);
+}
+
+- (CGPathRef)linePathAtIndex:(NSUInteger)index {
+    id path = (index < self.linePaths.count) ? self.linePaths[index] : nil;
+    return (path && path != [NSNull null]) ? (__bridge CGPathRef)path : NULL;
+}
+
+- (CGPathRef)bandPathAtIndex:(NSUInteger)index {
+    id path = (index < self.bandPaths.count) ? self.bandPaths[index] : nil;
+    return (path && path != [NSNull null]) ? (__bridge CGPathRef)path : NULL;
+}
+
++ (instancetype)geometryWithInput:(HAGraphGeometryInput *)input {
+    HAGraphGeometry *geometry = [[self alloc] init];
+    geometry.generation = input.generation;
+    geometry.minTime = input.minTime;
+    geometry.maxTime = input.maxTime;
+    geometry.fillSeries = input.fillSeries;
+
+    NSUInteger seriesCount = input.seriesPoints.count;
+    NSUInteger groupCount = MAX(input.groupUnits.count, (NSUInteger)1);
+    CGFloat w = input.size.width - input.leftPadding - input.rightPadding;
+    CGFloat h = input.size.height;
+    CGFloat drawH = h - kGraphInsetY * 2 - input.legendHeight - input.bottomPadding;
+    if (drawH < 10) drawH = 10;
+    CGFloat fillBottom = h - input.legendHeight - input.bottomPadding;
+
+    // Per-group Y range over what is drawn, padded by 10%
+    double *gMin = calloc(groupCount, sizeof(double));
+    double *gMax = calloc(groupCount, sizeof(double));
+    for (NSUInteger gi = 0; gi < groupCount; gi++) {
+        gMin[gi] = HUGE_VAL;
+        gMax[gi] = -HUGE_VAL;
+    }
+    for (NSUInteger i = 0; i < seriesCount; i++) {
+        NSUInteger gi = (i < input.seriesGroups.count) ? [input.seriesGroups[i] unsignedIntegerValue] : 0;
+        if (gi >= groupCount) gi = 0;
+        for (NSDictionary *pt in input.seriesPoints[i]) {
+            double lo, hi;
+            HAGraphPointExtent(pt, &lo, &hi);
+            if (lo < gMin[gi]) gMin[gi] = lo;
+            if (hi > gMax[gi]) gMax[gi] = hi;
+        }
+    }
+    NSMutableArray<NSNumber *> *mins = [NSMutableArray arrayWithCapacity:groupCount];
+    NSMutableArray<NSNumber *> *maxes = [NSMutableArray arrayWithCapacity:groupCount];
+    for (NSUInteger gi = 0; gi < groupCount; gi++) {
+        if (gMin[gi] <= gMax[gi]) {
+            double yRange = gMax[gi] - gMin[gi];
+            if (yRange < 0.001) yRange = 1.0;
+            gMin[gi] -= yRange * 0.1;
+            gMax[gi] += yRange * 0.1;
+        } else {
+            // No visible data for this group
+            gMin[gi] = 0.0;
+            gMax[gi] = 1.0;
+        }
+        [mins addObject:@(gMin[gi])];
+        [maxes addObject:@(gMax[gi])];
+    }
+    geometry.groupMins = mins;
+    geometry.groupMaxes = maxes;
+
+    double xRange = input.maxTime - input.minTime;
+    if (xRange < 1.0) xRange = 1.0;
+
+    NSMutableArray *linePaths = [NSMutableArray arrayWithCapacity:seriesCount];
+    NSMutableArray *bandPaths = [NSMutableArray arrayWithCapacity:seriesCount];
+    BOOL drewLine = NO;
+    for (NSUInteger i = 0; i < seriesCount; i++) {
+        NSArray<NSDictionary *> *points = input.seriesPoints[i];
+        if (points.count < 2) {
+            [linePaths addObject:[NSNull null]];
+            [bandPaths addObject:[NSNull null]];
+            continue;
+        }
+        NSUInteger gi = (i < input.seriesGroups.count) ? [input.seriesGroups[i] unsignedIntegerValue] : 0;
+        if (gi >= groupCount) gi = 0;
+        double yRange = gMax[gi] - gMin[gi];
+        if (yRange < 0.001) yRange = 1.0;
+        HAGraphProjection pr = {input.minTime, xRange, gMin[gi], yRange, input.leftPadding, w, drawH};
+
+        BOOL wantsFill = ((NSInteger)i == input.fillSeries);
+        CGMutablePathRef line = CGPathCreateMutable();
+        CGMutablePathRef fill = wantsFill ? CGPathCreateMutable() : NULL;
+        BOOL first = YES;
+        CGPoint last = CGPointZero;
+        for (NSDictionary *pt in points) {
+            CGPoint p = HAGraphProject(&pr, [pt[@"timestamp"] doubleValue], [pt[@"value"] doubleValue]);
+            if (first) {
+                CGPathMoveToPoint(line, NULL, p.x, p.y);
+                if (fill) {
+                    CGPathMoveToPoint(fill, NULL, p.x, fillBottom);
+                    CGPathAddLineToPoint(fill, NULL, p.x, p.y);
+                }
+                first = NO;
+            } else {
+                CGPathAddLineToPoint(line, NULL, p.x, p.y);
+                if (fill) CGPathAddLineToPoint(fill, NULL, p.x, p.y);
+            }
+            last = p;
+        }
+        [linePaths addObject:(__bridge id)line];
+        CGPathRelease(line);
+
+        CGPathRef band = HAGraphCreateBandPath(points, &pr);
+        [bandPaths addObject:band ? (__bridge id)band : [NSNull null]];
+        CGPathRelease(band);
+
+        if (fill) {
+            CGPathAddLineToPoint(fill, NULL, last.x, fillBottom);
+            CGPathCloseSubpath(fill);
+            geometry->_fillPath = fill;
+        }
+        drewLine = YES;
+    }
+    geometry.linePaths = linePaths;
+    geometry.bandPaths = bandPaths;
+
+    // Axis ticks only accompany a drawn line over a meaningful range
+    if (input.axisLabels && drewLine && input.maxTime - input.minTime >= 1.0) {
+        geometry.valueTicks = [self valueTicksForInput:input mins:gMin maxes:gMax groupCount:groupCount drawH:drawH];
+        geometry.timeTicks = [self timeTicksForMinTime:input.minTime maxTime:input.maxTime
+                                                 areaX:input.leftPadding areaWidth:w
+                                             baselineY:fillBottom viewWidth:input.size.width];
+    } else {
+        geometry.valueTicks = @[];
+        geometry.timeTicks = @[];
+    }
+
+    free(gMin);
+    free(gMax);
+    return geometry;
+}
+
+/// Five labels per axis group: group 0 on the left, the rest stacked
+/// inward from the right edge, each with its unit on top.
++ (NSArray<HAGraphAxisTick *> *)valueTicksForInput:(HAGraphGeometryInput *)input
+                                              mins:(const double *)mins
+                                             maxes:(const double *)maxes
+                                        groupCount:(NSUInteger)groupCount
+                                             drawH:(CGFloat)drawH {
+    NSMutableArray<HAGraphAxisTick *> *ticks = [NSMutableArray arrayWithCapacity:groupCount * (kGraphValueTickCount + 1)];
+    for (NSUInteger gi = 0; gi < groupCount; gi++) {
+        double minVal = mins[gi];
+        double valRange = maxes[gi] - minVal;
+        if (valRange < 0.0001) valRange = 1.0;
+        NSString *fmt = (valRange > 10.0) ? @"%.0f" : @"%.1f";
+
+        CGFloat axisX = 0;
+        CGFloat axisWidth = input.leftPadding - 3.0;
+        NSTextAlignment alignment = NSTextAlignmentRight;
+        if (gi > 0) {
+            axisX = input.size.width - input.rightPadding + (gi - 1) * 35.0;
+            axisWidth = 32.0;
+            alignment = NSTextAlignmentLeft;
+        }
+
+        NSString *unit = (gi < input.groupUnits.count) ? input.groupUnits[gi] : @"";
+        if (unit.length > 0) {
+            HAGraphAxisTick *unitTick = [HAGraphAxisTick tickWithText:unit
+                                                                frame:CGRectMake(axisX, kGraphInsetY - 2, axisWidth, 10)
+                                                            alignment:alignment];
+            unitTick.isUnit = YES;
+            [ticks addObject:unitTick];
+        }
+
+        for (NSUInteger i = 0; i < kGraphValueTickCount; i++) {
+            double fraction = (double)i / (double)(kGraphValueTickCount - 1);
+            CGFloat y = kGraphInsetY + drawH - (CGFloat)fraction * drawH;
+            [ticks addObject:[HAGraphAxisTick tickWithText:[NSString stringWithFormat:fmt, minVal + fraction * valRange]
+                                                     frame:CGRectMake(axisX, y - 6.0, axisWidth, 12.0)
+                                                 alignment:alignment]];
+        }
+    }
+    return ticks;
+}
+
++ (NSArray<HAGraphAxisTick *> *)timeTicksForMinTime:(NSTimeInterval)minTime
+                                            maxTime:(NSTimeInterval)maxTime
+                                              areaX:(CGFloat)areaX
+                                          areaWidth:(CGFloat)areaWidth
+                                          baselineY:(CGFloat)baselineY
+                                          viewWidth:(CGFloat)viewWidth {
+    double timeRange = maxTime - minTime;
+    if (timeRange < 1.0) return @[];
+
+    NSDateFormatter *timeFmt = HAGraphTimeFormatter();
+    if (timeRange > 604800) {
+        timeFmt.dateFormat = @"d/M HH:mm";
+    } else if (timeRange > 86400) {
+        timeFmt.dateFormat = @"MMM d";
+    } else {
+        timeFmt.dateFormat = @"HH:mm";
+    }
+
+    NSUInteger timeCount = (timeRange > 86400) ? 4 : 5;
+    // Fewer labels if the drawing area is narrow
+    if (areaWidth < 150) timeCount = 3;
+
+    NSDictionary *attrs = @{NSFontAttributeName: [UIFont systemFontOfSize:9]};
+    NSMutableArray<HAGraphAxisTick *> *ticks = [NSMutableArray arrayWithCapacity:timeCount];
+    for (NSUInteger i = 0; i < timeCount; i++) {
+        double fraction = (double)i / (double)(timeCount - 1);
+        NSString *text = [timeFmt stringFromDate:[NSDate dateWithTimeIntervalSince1970:minTime + fraction * timeRange]];
+        CGFloat x = areaX + (CGFloat)fraction * areaWidth;
+
+        // Center on x, clamped to the view
+        CGFloat lblW = ceil([text sizeWithAttributes:attrs].width);
+        CGFloat lblX = x - lblW / 2.0;
+        if (lblX < 0) lblX = 0;
+        if (lblX + lblW > viewWidth) lblX = viewWidth - lblW;
+        [ticks addObject:[HAGraphAxisTick tickWithText:text
+                                                 frame:CGRectMake(lblX, baselineY + 2.0, lblW, 14.0)
+                                             alignment:NSTextAlignmentCenter]];
+    }
+    return ticks;
+}
+
+#pragma mark - Timeline
+
++ (NSArray<HAGraphTimelineRun *> *)timelineRunsForSegments:(NSArray<NSDictionary *> *)segments
+                                                   minTime:(NSTimeInterval)minTime
+                                                   maxTime:(NSTimeInterval)maxTime
+                                                 areaWidth:(CGFloat)areaWidth
+                                                pixelScale:(CGFloat)pixelScale {
+    double timeRange = maxTime - minTime;
+    if (timeRange < 1.0) timeRange = 1.0;
+    double pointsPerSecond = areaWidth / timeRange;
+    CGFloat pixel = 1.0 / MAX(pixelScale, 1.0);
+
+    NSMutableArray<HAGraphTimelineRun *> *runs = [NSMutableArray array];
+    __block CGFloat drawnEnd = 0; // Runs never overlap: each starts where the last ended
+
+    void (^addRun)(NSString *, CGFloat, CGFloat) = ^(NSString *state, CGFloat x0, CGFloat x1) {
+        x0 = MAX(x0, drawnEnd);
+        if (x1 <= x0) return;
+        HAGraphTimelineRun *last = runs.lastObject;
+        BOOL sameState = (last.state == state) || [last.state isEqualToString:state];
+        if (last && sameState && last.x + last.width >= x0 - 0.001) {
+            last.width = x1 - last.x;
+        } else {
+            HAGraphTimelineRun *run = [[HAGraphTimelineRun alloc] init];
+            run.state = state;
+            run.x = x0;
+            run.width = x1 - x0;
+            [runs addObject:run];
+        }
+        drawnEnd = x1;
+    };
+
+    // Sub-pixel runs pool here until they cover a pixel
+    __block BOOL pooling = NO, poolMixed = NO;
+    __block CGFloat poolStart = 0, poolEnd = 0;
+    __block NSString *poolState = nil;
+    void (^flushPool)(void) = ^{
+        if (!pooling) return;
+        // A lone blip still gets a pixel so it stays visible
+        addRun(poolMixed ? nil : poolState, poolStart, MIN(MAX(poolEnd, poolStart + pixel), areaWidth));
+        pooling = NO;
+    };
+
+    void (^place)(NSString *, double, double) = ^(NSString *state, double start, double end) {
+        CGFloat x0 = (CGFloat)MIN(MAX((start - minTime) * pointsPerSecond, 0.0), areaWidth);
+        CGFloat x1 = (CGFloat)MIN(MAX((end - minTime) * pointsPerSecond, 0.0), areaWidth);
+        if (x1 - x0 >= pixel) {
+            flushPool();
+            addRun(state, x0, x1);
+            return;
+        }
+        if (!pooling) {
+            pooling = YES;
+            poolMixed = NO;
+            poolStart = x0;
+            poolEnd = x1;
+            poolState = state;
+        } else {
+            poolEnd = MAX(poolEnd, x1);
+            if (![state isEqualToString:poolState]) poolMixed = YES;
+        }
+        if (poolEnd - poolStart >= pixel) flushPool();
+    };
+
+    // Merge adjacent segments in the same state before placing them
+    NSString *curState = nil;
+    double curStart = 0, curEnd = 0;
+    for (NSDictionary *seg in segments) {
+        NSString *state = [seg[@"state"] isKindOfClass:[NSString class]] ? seg[@"state"] : @"";
+        double start = [seg[@"start"] doubleValue];
+        double end = [seg[@"end"] doubleValue];
+        if (curState && [state isEqualToString:curState]) {
+            curEnd = MAX(curEnd, end);
+            continue;
+        }
+        if (curState) place(curState, curStart, curEnd);
+        curState = state;
+        curStart = start;
+        curEnd = end;
+    }
+    if (curState) place(curState, curStart, curEnd);
+    flushPool();
+
+    return runs;
+}
+
+@end
@@ -1,6 +1,7 @@
 #import <UIKit/UIKit.h>
 
 @class HAGraphView;
+@class HAHistoryPyramid;
 
 @protocol HAGraphViewDelegate <NSObject>
 @optional
@@ -21,9 +22,16 @@
 @property (nonatomic, strong) NSMutableIndexSet *hiddenSeriesIndices;
 
 /// Single-series data: Array of NSDictionary with keys @"value" (NSNumber) and @"timestamp" (NSNumber, Unix epoch)
+/// Optional @"min"/@"max" (NSNumber) keys, as returned for long-term statistics, are drawn as a translucent band
+/// around the line and included in Y scaling.
 /// Setting this clears any multi-series data and renders a single line.
 @property (nonatomic, copy) NSArray<NSDictionary *> *dataPoints;
 @property (nonatomic, strong) UIColor *lineColor;
+
+/// Optional resolution pyramid for the single series in dataPoints. While zoomed, the line is drawn from the
+/// pyramid's best data for the visible window (about one sample per point of width), and finer tiles are
+/// loaded when a pinch/pan ends. Setting dataPoints clears it, so assign it after the points.
+@property (nonatomic, strong) HAHistoryPyramid *dataPyramid;
 @property (nonatomic, strong) UIColor *fillColor;
 
 /// Multi-series data: Array of NSDictionary, each with:
@@ -31,6 +39,7 @@
 ///   @"color"  — UIColor
 ///   @"label"  — NSString (entity friendly name, shown in legend)
 ///   @"unit"   — NSString (unit of measurement, used for multi-axis grouping; empty string if no unit)
+///   @"pyramid" — HAHistoryPyramid (optional; same role as dataPyramid, for this series)
 /// When set, dataPoints/lineColor are ignored. Gradient fill applies to first series only.
 /// Series are grouped by unit; each group gets independent Y-axis scaling.
 @property (nonatomic, copy) NSArray<NSDictionary *> *dataSeries;
@@ -51,7 +60,8 @@
 /// Enable touch-to-inspect mode (crosshair + tooltip). Default NO.
 @property (nonatomic, assign) BOOL inspectionEnabled;
 
-/// Currently visible time window (narrower than data when zoomed).
+/// Currently visible time window (narrower than data when zoomed). Both 0 = whole data range.
+/// Reset when new data is set.
 @property (nonatomic, assign) NSTimeInterval visibleStartTime;
 @property (nonatomic, assign) NSTimeInterval visibleEndTime;
 
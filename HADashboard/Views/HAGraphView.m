@@ -1,9 +1,12 @@
 #import "HAGraphView.h"
+#import "HAGraphGeometry.h"
+#import "HAHistoryPyramid.h"
 #import "HATheme.h"
-#import <sys/utsname.h>
+#import "HADeviceRegistration.h"
 
-// Cached date formatters used by axis labels, tooltip, and gesture handlers.
-// Format is set per-use since it depends on the visible time range.
+// Cached date formatter used by the tooltip and gesture handlers (main thread;
+// axis labels format on the geometry queue). Format is set per-use since it
+// depends on the visible time range.
 static NSDateFormatter *sCachedTimeFmt(void) {
     static NSDateFormatter *fmt = nil;
     static dispatch_once_t onceToken;
@@ -13,8 +16,52 @@ static NSDateFormatter *sCachedTimeFmt(void) {
     return fmt;
 }
 
+/// Index of the first point with timestamp >= t.
+static NSUInteger HAGraphLowerBound(NSArray<NSDictionary *> *points, double t) {
+    NSUInteger lo = 0, hi = points.count;
+    while (lo < hi) {
+        NSUInteger mid = lo + (hi - lo) / 2;
+        if ([points[mid][@"timestamp"] doubleValue] < t) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/// Point on the segment a→b at time t (value and band interpolated).
+static NSDictionary *HAGraphInterpolatedPoint(NSDictionary *a, NSDictionary *b, double t) {
+    double ta = [a[@"timestamp"] doubleValue];
+    double tb = [b[@"timestamp"] doubleValue];
+    double f = (tb - ta > 0.001) ? (t - ta) / (tb - ta) : 0.0;
+    NSMutableDictionary *pt = [NSMutableDictionary dictionaryWithCapacity:4];
+    pt[@"timestamp"] = @(t);
+    for (NSString *key in @[@"value", @"min", @"max"]) {
+        NSNumber *va = a[key], *vb = b[key];
+        if (va && vb) pt[key] = @([va doubleValue] + f * ([vb doubleValue] - [va doubleValue]));
+    }
+    return pt;
+}
+
+/// Points within [start, end], with the segments crossing either edge cut
+/// exactly at it, so a zoomed line never spills into the axis gutters.
+static NSArray<NSDictionary *> *HAGraphClipPoints(NSArray<NSDictionary *> *points, double start, double end) {
+    NSUInteger n = points.count;
+    NSUInteger lo = HAGraphLowerBound(points, start);
+    NSUInteger hi = HAGraphLowerBound(points, end);
+    while (hi < n && [points[hi][@"timestamp"] doubleValue] <= end) hi++;
+
+    NSMutableArray *clipped = [NSMutableArray arrayWithCapacity:hi - lo + 2];
+    if (lo > 0 && lo < n) [clipped addObject:HAGraphInterpolatedPoint(points[lo - 1], points[lo], start)];
+    if (hi > lo) [clipped addObjectsFromArray:[points subarrayWithRange:NSMakeRange(lo, hi - lo)]];
+    if (hi > 0 && hi < n) [clipped addObject:HAGraphInterpolatedPoint(points[hi - 1], points[hi], end)];
+    return clipped;
+}
+
 @interface HAGraphView () <UIGestureRecognizerDelegate>
 @property (nonatomic, strong) NSMutableArray<CAShapeLayer *> *lineLayers;
+@property (nonatomic, strong) NSMutableArray<CAShapeLayer *> *bandLayers; // Min/max envelope per line layer
 @property (nonatomic, strong) CAShapeLayer *fillMaskLayer;
 @property (nonatomic, strong) CAGradientLayer *gradientLayer;
 @property (nonatomic, strong) UIView *legendContainer;
@@ -24,7 +71,7 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 @property (nonatomic, strong) NSMutableArray<NSValue *> *legendEntryFrames; // CGRect wrapped in NSValue for hit-testing
 @property (nonatomic, assign) BOOL lightweight; // Skip gradient on older devices
 // State timeline rendering
-@property (nonatomic, strong) NSMutableArray<CALayer *> *timelineLayers; // Bar segment layers
+@property (nonatomic, strong) NSMutableArray<CALayer *> *timelineLayers; // Row track layers (run shapes are sublayers)
 @property (nonatomic, strong) NSMutableArray<UILabel *> *timelineLabels; // Entity name labels
 // Axis labels
 @property (nonatomic, strong) NSMutableArray<UILabel *> *timeAxisLabels;
@@ -34,9 +81,19 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 @property (nonatomic, assign) double currentMaxVal;
 @property (nonatomic, assign) NSTimeInterval currentMinTime;
 @property (nonatomic, assign) NSTimeInterval currentMaxTime;
-// Multi-axis Y scaling by unit: groups[i] = @{@"unit":NSString, @"indices":NSIndexSet, @"yMin":NSNumber, @"yMax":NSNumber}
-@property (nonatomic, strong) NSArray<NSDictionary *> *axisGroups;
-@property (nonatomic, strong) NSMutableDictionary<NSNumber *, NSNumber *> *seriesIndexToGroupIndex; // series idx -> group idx
+// Full extent of the line data (currentMin/MaxTime is the drawn range, narrower when zoomed)
+@property (nonatomic, assign) NSTimeInterval dataMinTime;
+@property (nonatomic, assign) NSTimeInterval dataMaxTime;
+// Multi-axis Y scaling by unit, in order of first appearance; ranges come from HAGraphGeometry
+@property (nonatomic, copy) NSArray<NSString *> *axisGroupUnits;
+@property (nonatomic, copy) NSArray<NSNumber *> *seriesGroupIndices; // series idx -> group idx
+// Geometry stage: paths and ticks built on a background queue, cached per window
+@property (nonatomic, strong) NSCache<NSString *, HAGraphGeometry *> *geometryCache;
+@property (nonatomic, assign) NSUInteger seriesGeneration; // Bumped when the data behind the paths changes
+@property (nonatomic, copy) NSString *latestGeometryKey;
+@property (nonatomic, assign) BOOL geometryInFlight;
+@property (nonatomic, strong) HAGraphGeometryInput *queuedGeometryInput;
+@property (nonatomic, assign) BOOL queuedGeometryAnimated;
 // Tooltip
 @property (nonatomic, strong) CALayer *crosshairLine;
 @property (nonatomic, strong) UIView *tooltipView;
@@ -78,26 +135,20 @@ static NSDateFormatter *sCachedTimeFmt(void) {
     _lineColor = [UIColor colorWithRed:0.0 green:0.8 blue:0.7 alpha:1.0]; // Teal
     _fillColor = nil; // Will derive from lineColor
     _lineLayers = [NSMutableArray array];
+    _bandLayers = [NSMutableArray array];
     _timelineLayers = [NSMutableArray array];
     _timelineLabels = [NSMutableArray array];
     _timeAxisLabels = [NSMutableArray array];
     _valueAxisLabels = [NSMutableArray array];
     _hiddenSeriesIndices = [NSMutableIndexSet indexSet];
     _legendEntryFrames = [NSMutableArray array];
-    _axisGroups = @[];
-    _seriesIndexToGroupIndex = [NSMutableDictionary dictionary];
-
-    // Detect older devices: armv7 or low RAM -> skip gradient
-    #if !TARGET_OS_SIMULATOR
-    NSString *machine = nil;
-    struct utsname systemInfo;
-    if (uname(&systemInfo) == 0) {
-        machine = [NSString stringWithCString:systemInfo.machine encoding:NSUTF8StringEncoding];
-    }
-    // iPad2,x / iPad3,x / iPhone4,x / iPod5,x are armv7 — use lightweight mode
-    _lightweight = (machine && ([machine hasPrefix:@"iPad2"] || [machine hasPrefix:@"iPad3"] ||
-                                [machine hasPrefix:@"iPhone4"] || [machine hasPrefix:@"iPod5"]));
-    #endif
+    _axisGroupUnits = @[];
+    _seriesGroupIndices = @[];
+    _geometryCache = [[NSCache alloc] init];
+    _geometryCache.countLimit = 8; // A few windows/sizes: rotation, zoom back out
+
+    // Older (armv7) devices skip the gradient
+    _lightweight = HADeviceIsLowEnd();
 
     if (!_lightweight) {
         // Gradient fill layer (skip on old devices — saves GPU compositing)
@@ -219,13 +270,13 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 - (CGFloat)graphAreaLeftPadding {
     if (!self.showAxisLabels) return 0.0;
     // First group gets left axis (30px for value labels)
-    return (self.axisGroups.count > 0) ? 35.0 : 30.0;
+    return (self.axisGroupUnits.count > 0) ? 35.0 : 30.0;
 }
 
 - (CGFloat)graphAreaRightPadding {
     if (!self.showAxisLabels) return 0.0;
     // Additional groups get right axes (35px per group)
-    NSUInteger additionalGroups = (self.axisGroups.count > 1) ? (self.axisGroups.count - 1) : 0;
+    NSUInteger additionalGroups = (self.axisGroupUnits.count > 1) ? (self.axisGroupUnits.count - 1) : 0;
     return additionalGroups * 35.0;
 }
 
@@ -237,8 +288,11 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 
 - (void)setDataPoints:(NSArray<NSDictionary *> *)points animated:(BOOL)animated {
     _dataPoints = [points copy];
+    _dataPyramid = nil;
     _dataSeries = nil;
     _timelineData = nil;
+    [self resetViewport];
+    [self invalidateGeometry];
     [self clearTimelineLayers];
     self.gradientLayer.hidden = NO;
     [self rebuildLayers];
@@ -247,20 +301,54 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 
 - (void)setDataPoints:(NSArray<NSDictionary *> *)dataPoints {
     _dataPoints = [dataPoints copy];
+    _dataPyramid = nil;
     _dataSeries = nil;
     _timelineData = nil;
+    [self resetViewport];
+    [self invalidateGeometry];
     [self clearTimelineLayers];
     self.gradientLayer.hidden = NO;
     [self rebuildLayers];
     [self updatePaths];
 }
 
+- (void)setDataPyramid:(HAHistoryPyramid *)dataPyramid {
+    _dataPyramid = dataPyramid;
+    [self observePyramid:dataPyramid];
+    [self invalidateGeometry];
+    [self updatePathsWithoutAnimation];
+}
+
+/// Redraw when a pyramid tile lands (only matters while zoomed).
+- (void)observePyramid:(HAHistoryPyramid *)pyramid {
+    __weak typeof(self) weakSelf = self;
+    pyramid.changeHandler = ^(HAHistoryPyramid *changed) {
+        if (![weakSelf hasVisibleWindow]) return;
+        // A tile refines the series already drawn; keep it up until the new paths land
+        [weakSelf invalidateGeometryClearingPaths:NO];
+        [weakSelf updatePathsWithoutAnimation];
+    };
+}
+
+/// New data starts unzoomed.
+- (void)resetViewport {
+    _visibleStartTime = 0;
+    _visibleEndTime = 0;
+    _zoomScale = 1.0;
+}
+
 #pragma mark - Multi-series
 
 - (void)setDataSeries:(NSArray<NSDictionary *> *)dataSeries {
     _dataSeries = [dataSeries copy];
     _dataPoints = nil;
+    _dataPyramid = nil;
     _timelineData = nil;
+    [self resetViewport];
+    [self invalidateGeometry];
+    for (NSDictionary *series in _dataSeries) {
+        [self observePyramid:series[@"pyramid"]];
+    }
     [self clearTimelineLayers];
     self.gradientLayer.hidden = NO;
     [self computeAxisGroups];
@@ -268,61 +356,24 @@ static NSDateFormatter *sCachedTimeFmt(void) {
     [self updatePaths];
 }
 
-/// Group series by unit of measurement for multi-axis Y scaling
+/// Group series by unit of measurement for multi-axis Y scaling. Runs once
+/// per data set; per-group ranges are computed with the paths.
 - (void)computeAxisGroups {
-    if (!self.dataSeries || self.dataSeries.count == 0) {
-        self.axisGroups = @[];
-        [self.seriesIndexToGroupIndex removeAllObjects];
-        return;
-    }
-
-    // Group series by unit
-    NSMutableDictionary<NSString *, NSMutableIndexSet *> *unitToIndices = [NSMutableDictionary dictionary];
-    for (NSUInteger i = 0; i < self.dataSeries.count; i++) {
-        NSDictionary *series = self.dataSeries[i];
-        NSString *unit = series[@"unit"];
-        if (!unit) unit = @"";
-
-        NSMutableIndexSet *indices = unitToIndices[unit];
-        if (!indices) {
-            indices = [NSMutableIndexSet indexSet];
-            unitToIndices[unit] = indices;
+    NSMutableArray<NSString *> *units = [NSMutableArray array];
+    NSMutableDictionary<NSString *, NSNumber *> *unitToGroup = [NSMutableDictionary dictionary];
+    NSMutableArray<NSNumber *> *seriesGroups = [NSMutableArray arrayWithCapacity:self.dataSeries.count];
+    for (NSDictionary *series in self.dataSeries) {
+        NSString *unit = series[@"unit"] ?: @"";
+        NSNumber *groupIndex = unitToGroup[unit];
+        if (!groupIndex) {
+            groupIndex = @(units.count);
+            unitToGroup[unit] = groupIndex;
+            [units addObject:unit];
         }
-        [indices addIndex:i];
-    }
-
-    // Build axis groups array, preserving order of first appearance
-    NSMutableArray<NSDictionary *> *groups = [NSMutableArray array];
-    NSMutableSet<NSString *> *seenUnits = [NSMutableSet set];
-
-    for (NSUInteger i = 0; i < self.dataSeries.count; i++) {
-        NSDictionary *series = self.dataSeries[i];
-        NSString *unit = series[@"unit"];
-        if (!unit) unit = @"";
-
-        if ([seenUnits containsObject:unit]) continue;
-        [seenUnits addObject:unit];
-
-        NSIndexSet *indices = unitToIndices[unit];
-        [groups addObject:@{
-            @"unit": unit,
-            @"indices": indices,
-            @"yMin": @0.0,  // Will be computed in updateMultiSeriesPaths
-            @"yMax": @0.0,
-        }];
-    }
-
-    self.axisGroups = [groups copy];
-
-    // Build seriesIndex -> groupIndex mapping
-    [self.seriesIndexToGroupIndex removeAllObjects];
-    for (NSUInteger gi = 0; gi < self.axisGroups.count; gi++) {
-        NSDictionary *group = self.axisGroups[gi];
-        NSIndexSet *indices = group[@"indices"];
-        [indices enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
-            self.seriesIndexToGroupIndex[@(idx)] = @(gi);
-        }];
+        [seriesGroups addObject:groupIndex];
     }
+    self.axisGroupUnits = units;
+    self.seriesGroupIndices = seriesGroups;
 }
 
 #pragma mark - State Timeline
@@ -330,13 +381,19 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 - (void)setTimelineData:(NSArray<NSDictionary *> *)timelineData {
     _timelineData = [timelineData copy];
     _dataPoints = nil;
+    _dataPyramid = nil;
     _dataSeries = nil;
+    [self invalidateGeometry];
     // Only destroy line graph layers when switching TO timeline mode (not when clearing)
     if (timelineData.count > 0) {
         for (CAShapeLayer *layer in self.lineLayers) {
             [layer removeFromSuperlayer];
         }
         [self.lineLayers removeAllObjects];
+        for (CAShapeLayer *layer in self.bandLayers) {
+            [layer removeFromSuperlayer];
+        }
+        [self.bandLayers removeAllObjects];
         self.fillMaskLayer.path = nil;
         self.gradientLayer.hidden = YES;
         self.legendContainer.hidden = YES;
@@ -414,6 +471,12 @@ static NSDateFormatter *sCachedTimeFmt(void) {
     return [UIColor colorWithRed:0.50 green:0.50 blue:0.60 alpha:1.0];
 }
 
+/// Pixel columns where several states flap faster than can be drawn:
+/// translucent active blue, reading as "partly on" over the dark track.
++ (UIColor *)colorForMixedStates {
+    return [UIColor colorWithRed:0.30 green:0.60 blue:1.00 alpha:0.55];
+}
+
 - (void)updateTimelineBars {
     if (!self.timelineData || self.timelineData.count == 0) return;
     if (CGRectIsEmpty(self.bounds)) return;
@@ -445,19 +508,14 @@ static NSDateFormatter *sCachedTimeFmt(void) {
     CGFloat barAreaW = w - barAreaX - 4; // 4pt right margin
     if (barAreaW < 20) barAreaW = 20;
 
-    // Compute global time range across all entity timelines
+    // Global time range across all entity timelines (segments are in time order)
     double minTime = HUGE_VAL, maxTime = -HUGE_VAL;
     for (NSDictionary *entity in self.timelineData) {
         NSArray *segments = entity[@"segments"];
-        for (NSDictionary *seg in segments) {
-            double start = [seg[@"start"] doubleValue];
-            double end = [seg[@"end"] doubleValue];
-            if (start < minTime) minTime = start;
-            if (end > maxTime) maxTime = end;
-        }
+        if (segments.count == 0) continue;
+        minTime = MIN(minTime, [[segments.firstObject objectForKey:@"start"] doubleValue]);
+        maxTime = MAX(maxTime, [[segments.lastObject objectForKey:@"end"] doubleValue]);
     }
-    double timeRange = maxTime - minTime;
-    if (timeRange < 1.0) timeRange = 1.0;
 
     // Store for Phase 4 tooltip hit-testing and axis labels
     self.currentMinTime = minTime;
@@ -471,6 +529,10 @@ static NSDateFormatter *sCachedTimeFmt(void) {
         barHeight = MAX(8.0, (h - topPad - verticalGap * entityCount) / entityCount);
     }
 
+    // Layer count per row is bounded by its colors, not its segments
+    CGFloat pixelScale = self.window.screen.scale ?: [UIScreen mainScreen].scale;
+    UIColor *mixedColor = [HAGraphView colorForMixedStates];
+
     // Draw each entity's timeline
     for (NSUInteger i = 0; i < entityCount; i++) {
         NSDictionary *entity = self.timelineData[i];
@@ -499,38 +561,46 @@ static NSDateFormatter *sCachedTimeFmt(void) {
         [self.layer addSublayer:bgBar];
         [self.timelineLayers addObject:bgBar];
 
-        // Segment bars
-        for (NSDictionary *seg in segments) {
-            double start = [seg[@"start"] doubleValue];
-            double end = [seg[@"end"] doubleValue];
-            NSString *state = seg[@"state"];
-
-            CGFloat segX = (CGFloat)((start - minTime) / timeRange) * barAreaW;
-            CGFloat segEndX = (CGFloat)((end - minTime) / timeRange) * barAreaW;
-            CGFloat segW = segEndX - segX;
-            if (segW < 0.5) segW = 0.5; // Minimum visible width
-
-            UIColor *color = [HAGraphView colorForState:state entityId:entityId];
-
-            CALayer *segLayer = [CALayer layer];
-            segLayer.frame = CGRectMake(barAreaX + segX, y, segW, barHeight);
-            segLayer.backgroundColor = color.CGColor;
-            // Round corners only on first/last segments
-            if (segX <= 0.5) {
-                segLayer.cornerRadius = 3.0;
-                segLayer.maskedCorners = kCALayerMinXMinYCorner | kCALayerMinXMaxYCorner;
+        // Compacted runs, one shape layer per color; the rounded track clips them
+        NSArray<HAGraphTimelineRun *> *runs = [HAGraphGeometry timelineRunsForSegments:segments
+                                                                               minTime:minTime maxTime:maxTime
+                                                                             areaWidth:barAreaW pixelScale:pixelScale];
+        NSMutableDictionary<NSString *, UIColor *> *stateColors = [NSMutableDictionary dictionary];
+        NSMutableDictionary<UIColor *, UIBezierPath *> *colorPaths = [NSMutableDictionary dictionary];
+        for (HAGraphTimelineRun *run in runs) {
+            UIColor *color = mixedColor;
+            if (run.state) {
+                color = stateColors[run.state];
+                if (!color) {
+                    color = [HAGraphView colorForState:run.state entityId:entityId];
+                    stateColors[run.state] = color;
+                }
             }
-            if (segEndX >= barAreaW - 0.5) {
-                segLayer.cornerRadius = 3.0;
-                segLayer.maskedCorners |= kCALayerMaxXMinYCorner | kCALayerMaxXMaxYCorner;
+            UIBezierPath *path = colorPaths[color];
+            if (!path) {
+                path = [UIBezierPath bezierPath];
+                colorPaths[color] = path;
             }
-            segLayer.masksToBounds = YES;
-            [self.layer addSublayer:segLayer];
-            [self.timelineLayers addObject:segLayer];
+            [path appendPath:[UIBezierPath bezierPathWithRect:CGRectMake(run.x, 0, run.width, barHeight)]];
         }
+        [colorPaths enumerateKeysAndObjectsUsingBlock:^(UIColor *color, UIBezierPath *path, BOOL *stop) {
+            CAShapeLayer *shape = [CAShapeLayer layer];
+            shape.frame = bgBar.bounds;
+            shape.fillColor = color.CGColor;
+            shape.path = path.CGPath;
+            [bgBar addSublayer:shape];
+        }];
     }
 
-    [self updateAxisLabels];
+    // Time axis under the bars (no value axis for timelines)
+    NSArray<HAGraphAxisTick *> *timeTicks = @[];
+    if (self.showAxisLabels && !self.lightweight) {
+        timeTicks = [HAGraphGeometry timeTicksForMinTime:minTime maxTime:maxTime
+                                                   areaX:barAreaX areaWidth:barAreaW
+                                               baselineY:self.bounds.size.height - bottomPad viewWidth:w];
+    }
+    [self applyTicks:@[] toLabels:self.valueAxisLabels];
+    [self applyTicks:timeTicks toLabels:self.timeAxisLabels];
 }
 
 #pragma mark - Layer management
@@ -541,6 +611,10 @@ static NSDateFormatter *sCachedTimeFmt(void) {
         [layer removeFromSuperlayer];
     }
     [self.lineLayers removeAllObjects];
+    for (CAShapeLayer *layer in self.bandLayers) {
+        [layer removeFromSuperlayer];
+    }
+    [self.bandLayers removeAllObjects];
 
     NSUInteger count = 1;
     if (self.dataSeries.count > 0) {
@@ -548,6 +622,12 @@ static NSDateFormatter *sCachedTimeFmt(void) {
     }
 
     for (NSUInteger i = 0; i < count; i++) {
+        // Band sits under its line; stays empty unless points carry min/max
+        CAShapeLayer *bandLayer = [CAShapeLayer layer];
+        bandLayer.strokeColor = nil;
+        [self.layer addSublayer:bandLayer];
+        [self.bandLayers addObject:bandLayer];
+
         CAShapeLayer *lineLayer = [CAShapeLayer layer];
         lineLayer.fillColor = [UIColor clearColor].CGColor;
         lineLayer.lineWidth = self.lightweight ? 1.5 : 2.0;
@@ -715,476 +795,242 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 
 #pragma mark - Path rendering
 
-- (void)updatePaths {
-    if (CGRectIsEmpty(self.bounds)) return;
-
-    if (self.dataSeries.count > 0) {
-        [self updateMultiSeriesPaths];
-    } else {
-        [self updateSingleSeriesPath];
-    }
+/// Serial queue shared by every graph view: geometry work never competes
+/// with itself, and a view only ever has one job in flight (see below).
+static dispatch_queue_t HAGraphGeometryQueue(void) {
+    static dispatch_queue_t queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        queue = dispatch_queue_create("com.hadashboard.graph.geometry",
+                                      dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0));
+    });
+    return queue;
 }
 
-- (void)updateSingleSeriesPath {
-    // Ensure we have exactly one line layer
-    if (self.lineLayers.count == 0) return;
-    CAShapeLayer *lineLayer = self.lineLayers.firstObject;
-
-    if (self.dataPoints.count < 2) {
-        lineLayer.path = nil;
-        self.fillMaskLayer.path = nil;
-        return;
-    }
+- (void)updatePaths {
+    [self updatePathsAnimated:YES];
+}
 
-    // Update colors
-    UIColor *fill = self.fillColor ?: [self.lineColor colorWithAlphaComponent:0.3];
-    lineLayer.strokeColor = self.lineColor.CGColor;
-    self.gradientLayer.colors = @[
-        (id)[fill colorWithAlphaComponent:0.5].CGColor,
-        (id)[fill colorWithAlphaComponent:0.05].CGColor
-    ];
+/// Redraw for a viewport change (pinch/pan/tile arrival) without implicit path animations.
+- (void)updatePathsWithoutAnimation {
+    [self updatePathsAnimated:NO];
+}
 
-    // Compute min/max for Y scaling
-    double minVal = HUGE_VAL, maxVal = -HUGE_VAL;
-    double minTime = HUGE_VAL, maxTime = -HUGE_VAL;
-    for (NSDictionary *pt in self.dataPoints) {
-        double v = [pt[@"value"] doubleValue];
-        double t = [pt[@"timestamp"] doubleValue];
-        if (v < minVal) minVal = v;
-        if (v > maxVal) maxVal = v;
-        if (t < minTime) minTime = t;
-        if (t > maxTime) maxTime = t;
-    }
+/// Data behind the paths changed: drop cached geometry, any result still
+/// in flight, and the paths on screen, so nothing old is drawn again.
+- (void)invalidateGeometry {
+    [self invalidateGeometryClearingPaths:YES];
+}
 
-    // Add 10% padding to Y range
-    double yRange = maxVal - minVal;
-    if (yRange < 0.001) yRange = 1.0;
-    double yPad = yRange * 0.1;
-    minVal -= yPad;
-    maxVal += yPad;
-    yRange = maxVal - minVal;
+- (void)invalidateGeometryClearingPaths:(BOOL)clearPaths {
+    self.seriesGeneration++;
+    [self.geometryCache removeAllObjects];
+    self.queuedGeometryInput = nil;
+    if (!clearPaths) return;
+
+    [CATransaction begin];
+    [CATransaction setDisableActions:YES];
+    for (CAShapeLayer *layer in self.lineLayers) layer.path = NULL;
+    for (CAShapeLayer *layer in self.bandLayers) layer.path = NULL;
+    self.fillMaskLayer.path = NULL;
+    [CATransaction commit];
+}
 
-    double xRange = maxTime - minTime;
-    if (xRange < 1.0) xRange = 1.0;
+/// Capture an input on main, then apply cached geometry immediately or build
+/// it on the geometry queue. While a build is running only the newest
+/// request is kept, so a fast pan costs one build per result, not per event.
+- (void)updatePathsAnimated:(BOOL)animated {
+    if (CGRectIsEmpty(self.bounds) || self.lineLayers.count == 0) return;
 
-    // Store for Phase 4 tooltip hit-testing and axis labels
-    self.currentMinVal = minVal;
-    self.currentMaxVal = maxVal;
-    self.currentMinTime = minTime;
-    self.currentMaxTime = maxTime;
+    HAGraphGeometryInput *input = [self geometryInput];
+    NSString *key = [input cacheKey];
+    self.latestGeometryKey = key;
 
-    CGFloat leftPad = [self graphAreaLeftPadding];
-    CGFloat rightPad = [self graphAreaRightPadding];
-    CGFloat bottomPad = [self graphAreaBottomPadding];
-    CGFloat w = self.bounds.size.width - leftPad - rightPad;
-    CGFloat h = self.bounds.size.height;
-    CGFloat insetY = 2.0;
-    CGFloat drawH = h - insetY * 2 - bottomPad;
-    CGFloat fillBottom = h - bottomPad;
-
-    // Build line path
-    UIBezierPath *linePath = [UIBezierPath bezierPath];
-    UIBezierPath *fillPath = self.lightweight ? nil : [UIBezierPath bezierPath];
-
-    BOOL first = YES;
-    CGPoint lastPoint = CGPointZero;
-    for (NSDictionary *pt in self.dataPoints) {
-        double v = [pt[@"value"] doubleValue];
-        double t = [pt[@"timestamp"] doubleValue];
-        CGFloat x = leftPad + (CGFloat)((t - minTime) / xRange) * w;
-        CGFloat y = insetY + drawH - (CGFloat)((v - minVal) / yRange) * drawH;
-        CGPoint p = CGPointMake(x, y);
-
-        if (first) {
-            [linePath moveToPoint:p];
-            [fillPath moveToPoint:CGPointMake(x, fillBottom)];
-            [fillPath addLineToPoint:p];
-            first = NO;
-        } else {
-            [linePath addLineToPoint:p];
-            [fillPath addLineToPoint:p];
-        }
-        lastPoint = p;
+    HAGraphGeometry *cached = [self.geometryCache objectForKey:key];
+    if (cached) {
+        self.queuedGeometryInput = nil;
+        [self applyGeometry:cached animated:animated];
+        return;
     }
-
-    lineLayer.path = linePath.CGPath;
-
-    if (!self.lightweight) {
-        [fillPath addLineToPoint:CGPointMake(lastPoint.x, fillBottom)];
-        [fillPath closePath];
-        self.fillMaskLayer.path = fillPath.CGPath;
+    if (self.geometryInFlight) {
+        self.queuedGeometryInput = input;
+        self.queuedGeometryAnimated = animated;
+        return;
     }
-
-    [self updateAxisLabels];
+    [self buildGeometryForInput:input key:key animated:animated];
 }
 
-- (void)updateMultiSeriesPaths {
-    if (self.dataSeries.count == 0 || self.lineLayers.count == 0) return;
-
-    // Compute per-group min/max ranges (skipping hidden series)
-    NSMutableArray<NSMutableDictionary *> *mutableGroups = [NSMutableArray array];
-    for (NSDictionary *group in self.axisGroups) {
-        [mutableGroups addObject:[group mutableCopy]];
-    }
+- (void)buildGeometryForInput:(HAGraphGeometryInput *)input key:(NSString *)key animated:(BOOL)animated {
+    self.geometryInFlight = YES;
+    __weak typeof(self) weakSelf = self;
+    dispatch_async(HAGraphGeometryQueue(), ^{
+        HAGraphGeometry *geometry = [HAGraphGeometry geometryWithInput:input];
+        dispatch_async(dispatch_get_main_queue(), ^{
+            HAGraphView *strongSelf = weakSelf;
+            if (!strongSelf) return;
+            strongSelf.geometryInFlight = NO;
+            if (geometry.generation != strongSelf.seriesGeneration) {
+                // Stale data; start over with whatever is current
+                BOOL queued = (strongSelf.queuedGeometryInput != nil);
+                strongSelf.queuedGeometryInput = nil;
+                if (queued) [strongSelf updatePathsAnimated:strongSelf.queuedGeometryAnimated];
+                return;
+            }
+            [strongSelf.geometryCache setObject:geometry forKey:key];
 
-    __block double minTime = HUGE_VAL, maxTime = -HUGE_VAL;
-
-    for (NSUInteger gi = 0; gi < mutableGroups.count; gi++) {
-        NSMutableDictionary *group = mutableGroups[gi];
-        NSIndexSet *indices = group[@"indices"];
-        __block double gMin = HUGE_VAL, gMax = -HUGE_VAL;
-
-        [indices enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
-            // Skip hidden series
-            if ([self.hiddenSeriesIndices containsIndex:idx]) return;
-
-            NSDictionary *series = self.dataSeries[idx];
-            NSArray *points = series[@"points"];
-            for (NSDictionary *pt in points) {
-                double v = [pt[@"value"] doubleValue];
-                double t = [pt[@"timestamp"] doubleValue];
-                if (v < gMin) gMin = v;
-                if (v > gMax) gMax = v;
-                if (t < minTime) minTime = t;
-                if (t > maxTime) maxTime = t;
+            HAGraphGeometryInput *next = strongSelf.queuedGeometryInput;
+            strongSelf.queuedGeometryInput = nil;
+            // Mid-gesture, a slightly old window beats a frozen one
+            if (next || [key isEqualToString:strongSelf.latestGeometryKey]) {
+                [strongSelf applyGeometry:geometry animated:animated];
             }
-        }];
+            if (next) [strongSelf buildGeometryForInput:next key:[next cacheKey] animated:strongSelf.queuedGeometryAnimated];
+        });
+    });
+}
 
-        // Add 10% padding to Y range for this group
-        if (gMin <= gMax) {
-            double yRange = gMax - gMin;
-            if (yRange < 0.001) yRange = 1.0;
-            double yPad = yRange * 0.1;
-            gMin -= yPad;
-            gMax += yPad;
-        } else {
-            // No valid data for this group (all series hidden)
-            gMin = 0.0;
-            gMax = 1.0;
-        }
+- (BOOL)hasVisibleWindow {
+    return self.visibleEndTime > self.visibleStartTime;
+}
 
-        group[@"yMin"] = @(gMin);
-        group[@"yMax"] = @(gMax);
-    }
+/// Points to draw for one series in the displayed time range: the pyramid's
+/// best data when there is one, clipped to the range when zoomed.
+- (NSArray<NSDictionary *> *)drawPointsForPoints:(NSArray<NSDictionary *> *)points
+                                         pyramid:(HAHistoryPyramid *)pyramid
+                                         minTime:(double)minTime
+                                         maxTime:(double)maxTime
+                                           width:(CGFloat)width {
+    NSArray *source = pyramid ? [pyramid pointsForStartTime:minTime endTime:maxTime pixelWidth:width] : points;
+    return [self hasVisibleWindow] ? HAGraphClipPoints(source, minTime, maxTime) : source;
+}
 
-    // Update stored groups with computed ranges
-    self.axisGroups = [mutableGroups copy];
+/// Everything the geometry stage needs, read from view state. Resolves
+/// pyramid/window points here since pyramids are main-thread only; the
+/// per-point work (Y ranges, paths, ticks) happens off main.
+- (HAGraphGeometryInput *)geometryInput {
+    BOOL multi = self.dataSeries.count > 0;
+    NSUInteger count = multi ? self.dataSeries.count : 1;
 
-    // For backward compat with single-axis: store first group's range as "current"
-    if (mutableGroups.count > 0) {
-        self.currentMinVal = [mutableGroups[0][@"yMin"] doubleValue];
-        self.currentMaxVal = [mutableGroups[0][@"yMax"] doubleValue];
+    // Full data extent of the visible series bounds zoom/pan (points are in time order)
+    double minTime = HUGE_VAL, maxTime = -HUGE_VAL;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (multi && [self.hiddenSeriesIndices containsIndex:i]) continue;
+        NSArray<NSDictionary *> *points = multi ? self.dataSeries[i][@"points"] : self.dataPoints;
+        if (points.count == 0) continue;
+        minTime = MIN(minTime, [points.firstObject[@"timestamp"] doubleValue]);
+        maxTime = MAX(maxTime, [points.lastObject[@"timestamp"] doubleValue]);
+    }
+    BOOL hasData = (minTime <= maxTime);
+    if (hasData) {
+        self.dataMinTime = minTime;
+        self.dataMaxTime = maxTime;
+        // The drawn range is the visible window when zoomed
+        if ([self hasVisibleWindow]) {
+            minTime = self.visibleStartTime;
+            maxTime = self.visibleEndTime;
+        }
+        self.currentMinTime = minTime;
+        self.currentMaxTime = maxTime;
     } else {
-        self.currentMinVal = 0.0;
-        self.currentMaxVal = 1.0;
+        minTime = maxTime = 0;
     }
 
-    if (minTime > maxTime) {
-        // No valid data
-        for (CAShapeLayer *layer in self.lineLayers) {
-            layer.path = nil;
+    HAGraphGeometryInput *input = [[HAGraphGeometryInput alloc] init];
+    input.size = self.bounds.size;
+    input.leftPadding = [self graphAreaLeftPadding];
+    input.rightPadding = [self graphAreaRightPadding];
+    input.bottomPadding = [self graphAreaBottomPadding];
+    input.legendHeight = [self currentLegendHeight];
+    input.minTime = minTime;
+    input.maxTime = maxTime;
+    input.axisLabels = self.showAxisLabels && !self.lightweight;
+    input.generation = self.seriesGeneration;
+    input.seriesGroups = multi ? self.seriesGroupIndices : @[@0];
+    input.groupUnits = multi ? self.axisGroupUnits : @[@""];
+
+    CGFloat w = input.size.width - input.leftPadding - input.rightPadding;
+    NSMutableArray<NSArray<NSDictionary *> *> *seriesPoints = [NSMutableArray arrayWithCapacity:count];
+    NSInteger fillSeries = -1;
+    for (NSUInteger i = 0; i < count; i++) {
+        if (!hasData || (multi && [self.hiddenSeriesIndices containsIndex:i])) {
+            [seriesPoints addObject:@[]];
+            continue;
         }
-        self.fillMaskLayer.path = nil;
-        return;
+        // Gradient fill follows the first visible series
+        if (fillSeries < 0 && !self.lightweight) fillSeries = (NSInteger)i;
+        NSArray *points = multi ? self.dataSeries[i][@"points"] : self.dataPoints;
+        HAHistoryPyramid *pyramid = multi ? self.dataSeries[i][@"pyramid"] : self.dataPyramid;
+        [seriesPoints addObject:(points.count < 2) ? @[] : [self drawPointsForPoints:points pyramid:pyramid
+                                                                             minTime:minTime maxTime:maxTime width:w]];
     }
+    input.seriesPoints = seriesPoints;
+    input.fillSeries = fillSeries;
+    return input;
+}
 
-    double xRange = maxTime - minTime;
-    if (xRange < 1.0) xRange = 1.0;
+/// The main-thread half: hand finished paths to their layers and place axis labels.
+- (void)applyGeometry:(HAGraphGeometry *)geometry animated:(BOOL)animated {
+    [CATransaction begin];
+    [CATransaction setDisableActions:!animated];
 
-    self.currentMinTime = minTime;
-    self.currentMaxTime = maxTime;
-
-    CGFloat leftPad = [self graphAreaLeftPadding];
-    CGFloat rightPad = [self graphAreaRightPadding];
-    CGFloat bottomPad = [self graphAreaBottomPadding];
-    CGFloat w = self.bounds.size.width - leftPad - rightPad;
-    CGFloat h = self.bounds.size.height;
-    CGFloat legendH = [self currentLegendHeight];
-    CGFloat insetY = 2.0;
-    CGFloat drawH = h - insetY * 2 - legendH - bottomPad;
-    if (drawH < 10) drawH = 10;
-    CGFloat fillBottom = h - legendH - bottomPad;
-
-    // Render each series
-    for (NSUInteger i = 0; i < self.dataSeries.count && i < self.lineLayers.count; i++) {
-        NSDictionary *series = self.dataSeries[i];
-        NSArray *points = series[@"points"];
-        UIColor *color = series[@"color"] ?: self.lineColor;
+    BOOL multi = self.dataSeries.count > 0;
+    for (NSUInteger i = 0; i < self.lineLayers.count; i++) {
+        UIColor *color = (multi && i < self.dataSeries.count) ? (self.dataSeries[i][@"color"] ?: self.lineColor) : self.lineColor;
         CAShapeLayer *lineLayer = self.lineLayers[i];
         lineLayer.strokeColor = color.CGColor;
+        lineLayer.path = [geometry linePathAtIndex:i];
 
-        // Skip hidden series — clear their paths
-        if ([self.hiddenSeriesIndices containsIndex:i]) {
-            lineLayer.path = nil;
-            if (i == 0) self.fillMaskLayer.path = nil;
-            continue;
-        }
+        CAShapeLayer *bandLayer = (i < self.bandLayers.count) ? self.bandLayers[i] : nil;
+        bandLayer.fillColor = [color colorWithAlphaComponent:0.2].CGColor;
+        bandLayer.path = [geometry bandPathAtIndex:i];
+    }
 
-        if (points.count < 2) {
-            lineLayer.path = nil;
-            if (i == 0) self.fillMaskLayer.path = nil;
-            continue;
-        }
+    NSInteger fillSeries = geometry.fillSeries;
+    if (fillSeries >= 0 && geometry.fillPath) {
+        UIColor *fill = multi ? [(self.dataSeries[fillSeries][@"color"] ?: self.lineColor) colorWithAlphaComponent:0.3]
+                              : (self.fillColor ?: [self.lineColor colorWithAlphaComponent:0.3]);
+        self.gradientLayer.colors = @[
+            (id)[fill colorWithAlphaComponent:0.5].CGColor,
+            (id)[fill colorWithAlphaComponent:0.05].CGColor
+        ];
+    }
+    self.fillMaskLayer.path = geometry.fillPath;
 
-        // Get this series' Y axis group
-        NSNumber *groupIndexNum = self.seriesIndexToGroupIndex[@(i)];
-        NSUInteger groupIndex = groupIndexNum ? [groupIndexNum unsignedIntegerValue] : 0;
-        NSDictionary *group = (groupIndex < self.axisGroups.count) ? self.axisGroups[groupIndex] : nil;
-        double seriesMinVal = group ? [group[@"yMin"] doubleValue] : 0.0;
-        double seriesMaxVal = group ? [group[@"yMax"] doubleValue] : 1.0;
-        double seriesYRange = seriesMaxVal - seriesMinVal;
-        if (seriesYRange < 0.001) seriesYRange = 1.0;
-
-        UIBezierPath *linePath = [UIBezierPath bezierPath];
-        // Gradient fill only for first VISIBLE series, non-lightweight
-        // Check if this is the first visible series (not just i == 0)
-        BOOL isFirstVisible = YES;
-        for (NSUInteger j = 0; j < i; j++) {
-            if (![self.hiddenSeriesIndices containsIndex:j]) {
-                isFirstVisible = NO;
-                break;
-            }
-        }
-        UIBezierPath *fillPath = (isFirstVisible && !self.lightweight) ? [UIBezierPath bezierPath] : nil;
-
-        BOOL first = YES;
-        CGPoint lastPoint = CGPointZero;
-        for (NSDictionary *pt in points) {
-            double v = [pt[@"value"] doubleValue];
-            double t = [pt[@"timestamp"] doubleValue];
-            CGFloat x = leftPad + (CGFloat)((t - minTime) / xRange) * w;
-            CGFloat y = insetY + drawH - (CGFloat)((v - seriesMinVal) / seriesYRange) * drawH;
-            CGPoint p = CGPointMake(x, y);
-
-            if (first) {
-                [linePath moveToPoint:p];
-                [fillPath moveToPoint:CGPointMake(x, fillBottom)];
-                [fillPath addLineToPoint:p];
-                first = NO;
-            } else {
-                [linePath addLineToPoint:p];
-                [fillPath addLineToPoint:p];
-            }
-            lastPoint = p;
-        }
+    // First group's range doubles as the single-axis range for tooltips
+    self.currentMinVal = [geometry.groupMins.firstObject doubleValue];
+    self.currentMaxVal = [geometry.groupMaxes.firstObject doubleValue];
 
-        lineLayer.path = linePath.CGPath;
-
-        if (isFirstVisible && !self.lightweight) {
-            // Update gradient for first visible series color
-            UIColor *fill = [color colorWithAlphaComponent:0.3];
-            self.gradientLayer.colors = @[
-                (id)[fill colorWithAlphaComponent:0.5].CGColor,
-                (id)[fill colorWithAlphaComponent:0.05].CGColor
-            ];
-            [fillPath addLineToPoint:CGPointMake(lastPoint.x, fillBottom)];
-            [fillPath closePath];
-            self.fillMaskLayer.path = fillPath.CGPath;
-        }
-    }
+    [self applyTicks:geometry.valueTicks toLabels:self.valueAxisLabels];
+    [self applyTicks:geometry.timeTicks toLabels:self.timeAxisLabels];
 
-    [self updateAxisLabels];
+    [CATransaction commit];
 }
 
 #pragma mark - Axis Labels
 
-- (void)removeOldAxisLabels {
-    for (UILabel *label in self.timeAxisLabels) {
-        [label removeFromSuperview];
-    }
-    [self.timeAxisLabels removeAllObjects];
-    for (UILabel *label in self.valueAxisLabels) {
-        [label removeFromSuperview];
+/// Lay axis ticks onto pooled labels; spare labels are hidden, not removed,
+/// so redraws during a pan don't churn subviews.
+- (void)applyTicks:(NSArray<HAGraphAxisTick *> *)ticks toLabels:(NSMutableArray<UILabel *> *)labels {
+    while (labels.count < ticks.count) {
+        UILabel *lbl = [[UILabel alloc] init];
+        [self insertSubview:lbl belowSubview:self.tooltipView];
+        [labels addObject:lbl];
     }
-    [self.valueAxisLabels removeAllObjects];
-}
-
-- (void)updateAxisLabels {
-    [self removeOldAxisLabels];
 
-    // Skip axis labels entirely on lightweight devices or when disabled
-    if (!self.showAxisLabels || self.lightweight) return;
-
-    UIFont *axisFont = [UIFont systemFontOfSize:9];
     UIColor *axisColor = [HATheme tertiaryTextColor];
-    BOOL isTimeline = (self.timelineData.count > 0);
-
-    double minTime = self.currentMinTime;
-    double maxTime = self.currentMaxTime;
-    double timeRange = maxTime - minTime;
-    if (timeRange < 1.0) return; // No meaningful range to label
-
-    // --- Value labels — skip for timeline bars ---
-    if (!isTimeline) {
-        CGFloat leftPad = [self graphAreaLeftPadding];
-        CGFloat rightPad = [self graphAreaRightPadding];
-        CGFloat bottomPad = [self graphAreaBottomPadding];
-        CGFloat h = self.bounds.size.height;
-        CGFloat insetY = 2.0;
-        CGFloat legendH = [self currentLegendHeight];
-        CGFloat drawH = h - insetY * 2 - bottomPad - legendH;
-        if (drawH < 10) drawH = 10;
-
-        if (self.axisGroups.count > 0) {
-            // Multi-axis: render per-group Y axes
-            CGFloat viewWidth = self.bounds.size.width;
-
-            for (NSUInteger gi = 0; gi < self.axisGroups.count; gi++) {
-                NSDictionary *group = self.axisGroups[gi];
-                double minVal = [group[@"yMin"] doubleValue];
-                double maxVal = [group[@"yMax"] doubleValue];
-                double valRange = maxVal - minVal;
-                if (valRange < 0.0001) valRange = 1.0;
-
-                NSString *unit = group[@"unit"];
-                BOOL isLeftAxis = (gi == 0);
-                BOOL useIntegers = (valRange > 10.0);
-                NSString *fmt = useIntegers ? @"%.0f" : @"%.1f";
-
-                // Position: left axis at left edge, subsequent axes stacked from right edge
-                CGFloat axisX = 0;
-                CGFloat axisWidth = 32.0;
-                NSTextAlignment alignment = NSTextAlignmentRight;
-
-                if (isLeftAxis) {
-                    axisX = 0;
-                    axisWidth = leftPad - 3.0;
-                    alignment = NSTextAlignmentRight;
-                } else {
-                    // Right-side axes: stack from right edge inward
-                    NSUInteger rightIndex = gi - 1;
-                    axisX = viewWidth - rightPad + rightIndex * 35.0;
-                    axisWidth = 32.0;
-                    alignment = NSTextAlignmentLeft;
-                }
-
-                // Unit label at top
-                if (unit.length > 0) {
-                    UILabel *unitLabel = [[UILabel alloc] init];
-                    unitLabel.text = unit;
-                    unitLabel.font = [UIFont systemFontOfSize:8 weight:UIFontWeightMedium];
-                    unitLabel.textColor = [axisColor colorWithAlphaComponent:0.7];
-                    unitLabel.textAlignment = alignment;
-                    unitLabel.frame = CGRectMake(axisX, insetY - 2, axisWidth, 10);
-                    [self addSubview:unitLabel];
-                    [self.valueAxisLabels addObject:unitLabel];
-                }
-
-                // Value labels
-                NSUInteger valueCount = 5;
-                for (NSUInteger i = 0; i < valueCount; i++) {
-                    double fraction = (double)i / (double)(valueCount - 1);
-                    double val = minVal + fraction * valRange;
-                    CGFloat y = insetY + drawH - (CGFloat)(fraction) * drawH;
-
-                    UILabel *lbl = [[UILabel alloc] init];
-                    lbl.text = [NSString stringWithFormat:fmt, val];
-                    lbl.font = axisFont;
-                    lbl.textColor = axisColor;
-                    lbl.textAlignment = alignment;
-                    lbl.frame = CGRectMake(axisX, y - 6.0, axisWidth, 12.0);
-                    [self addSubview:lbl];
-                    [self.valueAxisLabels addObject:lbl];
-                }
-            }
-        } else {
-            // Single-series: render one Y-axis using currentMinVal/currentMaxVal
-            double minVal = self.currentMinVal;
-            double maxVal = self.currentMaxVal;
-            double valRange = maxVal - minVal;
-            if (valRange < 0.0001) valRange = 1.0;
-
-            BOOL useIntegers = (valRange > 10.0);
-            NSString *fmt = useIntegers ? @"%.0f" : @"%.1f";
-
-            NSUInteger valueCount = 5;
-            for (NSUInteger i = 0; i < valueCount; i++) {
-                double fraction = (double)i / (double)(valueCount - 1);
-                double val = minVal + fraction * valRange;
-                CGFloat y = insetY + drawH - (CGFloat)(fraction) * drawH;
-
-                UILabel *lbl = [[UILabel alloc] init];
-                lbl.text = [NSString stringWithFormat:fmt, val];
-                lbl.font = axisFont;
-                lbl.textColor = axisColor;
-                lbl.textAlignment = NSTextAlignmentRight;
-                lbl.frame = CGRectMake(0, y - 6.0, leftPad - 3.0, 12.0);
-                [self addSubview:lbl];
-                [self.valueAxisLabels addObject:lbl];
-            }
-        }
-    }
-
-    // --- Time labels (bottom edge, above legend if present) ---
-    CGFloat leftPad = isTimeline ? 0.0 : [self graphAreaLeftPadding];
-    CGFloat rightPad = isTimeline ? 0.0 : [self graphAreaRightPadding];
-    CGFloat drawW = self.bounds.size.width - leftPad - rightPad;
-    CGFloat legendH = [self currentLegendHeight];
-    CGFloat bottomY = self.bounds.size.height - [self graphAreaBottomPadding] - legendH;
-
-    // For timeline bars, time labels start at the bar area X offset
-    CGFloat timeAreaX = leftPad;
-    CGFloat timeAreaW = drawW;
-    if (isTimeline) {
-        // Recompute barAreaX/W for timeline to align time labels with bars
-        CGFloat labelWidth = 0;
-        UIFont *labelFont = [UIFont systemFontOfSize:11 weight:UIFontWeightMedium];
-        for (NSDictionary *entity in self.timelineData) {
-            NSString *label = entity[@"label"] ?: @"";
-            CGSize sz = [label sizeWithAttributes:@{NSFontAttributeName: labelFont}];
-            if (sz.width > labelWidth) labelWidth = sz.width;
+    for (NSUInteger i = 0; i < labels.count; i++) {
+        UILabel *lbl = labels[i];
+        if (i >= ticks.count) {
+            lbl.hidden = YES;
+            continue;
         }
-        CGFloat w = self.bounds.size.width;
-        if (labelWidth > w * 0.35) labelWidth = w * 0.35;
-        if (labelWidth < 30) labelWidth = 30;
-        CGFloat barAreaX = labelWidth + 6.0 + 8.0;
-        CGFloat barAreaW = w - barAreaX - 4.0;
-        if (barAreaW < 20) barAreaW = 20;
-        timeAreaX = barAreaX;
-        timeAreaW = barAreaW;
-    }
-
-    // Choose time format based on total range
-    NSDateFormatter *timeFmt = sCachedTimeFmt();
-    if (timeRange > 604800) {
-        // > 7 days
-        timeFmt.dateFormat = @"d/M HH:mm";
-    } else if (timeRange > 86400) {
-        // > 24 hours
-        timeFmt.dateFormat = @"MMM d";
-    } else {
-        // <= 24 hours
-        timeFmt.dateFormat = @"HH:mm";
-    }
-
-    NSUInteger timeCount = (timeRange > 86400) ? 4 : 5;
-    // Use fewer labels if drawing area is narrow
-    if (timeAreaW < 150) timeCount = 3;
-
-    for (NSUInteger i = 0; i < timeCount; i++) {
-        double fraction = (double)i / (double)(timeCount - 1);
-        double t = minTime + fraction * timeRange;
-        NSDate *date = [NSDate dateWithTimeIntervalSince1970:t];
-        NSString *text = [timeFmt stringFromDate:date];
-
-        CGFloat x = timeAreaX + (CGFloat)(fraction) * timeAreaW;
-
-        UILabel *lbl = [[UILabel alloc] init];
-        lbl.text = text;
-        lbl.font = axisFont;
-        lbl.textColor = axisColor;
-        lbl.textAlignment = NSTextAlignmentCenter;
-        [lbl sizeToFit];
-
-        // Center the label on x, but clamp to bounds
-        CGFloat lblW = lbl.frame.size.width;
-        CGFloat lblX = x - lblW / 2.0;
-        if (lblX < 0) lblX = 0;
-        if (lblX + lblW > self.bounds.size.width) lblX = self.bounds.size.width - lblW;
-        lbl.frame = CGRectMake(lblX, bottomY + 2.0, lblW, 14.0);
-
-        [self addSubview:lbl];
-        [self.timeAxisLabels addObject:lbl];
+        HAGraphAxisTick *tick = ticks[i];
+        lbl.hidden = NO;
+        lbl.text = tick.text;
+        lbl.font = tick.isUnit ? [UIFont systemFontOfSize:8 weight:UIFontWeightMedium] : [UIFont systemFontOfSize:9];
+        lbl.textColor = tick.isUnit ? [axisColor colorWithAlphaComponent:0.7] : axisColor;
+        lbl.textAlignment = tick.alignment;
+        lbl.frame = tick.frame;
     }
 }
 
@@ -1418,8 +1264,8 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 
 - (void)handlePinch:(UIPinchGestureRecognizer *)gesture {
     if (gesture.state == UIGestureRecognizerStateBegan) {
-        self.anchorStartTime = (self.visibleStartTime > 0) ? self.visibleStartTime : self.currentMinTime;
-        self.anchorEndTime = (self.visibleEndTime > 0) ? self.visibleEndTime : self.currentMaxTime;
+        self.anchorStartTime = [self hasVisibleWindow] ? self.visibleStartTime : self.dataMinTime;
+        self.anchorEndTime = [self hasVisibleWindow] ? self.visibleEndTime : self.dataMaxTime;
     } else if (gesture.state == UIGestureRecognizerStateChanged) {
         CGFloat scale = MAX(0.1, gesture.scale);
         NSTimeInterval anchorRange = self.anchorEndTime - self.anchorStartTime;
@@ -1429,19 +1275,19 @@ static NSDateFormatter *sCachedTimeFmt(void) {
         NSTimeInterval newEnd = mid + newRange / 2.0;
 
         // Clamp to data bounds
-        if (newStart < self.currentMinTime) { newStart = self.currentMinTime; newEnd = newStart + newRange; }
-        if (newEnd > self.currentMaxTime) { newEnd = self.currentMaxTime; newStart = newEnd - newRange; }
-        newStart = MAX(newStart, self.currentMinTime);
-        newEnd = MIN(newEnd, self.currentMaxTime);
+        if (newStart < self.dataMinTime) { newStart = self.dataMinTime; newEnd = newStart + newRange; }
+        if (newEnd > self.dataMaxTime) { newEnd = self.dataMaxTime; newStart = newEnd - newRange; }
+        newStart = MAX(newStart, self.dataMinTime);
+        newEnd = MIN(newEnd, self.dataMaxTime);
 
         self.visibleStartTime = newStart;
         self.visibleEndTime = newEnd;
-        NSTimeInterval fullRange = self.currentMaxTime - self.currentMinTime;
+        NSTimeInterval fullRange = self.dataMaxTime - self.dataMinTime;
         _zoomScale = (fullRange > 0) ? (CGFloat)(fullRange / (newEnd - newStart)) : 1.0;
-        [self setNeedsLayout];
-        [self layoutIfNeeded];
+        [self updatePathsWithoutAnimation];
     } else if (gesture.state == UIGestureRecognizerStateEnded) {
-        NSTimeInterval fullRange = self.currentMaxTime - self.currentMinTime;
+        [self loadPyramidTilesForVisibleWindow];
+        NSTimeInterval fullRange = self.dataMaxTime - self.dataMinTime;
         NSTimeInterval visRange = self.visibleEndTime - self.visibleStartTime;
         if (fullRange > 0 && fabs(visRange / fullRange - 1.0) > 0.1) {
             if ([self.delegate respondsToSelector:@selector(graphView:didZoomToStartTime:endTime:)]) {
@@ -1591,15 +1437,15 @@ static NSDateFormatter *sCachedTimeFmt(void) {
             NSTimeInterval timeDelta = -(translation.x / drawW) * visRange;
             NSTimeInterval newStart = self.anchorStartTime + timeDelta;
             NSTimeInterval newEnd = self.anchorEndTime + timeDelta;
-            if (newStart < self.currentMinTime) { newEnd += (self.currentMinTime - newStart); newStart = self.currentMinTime; }
-            if (newEnd > self.currentMaxTime) { newStart -= (newEnd - self.currentMaxTime); newEnd = self.currentMaxTime; }
-            newStart = MAX(newStart, self.currentMinTime);
-            newEnd = MIN(newEnd, self.currentMaxTime);
+            if (newStart < self.dataMinTime) { newEnd += (self.dataMinTime - newStart); newStart = self.dataMinTime; }
+            if (newEnd > self.dataMaxTime) { newStart -= (newEnd - self.dataMaxTime); newEnd = self.dataMaxTime; }
+            newStart = MAX(newStart, self.dataMinTime);
+            newEnd = MIN(newEnd, self.dataMaxTime);
             self.visibleStartTime = newStart;
             self.visibleEndTime = newEnd;
-            [self setNeedsLayout];
-            [self layoutIfNeeded];
+            [self updatePathsWithoutAnimation];
         } else if (gesture.state == UIGestureRecognizerStateEnded) {
+            [self loadPyramidTilesForVisibleWindow];
             if ([self.delegate respondsToSelector:@selector(graphView:didZoomToStartTime:endTime:)]) {
                 [self.delegate graphView:self didZoomToStartTime:self.visibleStartTime endTime:self.visibleEndTime];
             }
@@ -1612,16 +1458,25 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 }
 
 - (void)resetZoom {
-    self.visibleStartTime = 0;
-    self.visibleEndTime = 0;
-    _zoomScale = 1.0;
-    [self setNeedsLayout];
-    [self layoutIfNeeded];
+    [self resetViewport];
+    [self updatePathsWithoutAnimation];
     if ([self.delegate respondsToSelector:@selector(graphView:didZoomToStartTime:endTime:)]) {
         [self.delegate graphView:self didZoomToStartTime:self.currentMinTime endTime:self.currentMaxTime];
     }
 }
 
+/// Ask each pyramid for the tiles the settled window needs.
+- (void)loadPyramidTilesForVisibleWindow {
+    if (![self hasVisibleWindow]) return;
+    CGFloat w = self.bounds.size.width - [self graphAreaLeftPadding] - [self graphAreaRightPadding];
+    [self.dataPyramid loadTilesForStartTime:self.visibleStartTime endTime:self.visibleEndTime pixelWidth:w];
+    for (NSUInteger i = 0; i < self.dataSeries.count; i++) {
+        if ([self.hiddenSeriesIndices containsIndex:i]) continue;
+        HAHistoryPyramid *pyramid = self.dataSeries[i][@"pyramid"];
+        [pyramid loadTilesForStartTime:self.visibleStartTime endTime:self.visibleEndTime pixelWidth:w];
+    }
+}
+
 #pragma mark - UIGestureRecognizerDelegate
 
 - (BOOL)gestureRecognizerShouldBegin:(UIGestureRecognizer *)gestureRecognizer {
@@ -1643,17 +1498,7 @@ static NSDateFormatter *sCachedTimeFmt(void) {
 #pragma mark - Device Max Points
 
 + (NSUInteger)maxPointsForDevice {
-#if !TARGET_OS_SIMULATOR
-    struct utsname systemInfo;
-    if (uname(&systemInfo) == 0) {
-        NSString *machine = [NSString stringWithCString:systemInfo.machine encoding:NSUTF8StringEncoding];
-        if ([machine hasPrefix:@"iPad2"] || [machine hasPrefix:@"iPad3"] ||
-            [machine hasPrefix:@"iPhone4"] || [machine hasPrefix:@"iPod5"]) {
-            return 150;
-        }
-    }
-#endif
-    return 300;
+    return HADeviceIsLowEnd() ? 150 : 300;
 }
 
 @end
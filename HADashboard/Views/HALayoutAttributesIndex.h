@@ -0,0 +1,30 @@
+#import <UIKit/UIKit.h>
+
+/// Spatial index over a layout's attributes for
+/// layoutAttributesForElementsInRect:. Attributes are grouped into lanes
+/// (the layout's columns); each lane is sorted by minY with a running
+/// maximum of maxY, so a query binary-searches every lane for the first
+/// element that can reach the rect and stops at the first one starting
+/// below it. O(lanes · log n + k) per query instead of O(n).
+///
+/// Built once in prepareLayout: add every attribute, then call build.
+/// Elements of a lane may overlap vertically (side-by-side sub-grid
+/// items); lanes may be added to in any order.
+@interface HALayoutAttributesIndex : NSObject
+
+/// Drop everything; the index is empty until the next build.
+- (void)removeAllAttributes;
+
+/// Add an attribute to a lane. Its frame must not change afterwards.
+- (void)addAttributes:(UICollectionViewLayoutAttributes *)attributes toLane:(NSUInteger)lane;
+
+/// Sort lanes and compute the search arrays. Required before querying.
+- (void)build;
+
+/// Attributes whose frame intersects rect.
+- (NSArray<UICollectionViewLayoutAttributes *> *)attributesInRect:(CGRect)rect;
+
+/// Number of attributes added.
+@property (nonatomic, readonly) NSUInteger count;
+
+@end
@@ -0,0 +1,113 @@
+#import "HALayoutAttributesIndex.h"
+
+/// One column: attributes by minY, with parallel C arrays for the search.
+@interface HALayoutIndexLane : NSObject {
+@public
+    CGFloat *_minY;
+    CGFloat *_reachY; // max of maxY over [0, i]; non-decreasing
+}
+@property (nonatomic, strong) NSMutableArray<UICollectionViewLayoutAttributes *> *attributes;
+@end
+
+@implementation HALayoutIndexLane
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _attributes = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)dealloc {
+    free(_minY);
+    free(_reachY);
+}
+
+- (void)build {
+    free(_minY);
+    free(_reachY);
+    _minY = NULL;
+    _reachY = NULL;
+    NSUInteger count = self.attributes.count;
+    if (count == 0) return;
+
+    // Layouts append in reading order, so this is usually already sorted
+    [self.attributes sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(UICollectionViewLayoutAttributes *a, UICollectionViewLayoutAttributes *b) {
+        CGFloat ya = CGRectGetMinY(a.frame), yb = CGRectGetMinY(b.frame);
+        if (ya == yb) return NSOrderedSame;
+        return ya < yb ? NSOrderedAscending : NSOrderedDescending;
+    }];
+    _minY = malloc(count * sizeof(CGFloat));
+    _reachY = malloc(count * sizeof(CGFloat));
+    CGFloat reach = -CGFLOAT_MAX;
+    for (NSUInteger i = 0; i < count; i++) {
+        CGRect frame = self.attributes[i].frame;
+        _minY[i] = CGRectGetMinY(frame);
+        reach = MAX(reach, CGRectGetMaxY(frame));
+        _reachY[i] = reach;
+    }
+}
+
+- (void)appendAttributesInRect:(CGRect)rect toArray:(NSMutableArray *)result {
+    NSUInteger count = self.attributes.count;
+    if (count == 0) return;
+
+    // First element that reaches rect's top; edges are inclusive here and
+    // CGRectIntersectsRect makes the final call
+    CGFloat top = CGRectGetMinY(rect), bottom = CGRectGetMaxY(rect);
+    NSUInteger lo = 0, hi = count;
+    while (lo < hi) {
+        NSUInteger mid = lo + (hi - lo) / 2;
+        if (_reachY[mid] >= top) hi = mid;
+        else lo = mid + 1;
+    }
+    for (NSUInteger i = lo; i < count && _minY[i] <= bottom; i++) {
+        UICollectionViewLayoutAttributes *attr = self.attributes[i];
+        if (CGRectIntersectsRect(attr.frame, rect)) [result addObject:attr];
+    }
+}
+
+@end
+
+@interface HALayoutAttributesIndex ()
+@property (nonatomic, strong) NSMutableArray<HALayoutIndexLane *> *lanes;
+@property (nonatomic, assign, readwrite) NSUInteger count;
+@end
+
+@implementation HALayoutAttributesIndex
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _lanes = [NSMutableArray array];
+    }
+    return self;
+}
+
+- (void)removeAllAttributes {
+    [self.lanes removeAllObjects];
+    self.count = 0;
+}
+
+- (void)addAttributes:(UICollectionViewLayoutAttributes *)attributes toLane:(NSUInteger)lane {
+    if (!attributes) return;
+    while (self.lanes.count <= lane) [self.lanes addObject:[[HALayoutIndexLane alloc] init]];
+    [self.lanes[lane].attributes addObject:attributes];
+    self.count++;
+}
+
+- (void)build {
+    for (HALayoutIndexLane *lane in self.lanes) [lane build];
+}
+
+- (NSArray<UICollectionViewLayoutAttributes *> *)attributesInRect:(CGRect)rect {
+    NSMutableArray *result = [NSMutableArray array];
+    if (CGRectIsNull(rect)) return result;
+    for (HALayoutIndexLane *lane in self.lanes) {
+        [lane appendAttributesInRect:rect toArray:result];
+    }
+    return result;
+}
+
+@end
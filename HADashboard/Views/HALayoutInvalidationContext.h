@@ -0,0 +1,16 @@
+#import <UIKit/UIKit.h>
+
+/// Invalidation context for the dashboard layouts (HAColumnarLayout,
+/// HAMasonryLayout) that says which items' heights may have changed.
+/// The layout re-queries only those heights and, if any differ, re-lays
+/// out from the first changed item down, keeping every other cached
+/// frame. Anything else (invalidateLayout, data source count changes,
+/// width changes) still gets a full pass.
+@interface HALayoutInvalidationContext : UICollectionViewLayoutInvalidationContext
+
+/// Mark items whose delegate height (or span, or size units) may differ.
+- (void)invalidateHeightsForItemsAtIndexPaths:(NSArray<NSIndexPath *> *)indexPaths;
+
+@property (nonatomic, copy, readonly) NSSet<NSIndexPath *> *invalidatedHeightIndexPaths;
+
+@end
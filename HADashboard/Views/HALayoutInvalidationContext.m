@@ -0,0 +1,21 @@
+#import "HALayoutInvalidationContext.h"
+
+@interface HALayoutInvalidationContext ()
+@property (nonatomic, strong) NSMutableSet<NSIndexPath *> *heightIndexPaths;
+@end
+
+@implementation HALayoutInvalidationContext
+
+- (void)invalidateHeightsForItemsAtIndexPaths:(NSArray<NSIndexPath *> *)indexPaths {
+    if (indexPaths.count == 0) return;
+    if (!self.heightIndexPaths) self.heightIndexPaths = [NSMutableSet set];
+    [self.heightIndexPaths addObjectsFromArray:indexPaths];
+    // Have the collection view fetch these items' attributes again
+    [self invalidateItemsAtIndexPaths:indexPaths];
+}
+
+- (NSSet<NSIndexPath *> *)invalidatedHeightIndexPaths {
+    return [self.heightIndexPaths copy] ?: [NSSet set];
+}
+
+@end
@@ -1,4 +1,6 @@
 #import "HAMasonryLayout.h"
+#import "HALayoutAttributesIndex.h"
+#import "HALayoutInvalidationContext.h"
 
 /// HA masonry spacing constants (matching hui-masonry-view.ts)
 static const CGFloat kContainerPaddingTop = 4.0;
@@ -9,8 +11,19 @@ static const CGFloat kCardMarginBottom = 8.0;
 static const CGFloat kMaxColumnWidth = 500.0;
 
 @interface HAMasonryLayout ()
-@property (nonatomic, strong) NSMutableArray<UICollectionViewLayoutAttributes *> *itemAttributes;
+@property (nonatomic, strong) NSMutableArray<UICollectionViewLayoutAttributes *> *itemAttributes; // by item
+@property (nonatomic, strong) HALayoutAttributesIndex *attributesIndex; // one lane per column
 @property (nonatomic, assign) CGSize cachedContentSize;
+/// Delegate answers and placement per item, kept for incremental passes
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *itemSizeUnits;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *itemHeights;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *itemColumns;
+@property (nonatomic, assign) NSInteger columnCount;
+@property (nonatomic, assign) CGFloat columnWidth;
+@property (nonatomic, assign) CGFloat cardWidth;
+@property (nonatomic, assign) CGFloat leftOffset;
+@property (nonatomic, assign) BOOL needsFullLayout;
+@property (nonatomic, strong) NSMutableSet<NSIndexPath *> *pendingHeightIndexPaths;
 @end
 
 @implementation HAMasonryLayout
@@ -19,10 +32,29 @@ static const CGFloat kMaxColumnWidth = 500.0;
     self = [super init];
     if (self) {
         _itemAttributes = [NSMutableArray array];
+        _attributesIndex = [[HALayoutAttributesIndex alloc] init];
+        _itemSizeUnits = [NSMutableArray array];
+        _itemHeights = [NSMutableArray array];
+        _itemColumns = [NSMutableArray array];
+        _needsFullLayout = YES;
+        _pendingHeightIndexPaths = [NSMutableSet set];
     }
     return self;
 }
 
++ (Class)invalidationContextClass {
+    return [HALayoutInvalidationContext class];
+}
+
+- (void)invalidateLayoutWithContext:(UICollectionViewLayoutInvalidationContext *)context {
+    [super invalidateLayoutWithContext:context];
+    if (context.invalidateEverything || context.invalidateDataSourceCounts) {
+        self.needsFullLayout = YES;
+    } else if ([context isKindOfClass:[HALayoutInvalidationContext class]]) {
+        [self.pendingHeightIndexPaths unionSet:((HALayoutInvalidationContext *)context).invalidatedHeightIndexPaths];
+    }
+}
+
 #pragma mark - Column Count (HA Breakpoints)
 
 /// Determine column count from viewport width using HA's matchMedia breakpoints.
@@ -71,11 +103,35 @@ static const CGFloat kMaxColumnWidth = 500.0;
 - (void)prepareLayout {
     [super prepareLayout];
 
-    [self.itemAttributes removeAllObjects];
-
     UICollectionView *cv = self.collectionView;
     if (!cv) return;
 
+    if ([self canReuseCachedLayout]) {
+        [self updatePendingHeights];
+    } else {
+        [self prepareFullLayout];
+    }
+    [self.pendingHeightIndexPaths removeAllObjects];
+}
+
+/// Same width and item count as the cached pass, and nothing but heights
+/// invalidated since (scrolling invalidates with no changes at all).
+- (BOOL)canReuseCachedLayout {
+    UICollectionView *cv = self.collectionView;
+    if (self.needsFullLayout || self.cachedContentSize.width != cv.bounds.size.width) return NO;
+    if ([cv numberOfSections] == 0) return NO;
+    return [cv numberOfItemsInSection:0] == (NSInteger)self.itemAttributes.count;
+}
+
+- (void)prepareFullLayout {
+    self.needsFullLayout = NO;
+    [self.itemAttributes removeAllObjects];
+    [self.itemSizeUnits removeAllObjects];
+    [self.itemHeights removeAllObjects];
+    [self.itemColumns removeAllObjects];
+    [self.attributesIndex removeAllAttributes];
+
+    UICollectionView *cv = self.collectionView;
     NSInteger sectionCount = [cv numberOfSections];
     if (sectionCount == 0) {
         self.cachedContentSize = CGSizeZero;
@@ -111,6 +167,61 @@ static const CGFloat kMaxColumnWidth = 500.0;
     CGFloat leftOffset = floor((viewportWidth - totalColumnsWidth) / 2.0);
     if (leftOffset < 0) leftOffset = 0;
 
+    self.columnCount = columnCount;
+    self.columnWidth = columnWidth;
+    self.cardWidth = cardWidth;
+    self.leftOffset = leftOffset;
+
+    for (NSInteger item = 0; item < itemCount; item++) {
+        NSIndexPath *indexPath = [NSIndexPath indexPathForItem:item inSection:0];
+        [self.itemSizeUnits addObject:@([self cardSizeUnitsForItemAtIndexPath:indexPath])];
+        [self.itemHeights addObject:@([self heightForItemAtIndexPath:indexPath])];
+        [self.itemColumns addObject:@0];
+        [self.itemAttributes addObject:[UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath]];
+    }
+
+    [self placeItemsFromIndex:0 copyingAttributes:NO];
+}
+
+/// Re-query the invalidated items. Column assignment depends on every
+/// card above, so placement restarts at the first changed item; frames
+/// before it are kept.
+- (void)updatePendingHeights {
+    NSInteger firstChanged = NSNotFound;
+    for (NSIndexPath *indexPath in self.pendingHeightIndexPaths) {
+        NSInteger item = indexPath.item;
+        if (indexPath.section != 0 || item < 0 || item >= (NSInteger)self.itemAttributes.count) continue;
+
+        NSInteger sizeUnits = [self cardSizeUnitsForItemAtIndexPath:indexPath];
+        CGFloat itemHeight = [self heightForItemAtIndexPath:indexPath];
+        if (sizeUnits == self.itemSizeUnits[item].integerValue && itemHeight == self.itemHeights[item].doubleValue) continue;
+        self.itemSizeUnits[item] = @(sizeUnits);
+        self.itemHeights[item] = @(itemHeight);
+        firstChanged = MIN(firstChanged, item);
+    }
+    if (firstChanged == NSNotFound) return;
+    [self placeItemsFromIndex:firstChanged copyingAttributes:YES];
+}
+
+- (CGFloat)heightForItemAtIndexPath:(NSIndexPath *)indexPath {
+    // Get actual pixel height from delegate
+    CGFloat itemHeight = 100.0; // fallback
+    if ([self.delegate respondsToSelector:@selector(collectionView:layout:heightForItemAtIndexPath:itemWidth:)]) {
+        itemHeight = [self.delegate collectionView:self.collectionView layout:self
+                          heightForItemAtIndexPath:indexPath itemWidth:self.cardWidth];
+    }
+    return itemHeight;
+}
+
+/// Assign columns and frames from startIndex on, using cached delegate
+/// answers. Items before it keep their column; they're replayed only to
+/// recover the column heights. When copying, changed attributes are
+/// replaced rather than mutated, since the collection view may still
+/// hold the ones it was given.
+- (void)placeItemsFromIndex:(NSInteger)startIndex copyingAttributes:(BOOL)copying {
+    NSInteger columnCount = self.columnCount;
+    NSInteger itemCount = (NSInteger)self.itemAttributes.count;
+
     // Column heights (abstract units for assignment) and Y offsets (pixels for placement)
     NSInteger *columnUnits = calloc(columnCount, sizeof(NSInteger));
     CGFloat *columnY = calloc(columnCount, sizeof(CGFloat));
@@ -119,49 +230,41 @@ static const CGFloat kMaxColumnWidth = 500.0;
     }
 
     for (NSInteger item = 0; item < itemCount; item++) {
-        NSIndexPath *indexPath = [NSIndexPath indexPathForItem:item inSection:0];
-
-        // Compute abstract size units for this card
-        NSInteger sizeUnits = [self cardSizeUnitsForItemAtIndexPath:indexPath];
-
-        // Find shortest column (HA: prefer columns with total < 5 units)
-        NSInteger targetColumn = 0;
-        NSInteger minUnits = columnUnits[0];
-        CGFloat minY = columnY[0];
-        for (NSInteger c = 1; c < columnCount; c++) {
-            BOOL currentUnder5 = (columnUnits[targetColumn] < 5);
-            BOOL candidateUnder5 = (columnUnits[c] < 5);
-
-            if (candidateUnder5 && !currentUnder5) {
-                // Prefer under-5 columns
-                targetColumn = c;
-                minUnits = columnUnits[c];
-                minY = columnY[c];
-            } else if (candidateUnder5 == currentUnder5) {
-                // Both under or both over: pick shortest by pixel height
-                if (columnY[c] < minY) {
+        NSInteger sizeUnits = self.itemSizeUnits[item].integerValue;
+        CGFloat itemHeight = self.itemHeights[item].doubleValue;
+
+        NSInteger targetColumn = self.itemColumns[item].integerValue;
+        if (item >= startIndex) {
+            // Find shortest column (HA: prefer columns with total < 5 units)
+            targetColumn = 0;
+            CGFloat minY = columnY[0];
+            for (NSInteger c = 1; c < columnCount; c++) {
+                BOOL currentUnder5 = (columnUnits[targetColumn] < 5);
+                BOOL candidateUnder5 = (columnUnits[c] < 5);
+
+                if (candidateUnder5 && !currentUnder5) {
+                    // Prefer under-5 columns
                     targetColumn = c;
-                    minUnits = columnUnits[c];
                     minY = columnY[c];
+                } else if (candidateUnder5 == currentUnder5) {
+                    // Both under or both over: pick shortest by pixel height
+                    if (columnY[c] < minY) {
+                        targetColumn = c;
+                        minY = columnY[c];
+                    }
                 }
             }
-        }
-
-        // Calculate X position for target column
-        CGFloat columnX = leftOffset + targetColumn * (columnWidth + 2.0 * kColumnMarginLR) + kColumnMarginLR + kCardMarginLR;
 
-        // Get actual pixel height from delegate
-        CGFloat itemHeight = 100.0; // fallback
-        if ([self.delegate respondsToSelector:@selector(collectionView:layout:heightForItemAtIndexPath:itemWidth:)]) {
-            itemHeight = [self.delegate collectionView:cv layout:self heightForItemAtIndexPath:indexPath itemWidth:cardWidth];
+            // Calculate X position for target column
+            CGFloat columnX = self.leftOffset + targetColumn * (self.columnWidth + 2.0 * kColumnMarginLR) + kColumnMarginLR + kCardMarginLR;
+            CGRect frame = CGRectMake(columnX, columnY[targetColumn] + kCardMarginTop, self.cardWidth, itemHeight);
+            if (copying && !CGRectEqualToRect(frame, self.itemAttributes[item].frame)) {
+                self.itemAttributes[item] = [self.itemAttributes[item] copy];
+            }
+            self.itemAttributes[item].frame = frame;
+            self.itemColumns[item] = @(targetColumn);
         }
 
-        // Create layout attributes
-        UICollectionViewLayoutAttributes *attr =
-            [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:indexPath];
-        attr.frame = CGRectMake(columnX, columnY[targetColumn] + kCardMarginTop, cardWidth, itemHeight);
-        [self.itemAttributes addObject:attr];
-
         // Advance column tracking
         columnUnits[targetColumn] += sizeUnits;
         columnY[targetColumn] += kCardMarginTop + itemHeight + kCardMarginBottom;
@@ -176,7 +279,14 @@ static const CGFloat kMaxColumnWidth = 500.0;
     free(columnUnits);
     free(columnY);
 
-    self.cachedContentSize = CGSizeMake(viewportWidth, maxY);
+    // Items may have changed columns
+    [self.attributesIndex removeAllAttributes];
+    for (NSInteger item = 0; item < itemCount; item++) {
+        [self.attributesIndex addAttributes:self.itemAttributes[item] toLane:self.itemColumns[item].unsignedIntegerValue];
+    }
+    [self.attributesIndex build];
+
+    self.cachedContentSize = CGSizeMake(self.collectionView.bounds.size.width, maxY);
 }
 
 - (CGSize)collectionViewContentSize {
@@ -184,26 +294,17 @@ static const CGFloat kMaxColumnWidth = 500.0;
 }
 
 - (NSArray<UICollectionViewLayoutAttributes *> *)layoutAttributesForElementsInRect:(CGRect)rect {
-    NSMutableArray *result = [NSMutableArray array];
-    for (UICollectionViewLayoutAttributes *attr in self.itemAttributes) {
-        if (CGRectIntersectsRect(attr.frame, rect)) {
-            [result addObject:attr];
-        }
-    }
-    return result;
+    return [self.attributesIndex attributesInRect:rect];
 }
 
 - (UICollectionViewLayoutAttributes *)layoutAttributesForItemAtIndexPath:(NSIndexPath *)indexPath {
-    for (UICollectionViewLayoutAttributes *attr in self.itemAttributes) {
-        if ([attr.indexPath isEqual:indexPath]) {
-            return attr;
-        }
-    }
-    return nil;
+    // Section 0 only, in item order
+    if (indexPath.section != 0 || indexPath.item < 0 || indexPath.item >= (NSInteger)self.itemAttributes.count) return nil;
+    return self.itemAttributes[indexPath.item];
 }
 
 - (BOOL)shouldInvalidateLayoutForBoundsChange:(CGRect)newBounds {
-    return YES; // Always recalculate on rotation or resize
+    return YES; // prepareLayout redoes work only when the width changed
 }
 
 @end
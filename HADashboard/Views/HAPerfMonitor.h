@@ -1,6 +1,7 @@
 #import <Foundation/Foundation.h>
 
-/// Lightweight performance monitor that logs FPS, memory, and timing data to a CSV file.
+/// Lightweight performance monitor that logs FPS, memory, and timing data to a CSV file,
+/// plus one row per camera with its stream mode, frame rate, drops, bandwidth and decode time.
 /// Designed for minimal overhead on iPad 2 (A5, 512MB).
 ///
 /// Log file: /tmp/perf.log (jailbroken) or Documents/perf.log (sandboxed).
@@ -23,4 +24,18 @@
 - (void)markCellStart:(NSString *)cellType;
 - (void)markCellEnd;
 
+/// Per-camera counters, keyed by entity id and written as "cam" rows after
+/// each flush line. Safe to call from any thread (decode and network
+/// queues); they return immediately unless the monitor is running.
+/// mode is "hls", "mjpeg" or "snapshot".
+- (void)recordCameraMode:(NSString *)mode forEntityId:(NSString *)entityId;
+/// A frame (or changed snapshot) handed to the screen.
+- (void)recordCameraFrameForEntityId:(NSString *)entityId;
+/// A frame superseded before it was decoded or shown.
+- (void)recordCameraDroppedFrameForEntityId:(NSString *)entityId;
+- (void)recordCameraBytes:(NSUInteger)bytes forEntityId:(NSString *)entityId;
+- (void)recordCameraDecodeMs:(double)ms forEntityId:(NSString *)entityId;
+/// The camera gave up a mode for a lesser one (HLS → MJPEG → snapshot).
+- (void)recordCameraFallbackForEntityId:(NSString *)entityId;
+
 @end
@@ -1,16 +1,70 @@
 #import "HAPerfMonitor.h"
+#import "HADeviceRegistration.h"
 #import "HALog.h"
 #import <QuartzCore/QuartzCore.h>
 #import <mach/mach.h>
-#import <sys/utsname.h>
 #import <UIKit/UIKit.h>
 
 // Ring buffer size — 120 frames ≈ 2s at 60fps or 4s at 30fps
 #define kFrameRingSize 120
 
+// Decode times kept per camera per flush window for the p95
+#define kDecodeSampleSize 256
+
 // Flush interval in seconds
 static const NSTimeInterval kFlushInterval = 10.0;
 
+/// One camera's counters for the current flush window.
+@interface HACameraPerfStats : NSObject {
+@public
+    NSUInteger _frames;
+    NSUInteger _drops;
+    unsigned long long _bytes;
+    NSUInteger _fallbacks;
+    NSUInteger _decodeCount;
+    double _decodeTotalMs;
+    double _decodeSamples[kDecodeSampleSize]; // ring; the latest decodes win
+    CFTimeInterval _windowStart;
+    CFTimeInterval _windowLength; // set on taken windows
+}
+@property (nonatomic, copy) NSString *entityId;
+@property (nonatomic, copy) NSString *mode;
+@end
+
+@implementation HACameraPerfStats
+
+/// Copy for formatting off main, leaving this one reset for the next window.
+- (HACameraPerfStats *)takeWindowAt:(CFTimeInterval)now {
+    HACameraPerfStats *window = [[HACameraPerfStats alloc] init];
+    window->_frames = _frames;
+    window->_drops = _drops;
+    window->_bytes = _bytes;
+    window->_fallbacks = _fallbacks;
+    window->_decodeCount = _decodeCount;
+    window->_decodeTotalMs = _decodeTotalMs;
+    memcpy(window->_decodeSamples, _decodeSamples, MIN(_decodeCount, (NSUInteger)kDecodeSampleSize) * sizeof(double));
+    window->_windowStart = _windowStart;
+    window->_windowLength = now - _windowStart;
+    window.entityId = self.entityId;
+    window.mode = self.mode;
+
+    _frames = 0;
+    _drops = 0;
+    _bytes = 0;
+    _fallbacks = 0;
+    _decodeCount = 0;
+    _decodeTotalMs = 0;
+    _windowStart = now;
+    return window;
+}
+
+@end
+
+static int ha_compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
 @interface HAPerfMonitor ()
 @property (nonatomic, strong) CADisplayLink *displayLink;
 @property (nonatomic, strong) NSTimer *flushTimer;
@@ -18,6 +72,7 @@ static const NSTimeInterval kFlushInterval = 10.0;
 @property (nonatomic, copy) NSString *logPath;
 @property (nonatomic, copy) NSString *deviceModel;
 @property (nonatomic, assign) BOOL isLightweight; // iPad2/iPad3 class device
+@property (atomic, assign) BOOL collecting;      // gates the camera recorders
 @end
 
 @implementation HAPerfMonitor {
@@ -39,6 +94,9 @@ static const NSTimeInterval kFlushInterval = 10.0;
     double _cellMaxMs;
     NSString *_cellMaxType;
 
+    // Camera counters — written from decode/network queues, guarded by @synchronized(_cameraStats)
+    NSMutableDictionary<NSString *, HACameraPerfStats *> *_cameraStats;
+
     BOOL _headerWritten;
 }
 
@@ -56,6 +114,7 @@ static const NSTimeInterval kFlushInterval = 10.0;
     if (self) {
         [self detectDevice];
         [self resolveLogPath];
+        _cameraStats = [NSMutableDictionary dictionary];
     }
     return self;
 }
@@ -63,18 +122,8 @@ static const NSTimeInterval kFlushInterval = 10.0;
 #pragma mark - Device Detection
 
 - (void)detectDevice {
-#if !TARGET_OS_SIMULATOR
-    struct utsname systemInfo;
-    if (uname(&systemInfo) == 0) {
-        self.deviceModel = [NSString stringWithCString:systemInfo.machine encoding:NSUTF8StringEncoding];
-    }
-    self.isLightweight = (self.deviceModel &&
-        ([self.deviceModel hasPrefix:@"iPad2"] || [self.deviceModel hasPrefix:@"iPad3"] ||
-         [self.deviceModel hasPrefix:@"iPhone4"] || [self.deviceModel hasPrefix:@"iPod5"]));
-#else
-    self.deviceModel = @"Simulator";
-    self.isLightweight = NO;
-#endif
+    self.deviceModel = HADeviceMachineModel();
+    self.isLightweight = HADeviceIsLowEnd();
 }
 
 - (void)resolveLogPath {
@@ -103,6 +152,10 @@ static const NSTimeInterval kFlushInterval = 10.0;
     _cellMaxMs = 0;
     _cellMaxType = nil;
     _headerWritten = NO;
+    @synchronized (_cameraStats) {
+        [_cameraStats removeAllObjects];
+    }
+    self.collecting = YES;
 
     // Open log file (truncate on fresh start)
     [[NSFileManager defaultManager] createFileAtPath:self.logPath contents:nil attributes:nil];
@@ -129,6 +182,7 @@ static const NSTimeInterval kFlushInterval = 10.0;
 }
 
 - (void)stop {
+    self.collecting = NO;
     [self.displayLink invalidate];
     self.displayLink = nil;
     [self.flushTimer invalidate];
@@ -154,6 +208,8 @@ static const NSTimeInterval kFlushInterval = 10.0;
                 ts, fpsAvg, fpsMin, fpsMin, [self residentMemoryMB],
                 _lastRebuildMs, cellAvgMs, _cellMaxMs, _cellMaxType ?: @"-"];
             [self.logHandle writeData:[line dataUsingEncoding:NSUTF8StringEncoding]];
+            NSString *cameraRows = [self cameraRowsForWindows:[self takeCameraWindows] timestamp:ts];
+            [self.logHandle writeData:[cameraRows dataUsingEncoding:NSUTF8StringEncoding]];
             [self.logHandle synchronizeFile];
         }
         [self.logHandle closeFile];
@@ -168,6 +224,9 @@ static const NSTimeInterval kFlushInterval = 10.0;
     _cellCount = 0;
     _cellMaxMs = 0;
     _cellMaxType = nil;
+    @synchronized (_cameraStats) {
+        [_cameraStats removeAllObjects];
+    }
 
     HALogI(@"perf", @"Stopped — log at %@", self.logPath);
 }
@@ -187,8 +246,9 @@ static const NSTimeInterval kFlushInterval = 10.0;
     NSString *startTime = [fmt stringFromDate:[NSDate date]];
 
     NSString *header = [NSString stringWithFormat:
-        @"# HAPerfMonitor v1 | device=%@ | iOS=%@ | scale=%.0fx | started=%@\n"
-        @"# ts,fps_avg,fps_min,fps_p1,mem_mb,rebuild_ms,cell_avg_ms,cell_max_ms,cell_max_type\n",
+        @"# HAPerfMonitor v2 | device=%@ | iOS=%@ | scale=%.0fx | started=%@\n"
+        @"# ts,fps_avg,fps_min,fps_p1,mem_mb,rebuild_ms,cell_avg_ms,cell_max_ms,cell_max_type\n"
+        @"# cam,ts,entity_id,mode,fps,dropped,bytes_s,decode_avg_ms,decode_p95_ms,fallbacks\n",
         self.deviceModel ?: @"unknown", iosVersion, scale, startTime];
 
     [self.logHandle writeData:[header dataUsingEncoding:NSUTF8StringEncoding]];
@@ -257,6 +317,7 @@ static const NSTimeInterval kFlushInterval = 10.0;
     NSUInteger cellCount = _cellCount;
     double cellMax = _cellMaxMs;
     NSString *cellType = _cellMaxType ?: @"-";
+    NSArray<HACameraPerfStats *> *cameraWindows = [self takeCameraWindows];
 
     // Reset counters immediately (main thread)
     _frameWriteIndex = 0;
@@ -301,6 +362,7 @@ static const NSTimeInterval kFlushInterval = 10.0;
 
         NSString *line = [NSString stringWithFormat:@"%.0f,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f,%.2f,%@\n",
             ts, fpsAvg, fpsMin, fpsP1, memMB, rebuildMs, cellAvgMs, cellMax, cellType];
+        line = [line stringByAppendingString:[self cameraRowsForWindows:cameraWindows timestamp:ts]];
         @synchronized(handle) {
             [handle writeData:[line dataUsingEncoding:NSUTF8StringEncoding]];
             [handle synchronizeFile];
@@ -309,6 +371,97 @@ static const NSTimeInterval kFlushInterval = 10.0;
     });
 }
 
+#pragma mark - Camera Metrics
+
+/// Stats for entityId, created on first use. Caller holds @synchronized(_cameraStats).
+- (HACameraPerfStats *)statsForEntityId:(NSString *)entityId {
+    HACameraPerfStats *stats = _cameraStats[entityId];
+    if (!stats) {
+        stats = [[HACameraPerfStats alloc] init];
+        stats->_windowStart = CACurrentMediaTime();
+        stats.entityId = entityId;
+        _cameraStats[entityId] = stats;
+    }
+    return stats;
+}
+
+- (void)recordCameraMode:(NSString *)mode forEntityId:(NSString *)entityId {
+    if (!self.collecting || !entityId) return;
+    @synchronized (_cameraStats) {
+        [self statsForEntityId:entityId].mode = mode;
+    }
+}
+
+- (void)recordCameraFrameForEntityId:(NSString *)entityId {
+    if (!self.collecting || !entityId) return;
+    @synchronized (_cameraStats) {
+        [self statsForEntityId:entityId]->_frames++;
+    }
+}
+
+- (void)recordCameraDroppedFrameForEntityId:(NSString *)entityId {
+    if (!self.collecting || !entityId) return;
+    @synchronized (_cameraStats) {
+        [self statsForEntityId:entityId]->_drops++;
+    }
+}
+
+- (void)recordCameraBytes:(NSUInteger)bytes forEntityId:(NSString *)entityId {
+    if (!self.collecting || !entityId) return;
+    @synchronized (_cameraStats) {
+        [self statsForEntityId:entityId]->_bytes += bytes;
+    }
+}
+
+- (void)recordCameraDecodeMs:(double)ms forEntityId:(NSString *)entityId {
+    if (!self.collecting || !entityId) return;
+    @synchronized (_cameraStats) {
+        HACameraPerfStats *stats = [self statsForEntityId:entityId];
+        stats->_decodeSamples[stats->_decodeCount % kDecodeSampleSize] = ms;
+        stats->_decodeCount++;
+        stats->_decodeTotalMs += ms;
+    }
+}
+
+- (void)recordCameraFallbackForEntityId:(NSString *)entityId {
+    if (!self.collecting || !entityId) return;
+    @synchronized (_cameraStats) {
+        [self statsForEntityId:entityId]->_fallbacks++;
+    }
+}
+
+/// Every camera's window so far (sorted by entity id), counters reset.
+/// Cameras stay listed while the monitor runs, so an idle one logs zeros.
+- (NSArray<HACameraPerfStats *> *)takeCameraWindows {
+    CFTimeInterval now = CACurrentMediaTime();
+    NSMutableArray<HACameraPerfStats *> *windows = [NSMutableArray array];
+    @synchronized (_cameraStats) {
+        for (NSString *entityId in [[_cameraStats allKeys] sortedArrayUsingSelector:@selector(compare:)]) {
+            [windows addObject:[_cameraStats[entityId] takeWindowAt:now]];
+        }
+    }
+    return windows;
+}
+
+- (NSString *)cameraRowsForWindows:(NSArray<HACameraPerfStats *> *)windows timestamp:(NSTimeInterval)ts {
+    NSMutableString *rows = [NSMutableString string];
+    for (HACameraPerfStats *window in windows) {
+        double seconds = MAX(window->_windowLength, 0.001);
+        double decodeAvgMs = 0, decodeP95Ms = 0;
+        NSUInteger samples = MIN(window->_decodeCount, (NSUInteger)kDecodeSampleSize);
+        if (samples > 0) {
+            decodeAvgMs = window->_decodeTotalMs / window->_decodeCount;
+            qsort(window->_decodeSamples, samples, sizeof(double), ha_compareDoubles);
+            NSUInteger p95Index = MIN((NSUInteger)(samples * 0.95), samples - 1);
+            decodeP95Ms = window->_decodeSamples[p95Index];
+        }
+        [rows appendFormat:@"cam,%.0f,%@,%@,%.1f,%lu,%.0f,%.2f,%.2f,%lu\n",
+            ts, window.entityId, window.mode ?: @"-", window->_frames / seconds, (unsigned long)window->_drops,
+            window->_bytes / seconds, decodeAvgMs, decodeP95Ms, (unsigned long)window->_fallbacks];
+    }
+    return rows;
+}
+
 - (double)residentMemoryMB {
     struct mach_task_basic_info info;
     mach_msg_type_number_t size = MACH_TASK_BASIC_INFO_COUNT;
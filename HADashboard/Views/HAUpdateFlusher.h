@@ -0,0 +1,53 @@
+#import <UIKit/UIKit.h>
+
+@class HAUpdateFlusher;
+
+@protocol HAUpdateFlusherDelegate <NSObject>
+
+/// Apply the updates for these index paths now. Called on a display
+/// frame, possibly several times per frame in small batches, priority
+/// paths first.
+- (void)updateFlusher:(HAUpdateFlusher *)flusher flushIndexPaths:(NSArray<NSIndexPath *> *)indexPaths;
+
+@end
+
+/// Frame-aligned coalescing of cell updates, replacing a restartable
+/// timer (which a steady stream of updates could postpone forever).
+///
+/// A path becomes due coalesceInterval after it was first enqueued;
+/// enqueueing it again doesn't reset that. On each display frame due
+/// paths are handed to the delegate in batches until frameBudget is
+/// spent; the rest wait for the next frame. Paths older than maxLatency
+/// and prioritized paths (cells the user is touching) are always
+/// flushed, on the next frame, whatever the budget. The display link is
+/// paused while nothing is pending. Main thread only.
+@interface HAUpdateFlusher : NSObject
+
+@property (nonatomic, weak) id<HAUpdateFlusherDelegate> delegate;
+
+/// Defaults 0.1 s, or 0.25 s on armv7 devices (fewer, larger batches).
+@property (nonatomic, assign) NSTimeInterval coalesceInterval;
+/// Upper bound on how long an update waits. Default 0.5 s.
+@property (nonatomic, assign) NSTimeInterval maxLatency;
+/// Main-thread time per frame for flushing. Default 4 ms, 6 ms on armv7
+/// (which runs at a lower frame rate for the same work).
+@property (nonatomic, assign) NSTimeInterval frameBudget;
+
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+- (void)enqueueIndexPaths:(NSArray<NSIndexPath *> *)indexPaths;
+
+/// Updates to this path skip coalescing and the budget for duration
+/// seconds (e.g. a card just tapped, whose new state is on its way).
+- (void)prioritizeIndexPath:(NSIndexPath *)indexPath forDuration:(NSTimeInterval)duration;
+
+/// Drop pending paths (their index paths went stale) and priorities.
+- (void)removeAllPending;
+
+/// Run one frame's flush now; for tests and callers that can't wait.
+- (void)flushDueIndexPathsAtTime:(CFTimeInterval)now;
+
+/// Stop the display link for good. Call before releasing the delegate.
+- (void)invalidate;
+
+@end
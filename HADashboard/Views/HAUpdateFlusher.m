@@ -0,0 +1,137 @@
+#import "HAUpdateFlusher.h"
+#import "HADeviceRegistration.h"
+#import <QuartzCore/QuartzCore.h>
+
+/// Paths handed to the delegate between budget checks
+static const NSUInteger kFlushBatchSize = 4;
+
+/// CADisplayLink retains its target; this breaks the cycle.
+@interface HAUpdateFlusherTrampoline : NSObject
+@property (nonatomic, weak) HAUpdateFlusher *flusher;
+@end
+
+@interface HAUpdateFlusher ()
+@property (nonatomic, strong) CADisplayLink *displayLink;
+@property (nonatomic, strong) NSMutableDictionary<NSIndexPath *, NSNumber *> *pendingSince; // first enqueue time
+@property (nonatomic, strong) NSMutableDictionary<NSIndexPath *, NSNumber *> *priorityUntil;
+- (void)displayLinkFired:(CADisplayLink *)link;
+@end
+
+@implementation HAUpdateFlusherTrampoline
+
+- (void)displayLinkFired:(CADisplayLink *)link {
+    [self.flusher displayLinkFired:link];
+}
+
+@end
+
+@implementation HAUpdateFlusher
+
+- (instancetype)init {
+    self = [super init];
+    if (self) {
+        _pendingSince = [NSMutableDictionary dictionary];
+        _priorityUntil = [NSMutableDictionary dictionary];
+
+        BOOL lightweight = HADeviceIsLowEnd();
+        _coalesceInterval = lightweight ? 0.25 : 0.1;
+        _maxLatency = 0.5;
+        _frameBudget = lightweight ? 0.006 : 0.004;
+    }
+    return self;
+}
+
+- (void)dealloc {
+    [_displayLink invalidate];
+}
+
+- (NSUInteger)pendingCount {
+    return self.pendingSince.count;
+}
+
+#pragma mark - Enqueue
+
+- (void)enqueueIndexPaths:(NSArray<NSIndexPath *> *)indexPaths {
+    if (indexPaths.count == 0) return;
+    NSNumber *now = @(CACurrentMediaTime());
+    for (NSIndexPath *indexPath in indexPaths) {
+        if (!self.pendingSince[indexPath]) self.pendingSince[indexPath] = now;
+    }
+    [self resume];
+}
+
+- (void)prioritizeIndexPath:(NSIndexPath *)indexPath forDuration:(NSTimeInterval)duration {
+    if (!indexPath) return;
+    self.priorityUntil[indexPath] = @(CACurrentMediaTime() + duration);
+    if (self.pendingSince[indexPath]) [self resume];
+}
+
+- (void)removeAllPending {
+    [self.pendingSince removeAllObjects];
+    [self.priorityUntil removeAllObjects];
+    self.displayLink.paused = YES;
+}
+
+- (void)invalidate {
+    [self.displayLink invalidate];
+    self.displayLink = nil;
+    [self.pendingSince removeAllObjects];
+}
+
+- (void)resume {
+    if (!self.displayLink) {
+        HAUpdateFlusherTrampoline *trampoline = [[HAUpdateFlusherTrampoline alloc] init];
+        trampoline.flusher = self;
+        self.displayLink = [CADisplayLink displayLinkWithTarget:trampoline selector:@selector(displayLinkFired:)];
+        // Common modes: keep updating while the dashboard is scrolled
+        [self.displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+    }
+    self.displayLink.paused = NO;
+}
+
+#pragma mark - Flush
+
+- (void)displayLinkFired:(CADisplayLink *)link {
+    [self flushDueIndexPathsAtTime:CACurrentMediaTime()];
+}
+
+- (void)flushDueIndexPathsAtTime:(CFTimeInterval)now {
+    // Expired priorities
+    for (NSIndexPath *indexPath in [self.priorityUntil allKeys]) {
+        if (self.priorityUntil[indexPath].doubleValue <= now) [self.priorityUntil removeObjectForKey:indexPath];
+    }
+
+    // Must go this frame: prioritized or overdue. May go: due, oldest first.
+    NSMutableArray<NSIndexPath *> *urgent = [NSMutableArray array];
+    NSMutableArray<NSIndexPath *> *due = [NSMutableArray array];
+    [self.pendingSince enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *indexPath, NSNumber *since, BOOL *stop) {
+        CFTimeInterval age = now - since.doubleValue;
+        if (self.priorityUntil[indexPath] || age >= self.maxLatency) {
+            [urgent addObject:indexPath];
+        } else if (age >= self.coalesceInterval) {
+            [due addObject:indexPath];
+        }
+    }];
+    [due sortUsingComparator:^NSComparisonResult(NSIndexPath *a, NSIndexPath *b) {
+        return [self.pendingSince[a] compare:self.pendingSince[b]];
+    }];
+
+    if (urgent.count > 0) {
+        // Outside the budget: the latency bound wins
+        [self.pendingSince removeObjectsForKeys:urgent];
+        [self.delegate updateFlusher:self flushIndexPaths:urgent];
+    }
+    // At least one batch per frame, so a tiny budget still makes progress
+    CFTimeInterval frameStart = CACurrentMediaTime();
+    NSUInteger next = 0;
+    while (next < due.count && (next == 0 || CACurrentMediaTime() - frameStart < self.frameBudget)) {
+        NSArray<NSIndexPath *> *batch = [due subarrayWithRange:NSMakeRange(next, MIN(kFlushBatchSize, due.count - next))];
+        next += batch.count;
+        [self.pendingSince removeObjectsForKeys:batch];
+        [self.delegate updateFlusher:self flushIndexPaths:batch];
+    }
+
+    if (self.pendingSince.count == 0) self.displayLink.paused = YES;
+}
+
+@end
@@ -0,0 +1,108 @@
+#import <XCTest/XCTest.h>
+#import "HABitmapBufferPool.h"
+
+#pragma mark - Bitmap Buffer Pool Tests
+
+@interface HABitmapBufferPoolTests : XCTestCase
+@property (nonatomic, strong) HABitmapBufferPool *pool;
+@end
+
+@implementation HABitmapBufferPoolTests
+
+- (void)setUp {
+    [super setUp];
+    self.pool = [[HABitmapBufferPool alloc] init];
+    self.pool.maxPooledBytes = 4 * 1024 * 1024;
+}
+
+- (UIImage *)imageOfWidth:(size_t)width height:(size_t)height color:(UIColor *)color {
+    return [self.pool imageWithPixelWidth:width height:height drawing:^(CGContextRef context) {
+        CGContextSetFillColorWithColor(context, color.CGColor);
+        CGContextFillRect(context, CGRectMake(0, 0, width, height));
+    }];
+}
+
+- (void)testReleasedBufferIsReusedForSameSize {
+    @autoreleasepool {
+        UIImage *first = [self imageOfWidth:320 height:240 color:[UIColor redColor]];
+        XCTAssertNotNil(first);
+        XCTAssertEqual(CGImageGetWidth(first.CGImage), 320u);
+        XCTAssertEqual(self.pool.pooledBytes, 0u, @"In use, not pooled");
+    }
+    XCTAssertGreaterThan(self.pool.pooledBytes, 0u, @"Released image returns its buffer");
+
+    @autoreleasepool {
+        UIImage *second = [self imageOfWidth:320 height:240 color:[UIColor blueColor]];
+        XCTAssertNotNil(second);
+    }
+    XCTAssertEqual(self.pool.allocationCount, 1u);
+    XCTAssertEqual(self.pool.reuseCount, 1u);
+}
+
+- (void)testRecycledBufferShowsNewFrame {
+    @autoreleasepool {
+        [self imageOfWidth:4 height:4 color:[UIColor redColor]];
+    }
+    UIImage *image = [self imageOfWidth:4 height:4 color:[UIColor blueColor]];
+    CFDataRef pixels = CGDataProviderCopyData(CGImageGetDataProvider(image.CGImage));
+    const uint8_t *bgrx = CFDataGetBytePtr(pixels);
+    XCTAssertEqual(bgrx[0], 255, @"Blue");
+    XCTAssertEqual(bgrx[2], 0, @"No red left from the previous frame");
+    CFRelease(pixels);
+    XCTAssertEqual(self.pool.reuseCount, 1u);
+}
+
+- (void)testDifferentSizeAllocates {
+    @autoreleasepool {
+        [self imageOfWidth:320 height:240 color:[UIColor redColor]];
+        [self imageOfWidth:640 height:480 color:[UIColor redColor]];
+    }
+    XCTAssertEqual(self.pool.allocationCount, 2u);
+    XCTAssertEqual(self.pool.reuseCount, 0u);
+}
+
+- (void)testPooledBytesNeverExceedCap {
+    self.pool.maxPooledBytes = 400 * 1024; // one 320x240 buffer (~300 KB), not two
+    @autoreleasepool {
+        UIImage *a = [self imageOfWidth:320 height:240 color:[UIColor redColor]];
+        UIImage *b = [self imageOfWidth:320 height:240 color:[UIColor redColor]];
+        XCTAssertNotNil(a);
+        XCTAssertNotNil(b);
+    }
+    XCTAssertLessThanOrEqual(self.pool.pooledBytes, 400u * 1024);
+    XCTAssertGreaterThan(self.pool.pooledBytes, 0u);
+}
+
+- (void)testNewSizeEvictsOldSize {
+    self.pool.maxPooledBytes = 400 * 1024;
+    @autoreleasepool {
+        [self imageOfWidth:320 height:240 color:[UIColor redColor]];
+    }
+    @autoreleasepool {
+        [self imageOfWidth:300 height:240 color:[UIColor redColor]];
+    }
+    // Only the 300-wide buffer is kept: a 320-wide request allocates
+    @autoreleasepool {
+        [self imageOfWidth:320 height:240 color:[UIColor redColor]];
+    }
+    XCTAssertEqual(self.pool.allocationCount, 3u);
+}
+
+- (void)testLoweringCapAndDrainFreeBuffers {
+    @autoreleasepool {
+        [self imageOfWidth:320 height:240 color:[UIColor redColor]];
+        [self imageOfWidth:64 height:64 color:[UIColor redColor]];
+    }
+    XCTAssertGreaterThan(self.pool.pooledBytes, 64u * 64 * 4);
+    self.pool.maxPooledBytes = 64 * 64 * 4;
+    XCTAssertLessThanOrEqual(self.pool.pooledBytes, 64u * 64 * 4);
+
+    [self.pool drain];
+    XCTAssertEqual(self.pool.pooledBytes, 0u);
+}
+
+- (void)testEmptySizeReturnsNil {
+    XCTAssertNil([self imageOfWidth:0 height:10 color:[UIColor redColor]]);
+}
+
+@end
@@ -2,6 +2,7 @@
 #import "HACacheManager.h"
 #import "HAEntityStateCache.h"
 #import "HADashboardConfigCache.h"
+#import "HAHistoryDiskCache.h"
 #import "HAEntity.h"
 
 #pragma mark - HACacheManager Tests
@@ -403,3 +404,149 @@
 }
 
 @end
+
+#pragma mark - HAHistoryDiskCache Tests
+
+@interface HAHistoryDiskCacheTests : XCTestCase
+@property (nonatomic, strong) HAHistoryDiskCache *cache;
+@end
+
+@implementation HAHistoryDiskCacheTests
+
+- (void)setUp {
+    [super setUp];
+    [HACacheManager sharedManager].serverURL = @"http://history-cache-test.local:8123";
+    self.cache = [[HAHistoryDiskCache alloc] init];
+}
+
+- (void)tearDown {
+    [[HACacheManager sharedManager] clearAllCaches];
+    [super tearDown];
+}
+
+- (NSArray *)pointsFrom:(NSTimeInterval)start count:(NSUInteger)count bands:(BOOL)bands {
+    NSMutableArray *points = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        double value = 20.0 + i * 0.5;
+        if (bands) {
+            [points addObject:@{@"timestamp": @(start + i * 60), @"value": @(value),
+                                @"min": @(value - 1), @"max": @(value + 1)}];
+        } else {
+            [points addObject:@{@"timestamp": @(start + i * 60), @"value": @(value)}];
+        }
+    }
+    return points;
+}
+
+- (void)testEncodeDecodeRoundTrip {
+    NSTimeInterval start = 1700000000;
+    NSArray *points = [self pointsFrom:start count:100 bands:NO];
+    NSData *data = [HAHistoryDiskCache dataForPoints:points coveredStart:start coveredEnd:start + 6000];
+    XCTAssertEqual(data.length, 32 + 100 * 2 * sizeof(double), @"Two doubles per point after the header");
+
+    NSTimeInterval coveredStart = 0, coveredEnd = 0;
+    NSArray *decoded = [HAHistoryDiskCache pointsFromData:data coveredStart:&coveredStart coveredEnd:&coveredEnd];
+    XCTAssertEqual(decoded.count, 100);
+    XCTAssertEqualWithAccuracy(coveredStart, start, 0.001);
+    XCTAssertEqualWithAccuracy(coveredEnd, start + 6000, 0.001);
+    for (NSUInteger i = 0; i < 100; i++) {
+        XCTAssertEqualWithAccuracy([decoded[i][@"timestamp"] doubleValue], [points[i][@"timestamp"] doubleValue], 0.01);
+        XCTAssertEqualWithAccuracy([decoded[i][@"value"] doubleValue], [points[i][@"value"] doubleValue], 0.001);
+        XCTAssertNil(decoded[i][@"min"], @"Series without bands should decode without them");
+    }
+}
+
+- (void)testEncodeDecodeKeepsBands {
+    NSTimeInterval start = 1700000000;
+    NSArray *points = [self pointsFrom:start count:10 bands:YES];
+    NSData *data = [HAHistoryDiskCache dataForPoints:points coveredStart:start coveredEnd:start + 600];
+    NSArray *decoded = [HAHistoryDiskCache pointsFromData:data coveredStart:NULL coveredEnd:NULL];
+    XCTAssertEqual(decoded.count, 10);
+    XCTAssertEqualWithAccuracy([decoded[3][@"min"] doubleValue], [points[3][@"min"] doubleValue], 0.001);
+    XCTAssertEqualWithAccuracy([decoded[3][@"max"] doubleValue], [points[3][@"max"] doubleValue], 0.001);
+}
+
+- (void)testEncodeDecodeKeepsLargeMeterValuesExact {
+    NSTimeInterval start = 1700000000;
+    NSArray *points = @[@{@"timestamp": @(start), @"value": @(123456789.125)},
+                        @{@"timestamp": @(start + 60), @"value": @(123456789.375)}];
+    NSData *data = [HAHistoryDiskCache dataForPoints:points coveredStart:start coveredEnd:start + 120];
+    NSArray *decoded = [HAHistoryDiskCache pointsFromData:data coveredStart:NULL coveredEnd:NULL];
+    XCTAssertEqual([decoded[0][@"value"] doubleValue], 123456789.125);
+    XCTAssertEqual([decoded[1][@"value"] doubleValue], 123456789.375);
+}
+
+- (void)testDecodeRejectsTruncatedOrForeignData {
+    NSTimeInterval start = 1700000000;
+    NSData *data = [HAHistoryDiskCache dataForPoints:[self pointsFrom:start count:10 bands:NO]
+                                        coveredStart:start coveredEnd:start + 600];
+    NSData *truncated = [data subdataWithRange:NSMakeRange(0, data.length - 4)];
+    XCTAssertNil([HAHistoryDiskCache pointsFromData:truncated coveredStart:NULL coveredEnd:NULL]);
+
+    NSData *json = [@"{\"state\": \"on\", \"attributes\": {}, \"padding\": true}" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertNil([HAHistoryDiskCache pointsFromData:json coveredStart:NULL coveredEnd:NULL]);
+}
+
+- (void)testKeyRoundsRangeAndSanitisesEntityId {
+    NSString *a = [HAHistoryDiskCache keyForEntityId:@"sensor.temp" range:24 * 3600 + 0.4 maxPoints:100];
+    NSString *b = [HAHistoryDiskCache keyForEntityId:@"sensor.temp" range:24 * 3600 - 0.4 maxPoints:100];
+    XCTAssertEqualObjects(a, b, @"Successive 'last 24 h' windows should share a key");
+    XCTAssertEqualObjects(a, @"sensor.temp-1440m-100");
+
+    NSString *unsafe = [HAHistoryDiskCache keyForEntityId:@"../../etc/passwd" range:3600 maxPoints:100];
+    XCTAssertFalse([unsafe containsString:@"/"], @"Keys must not escape the cache directory");
+}
+
+- (void)testWriteThenReadSeries {
+    NSTimeInterval start = 1700000000;
+    NSArray *points = [self pointsFrom:start count:50 bands:NO];
+    [self.cache writeSeries:points coveredStart:start coveredEnd:start + 3000 forKey:@"sensor.rt-50m-100"];
+
+    XCTestExpectation *exp = [self expectationWithDescription:@"read completes"];
+    [self.cache readSeriesForKey:@"sensor.rt-50m-100" completion:^(NSArray *read, NSTimeInterval coveredStart, NSTimeInterval coveredEnd) {
+        XCTAssertTrue([NSThread isMainThread], @"Completion should run on main");
+        XCTAssertEqual(read.count, 50);
+        XCTAssertEqualWithAccuracy(coveredEnd, start + 3000, 0.001);
+        [exp fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testEvictsLeastRecentlyUsedPastByteLimit {
+    NSTimeInterval start = 1700000000;
+    NSArray *points = [self pointsFrom:start count:100 bands:NO]; // ~832 bytes each
+    self.cache.byteLimit = 2000;
+
+    [self.cache writeSeries:points coveredStart:start coveredEnd:start + 6000 forKey:@"oldest"];
+    [self.cache writeSeries:points coveredStart:start coveredEnd:start + 6000 forKey:@"middle"];
+    // Modification dates have one-second granularity on some filesystems
+    XCTestExpectation *settle = [self expectationWithDescription:@"dates differ"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(1.1 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [settle fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    // Reading "oldest" makes "middle" the least recently used
+    XCTestExpectation *touched = [self expectationWithDescription:@"touched"];
+    [self.cache readSeriesForKey:@"oldest" completion:^(NSArray *read, NSTimeInterval s, NSTimeInterval e) {
+        XCTAssertNotNil(read);
+        [touched fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    [self.cache writeSeries:points coveredStart:start coveredEnd:start + 6000 forKey:@"newest"];
+
+    XCTestExpectation *middleGone = [self expectationWithDescription:@"middle evicted"];
+    [self.cache readSeriesForKey:@"middle" completion:^(NSArray *read, NSTimeInterval s, NSTimeInterval e) {
+        XCTAssertNil(read, @"Least recently used series should be evicted");
+        [middleGone fulfill];
+    }];
+    XCTestExpectation *oldestKept = [self expectationWithDescription:@"oldest kept"];
+    [self.cache readSeriesForKey:@"oldest" completion:^(NSArray *read, NSTimeInterval s, NSTimeInterval e) {
+        XCTAssertNotNil(read, @"Recently read series should survive eviction");
+        [oldestKept fulfill];
+    }];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+@end
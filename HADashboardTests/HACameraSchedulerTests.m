@@ -0,0 +1,118 @@
+#import <XCTest/XCTest.h>
+#import "HACameraScheduler.h"
+
+/// Records the slots the scheduler pushes to it.
+@interface HAFakeCameraClient : NSObject <HACameraSchedulerClient>
+@property (nonatomic, assign) HACameraSlot slot;
+@property (nonatomic, assign) NSUInteger reassignCount;
+@end
+
+@implementation HAFakeCameraClient
+- (void)cameraScheduler:(HACameraScheduler *)scheduler didAssignSlot:(HACameraSlot)slot {
+    self.slot = slot;
+    self.reassignCount++;
+}
+@end
+
+#pragma mark - Camera Scheduler Tests
+
+@interface HACameraSchedulerTests : XCTestCase
+@property (nonatomic, strong) HACameraScheduler *scheduler;
+@end
+
+@implementation HACameraSchedulerTests
+
+- (void)setUp {
+    [super setUp];
+    // Fresh instance: the shared one's budget depends on the device class
+    self.scheduler = [[HACameraScheduler alloc] init];
+    self.scheduler.maxLiveStreams = 2;
+    self.scheduler.maxSnapshotsPerSecond = 2;
+}
+
+- (HAFakeCameraClient *)request:(CGFloat)area wantsLive:(BOOL)wantsLive {
+    HAFakeCameraClient *client = [[HAFakeCameraClient alloc] init];
+    client.slot = [self.scheduler requestSlotForClient:client area:area wantsLive:wantsLive];
+    return client;
+}
+
+- (void)testLargestTilesGetLiveSlots {
+    HAFakeCameraClient *small = [self request:100 wantsLive:YES];
+    HAFakeCameraClient *medium = [self request:200 wantsLive:YES];
+    XCTAssertEqual(small.slot, HACameraSlotLive);
+    XCTAssertEqual(medium.slot, HACameraSlotLive);
+
+    HAFakeCameraClient *large = [self request:400 wantsLive:YES];
+    XCTAssertEqual(large.slot, HACameraSlotLive, @"Largest tile should get a live slot");
+    XCTAssertEqual(small.slot, HACameraSlotSnapshot, @"Smallest tile should be downgraded to snapshots");
+    XCTAssertEqual(small.reassignCount, 1u);
+    XCTAssertEqual(medium.slot, HACameraSlotLive);
+}
+
+- (void)testReleasingLiveSlotPromotesNextTile {
+    HAFakeCameraClient *a = [self request:300 wantsLive:YES];
+    HAFakeCameraClient *b = [self request:200 wantsLive:YES];
+    HAFakeCameraClient *c = [self request:100 wantsLive:YES];
+    XCTAssertEqual(c.slot, HACameraSlotSnapshot);
+
+    [self.scheduler releaseSlotForClient:a];
+    XCTAssertEqual([self.scheduler slotForClient:a], HACameraSlotPaused, @"Off-screen tiles are paused");
+    XCTAssertEqual(c.slot, HACameraSlotLive, @"Freed slot goes to the next tile");
+    XCTAssertEqual(b.slot, HACameraSlotLive);
+}
+
+- (void)testDeallocatedLiveTileFreesItsSlot {
+    HAFakeCameraClient *b = [self request:200 wantsLive:YES];
+    HAFakeCameraClient *c = [self request:100 wantsLive:YES];
+    @autoreleasepool {
+        HAFakeCameraClient *a = [self request:300 wantsLive:YES];
+        XCTAssertEqual(a.slot, HACameraSlotLive);
+    }
+    XCTAssertEqual(c.slot, HACameraSlotSnapshot);
+
+    [self.scheduler acquireSnapshotToken];
+    XCTAssertEqual(c.slot, HACameraSlotLive, @"The gone tile's slot goes to the next tile");
+    XCTAssertEqual(b.slot, HACameraSlotLive);
+}
+
+- (void)testSnapshotOnlyCamerasDontUseBudget {
+    HAFakeCameraClient *still = [self request:1000 wantsLive:NO];
+    HAFakeCameraClient *a = [self request:100 wantsLive:YES];
+    HAFakeCameraClient *b = [self request:100 wantsLive:YES];
+    XCTAssertEqual(still.slot, HACameraSlotSnapshot);
+    XCTAssertEqual(a.slot, HACameraSlotLive);
+    XCTAssertEqual(b.slot, HACameraSlotLive);
+}
+
+- (void)testEqualAreasKeepRegistrationOrder {
+    HAFakeCameraClient *first = [self request:100 wantsLive:YES];
+    HAFakeCameraClient *second = [self request:100 wantsLive:YES];
+    HAFakeCameraClient *third = [self request:100 wantsLive:YES];
+    XCTAssertEqual(first.slot, HACameraSlotLive);
+    XCTAssertEqual(second.slot, HACameraSlotLive);
+    XCTAssertEqual(third.slot, HACameraSlotSnapshot, @"Later tiles shouldn't steal slots from equal ones");
+    XCTAssertEqual(first.reassignCount + second.reassignCount, 0u, @"No churn for existing tiles");
+}
+
+- (void)testLoweringBudgetDowngradesImmediately {
+    HAFakeCameraClient *a = [self request:200 wantsLive:YES];
+    HAFakeCameraClient *b = [self request:100 wantsLive:YES];
+    self.scheduler.maxLiveStreams = 1;
+    XCTAssertEqual(a.slot, HACameraSlotLive);
+    XCTAssertEqual(b.slot, HACameraSlotSnapshot);
+}
+
+- (void)testSnapshotBudgetLimitsBurst {
+    XCTAssertTrue([self.scheduler acquireSnapshotToken]);
+    XCTAssertTrue([self.scheduler acquireSnapshotToken]);
+    XCTAssertFalse([self.scheduler acquireSnapshotToken], @"Third fetch in the same instant exceeds 2/s");
+
+    XCTestExpectation *refill = [self expectationWithDescription:@"refilled"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.6 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        XCTAssertTrue([self.scheduler acquireSnapshotToken], @"Budget refills over time");
+        [refill fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+}
+
+@end
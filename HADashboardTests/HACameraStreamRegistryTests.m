@@ -0,0 +1,115 @@
+#import <XCTest/XCTest.h>
+#import "HACameraStreamRegistry.h"
+#import "HAMJPEGStreamParser.h"
+
+#pragma mark - Camera Stream Registry Tests
+
+@interface HACameraStreamRegistryTests : XCTestCase
+@property (nonatomic, strong) HACameraStreamRegistry *registry;
+@property (nonatomic, strong) NSMutableArray<HACameraStreamConsumer *> *consumers;
+@end
+
+@implementation HACameraStreamRegistryTests
+
+- (void)setUp {
+    [super setUp];
+    self.registry = [HACameraStreamRegistry sharedRegistry];
+    self.consumers = [NSMutableArray array];
+}
+
+- (void)tearDown {
+    for (HACameraStreamConsumer *consumer in self.consumers) [consumer cancel];
+    [super tearDown];
+}
+
+- (HACameraStreamConsumer *)addConsumer:(NSString *)entityId size:(CGSize)size
+                                 frames:(NSMutableArray *)frames errors:(NSMutableArray *)errors {
+    NSURL *url = [NSURL URLWithString:[@"http://test-server.local:8123/api/camera_proxy_stream/" stringByAppendingString:entityId]];
+    HACameraStreamConsumer *consumer = [self.registry addConsumerForEntityId:entityId url:url authToken:@"token"
+        pixelSize:size
+        frameHandler:^(UIImage *frame) { [frames addObject:frame]; }
+        errorHandler:^(NSError *error) { [errors addObject:error]; }];
+    [self.consumers addObject:consumer];
+    return consumer;
+}
+
+- (UIImage *)frame {
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(4, 3), YES, 1.0);
+    UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+    return image;
+}
+
+- (void)testConsumersOfSameCameraShareOneStream {
+    HACameraStreamConsumer *a = [self addConsumer:@"camera.share" size:CGSizeMake(320, 240) frames:nil errors:nil];
+    HAMJPEGStreamParser *parser = [self.registry parserForEntityId:@"camera.share"];
+    HACameraStreamConsumer *b = [self addConsumer:@"camera.share" size:CGSizeMake(320, 240) frames:nil errors:nil];
+
+    XCTAssertNotNil(parser);
+    XCTAssertEqual([self.registry parserForEntityId:@"camera.share"], parser, @"Second consumer should join, not reopen");
+    XCTAssertEqual([self.registry consumerCountForEntityId:@"camera.share"], 2u);
+    XCTAssertTrue(b.isStreaming);
+
+    [a cancel];
+    XCTAssertEqual([self.registry parserForEntityId:@"camera.share"], parser, @"Stream stays open while consumers remain");
+    [b cancel];
+    XCTAssertNil([self.registry parserForEntityId:@"camera.share"], @"Last consumer out closes the stream");
+    XCTAssertFalse(parser.isStreaming);
+}
+
+- (void)testDifferentCamerasGetSeparateStreams {
+    [self addConsumer:@"camera.one" size:CGSizeZero frames:nil errors:nil];
+    [self addConsumer:@"camera.two" size:CGSizeZero frames:nil errors:nil];
+    XCTAssertNotEqual([self.registry parserForEntityId:@"camera.one"], [self.registry parserForEntityId:@"camera.two"]);
+}
+
+- (void)testDecodeSizeIsLargestRequest {
+    [self addConsumer:@"camera.size" size:CGSizeMake(320, 240) frames:nil errors:nil];
+    HACameraStreamConsumer *big = [self addConsumer:@"camera.size" size:CGSizeMake(640, 360) frames:nil errors:nil];
+    HAMJPEGStreamParser *parser = [self.registry parserForEntityId:@"camera.size"];
+    XCTAssertTrue(CGSizeEqualToSize(parser.targetPixelSize, CGSizeMake(640, 360)));
+
+    HACameraStreamConsumer *fullscreen = [self addConsumer:@"camera.size" size:CGSizeZero frames:nil errors:nil];
+    XCTAssertTrue(CGSizeEqualToSize(parser.targetPixelSize, CGSizeZero), @"A full-resolution consumer wins");
+
+    [fullscreen cancel];
+    XCTAssertTrue(CGSizeEqualToSize(parser.targetPixelSize, CGSizeMake(640, 360)));
+    big.pixelSize = CGSizeMake(200, 400);
+    XCTAssertTrue(CGSizeEqualToSize(parser.targetPixelSize, CGSizeMake(320, 400)), @"Per-axis maximum");
+}
+
+- (void)testFramesFanOutAndLateJoinerGetsLatest {
+    NSMutableArray *framesA = [NSMutableArray array], *framesB = [NSMutableArray array], *framesC = [NSMutableArray array];
+    [self addConsumer:@"camera.fan" size:CGSizeZero frames:framesA errors:nil];
+    [self addConsumer:@"camera.fan" size:CGSizeZero frames:framesB errors:nil];
+    HAMJPEGStreamParser *parser = [self.registry parserForEntityId:@"camera.fan"];
+
+    UIImage *frame = [self frame];
+    parser.frameHandler(frame);
+    XCTAssertEqual(framesA.count, 1u);
+    XCTAssertEqual(framesB.firstObject, frame, @"One decoded frame serves every consumer");
+
+    [self addConsumer:@"camera.fan" size:CGSizeZero frames:framesC errors:nil];
+    XCTestExpectation *exp = [self expectationWithDescription:@"late joiner painted"];
+    dispatch_async(dispatch_get_main_queue(), ^{ [exp fulfill]; });
+    [self waitForExpectationsWithTimeout:2 handler:nil];
+    XCTAssertEqual(framesC.firstObject, frame, @"A consumer joining a running stream gets the latest frame");
+}
+
+- (void)testFailStreamNotifiesEveryConsumer {
+    NSMutableArray *errorsA = [NSMutableArray array], *errorsB = [NSMutableArray array];
+    HACameraStreamConsumer *a = [self addConsumer:@"camera.fail" size:CGSizeZero frames:nil errors:errorsA];
+    HACameraStreamConsumer *b = [self addConsumer:@"camera.fail" size:CGSizeZero frames:nil errors:errorsB];
+
+    [a failStreamWithError:[NSError errorWithDomain:@"test" code:1 userInfo:nil]];
+    XCTAssertEqual(errorsA.count, 1u);
+    XCTAssertEqual(errorsB.count, 1u);
+    XCTAssertFalse(b.isStreaming);
+    XCTAssertNil([self.registry parserForEntityId:@"camera.fail"]);
+
+    // Reconnecting opens a fresh stream
+    [self addConsumer:@"camera.fail" size:CGSizeZero frames:nil errors:nil];
+    XCTAssertNotNil([self.registry parserForEntityId:@"camera.fail"]);
+}
+
+@end
@@ -0,0 +1,134 @@
+#import <XCTest/XCTest.h>
+#import "HACardHeightCache.h"
+#import "HADashboardConfig.h"
+#import "HAEntity.h"
+
+#pragma mark - Card Height Cache Tests
+
+@interface HACardHeightCacheTests : XCTestCase
+@property (nonatomic, strong) HACardHeightCache *cache;
+@property (nonatomic, assign) NSUInteger computeCount;
+@end
+
+@implementation HACardHeightCacheTests
+
+- (void)setUp {
+    [super setUp];
+    self.cache = [[HACardHeightCache alloc] init];
+    self.computeCount = 0;
+}
+
+- (HADashboardConfigItem *)itemWithName:(NSString *)name {
+    HADashboardConfigItem *item = [[HADashboardConfigItem alloc] init];
+    item.entityId = @"sensor.kitchen";
+    item.cardType = @"tile";
+    item.displayName = name;
+    item.columnSpan = 1;
+    item.rowSpan = 1;
+    return item;
+}
+
+- (CGFloat)heightOf:(HADashboardConfigItem *)item section:(HADashboardConfigSection *)section width:(CGFloat)width {
+    return [self.cache heightForItem:item section:section width:width entityIds:@[@"sensor.kitchen"] computedBy:^CGFloat{
+        self.computeCount++;
+        return 100.0 + self.computeCount;
+    }];
+}
+
+- (void)testRepeatedLookupHits {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    CGFloat first = [self heightOf:item section:nil width:320];
+    XCTAssertEqual([self heightOf:item section:nil width:320], first);
+    XCTAssertEqual(self.computeCount, 1u);
+    XCTAssertEqual(self.cache.hitCount, 1u);
+    XCTAssertEqual(self.cache.missCount, 1u);
+}
+
+- (void)testRebuiltItemWithSameContentHits {
+    [self heightOf:[self itemWithName:@"Kitchen"] section:nil width:320];
+    [self heightOf:[self itemWithName:@"Kitchen"] section:nil width:320];
+    XCTAssertEqual(self.computeCount, 1u);
+}
+
+- (void)testWidthChangeMisses {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    [self heightOf:item section:nil width:320];
+    [self heightOf:item section:nil width:480];
+    XCTAssertEqual(self.computeCount, 2u);
+}
+
+- (void)testContentChangeMisses {
+    [self heightOf:[self itemWithName:@"Kitchen"] section:nil width:320];
+    HADashboardConfigItem *changed = [self itemWithName:@"Kitchen"];
+    changed.customProperties = @{@"compact": @YES};
+    [self heightOf:changed section:nil width:320];
+    XCTAssertEqual(self.computeCount, 2u);
+}
+
+- (void)testSectionHeaderChangeMisses {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    HADashboardConfigSection *section = [[HADashboardConfigSection alloc] init];
+    section.entityIds = @[@"light.a"];
+    [self heightOf:item section:section width:320];
+
+    HADashboardConfigSection *same = [[HADashboardConfigSection alloc] init];
+    same.entityIds = @[@"light.a"];
+    [self heightOf:item section:same width:320];
+    XCTAssertEqual(self.computeCount, 1u);
+
+    HADashboardConfigSection *grown = [[HADashboardConfigSection alloc] init];
+    grown.entityIds = @[@"light.a", @"light.b"];
+    [self heightOf:item section:grown width:320];
+    XCTAssertEqual(self.computeCount, 2u);
+}
+
+- (void)testSameIdentityCardsKeepTheirOwnHeights {
+    HADashboardConfigItem *shortNote = [[HADashboardConfigItem alloc] init];
+    shortNote.cardType = @"markdown";
+    shortNote.customProperties = @{@"content": @"Hi"};
+    HADashboardConfigItem *longNote = [[HADashboardConfigItem alloc] init];
+    longNote.cardType = @"markdown";
+    longNote.customProperties = @{@"content": @"A\nB\nC\nD\nE\nF"};
+    XCTAssertEqualObjects([shortNote diffIdentity], [longNote diffIdentity]);
+
+    CGFloat (^heightOf)(HADashboardConfigItem *, CGFloat) = ^CGFloat(HADashboardConfigItem *item, CGFloat height) {
+        return [self.cache heightForItem:item section:nil width:320 entityIds:nil computedBy:^CGFloat{
+            self.computeCount++;
+            return height;
+        }];
+    };
+    XCTAssertEqual(heightOf(shortNote, 60), 60);
+    XCTAssertEqual(heightOf(longNote, 200), 200);
+    // A second layout pass hits for both
+    XCTAssertEqual(heightOf(shortNote, 0), 60);
+    XCTAssertEqual(heightOf(longNote, 0), 200);
+    XCTAssertEqual(self.computeCount, 2u);
+    XCTAssertEqual(self.cache.hitCount, 2u);
+}
+
+- (void)testRemoveAll {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    [self heightOf:item section:nil width:320];
+    [self.cache removeAllHeights];
+    [self heightOf:item section:nil width:320];
+    XCTAssertEqual(self.computeCount, 2u);
+}
+
+#pragma mark - Entity Version Tests
+
+- (void)testEntityVersionBumpsOnUpdate {
+    HAEntity *entity = [[HAEntity alloc] initWithDictionary:@{@"entity_id": @"light.a", @"state": @"on", @"attributes": @{}}];
+    NSUInteger version = entity.version;
+    [entity updateWithDictionary:@{@"entity_id": @"light.a", @"state": @"off", @"attributes": @{}}];
+    XCTAssertGreaterThan(entity.version, version);
+
+    version = entity.version;
+    entity.attributes = @{@"brightness": @10};
+    XCTAssertGreaterThan(entity.version, version);
+
+    version = entity.version;
+    [entity updateWithDictionary:@{@"entity_id": @"light.a", @"state": @"off", @"attributes": @{@"brightness": @10}}];
+    XCTAssertEqual(entity.version, version, @"a refresh that changes nothing keeps the version");
+}
+
+@end
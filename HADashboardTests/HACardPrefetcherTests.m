@@ -0,0 +1,96 @@
+#import <XCTest/XCTest.h>
+#import "HACardPrefetcher.h"
+#import "HARequestCoalescer.h"
+
+#pragma mark - Card Prefetcher Tests
+
+@interface HACardPrefetcherTests : XCTestCase
+@property (nonatomic, strong) HACardPrefetcher *prefetcher;
+@property (nonatomic, strong) NSMutableArray<NSString *> *started;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, dispatch_block_t> *doneBlocks;
+@end
+
+@implementation HACardPrefetcherTests
+
+- (void)setUp {
+    [super setUp];
+    self.prefetcher = [[HACardPrefetcher alloc] init];
+    self.prefetcher.maxConcurrentLoads = 1;
+    self.started = [NSMutableArray array];
+    self.doneBlocks = [NSMutableDictionary dictionary];
+}
+
+- (void)prefetch:(NSString *)key {
+    [self.prefetcher prefetchKey:key start:^NSArray<HARequestInterest *> *(dispatch_block_t done) {
+        [self.started addObject:key];
+        self.doneBlocks[key] = done;
+        return nil;
+    }];
+}
+
+- (void)testRunsInOrderWithinLimit {
+    [self prefetch:@"a"];
+    [self prefetch:@"b"];
+    [self prefetch:@"c"];
+    XCTAssertEqualObjects(self.started, (@[@"a"]));
+    XCTAssertEqual(self.prefetcher.runningCount, 1u);
+    XCTAssertEqual(self.prefetcher.pendingCount, 2u);
+
+    self.doneBlocks[@"a"]();
+    XCTAssertEqualObjects(self.started, (@[@"a", @"b"]));
+
+    self.prefetcher.maxConcurrentLoads = 2;
+    XCTAssertEqualObjects(self.started, (@[@"a", @"b", @"c"]));
+}
+
+- (void)testDuplicateKeyIsIgnored {
+    [self prefetch:@"a"];
+    [self prefetch:@"a"];
+    XCTAssertEqual(self.started.count, 1u);
+    XCTAssertEqual(self.prefetcher.pendingCount, 0u);
+}
+
+- (void)testWithdrawnPendingPrefetchNeverStarts {
+    [self prefetch:@"a"];
+    [self prefetch:@"b"];
+    [self.prefetcher cancelPrefetchForKey:@"b"];
+    self.doneBlocks[@"a"]();
+    XCTAssertEqualObjects(self.started, (@[@"a"]));
+    XCTAssertEqual(self.prefetcher.runningCount, 0u);
+}
+
+- (void)testWithdrawnRunningPrefetchCancelsItsRequest {
+    HARequestCoalescer *coalescer = [[HARequestCoalescer alloc] initWithFreshness:60.0];
+    __block NSUInteger cancels = 0;
+    [self.prefetcher prefetchKey:@"a" start:^NSArray<HARequestInterest *> *(dispatch_block_t done) {
+        HARequestInterest *interest = [coalescer loadKey:@"a" start:^dispatch_block_t(HARequestFinishBlock finish) {
+            return ^{ cancels++; };
+        } completion:nil];
+        return @[interest];
+    }];
+    [self prefetch:@"b"];
+
+    [self.prefetcher cancelPrefetchForKey:@"a"];
+    XCTAssertEqual(cancels, 1u);
+    XCTAssertEqualObjects(self.started, (@[@"b"]), @"the freed slot goes to the next card");
+}
+
+- (void)testLateDoneAfterWithdrawIsIgnored {
+    [self prefetch:@"a"];
+    [self prefetch:@"b"];
+    [self.prefetcher cancelPrefetchForKey:@"a"];
+    self.doneBlocks[@"a"]();
+    XCTAssertEqual(self.prefetcher.runningCount, 1u, @"b is still running");
+}
+
+- (void)testCancelAllStartsNothingQueued {
+    [self prefetch:@"a"];
+    [self prefetch:@"b"];
+    [self prefetch:@"c"];
+    [self.prefetcher cancelAll];
+    XCTAssertEqualObjects(self.started, (@[@"a"]));
+    XCTAssertEqual(self.prefetcher.runningCount, 0u);
+    XCTAssertEqual(self.prefetcher.pendingCount, 0u);
+}
+
+@end
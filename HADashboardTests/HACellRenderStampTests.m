@@ -0,0 +1,139 @@
+#import <XCTest/XCTest.h>
+#import "HACellRenderStamp.h"
+#import "HADashboardConfig.h"
+#import "HAEntity.h"
+#import "HAEntitiesCardCell.h"
+
+#pragma mark - Cell Render Stamp Tests
+
+@interface HACellRenderStampTests : XCTestCase
+@end
+
+@implementation HACellRenderStampTests
+
+- (HADashboardConfigItem *)itemWithName:(NSString *)name {
+    HADashboardConfigItem *item = [[HADashboardConfigItem alloc] init];
+    item.entityId = @"light.kitchen";
+    item.cardType = @"tile";
+    item.displayName = name;
+    item.columnSpan = 1;
+    item.rowSpan = 1;
+    return item;
+}
+
+- (HADashboardConfigSection *)sectionWithTitle:(NSString *)title {
+    HADashboardConfigSection *section = [[HADashboardConfigSection alloc] init];
+    section.title = title;
+    section.cardType = @"entities";
+    section.entityIds = @[@"light.kitchen"];
+    return section;
+}
+
+- (HAEntity *)entityWithId:(NSString *)entityId state:(NSString *)state {
+    return [[HAEntity alloc] initWithDictionary:@{@"entity_id": entityId, @"state": state, @"attributes": @{}}];
+}
+
+- (void)testSameInputsAreCurrent {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    HADashboardConfigSection *section = [self sectionWithTitle:@"Lights"];
+    NSDictionary *entities = @{@"light.kitchen": [self entityWithId:@"light.kitchen" state:@"on"]};
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:item section:section entities:entities];
+    XCTAssertTrue([stamp isCurrentForItem:item section:section entities:entities]);
+}
+
+- (void)testEntityUpdateMakesStale {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    HAEntity *light = [self entityWithId:@"light.kitchen" state:@"on"];
+    NSDictionary *entities = @{@"light.kitchen": light};
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:item section:nil entities:entities];
+
+    light.state = @"off";
+    XCTAssertFalse([stamp isCurrentForItem:item section:nil entities:entities]);
+}
+
+- (void)testRefreshWithSameValuesStaysCurrent {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    HAEntity *light = [self entityWithId:@"light.kitchen" state:@"on"];
+    NSDictionary *entities = @{@"light.kitchen": light};
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:item section:nil entities:entities];
+
+    [light updateWithDictionary:@{@"entity_id": @"light.kitchen", @"state": @"on", @"attributes": @{}}];
+    XCTAssertTrue([stamp isCurrentForItem:item section:nil entities:entities]);
+}
+
+- (void)testRecreatedEntityMakesStale {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:item section:nil
+                                                              entities:@{@"light.kitchen": [self entityWithId:@"light.kitchen" state:@"on"]}];
+    // Store cleared and refetched: a new object whose state has since changed
+    HAEntity *recreated = [self entityWithId:@"light.kitchen" state:@"off"];
+    XCTAssertFalse([stamp isCurrentForItem:item section:nil entities:@{@"light.kitchen": recreated}]);
+}
+
+- (void)testEntityAppearingOrDisappearingMakesStale {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    HACellRenderStamp *missing = [[HACellRenderStamp alloc] initWithItem:item section:nil entities:@{}];
+    NSDictionary *entities = @{@"light.kitchen": [self entityWithId:@"light.kitchen" state:@"on"]};
+    XCTAssertFalse([missing isCurrentForItem:item section:nil entities:entities]);
+
+    HACellRenderStamp *present = [[HACellRenderStamp alloc] initWithItem:item section:nil entities:entities];
+    XCTAssertFalse([present isCurrentForItem:item section:nil entities:@{}]);
+}
+
+- (void)testRebuiltItemWithSameContentIsCurrent {
+    HADashboardConfigSection *section = [self sectionWithTitle:@"Lights"];
+    NSDictionary *entities = @{@"light.kitchen": [self entityWithId:@"light.kitchen" state:@"on"]};
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:[self itemWithName:@"Kitchen"]
+                                                               section:section
+                                                              entities:entities];
+    XCTAssertTrue([stamp isCurrentForItem:[self itemWithName:@"Kitchen"]
+                                  section:[self sectionWithTitle:@"Lights"]
+                                 entities:entities]);
+}
+
+- (void)testContentChangeMakesStale {
+    NSDictionary *entities = @{@"light.kitchen": [self entityWithId:@"light.kitchen" state:@"on"]};
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:[self itemWithName:@"Kitchen"]
+                                                               section:nil
+                                                              entities:entities];
+    XCTAssertFalse([stamp isCurrentForItem:[self itemWithName:@"Kitchen Lights"] section:nil entities:entities]);
+}
+
+- (void)testSectionHeaderChangeMakesStale {
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    NSDictionary *entities = @{@"light.kitchen": [self entityWithId:@"light.kitchen" state:@"on"]};
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:item
+                                                               section:[self sectionWithTitle:@"Lights"]
+                                                              entities:entities];
+    XCTAssertFalse([stamp isCurrentForItem:item section:[self sectionWithTitle:@"Downstairs"] entities:entities]);
+    XCTAssertFalse([stamp isCurrentForItem:item section:nil entities:entities]);
+}
+
+- (void)testConditionalRowEntitiesAreTracked {
+    HADashboardConfigSection *section = [self sectionWithTitle:@"Lights"];
+    section.customProperties = @{@"orderedRows": @[
+        @{@"entity": @"light.kitchen"},
+        @{@"row_type": @"conditional",
+          @"conditions": @[@{@"entity": @"input_boolean.guest_mode", @"state": @"on"}],
+          @"row": @{@"entity": @"light.guest_room"}},
+        @{@"row_type": @"buttons", @"entities": @[@"scene.movie", @{@"entity": @"script.bedtime", @"name": @"Bed"}]},
+    ]};
+    NSArray<NSString *> *rowIds = [HAEntitiesCardCell orderedRowEntityIdsForSection:section];
+    XCTAssertEqualObjects(rowIds, (@[@"input_boolean.guest_mode", @"light.guest_room", @"scene.movie", @"script.bedtime"]));
+
+    // The card read the condition entity, so flipping it makes the card stale
+    HADashboardConfigItem *item = [self itemWithName:@"Kitchen"];
+    HAEntity *guestMode = [self entityWithId:@"input_boolean.guest_mode" state:@"off"];
+    NSDictionary *entities = @{@"light.kitchen": [self entityWithId:@"light.kitchen" state:@"on"],
+                               @"input_boolean.guest_mode": guestMode};
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:item section:section entities:entities];
+    guestMode.state = @"on";
+    XCTAssertFalse([stamp isCurrentForItem:item section:section entities:entities]);
+}
+
+- (void)testNilItemIsNeverCurrent {
+    HACellRenderStamp *stamp = [[HACellRenderStamp alloc] initWithItem:nil section:nil entities:@{}];
+    XCTAssertFalse([stamp isCurrentForItem:nil section:nil entities:@{}]);
+}
+
+@end
@@ -0,0 +1,130 @@
+#import <XCTest/XCTest.h>
+#import "HACellViewModel.h"
+#import "HADashboardConfig.h"
+#import "HAEntity.h"
+#import "HAEntityDisplayHelper.h"
+
+#pragma mark - Cell View Model Tests
+
+@interface HACellViewModelTests : XCTestCase
+@end
+
+@implementation HACellViewModelTests
+
+- (HADashboardConfigItem *)itemForEntityId:(NSString *)entityId cardType:(NSString *)cardType properties:(NSDictionary *)props {
+    HADashboardConfigItem *item = [[HADashboardConfigItem alloc] init];
+    item.entityId = entityId;
+    item.cardType = cardType;
+    item.customProperties = props ?: @{};
+    item.columnSpan = 1;
+    item.rowSpan = 1;
+    return item;
+}
+
+- (HAEntity *)entityWithId:(NSString *)entityId state:(NSString *)state attributes:(NSDictionary *)attributes {
+    return [[HAEntity alloc] initWithDictionary:@{@"entity_id": entityId, @"state": state, @"attributes": attributes ?: @{}}];
+}
+
+- (void)testLightShowsBrightness {
+    HAEntity *light = [self entityWithId:@"light.kitchen" state:@"on"
+                              attributes:@{@"friendly_name": @"Kitchen", @"brightness": @128}];
+    HADashboardConfigItem *item = [self itemForEntityId:@"light.kitchen" cardType:@"tile" properties:nil];
+    HACellViewModel *vm = [HACellViewModel tileViewModelForEntity:light configItem:item];
+    XCTAssertEqualObjects(vm.name, @"Kitchen");
+    XCTAssertEqualObjects(vm.stateText, @"50%");
+    XCTAssertTrue(vm.showsState);
+    XCTAssertEqual(vm.contentAlpha, 1.0);
+}
+
+- (void)testSensorAppendsUnit {
+    HAEntity *sensor = [self entityWithId:@"sensor.temp" state:@"21.5"
+                               attributes:@{@"unit_of_measurement": @"°C"}];
+    HADashboardConfigItem *item = [self itemForEntityId:@"sensor.temp" cardType:@"tile" properties:nil];
+    HACellViewModel *vm = [HACellViewModel tileViewModelForEntity:sensor configItem:item];
+    XCTAssertTrue([vm.stateText hasSuffix:@" °C"]);
+}
+
+- (void)testButtonCardHidesStateByDefault {
+    HAEntity *script = [self entityWithId:@"script.goodnight" state:@"off" attributes:nil];
+    HADashboardConfigItem *item = [self itemForEntityId:@"script.goodnight" cardType:@"button" properties:nil];
+    HACellViewModel *vm = [HACellViewModel tileViewModelForEntity:script configItem:item];
+    XCTAssertFalse(vm.showsState);
+    XCTAssertNil(vm.stateText);
+    XCTAssertTrue(vm.showsName);
+    XCTAssertTrue(vm.showsIcon);
+}
+
+- (void)testEntityPictureOnlyWhenConfigured {
+    HAEntity *person = [self entityWithId:@"person.sam" state:@"home"
+                               attributes:@{@"entity_picture": @"/api/image/sam.jpg"}];
+    HADashboardConfigItem *plain = [self itemForEntityId:@"person.sam" cardType:@"tile" properties:nil];
+    XCTAssertNil([HACellViewModel tileViewModelForEntity:person configItem:plain].entityPicturePath);
+
+    HADashboardConfigItem *picture = [self itemForEntityId:@"person.sam" cardType:@"tile"
+                                                properties:@{@"show_entity_picture": @YES}];
+    XCTAssertEqualObjects([HACellViewModel tileViewModelForEntity:person configItem:picture].entityPicturePath,
+                          @"/api/image/sam.jpg");
+}
+
+- (void)testUnavailableAndMissingEntitiesAreDimmed {
+    HADashboardConfigItem *item = [self itemForEntityId:@"switch.fan" cardType:@"tile" properties:nil];
+    HAEntity *unavailable = [self entityWithId:@"switch.fan" state:@"unavailable" attributes:nil];
+    XCTAssertEqual([HACellViewModel tileViewModelForEntity:unavailable configItem:item].contentAlpha, 0.5);
+    XCTAssertEqual([HACellViewModel tileViewModelForEntity:nil configItem:item].contentAlpha, 0.5);
+}
+
+- (void)testSameInputsGiveEqualViewModels {
+    HADashboardConfigItem *item = [self itemForEntityId:@"light.kitchen" cardType:@"tile" properties:nil];
+    HAEntity *light = [self entityWithId:@"light.kitchen" state:@"on" attributes:@{@"brightness": @255}];
+    HACellViewModel *a = [HACellViewModel tileViewModelForEntity:light configItem:item];
+    HACellViewModel *b = [HACellViewModel tileViewModelForEntity:[light copy] configItem:item];
+    XCTAssertTrue([a isEqualToViewModel:b]);
+
+    light.state = @"off";
+    HACellViewModel *c = [HACellViewModel tileViewModelForEntity:light configItem:item];
+    XCTAssertFalse([a isEqualToViewModel:c]);
+}
+
+- (void)testEntityCopyIsAnIndependentSnapshot {
+    HAEntity *light = [self entityWithId:@"light.kitchen" state:@"on" attributes:@{@"brightness": @255}];
+    HAEntity *snapshot = [light copy];
+    XCTAssertEqual(snapshot.version, light.version);
+
+    light.state = @"off";
+    XCTAssertEqualObjects(snapshot.state, @"on");
+    XCTAssertNotEqual(snapshot.version, light.version);
+}
+
+- (void)testBuildsOffMainThread {
+    HADashboardConfigItem *item = [self itemForEntityId:@"light.kitchen" cardType:@"tile" properties:nil];
+    HAEntity *snapshot = [[self entityWithId:@"light.kitchen" state:@"on" attributes:@{@"brightness": @128}] copy];
+    XCTestExpectation *built = [self expectationWithDescription:@"built"];
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        HACellViewModel *vm = [HACellViewModel tileViewModelForEntity:snapshot configItem:item];
+        XCTAssertEqualObjects(vm.stateText, @"50%");
+        [built fulfill];
+    });
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+
+- (void)testNumberFormattingWhileMainFormatsToo {
+    HADashboardConfigItem *item = [self itemForEntityId:@"sensor.energy" cardType:@"tile" properties:nil];
+    HAEntity *snapshot = [[self entityWithId:@"sensor.energy" state:@"12.25" attributes:@{}] copy];
+    XCTestExpectation *built = [self expectationWithDescription:@"built"];
+    __block BOOL stable = YES;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^{
+        for (NSUInteger i = 0; i < 500; i++) {
+            HACellViewModel *vm = [HACellViewModel tileViewModelForEntity:snapshot configItem:item];
+            if (![vm.stateText isEqualToString:@"12.25"]) stable = NO;
+        }
+        [built fulfill];
+    });
+    // Main keeps changing the digit limits meanwhile
+    for (NSUInteger i = 0; i < 500; i++) {
+        XCTAssertEqualObjects([HAEntityDisplayHelper formattedNumberString:12.25 decimals:0], @"12");
+    }
+    [self waitForExpectationsWithTimeout:5.0 handler:nil];
+    XCTAssertTrue(stable);
+}
+@end
@@ -0,0 +1,86 @@
+#import <XCTest/XCTest.h>
+#import "HACellWarmer.h"
+
+#pragma mark - Cell Warmer Tests
+
+@interface HACellWarmerTests : XCTestCase
+@property (nonatomic, strong) HACellWarmer *warmer;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *ran;
+@end
+
+@implementation HACellWarmerTests
+
+- (void)setUp {
+    [super setUp];
+    self.warmer = [[HACellWarmer alloc] init];
+    self.ran = [NSMutableArray array];
+}
+
+- (void)tearDown {
+    [self.warmer stop];
+    self.warmer = nil;
+    [super tearDown];
+}
+
+- (void)enqueue:(NSUInteger)count {
+    for (NSUInteger i = 0; i < count; i++) {
+        NSUInteger n = self.ran.count + self.warmer.pendingCount;
+        [self.warmer enqueueTask:^{ [self.ran addObject:@(n)]; }];
+    }
+}
+
+- (void)testRunsInOrder {
+    [self enqueue:3];
+    self.warmer.passBudget = 1.0;
+    [self.warmer runPass];
+    XCTAssertEqualObjects(self.ran, (@[@0, @1, @2]));
+    XCTAssertEqual(self.warmer.pendingCount, 0u);
+}
+
+- (void)testSpentBudgetStillRunsOneTaskPerPass {
+    self.warmer.passBudget = 0;
+    [self enqueue:3];
+    [self.warmer runPass];
+    XCTAssertEqual(self.ran.count, 1u);
+    [self.warmer runPass];
+    XCTAssertEqual(self.ran.count, 2u);
+    XCTAssertEqual(self.warmer.pendingCount, 1u);
+}
+
+- (void)testTaskMayEnqueueMore {
+    self.warmer.passBudget = 0;
+    [self.warmer enqueueTask:^{
+        [self.warmer enqueueTask:^{ [self.ran addObject:@1]; }];
+    }];
+    [self.warmer runPass];
+    XCTAssertEqual(self.warmer.pendingCount, 1u);
+    [self.warmer runPass];
+    XCTAssertEqualObjects(self.ran, (@[@1]));
+}
+
+- (void)testStopDropsQueuedTasks {
+    [self enqueue:3];
+    [self.warmer stop];
+    [self.warmer runPass];
+    XCTAssertEqual(self.ran.count, 0u);
+}
+
+- (void)testTaskCanStopTheRest {
+    self.warmer.passBudget = 1.0;
+    [self.warmer enqueueTask:^{ [self.warmer stop]; }];
+    [self enqueue:2];
+    [self.warmer runPass];
+    XCTAssertEqual(self.ran.count, 0u);
+}
+
+- (void)testDrainsInIdleTime {
+    self.warmer.passBudget = 0;
+    [self enqueue:5];
+    XCTestExpectation *drained = [self expectationWithDescription:@"drained"];
+    [self.warmer enqueueTask:^{ [drained fulfill]; }];
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqual(self.ran.count, 5u);
+    XCTAssertEqual(self.warmer.pendingCount, 0u);
+}
+
+@end
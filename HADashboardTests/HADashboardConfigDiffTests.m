@@ -0,0 +1,188 @@
+#import <XCTest/XCTest.h>
+#import "HADashboardConfig.h"
+#import "HADashboardConfigDiff.h"
+
+#pragma mark - Dashboard Config Diff Tests
+
+@interface HADashboardConfigDiffTests : XCTestCase
+@end
+
+@implementation HADashboardConfigDiffTests
+
+- (HADashboardConfigItem *)item:(NSString *)entityId {
+    HADashboardConfigItem *item = [[HADashboardConfigItem alloc] init];
+    item.entityId = entityId;
+    item.cardType = @"tile";
+    item.columnSpan = 1;
+    item.rowSpan = 1;
+    return item;
+}
+
+- (HADashboardConfigSection *)section:(NSString *)title items:(NSArray<NSString *> *)entityIds {
+    HADashboardConfigSection *section = [[HADashboardConfigSection alloc] init];
+    section.title = title;
+    NSMutableArray *items = [NSMutableArray array];
+    for (NSString *eid in entityIds) [items addObject:[self item:eid]];
+    section.items = items;
+    return section;
+}
+
+- (HADashboardConfig *)config:(NSArray<HADashboardConfigSection *> *)sections {
+    HADashboardConfig *config = [[HADashboardConfig alloc] init];
+    config.sections = sections;
+    return config;
+}
+
+/// Replays the diff on the old identities the way UICollectionView does and
+/// checks the result is the new config.
+- (void)assertDiff:(HADashboardConfigDiff *)diff transforms:(HADashboardConfig *)oldConfig into:(HADashboardConfig *)newConfig {
+    NSMutableArray<NSMutableArray *> *result = [NSMutableArray array];
+    for (NSUInteger ns = 0; ns < newConfig.sections.count; ns++) {
+        NSMutableArray *items = [NSMutableArray array];
+        if ([diff.insertedSections containsIndex:ns]) {
+            for (HADashboardConfigItem *item in newConfig.sections[ns].items) [items addObject:item.entityId];
+        }
+        [result addObject:items];
+    }
+    // Old sections kept, in order, map onto the new sections not inserted
+    NSMutableArray<NSNumber *> *keptOld = [NSMutableArray array];
+    for (NSUInteger os = 0; os < oldConfig.sections.count; os++) {
+        if (![diff.deletedSections containsIndex:os]) [keptOld addObject:@(os)];
+    }
+    NSMutableArray<NSNumber *> *keptNew = [NSMutableArray array];
+    for (NSUInteger ns = 0; ns < newConfig.sections.count; ns++) {
+        if (![diff.insertedSections containsIndex:ns]) [keptNew addObject:@(ns)];
+    }
+    XCTAssertEqual(keptOld.count, keptNew.count);
+
+    for (NSUInteger k = 0; k < keptOld.count; k++) {
+        NSUInteger os = keptOld[k].unsignedIntegerValue, ns = keptNew[k].unsignedIntegerValue;
+        NSArray<HADashboardConfigItem *> *oldItems = oldConfig.sections[os].items;
+        NSArray<HADashboardConfigItem *> *newItems = newConfig.sections[ns].items;
+        NSMutableArray *slots = [NSMutableArray arrayWithCapacity:newItems.count];
+        for (NSUInteger j = 0; j < newItems.count; j++) [slots addObject:[NSNull null]];
+
+        NSMutableIndexSet *gone = [NSMutableIndexSet indexSet];
+        for (NSIndexPath *ip in diff.deletedItems) if (ip.section == (NSInteger)os) [gone addIndex:ip.item];
+        for (NSArray<NSIndexPath *> *move in diff.movedItems) {
+            if (move[0].section != (NSInteger)os) continue;
+            XCTAssertEqual(move[1].section, (NSInteger)ns);
+            slots[move[1].item] = oldItems[move[0].item].entityId;
+            [gone addIndex:move[0].item];
+        }
+        for (NSIndexPath *ip in diff.insertedItems) {
+            if (ip.section == (NSInteger)ns) slots[ip.item] = newItems[ip.item].entityId;
+        }
+        // Items neither deleted nor moved keep their relative order
+        NSUInteger next = 0;
+        for (NSUInteger i = 0; i < oldItems.count; i++) {
+            if ([gone containsIndex:i]) continue;
+            while (next < slots.count && slots[next] != [NSNull null]) next++;
+            XCTAssertLessThan(next, slots.count);
+            if (next < slots.count) slots[next] = oldItems[i].entityId;
+        }
+        result[ns] = slots;
+    }
+
+    for (NSUInteger ns = 0; ns < newConfig.sections.count; ns++) {
+        NSMutableArray *expected = [NSMutableArray array];
+        for (HADashboardConfigItem *item in newConfig.sections[ns].items) [expected addObject:item.entityId];
+        XCTAssertEqualObjects(result[ns], expected, @"section %lu", (unsigned long)ns);
+    }
+}
+
+- (void)testIdenticalReparseHasNoChanges {
+    HADashboardConfig *a = [self config:@[[self section:@"Lights" items:@[@"light.a", @"light.b"]]]];
+    HADashboardConfig *b = [self config:@[[self section:@"Lights" items:@[@"light.a", @"light.b"]]]];
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertNotNil(diff);
+    XCTAssertFalse(diff.hasStructuralChanges);
+    XCTAssertEqual(diff.updatedItems.count, 0u);
+}
+
+- (void)testInsertDeleteAndMove {
+    HADashboardConfig *a = [self config:@[[self section:nil items:@[@"a", @"b", @"c", @"d", @"e"]]]];
+    HADashboardConfig *b = [self config:@[[self section:nil items:@[@"e", @"a", @"c", @"x", @"d"]]]];
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertEqualObjects(diff.deletedItems, @[[NSIndexPath indexPathForItem:1 inSection:0]]);
+    XCTAssertEqualObjects(diff.insertedItems, @[[NSIndexPath indexPathForItem:3 inSection:0]]);
+    XCTAssertEqual(diff.movedItems.count, 1u, @"Only e moves; a, c, d stay in order");
+    [self assertDiff:diff transforms:a into:b];
+}
+
+- (void)testReversalMovesAllButOne {
+    HADashboardConfig *a = [self config:@[[self section:nil items:@[@"a", @"b", @"c", @"d"]]]];
+    HADashboardConfig *b = [self config:@[[self section:nil items:@[@"d", @"c", @"b", @"a"]]]];
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertEqual(diff.movedItems.count, 3u);
+    [self assertDiff:diff transforms:a into:b];
+}
+
+- (void)testDuplicateCardsAreMatchedInOrder {
+    HADashboardConfig *a = [self config:@[[self section:nil items:@[@"a", @"a", @"b"]]]];
+    HADashboardConfig *b = [self config:@[[self section:nil items:@[@"a", @"b", @"a", @"a"]]]];
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertEqual(diff.deletedItems.count, 0u);
+    XCTAssertEqual(diff.insertedItems.count, 1u);
+    [self assertDiff:diff transforms:a into:b];
+}
+
+- (void)testContentChangeIsUpdateNotReinsert {
+    HADashboardConfig *a = [self config:@[[self section:nil items:@[@"a", @"b"]]]];
+    HADashboardConfig *b = [self config:@[[self section:nil items:@[@"a", @"b"]]]];
+    b.sections[0].items[1].displayName = @"Renamed";
+    b.sections[0].items[1].customProperties = @{@"color": @"red"};
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertFalse(diff.hasStructuralChanges);
+    XCTAssertEqualObjects(diff.updatedItems, @[[NSIndexPath indexPathForItem:1 inSection:0]]);
+}
+
+- (void)testMovedAndChangedIsReportedAtNewPath {
+    HADashboardConfig *a = [self config:@[[self section:nil items:@[@"a", @"b", @"c"]]]];
+    HADashboardConfig *b = [self config:@[[self section:nil items:@[@"c", @"a", @"b"]]]];
+    b.sections[0].items[0].rowSpan = 3;
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertEqualObjects(diff.updatedItems, @[[NSIndexPath indexPathForItem:0 inSection:0]]);
+    [self assertDiff:diff transforms:a into:b];
+}
+
+- (void)testSectionInsertAndDelete {
+    HADashboardConfig *a = [self config:@[[self section:@"One" items:@[@"a"]],
+                                          [self section:@"Two" items:@[@"b"]],
+                                          [self section:@"Three" items:@[@"c"]]]];
+    HADashboardConfig *b = [self config:@[[self section:@"One" items:@[@"a", @"z"]],
+                                          [self section:@"New" items:@[@"n"]],
+                                          [self section:@"Three" items:@[@"c"]]]];
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertEqualObjects(diff.deletedSections, [NSIndexSet indexSetWithIndex:1]);
+    XCTAssertEqualObjects(diff.insertedSections, [NSIndexSet indexSetWithIndex:1]);
+    XCTAssertEqualObjects(diff.insertedItems, @[[NSIndexPath indexPathForItem:1 inSection:0]]);
+    [self assertDiff:diff transforms:a into:b];
+}
+
+- (void)testSectionHeaderChangeReplacesSection {
+    HADashboardConfig *a = [self config:@[[self section:@"One" items:@[@"a"]]]];
+    HADashboardConfig *b = [self config:@[[self section:@"One" items:@[@"a"]]]];
+    b.sections[0].icon = @"mdi:sofa";
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:a toConfig:b];
+    XCTAssertEqualObjects(diff.deletedSections, [NSIndexSet indexSetWithIndex:0]);
+    XCTAssertEqualObjects(diff.insertedSections, [NSIndexSet indexSetWithIndex:0]);
+}
+
+- (void)testReorderedSectionsNeedReload {
+    HADashboardConfig *a = [self config:@[[self section:@"One" items:@[@"a"]], [self section:@"Two" items:@[@"b"]]]];
+    HADashboardConfig *b = [self config:@[[self section:@"Two" items:@[@"b"]], [self section:@"One" items:@[@"a"]]]];
+    XCTAssertNil([HADashboardConfigDiff diffFromConfig:a toConfig:b]);
+}
+
+- (void)testFlattenedSectionBackReferenceDoesNotRecurse {
+    HADashboardConfigSection *flat = [self section:nil items:@[@"a"]];
+    flat.items[0].entitiesSection = flat;
+    HADashboardConfigSection *flat2 = [self section:nil items:@[@"a"]];
+    flat2.items[0].entitiesSection = flat2;
+    HADashboardConfigDiff *diff = [HADashboardConfigDiff diffFromConfig:[self config:@[flat]] toConfig:[self config:@[flat2]]];
+    XCTAssertFalse(diff.hasStructuralChanges);
+    XCTAssertEqual(diff.updatedItems.count, 0u);
+}
+
+@end
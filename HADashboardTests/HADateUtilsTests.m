@@ -0,0 +1,179 @@
+#import <XCTest/XCTest.h>
+#import "HADateUtils.h"
+
+#pragma mark - HADateUtils Test Access
+
+@interface HADateUtils (TestAccess)
++ (NSDate *)formatterDateFromISO8601String:(NSString *)string;
+@end
+
+/// Parse via the C fast path only (no formatter fallback).
+static BOOL HATestFastParse(NSString *string, NSTimeInterval *outEpoch) {
+    const char *utf8 = string.UTF8String;
+    return HAParseISO8601Epoch(utf8, strlen(utf8), outEpoch);
+}
+
+@interface HADateUtilsTests : XCTestCase
+@end
+
+@implementation HADateUtilsTests
+
+#pragma mark - Fast Path Shapes
+
+- (void)testUTCWithoutFraction {
+    NSTimeInterval epoch = 0;
+    XCTAssertTrue(HATestFastParse(@"2024-01-15T10:30:00+00:00", &epoch));
+    XCTAssertEqualWithAccuracy(epoch, 1705314600.0, 0.0001);
+}
+
+- (void)testZuluSuffix {
+    NSTimeInterval epoch = 0;
+    XCTAssertTrue(HATestFastParse(@"2024-01-15T10:30:00Z", &epoch));
+    XCTAssertEqualWithAccuracy(epoch, 1705314600.0, 0.0001);
+}
+
+- (void)testMicrosecondFraction {
+    NSTimeInterval epoch = 0;
+    XCTAssertTrue(HATestFastParse(@"2024-01-15T10:30:00.123456+00:00", &epoch));
+    XCTAssertEqualWithAccuracy(epoch, 1705314600.123456, 0.000001);
+}
+
+- (void)testAllFractionLengths {
+    NSArray *fractions = @[@".1", @".12", @".123", @".1234", @".12345", @".123456"];
+    NSArray *expected = @[@0.1, @0.12, @0.123, @0.1234, @0.12345, @0.123456];
+    for (NSUInteger i = 0; i < fractions.count; i++) {
+        NSString *s = [NSString stringWithFormat:@"1970-01-01T00:00:00%@Z", fractions[i]];
+        NSTimeInterval epoch = 0;
+        XCTAssertTrue(HATestFastParse(s, &epoch), @"Should parse %@", s);
+        XCTAssertEqualWithAccuracy(epoch, [expected[i] doubleValue], 0.000001, @"%@", s);
+    }
+}
+
+- (void)testPositiveAndNegativeOffsets {
+    NSTimeInterval plus = 0, minus = 0, compact = 0;
+    XCTAssertTrue(HATestFastParse(@"2024-01-15T16:00:00+05:30", &plus));
+    XCTAssertTrue(HATestFastParse(@"2024-01-15T01:00:00-09:30", &minus));
+    XCTAssertTrue(HATestFastParse(@"2024-01-15T16:00:00+0530", &compact));
+    XCTAssertEqualWithAccuracy(plus, 1705314600.0, 0.0001);
+    XCTAssertEqualWithAccuracy(minus, 1705314600.0, 0.0001);
+    XCTAssertEqualWithAccuracy(compact, plus, 0.0001);
+}
+
+- (void)testLeapDay {
+    NSTimeInterval epoch = 0;
+    XCTAssertTrue(HATestFastParse(@"2024-02-29T00:00:00Z", &epoch));
+    XCTAssertEqualWithAccuracy(epoch, 1709164800.0, 0.0001);
+    XCTAssertFalse(HATestFastParse(@"2023-02-29T00:00:00Z", &epoch));
+}
+
+- (void)testRejectsMalformedInput {
+    NSArray *bad = @[
+        @"", @"garbage", @"2024-01-15", @"2024-01-15T10:30:00",
+        @"2024-13-01T00:00:00Z", @"2024-04-31T00:00:00Z", @"2024-01-15T24:00:00Z",
+        @"2024-01-15T10:60:00Z", @"2024-01-15 10:30:00Z", @"2024-01-15T10:30:00.Z",
+        @"2024-01-15T10:30:00+5:30", @"2024-01-15T10:30:00+05:30x", @"2024-01-15T10:30:00Zx",
+    ];
+    for (NSString *s in bad) {
+        NSTimeInterval epoch = 0;
+        XCTAssertFalse(HATestFastParse(s, &epoch), @"Should reject '%@'", s);
+    }
+}
+
+- (void)testNoTimezoneStillParsesViaFallback {
+    NSDate *date = [HADateUtils dateFromISO8601String:@"2024-01-15T10:30:00"];
+    XCTAssertNotNil(date, @"No-timezone strings should fall back to the formatter chain");
+    XCTAssertEqualObjects(date, [HADateUtils formatterDateFromISO8601String:@"2024-01-15T10:30:00"]);
+}
+
+- (void)testNilAndNonStringInput {
+    NSTimeInterval epoch = 0;
+    XCTAssertNil([HADateUtils dateFromISO8601String:nil]);
+    XCTAssertNil([HADateUtils dateFromISO8601String:(NSString *)@42]);
+    XCTAssertFalse([HADateUtils epochFromISO8601String:nil epoch:&epoch]);
+}
+
+#pragma mark - Equivalence With Formatter Chain
+
+/// Random timestamps in HA's shapes, formatted through NSDateFormatter in
+/// assorted timezones, must parse to the same instant as the formatter chain.
+- (void)testFuzzEquivalenceWithFormatterChain {
+    NSArray *formats = @[
+        @"yyyy-MM-dd'T'HH:mm:ssZZZZZ",
+        @"yyyy-MM-dd'T'HH:mm:ss.SSSZZZZZ",
+        @"yyyy-MM-dd'T'HH:mm:ss.SSSSSSZZZZZ",
+    ];
+    NSArray *zones = @[@0, @3600, @-18000, @19800, @-34200, @45900];
+    NSDateFormatter *fmt = [[NSDateFormatter alloc] init];
+    fmt.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+
+    srand48(26);
+    for (NSUInteger i = 0; i < 2000; i++) {
+        NSTimeInterval t = floor((drand48() * 2.0e9 + 1.0e8) * 1000.0) / 1000.0;
+        fmt.dateFormat = formats[i % formats.count];
+        fmt.timeZone = [NSTimeZone timeZoneForSecondsFromGMT:[zones[i % zones.count] integerValue]];
+        NSString *s = [fmt stringFromDate:[NSDate dateWithTimeIntervalSince1970:t]];
+
+        NSDate *reference = [HADateUtils formatterDateFromISO8601String:s];
+        NSTimeInterval fast = 0;
+        XCTAssertNotNil(reference, @"Formatter chain should parse %@", s);
+        XCTAssertTrue(HATestFastParse(s, &fast), @"Fast path should parse %@", s);
+        XCTAssertEqualWithAccuracy(fast, [reference timeIntervalSince1970], 0.001, @"Mismatch for %@", s);
+    }
+}
+
+- (void)testHistoryFixtureEquivalence {
+    NSArray *samples = @[
+        @"2024-06-01T00:00:00+00:00",
+        @"2024-06-01T12:34:56.789+00:00",
+        @"2024-06-01T12:34:56.789012+00:00",
+        @"2023-12-31T23:59:59.999999+00:00",
+        @"2024-03-10T02:30:00-05:00",
+        @"2024-10-27T01:30:00+01:00",
+    ];
+    for (NSString *s in samples) {
+        NSDate *reference = [HADateUtils formatterDateFromISO8601String:s];
+        NSDate *fast = [HADateUtils dateFromISO8601String:s];
+        XCTAssertNotNil(fast);
+        XCTAssertEqualWithAccuracy([fast timeIntervalSince1970], [reference timeIntervalSince1970], 0.001, @"%@", s);
+    }
+}
+
+#pragma mark - Benchmarks
+
+static NSArray<NSString *> *HATestTimestampCorpus(NSUInteger count) {
+    NSMutableArray *corpus = [NSMutableArray arrayWithCapacity:count];
+    for (NSUInteger i = 0; i < count; i++) {
+        // 30 s spacing with microsecond fractions, like a chatty sensor
+        NSUInteger secs = i * 30;
+        [corpus addObject:[NSString stringWithFormat:@"2024-06-%02luT%02lu:%02lu:%02lu.%06lu+00:00",
+            (unsigned long)(1 + secs / 86400 % 28), (unsigned long)(secs / 3600 % 24),
+            (unsigned long)(secs / 60 % 60), (unsigned long)(secs % 60), (unsigned long)(i * 7919 % 1000000)]];
+    }
+    return corpus;
+}
+
+- (void)testPerformanceFastPath {
+    NSArray *corpus = HATestTimestampCorpus(20000);
+    [self measureBlock:^{
+        NSTimeInterval sum = 0;
+        for (NSString *s in corpus) {
+            NSTimeInterval epoch = 0;
+            [HADateUtils epochFromISO8601String:s epoch:&epoch];
+            sum += epoch;
+        }
+        XCTAssertGreaterThan(sum, 0);
+    }];
+}
+
+- (void)testPerformanceFormatterChain {
+    NSArray *corpus = HATestTimestampCorpus(20000);
+    [self measureBlock:^{
+        NSTimeInterval sum = 0;
+        for (NSString *s in corpus) {
+            sum += [[HADateUtils formatterDateFromISO8601String:s] timeIntervalSince1970];
+        }
+        XCTAssertGreaterThan(sum, 0);
+    }];
+}
+
+@end
@@ -0,0 +1,220 @@
+#import <XCTest/XCTest.h>
+#import "HAGraphGeometry.h"
+
+/// Evenly spaced points over [start, end] with value = index.
+static NSArray<NSDictionary *> *HATestSeries(NSTimeInterval start, NSTimeInterval end, NSUInteger count) {
+    NSMutableArray *points = [NSMutableArray arrayWithCapacity:count];
+    double step = (end - start) / (double)(count - 1);
+    for (NSUInteger i = 0; i < count; i++) {
+        [points addObject:@{@"value": @(i), @"timestamp": @(start + i * step)}];
+    }
+    return points;
+}
+
+@interface HAGraphGeometryTests : XCTestCase
+@end
+
+@implementation HAGraphGeometryTests
+
+static const NSTimeInterval kStart = 1700000000;
+static const NSTimeInterval kHour = 3600;
+
+- (HAGraphGeometryInput *)inputWithSeries:(NSArray<NSArray<NSDictionary *> *> *)series {
+    HAGraphGeometryInput *input = [[HAGraphGeometryInput alloc] init];
+    input.seriesPoints = series;
+    NSMutableArray *groups = [NSMutableArray array];
+    for (NSUInteger i = 0; i < series.count; i++) [groups addObject:@0];
+    input.seriesGroups = groups;
+    input.groupUnits = @[@""];
+    input.fillSeries = 0;
+    input.size = CGSizeMake(300, 120);
+    input.leftPadding = 30;
+    input.bottomPadding = 18;
+    input.minTime = kStart;
+    input.maxTime = kStart + kHour;
+    input.axisLabels = YES;
+    return input;
+}
+
+#pragma mark - Paths
+
+- (void)testLinePathSpansDrawingArea {
+    HAGraphGeometry *g = [HAGraphGeometry geometryWithInput:[self inputWithSeries:@[HATestSeries(kStart, kStart + kHour, 10)]]];
+    CGPathRef line = [g linePathAtIndex:0];
+    XCTAssertTrue(line != NULL);
+    CGRect box = CGPathGetBoundingBox(line);
+    XCTAssertEqualWithAccuracy(CGRectGetMinX(box), 30.0, 0.01);
+    XCTAssertEqualWithAccuracy(CGRectGetMaxX(box), 300.0, 0.01);
+    // 10% Y padding keeps the line off the top and bottom edges
+    XCTAssertGreaterThan(CGRectGetMinY(box), 2.0);
+    XCTAssertLessThan(CGRectGetMaxY(box), 120.0 - 18.0 - 2.0);
+    XCTAssertTrue(g.fillPath != NULL);
+    XCTAssertTrue([g bandPathAtIndex:0] == NULL, @"No min/max, no band");
+}
+
+- (void)testTooFewPointsDrawNothing {
+    HAGraphGeometry *g = [HAGraphGeometry geometryWithInput:[self inputWithSeries:@[@[@{@"value": @1, @"timestamp": @(kStart)}]]]];
+    XCTAssertTrue([g linePathAtIndex:0] == NULL);
+    XCTAssertTrue(g.fillPath == NULL);
+    XCTAssertEqual(g.valueTicks.count, 0u);
+    XCTAssertEqual(g.timeTicks.count, 0u);
+}
+
+- (void)testBandWidensRange {
+    NSArray *points = @[
+        @{@"value": @10, @"min": @0, @"max": @20, @"timestamp": @(kStart)},
+        @{@"value": @10, @"min": @5, @"max": @15, @"timestamp": @(kStart + kHour)},
+    ];
+    HAGraphGeometry *g = [HAGraphGeometry geometryWithInput:[self inputWithSeries:@[points]]];
+    XCTAssertTrue([g bandPathAtIndex:0] != NULL);
+    XCTAssertEqualWithAccuracy([g.groupMins[0] doubleValue], -2.0, 0.0001);
+    XCTAssertEqualWithAccuracy([g.groupMaxes[0] doubleValue], 22.0, 0.0001);
+}
+
+#pragma mark - Axis Groups
+
+- (void)testGroupsScaleIndependently {
+    HAGraphGeometryInput *input = [self inputWithSeries:@[HATestSeries(kStart, kStart + kHour, 11),
+                                                          HATestSeries(kStart, kStart + kHour, 101)]];
+    input.seriesGroups = @[@0, @1];
+    input.groupUnits = @[@"°C", @"%"];
+    input.rightPadding = 35;
+    HAGraphGeometry *g = [HAGraphGeometry geometryWithInput:input];
+    XCTAssertEqualWithAccuracy([g.groupMaxes[0] doubleValue], 11.0, 0.0001);
+    XCTAssertEqualWithAccuracy([g.groupMaxes[1] doubleValue], 110.0, 0.0001);
+    // 5 values + unit per group
+    XCTAssertEqual(g.valueTicks.count, 12u);
+    XCTAssertTrue(g.valueTicks[0].isUnit);
+    XCTAssertEqualObjects(g.valueTicks[6].text, @"%");
+    XCTAssertEqual(g.valueTicks[7].alignment, NSTextAlignmentLeft);
+    XCTAssertEqualWithAccuracy(CGRectGetMinX(g.valueTicks[7].frame), 265.0, 0.01);
+}
+
+- (void)testHiddenSeriesOnlyFillsWhenChosen {
+    HAGraphGeometryInput *input = [self inputWithSeries:@[@[], HATestSeries(kStart, kStart + kHour, 10)]];
+    input.fillSeries = 1;
+    HAGraphGeometry *g = [HAGraphGeometry geometryWithInput:input];
+    XCTAssertTrue([g linePathAtIndex:0] == NULL);
+    XCTAssertTrue([g linePathAtIndex:1] != NULL);
+    XCTAssertTrue(g.fillPath != NULL);
+
+    input.fillSeries = -1;
+    XCTAssertTrue([HAGraphGeometry geometryWithInput:input].fillPath == NULL);
+}
+
+#pragma mark - Ticks
+
+- (void)testTimeTicksStayInView {
+    NSArray<HAGraphAxisTick *> *ticks = [HAGraphGeometry timeTicksForMinTime:kStart maxTime:kStart + kHour
+                                                                       areaX:30 areaWidth:270
+                                                                   baselineY:102 viewWidth:300];
+    XCTAssertEqual(ticks.count, 5u);
+    for (HAGraphAxisTick *tick in ticks) {
+        XCTAssertGreaterThanOrEqual(CGRectGetMinX(tick.frame), 0.0);
+        XCTAssertLessThanOrEqual(CGRectGetMaxX(tick.frame), 300.0);
+        XCTAssertEqualWithAccuracy(CGRectGetMinY(tick.frame), 104.0, 0.01);
+    }
+    // Narrow area and multi-day range thin the labels
+    XCTAssertEqual([HAGraphGeometry timeTicksForMinTime:kStart maxTime:kStart + kHour
+                                                  areaX:0 areaWidth:120 baselineY:0 viewWidth:120].count, 3u);
+    XCTAssertEqual([HAGraphGeometry timeTicksForMinTime:kStart maxTime:kStart + 3 * 86400
+                                                  areaX:0 areaWidth:300 baselineY:0 viewWidth:300].count, 4u);
+    XCTAssertEqual([HAGraphGeometry timeTicksForMinTime:kStart maxTime:kStart
+                                                  areaX:0 areaWidth:300 baselineY:0 viewWidth:300].count, 0u);
+}
+
+#pragma mark - Timeline Compaction
+
+static NSDictionary *HATestSegment(NSString *state, NSTimeInterval start, NSTimeInterval end) {
+    return @{@"state": state, @"start": @(start), @"end": @(end)};
+}
+
+- (void)testAdjacentIdenticalStatesMerge {
+    NSArray *segments = @[HATestSegment(@"on", kStart, kStart + 600),
+                          HATestSegment(@"on", kStart + 600, kStart + 1800),
+                          HATestSegment(@"off", kStart + 1800, kStart + kHour)];
+    NSArray<HAGraphTimelineRun *> *runs = [HAGraphGeometry timelineRunsForSegments:segments minTime:kStart maxTime:kStart + kHour
+                                                                         areaWidth:300 pixelScale:2];
+    XCTAssertEqual(runs.count, 2u);
+    XCTAssertEqualObjects(runs[0].state, @"on");
+    XCTAssertEqualWithAccuracy(runs[0].width, 150.0, 0.01);
+    XCTAssertEqualWithAccuracy(runs[1].x, 150.0, 0.01);
+}
+
+- (void)testFlappingCollapsesToMixedAndIsBounded {
+    // 24 h of a sensor toggling every 5 s: 17,280 segments across 300 pt
+    NSMutableArray *segments = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 17280; i++) {
+        [segments addObject:HATestSegment((i % 2) ? @"on" : @"off", kStart + i * 5, kStart + (i + 1) * 5)];
+    }
+    NSArray<HAGraphTimelineRun *> *runs = [HAGraphGeometry timelineRunsForSegments:segments minTime:kStart maxTime:kStart + 86400
+                                                                         areaWidth:300 pixelScale:2];
+    XCTAssertLessThanOrEqual(runs.count, 600u * 2);
+    XCTAssertEqual(runs.count, 1u, @"Every pixel is mixed, so it is all one run");
+    XCTAssertNil(runs[0].state);
+    XCTAssertEqualWithAccuracy(runs[0].width, 300.0, 0.01);
+}
+
+- (void)testBlipStaysVisibleWithoutOverlap {
+    NSArray *segments = @[HATestSegment(@"off", kStart, kStart + 43200),
+                          HATestSegment(@"on", kStart + 43200, kStart + 43201),
+                          HATestSegment(@"off", kStart + 43201, kStart + 86400)];
+    NSArray<HAGraphTimelineRun *> *runs = [HAGraphGeometry timelineRunsForSegments:segments minTime:kStart maxTime:kStart + 86400
+                                                                         areaWidth:300 pixelScale:2];
+    XCTAssertEqual(runs.count, 3u);
+    XCTAssertEqualObjects(runs[1].state, @"on");
+    XCTAssertEqualWithAccuracy(runs[1].width, 0.5, 0.01, @"Widened to one pixel");
+    for (NSUInteger i = 1; i < runs.count; i++) {
+        XCTAssertGreaterThanOrEqual(runs[i].x, runs[i - 1].x + runs[i - 1].width - 0.001);
+    }
+}
+
+#pragma mark - Cache Key
+
+- (void)testCacheKeyTracksInputs {
+    HAGraphGeometryInput *a = [self inputWithSeries:@[HATestSeries(kStart, kStart + kHour, 10), HATestSeries(kStart, kStart + kHour, 10)]];
+    HAGraphGeometryInput *b = [self inputWithSeries:@[HATestSeries(kStart, kStart + kHour, 10), HATestSeries(kStart, kStart + kHour, 10)]];
+    XCTAssertEqualObjects([a cacheKey], [b cacheKey]);
+
+    b.seriesPoints = @[HATestSeries(kStart, kStart + kHour, 10), @[]];
+    XCTAssertNotEqualObjects([a cacheKey], [b cacheKey], @"Legend toggle");
+    b = [self inputWithSeries:a.seriesPoints];
+    b.generation = 1;
+    XCTAssertNotEqualObjects([a cacheKey], [b cacheKey], @"New data");
+    b = [self inputWithSeries:a.seriesPoints];
+    b.maxTime += 60;
+    XCTAssertNotEqualObjects([a cacheKey], [b cacheKey], @"Pan");
+    b = [self inputWithSeries:a.seriesPoints];
+    b.size = CGSizeMake(400, 120);
+    XCTAssertNotEqualObjects([a cacheKey], [b cacheKey], @"Resize");
+}
+
+#pragma mark - Benchmark
+
+/// Four 300-point series with axes: a full-width multi-series dashboard card.
+- (void)testPerformanceMultiSeriesGeometry {
+    NSMutableArray *series = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 4; i++) [series addObject:HATestSeries(kStart, kStart + 86400, 300)];
+    HAGraphGeometryInput *input = [self inputWithSeries:series];
+    input.size = CGSizeMake(700, 200);
+    input.legendHeight = 16;
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 20; i++) {
+            [HAGraphGeometry geometryWithInput:input];
+        }
+    }];
+}
+
+/// A day of a flapping sensor compacted for one timeline row.
+- (void)testPerformanceTimelineCompaction {
+    NSMutableArray *segments = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 17280; i++) {
+        [segments addObject:HATestSegment((i % 7 < 3) ? @"on" : @"off", kStart + i * 5, kStart + (i + 1) * 5)];
+    }
+    [self measureBlock:^{
+        [HAGraphGeometry timelineRunsForSegments:segments minTime:kStart maxTime:kStart + 86400
+                                       areaWidth:600 pixelScale:2];
+    }];
+}
+
+@end
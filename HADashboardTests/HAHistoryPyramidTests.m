@@ -0,0 +1,185 @@
+#import <XCTest/XCTest.h>
+#import "HAHistoryPyramid.h"
+
+#pragma mark - HAHistoryPyramid Test Access
+
+@interface HAHistoryPyramid (TestAccess)
+@property (nonatomic, copy) NSArray<NSArray<NSDictionary *> *> *coarseLevels;
+@end
+
+/// Evenly spaced points over [start, end) with value = index.
+static NSArray<NSDictionary *> *HATestPoints(NSTimeInterval start, NSTimeInterval end, NSUInteger count) {
+    NSMutableArray *points = [NSMutableArray arrayWithCapacity:count];
+    double step = (end - start) / (double)count;
+    for (NSUInteger i = 0; i < count; i++) {
+        [points addObject:@{@"value": @(i), @"timestamp": @(start + i * step)}];
+    }
+    return points;
+}
+
+static BOOL HATestSorted(NSArray<NSDictionary *> *points) {
+    for (NSUInteger i = 1; i < points.count; i++) {
+        if ([points[i][@"timestamp"] doubleValue] < [points[i - 1][@"timestamp"] doubleValue]) return NO;
+    }
+    return YES;
+}
+
+@interface HAHistoryPyramidTests : XCTestCase
+@property (nonatomic, strong) HAHistoryPyramid *pyramid;
+@property (nonatomic, strong) NSMutableArray<NSArray<NSNumber *> *> *loadRequests;
+@end
+
+@implementation HAHistoryPyramidTests
+
+static const NSTimeInterval kStart = 1700000000;
+static const NSTimeInterval kDay = 86400;
+
+- (void)setUp {
+    [super setUp];
+    self.pyramid = [[HAHistoryPyramid alloc] initWithStartTime:kStart endTime:kStart + kDay
+                                                    basePoints:HATestPoints(kStart, kStart + kDay, 100)];
+    self.loadRequests = [NSMutableArray array];
+
+    // Synchronous loader: one point per 10 s over the requested range
+    __weak typeof(self) weakSelf = self;
+    self.pyramid.tileLoader = ^(NSTimeInterval start, NSTimeInterval end, NSUInteger maxPoints, void (^done)(NSArray *)) {
+        [weakSelf.loadRequests addObject:@[@(start), @(end), @(maxPoints)]];
+        done(HATestPoints(start, end, (NSUInteger)((end - start) / 10.0)));
+    };
+}
+
+#pragma mark - Levels
+
+- (void)testCoarseLevelsHalveDownToMinimum {
+    HAHistoryPyramid *p = [[HAHistoryPyramid alloc] initWithStartTime:kStart endTime:kStart + kDay
+                                                           basePoints:HATestPoints(kStart, kStart + kDay, 1000)];
+    NSArray *levels = p.coarseLevels;
+    XCTAssertEqual([levels[0] count], 1000u);
+    XCTAssertEqual([levels[1] count], 500u);
+    XCTAssertGreaterThanOrEqual([levels.lastObject count], 32u);
+    XCTAssertLessThan([levels.lastObject count], 64u);
+    // Latest value survives every level
+    XCTAssertEqualObjects([levels.lastObject lastObject], [levels[0] lastObject]);
+}
+
+- (void)testWideWindowUsesCoarseLevel {
+    HAHistoryPyramid *p = [[HAHistoryPyramid alloc] initWithStartTime:kStart endTime:kStart + kDay
+                                                           basePoints:HATestPoints(kStart, kStart + kDay, 1000)];
+    NSArray *points = [p pointsForStartTime:kStart endTime:kStart + kDay pixelWidth:300];
+    XCTAssertGreaterThanOrEqual(points.count, 300u);
+    XCTAssertLessThan(points.count, 1000u);
+}
+
+- (void)testLevelSelection {
+    // Unzoomed: base data is enough
+    XCTAssertEqual([self.pyramid levelForStartTime:kStart endTime:kStart + kDay pixelWidth:100], 0u);
+    // 10x zoom on 300 px wants 28.8 s/px → finer than base (864 s/pt)
+    NSUInteger level = [self.pyramid levelForStartTime:kStart endTime:kStart + kDay / 10 pixelWidth:300];
+    XCTAssertGreaterThan(level, 0u);
+    double tileResolution = kDay / (double)(1UL << level) / (double)kHistoryPyramidTilePoints;
+    XCTAssertLessThanOrEqual(tileResolution, (kDay / 10) / 300.0);
+    // Absurd zoom is capped
+    XCTAssertEqual([self.pyramid levelForStartTime:kStart endTime:kStart + 1 pixelWidth:300], kHistoryPyramidMaxLevel);
+}
+
+#pragma mark - Tiles
+
+- (void)testPointsWithoutTilesFallBackToBase {
+    NSArray *points = [self.pyramid pointsForStartTime:kStart + kDay / 2 endTime:kStart + kDay / 2 + 3600 pixelWidth:300];
+    XCTAssertGreaterThanOrEqual(points.count, 2u, @"Neighbours on both sides of the window");
+    XCTAssertLessThan(points.count, 10u);
+    XCTAssertTrue(HATestSorted(points));
+    XCTAssertEqual(self.loadRequests.count, 0u, @"Reading points never fetches");
+}
+
+- (void)testLoadTilesRefinesWindow {
+    NSTimeInterval from = kStart + kDay / 2, to = from + 3600;
+    NSUInteger before = [self.pyramid pointsForStartTime:from endTime:to pixelWidth:300].count;
+
+    __block NSUInteger changes = 0;
+    self.pyramid.changeHandler = ^(HAHistoryPyramid *p) { changes++; };
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+
+    XCTAssertGreaterThan(self.loadRequests.count, 0u);
+    XCTAssertEqual(changes, self.loadRequests.count);
+    for (NSArray *request in self.loadRequests) {
+        XCTAssertEqual([request[2] unsignedIntegerValue], kHistoryPyramidTilePoints);
+    }
+
+    NSArray *after = [self.pyramid pointsForStartTime:from endTime:to pixelWidth:300];
+    XCTAssertGreaterThan(after.count, before);
+    XCTAssertTrue(HATestSorted(after));
+    XCTAssertLessThanOrEqual([after.firstObject[@"timestamp"] doubleValue], from);
+    XCTAssertGreaterThanOrEqual([after.lastObject[@"timestamp"] doubleValue], to);
+}
+
+- (void)testLoadedTilesAreNotRefetched {
+    NSTimeInterval from = kStart + kDay / 2, to = from + 3600;
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+    NSUInteger requests = self.loadRequests.count;
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+    XCTAssertEqual(self.loadRequests.count, requests);
+
+    [self.pyramid evictTiles];
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+    XCTAssertEqual(self.loadRequests.count, requests * 2, @"Evicted tiles load again");
+}
+
+- (void)testSparseTilesFallBackAndAreRemembered {
+    __block NSUInteger requests = 0;
+    self.pyramid.tileLoader = ^(NSTimeInterval start, NSTimeInterval end, NSUInteger maxPoints, void (^done)(NSArray *)) {
+        requests++;
+        done(@[]); // Sensor didn't change in this slice
+    };
+    NSTimeInterval from = kStart + kDay / 2, to = from + 3600;
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+    NSUInteger first = requests;
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+    XCTAssertEqual(requests, first);
+    XCTAssertGreaterThanOrEqual([self.pyramid pointsForStartTime:from endTime:to pixelWidth:300].count, 2u);
+}
+
+- (void)testFailedTileIsRetried {
+    __block NSUInteger requests = 0;
+    __block BOOL fail = YES;
+    self.pyramid.tileLoader = ^(NSTimeInterval start, NSTimeInterval end, NSUInteger maxPoints, void (^done)(NSArray *)) {
+        requests++;
+        done(fail ? nil : HATestPoints(start, end, (NSUInteger)((end - start) / 10.0)));
+    };
+    __block NSUInteger changes = 0;
+    self.pyramid.changeHandler = ^(HAHistoryPyramid *p) { changes++; };
+    NSTimeInterval from = kStart + kDay / 2, to = from + 3600;
+    NSUInteger fallback = [self.pyramid pointsForStartTime:from endTime:to pixelWidth:300].count;
+
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+    NSUInteger failed = requests;
+    XCTAssertGreaterThan(failed, 0u);
+    XCTAssertEqual(changes, 0u);
+
+    fail = NO;
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:300];
+    XCTAssertEqual(requests, failed * 2, @"Failed tiles are fetched again");
+    XCTAssertEqual(changes, failed);
+    XCTAssertGreaterThan([self.pyramid pointsForStartTime:from endTime:to pixelWidth:300].count, fallback);
+}
+
+- (void)testNoFetchWithoutZoom {
+    [self.pyramid loadTilesForStartTime:kStart endTime:kStart + kDay pixelWidth:100];
+    XCTAssertEqual(self.loadRequests.count, 0u);
+}
+
+#pragma mark - Benchmark
+
+/// One pan step at deep zoom: what HAGraphView asks for every frame.
+- (void)testPerformancePointsForWindow {
+    NSTimeInterval from = kStart + kDay / 2, to = from + 3600;
+    [self.pyramid loadTilesForStartTime:from endTime:to pixelWidth:600];
+    [self measureBlock:^{
+        for (NSUInteger i = 0; i < 600; i++) {
+            NSTimeInterval shift = (double)(i % 60) * 10.0;
+            [self.pyramid pointsForStartTime:from + shift endTime:to + shift pixelWidth:600];
+        }
+    }];
+}
+
+@end
@@ -0,0 +1,114 @@
+#import <XCTest/XCTest.h>
+#import "HAHistoryStatistics.h"
+
+@interface HAHistoryStatisticsTests : XCTestCase
+@end
+
+@implementation HAHistoryStatisticsTests
+
+static NSDictionary *HATestRow(NSTimeInterval start, id mean, id min, id max) {
+    NSMutableDictionary *row = [NSMutableDictionary dictionary];
+    row[@"start"] = @(start * 1000.0);
+    row[@"end"] = @((start + 3600) * 1000.0);
+    row[@"mean"] = mean ?: [NSNull null];
+    row[@"min"] = min ?: [NSNull null];
+    row[@"max"] = max ?: [NSNull null];
+    return row;
+}
+
+#pragma mark - Source Selection
+
+- (void)testUsesStatisticsOnlyForLongMeasurementRanges {
+    NSTimeInterval week = 7 * 86400;
+    XCTAssertTrue([HAHistoryStatistics shouldUseStatisticsForStateClass:@"measurement" range:week]);
+    XCTAssertFalse([HAHistoryStatistics shouldUseStatisticsForStateClass:@"measurement" range:24 * 3600]);
+    XCTAssertFalse([HAHistoryStatistics shouldUseStatisticsForStateClass:@"measurement" range:HAHistoryStatisticsMinimumRange]);
+    XCTAssertFalse([HAHistoryStatistics shouldUseStatisticsForStateClass:@"total_increasing" range:week]);
+    XCTAssertFalse([HAHistoryStatistics shouldUseStatisticsForStateClass:nil range:week]);
+    XCTAssertFalse([HAHistoryStatistics shouldUseStatisticsForStateClass:(NSString *)@1 range:week]);
+}
+
+- (void)testPeriodSelection {
+    NSDate *now = [NSDate date];
+    NSDate *threeDays = [now dateByAddingTimeInterval:-3 * 86400];
+    NSDate *month = [now dateByAddingTimeInterval:-30 * 86400];
+
+    // 72 hourly rows < 100 points: 5-minute rows give the resolution
+    XCTAssertEqualObjects([HAHistoryStatistics periodForStartDate:threeDays endDate:now maxPoints:100], @"5minute");
+    // 72 hourly rows already cover 50 points
+    XCTAssertEqualObjects([HAHistoryStatistics periodForStartDate:threeDays endDate:now maxPoints:50], @"hour");
+    // Past short-term retention, only hourly rows exist
+    XCTAssertEqualObjects([HAHistoryStatistics periodForStartDate:month endDate:now maxPoints:1000], @"hour");
+}
+
+- (void)testCommandShape {
+    NSDate *start = [NSDate dateWithTimeIntervalSince1970:1705314600];
+    NSDate *end = [NSDate dateWithTimeIntervalSince1970:1705314600 + 7 * 86400];
+    NSDictionary *cmd = [HAHistoryStatistics commandForEntityId:@"sensor.temp" startDate:start endDate:end period:@"hour"];
+    XCTAssertEqualObjects(cmd[@"type"], @"recorder/statistics_during_period");
+    XCTAssertEqualObjects(cmd[@"start_time"], @"2024-01-15T10:30:00Z");
+    XCTAssertEqualObjects(cmd[@"end_time"], @"2024-01-22T10:30:00Z");
+    XCTAssertEqualObjects(cmd[@"statistic_ids"], @[@"sensor.temp"]);
+    XCTAssertEqualObjects(cmd[@"period"], @"hour");
+    XCTAssertEqualObjects(cmd[@"types"], (@[@"mean", @"min", @"max"]));
+}
+
+#pragma mark - Result Reduction
+
+- (void)testRowsMapToPointsWithBands {
+    NSTimeInterval t0 = 1705314600;
+    NSDictionary *result = @{@"sensor.temp": @[
+        HATestRow(t0, @20.5, @19.0, @22.0),
+        HATestRow(t0 + 3600, @21.0, @20.0, @23.5),
+    ]};
+    NSArray *points = [HAHistoryStatistics pointsFromResult:result entityId:@"sensor.temp"
+                                                 startTime:t0 endTime:t0 + 7200 maxPoints:100];
+    XCTAssertEqual(points.count, 2u);
+    XCTAssertEqualWithAccuracy([points[0][@"timestamp"] doubleValue], t0, 0.001);
+    XCTAssertEqualWithAccuracy([points[0][@"value"] doubleValue], 20.5, 0.0001);
+    XCTAssertEqualWithAccuracy([points[0][@"min"] doubleValue], 19.0, 0.0001);
+    XCTAssertEqualWithAccuracy([points[1][@"max"] doubleValue], 23.5, 0.0001);
+}
+
+- (void)testBucketsMergeMeanMinMax {
+    NSTimeInterval t0 = 1705314600;
+    NSMutableArray *rows = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 24; i++) {
+        [rows addObject:HATestRow(t0 + i * 3600, @(i), @(i - 1.0), @(i + 1.0))];
+    }
+    // 24 hourly rows into 4 buckets of 6
+    NSArray *points = [HAHistoryStatistics pointsFromResult:@{@"sensor.temp": rows} entityId:@"sensor.temp"
+                                                 startTime:t0 endTime:t0 + 24 * 3600 maxPoints:4];
+    XCTAssertEqual(points.count, 4u);
+    XCTAssertEqualWithAccuracy([points[0][@"value"] doubleValue], 2.5, 0.0001);  // mean of 0..5
+    XCTAssertEqualWithAccuracy([points[0][@"min"] doubleValue], -1.0, 0.0001);
+    XCTAssertEqualWithAccuracy([points[0][@"max"] doubleValue], 6.0, 0.0001);
+    XCTAssertEqualWithAccuracy([points[3][@"timestamp"] doubleValue], t0 + 18 * 3600, 0.001);
+    XCTAssertEqualWithAccuracy([points[3][@"max"] doubleValue], 24.0, 0.0001);
+}
+
+- (void)testISOStartAndMissingValues {
+    NSDictionary *result = @{@"sensor.temp": @[
+        @{@"start": @"2024-01-15T10:00:00+00:00", @"mean": @10.0, @"min": @9.0, @"max": @11.0},
+        @{@"start": @"2024-01-15T11:00:00+00:00", @"mean": [NSNull null], @"min": [NSNull null], @"max": [NSNull null]},
+        @{@"start": @"2024-01-15T12:00:00+00:00", @"mean": @12.0},
+        @{@"start": @"not a date", @"mean": @99.0},
+    ]};
+    NSArray *points = [HAHistoryStatistics pointsFromResult:result entityId:@"sensor.temp"
+                                                 startTime:1705312800 endTime:1705312800 + 3 * 3600 maxPoints:100];
+    XCTAssertEqual(points.count, 2u);
+    XCTAssertEqualWithAccuracy([points[0][@"timestamp"] doubleValue], 1705312800.0, 0.001);
+    // No min/max in the row: band collapses onto the mean
+    XCTAssertEqualWithAccuracy([points[1][@"min"] doubleValue], 12.0, 0.0001);
+    XCTAssertEqualWithAccuracy([points[1][@"max"] doubleValue], 12.0, 0.0001);
+}
+
+- (void)testUnexpectedShapesYieldEmpty {
+    XCTAssertEqual([HAHistoryStatistics pointsFromResult:nil entityId:@"sensor.temp" startTime:0 endTime:1 maxPoints:0].count, 0u);
+    XCTAssertEqual([HAHistoryStatistics pointsFromResult:@[] entityId:@"sensor.temp" startTime:0 endTime:1 maxPoints:0].count, 0u);
+    XCTAssertEqual([HAHistoryStatistics pointsFromResult:@{} entityId:@"sensor.temp" startTime:0 endTime:1 maxPoints:0].count, 0u);
+    XCTAssertEqual([HAHistoryStatistics pointsFromResult:@{@"sensor.temp": @"x"} entityId:@"sensor.temp" startTime:0 endTime:1 maxPoints:0].count, 0u);
+    XCTAssertEqual([HAHistoryStatistics pointsFromResult:@{@"sensor.temp": @[@1, @"a"]} entityId:@"sensor.temp" startTime:0 endTime:1 maxPoints:0].count, 0u);
+}
+
+@end
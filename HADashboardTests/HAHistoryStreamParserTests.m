@@ -0,0 +1,191 @@
+#import <XCTest/XCTest.h>
+#import "HAHistoryStreamParser.h"
+#import "HAHistoryDownsampler.h"
+
+/// Build a minimal_response-style history body for one entity.
+static NSData *HATestHistoryBody(NSArray<NSString *> *states, NSTimeInterval start, NSTimeInterval step) {
+    NSMutableString *json = [NSMutableString stringWithString:@"[["];
+    NSDateFormatter *fmt = [[NSDateFormatter alloc] init];
+    fmt.locale = [[NSLocale alloc] initWithLocaleIdentifier:@"en_US_POSIX"];
+    fmt.timeZone = [NSTimeZone timeZoneForSecondsFromGMT:0];
+    fmt.dateFormat = @"yyyy-MM-dd'T'HH:mm:ss.SSSSSSZZZZZ";
+    for (NSUInteger i = 0; i < states.count; i++) {
+        NSString *ts = [fmt stringFromDate:[NSDate dateWithTimeIntervalSince1970:start + i * step]];
+        if (i == 0) {
+            [json appendFormat:@"{\"entity_id\":\"sensor.power\",\"state\":\"%@\",\"attributes\":{\"state\":\"ignored\"},\"last_changed\":\"%@\",\"last_updated\":\"%@\"}",
+                states[i], ts, ts];
+        } else {
+            [json appendFormat:@",{\"state\":\"%@\",\"last_changed\":\"%@\"}", states[i], ts];
+        }
+    }
+    [json appendString:@"]]"];
+    return [json dataUsingEncoding:NSUTF8StringEncoding];
+}
+
+static NSArray *HATestParse(HAHistoryStreamParser *parser, NSData *body, NSUInteger chunkSize) {
+    const uint8_t *bytes = body.bytes;
+    for (NSUInteger offset = 0; offset < body.length; offset += chunkSize) {
+        NSUInteger len = MIN(chunkSize, body.length - offset);
+        [parser appendBytes:bytes + offset length:len];
+    }
+    return [parser finish];
+}
+
+#pragma mark - HAHistoryStreamParser Tests
+
+@interface HAHistoryStreamParserTests : XCTestCase
+@end
+
+@implementation HAHistoryStreamParserTests
+
+- (HAHistoryStreamParser *)pointsParserWithMax:(NSUInteger)maxPoints {
+    return [[HAHistoryStreamParser alloc] initWithMode:HAHistoryStreamModePoints
+                                             startTime:1700000000
+                                               endTime:1700000000 + 86400
+                                             maxPoints:maxPoints];
+}
+
+- (void)testParsesNumericPoints {
+    NSData *body = HATestHistoryBody(@[@"1.5", @"2", @"0", @"0.25"], 1700000000, 3600);
+    NSArray *points = HATestParse([self pointsParserWithMax:100], body, body.length);
+
+    XCTAssertEqual(points.count, 4u);
+    XCTAssertEqualWithAccuracy([points[0][@"value"] doubleValue], 1.5, 0.0001);
+    XCTAssertEqualWithAccuracy([points[2][@"value"] doubleValue], 0.0, 0.0001);
+    XCTAssertEqualWithAccuracy([points[3][@"timestamp"] doubleValue], 1700000000 + 3 * 3600, 0.001);
+}
+
+- (void)testSkipsNonNumericStates {
+    NSData *body = HATestHistoryBody(@[@"unknown", @"3", @"unavailable", @"abc", @"4"], 1700000000, 60);
+    NSArray *points = HATestParse([self pointsParserWithMax:100], body, body.length);
+
+    XCTAssertEqual(points.count, 2u, @"unknown/unavailable/non-numeric states should be dropped");
+    XCTAssertEqualWithAccuracy([points[0][@"value"] doubleValue], 3, 0.0001);
+    XCTAssertEqualWithAccuracy([points[1][@"value"] doubleValue], 4, 0.0001);
+}
+
+- (void)testChunkBoundariesDoNotChangeResult {
+    NSMutableArray *states = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 500; i++) [states addObject:[NSString stringWithFormat:@"%.2f", i * 0.5]];
+    NSData *body = HATestHistoryBody(states, 1700000000, 120);
+
+    NSArray *whole = HATestParse([self pointsParserWithMax:100], body, body.length);
+    for (NSNumber *chunk in @[@1, @3, @17, @1024]) {
+        NSArray *chunked = HATestParse([self pointsParserWithMax:100], body, chunk.unsignedIntegerValue);
+        XCTAssertEqualObjects(chunked, whole, @"Chunk size %@ should not change output", chunk);
+    }
+}
+
+- (void)testDownsamplesToMaxPoints {
+    NSMutableArray *states = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 8640; i++) [states addObject:[NSString stringWithFormat:@"%lu", (unsigned long)(i % 50)]];
+    NSData *body = HATestHistoryBody(states, 1700000000, 10); // one day at 10 s
+
+    HAHistoryStreamParser *parser = [self pointsParserWithMax:100];
+    NSArray *points = HATestParse(parser, body, 4096);
+
+    XCTAssertEqual(parser.entryCount, 8640u);
+    XCTAssertLessThanOrEqual(points.count, 101u, @"Output bounded by maxPoints + latest point");
+    XCTAssertGreaterThanOrEqual(points.count, 99u);
+    XCTAssertEqualWithAccuracy([points.lastObject[@"timestamp"] doubleValue], 1700000000 + 8639 * 10, 0.001,
+                               @"Most recent point should always be kept");
+}
+
+- (void)testIgnoresEntitiesAfterFirst {
+    NSString *json = @"[[{\"state\":\"1\",\"last_changed\":\"2023-11-14T22:13:20+00:00\"}],"
+                     @"[{\"state\":\"99\",\"last_changed\":\"2023-11-14T23:13:20+00:00\"}]]";
+    NSData *body = [json dataUsingEncoding:NSUTF8StringEncoding];
+    NSArray *points = HATestParse([self pointsParserWithMax:100], body, 5);
+    XCTAssertEqual(points.count, 1u);
+    XCTAssertEqualWithAccuracy([points[0][@"value"] doubleValue], 1, 0.0001);
+}
+
+- (void)testMalformedBodyReturnsEmpty {
+    NSData *body = [@"401: Unauthorized" dataUsingEncoding:NSUTF8StringEncoding];
+    XCTAssertEqual(HATestParse([self pointsParserWithMax:100], body, body.length).count, 0u);
+    XCTAssertEqual([[self pointsParserWithMax:100] finish].count, 0u);
+}
+
+#pragma mark - Timeline
+
+- (void)testTimelineSegments {
+    NSData *body = HATestHistoryBody(@[@"off", @"on", @"on", @"Not \\\"home\\\""], 1700000000, 600);
+    HAHistoryStreamParser *parser = [[HAHistoryStreamParser alloc] initWithMode:HAHistoryStreamModeTimeline
+                                                                     startTime:1700000000
+                                                                       endTime:1700003600
+                                                                     maxPoints:0];
+    NSArray *segments = HATestParse(parser, body, 7);
+
+    XCTAssertEqual(segments.count, 4u);
+    XCTAssertEqualObjects(segments[0][@"state"], @"off");
+    XCTAssertEqualWithAccuracy([segments[0][@"end"] doubleValue], 1700000600, 0.001);
+    XCTAssertEqualObjects(segments[1][@"state"], @"on");
+    XCTAssertEqualObjects(segments[3][@"state"], @"Not \"home\"", @"JSON escapes should be decoded");
+    XCTAssertGreaterThan([segments[3][@"end"] doubleValue], 1700001800, @"Last segment should run to now");
+}
+
+- (void)testTimelineUnicodeEscapes {
+    NSString *json = @"[[{\"state\":\"K\\u00fcche \\ud83d\\ude00\",\"last_changed\":\"2023-11-14T22:13:20Z\"}]]";
+    HAHistoryStreamParser *parser = [[HAHistoryStreamParser alloc] initWithMode:HAHistoryStreamModeTimeline
+                                                                     startTime:0 endTime:0 maxPoints:0];
+    NSArray *segments = HATestParse(parser, [json dataUsingEncoding:NSUTF8StringEncoding], 3);
+    XCTAssertEqualObjects(segments.firstObject[@"state"], @"Küche 😀");
+}
+
+#pragma mark - Benchmark
+
+- (void)testPerformanceStreamingParse {
+    NSMutableArray *states = [NSMutableArray array];
+    for (NSUInteger i = 0; i < 60480; i++) [states addObject:[NSString stringWithFormat:@"%.1f", 100 + (i % 300) * 0.1]];
+    NSData *body = HATestHistoryBody(states, 1700000000, 10); // 7 days at 10 s
+
+    [self measureBlock:^{
+        HAHistoryStreamParser *parser = [[HAHistoryStreamParser alloc] initWithMode:HAHistoryStreamModePoints
+                                                                         startTime:1700000000
+                                                                           endTime:1700000000 + 7 * 86400
+                                                                         maxPoints:100];
+        XCTAssertGreaterThan(HATestParse(parser, body, 16384).count, 0u);
+    }];
+}
+
+@end
+
+#pragma mark - HAHistoryDownsampler Tests
+
+@interface HAHistoryDownsamplerTests : XCTestCase
+@end
+
+@implementation HAHistoryDownsamplerTests
+
+- (void)testKeepsFirstPointPerBucketAndLatest {
+    HAHistoryDownsampler *ds = [[HAHistoryDownsampler alloc] initWithStartTime:0 endTime:100 maxPoints:10];
+    for (NSUInteger t = 0; t < 100; t++) [ds addValue:t timestamp:t];
+
+    NSArray *points = [ds points];
+    XCTAssertEqual(ds.inputCount, 100u);
+    XCTAssertEqual(points.count, 11u);
+    XCTAssertEqualWithAccuracy([points[1][@"timestamp"] doubleValue], 10, 0.001);
+    XCTAssertEqualWithAccuracy([points.lastObject[@"timestamp"] doubleValue], 99, 0.001);
+}
+
+- (void)testPointsBeforeWindowClampToFirstBucket {
+    HAHistoryDownsampler *ds = [[HAHistoryDownsampler alloc] initWithStartTime:1000 endTime:2000 maxPoints:10];
+    [ds addValue:1 timestamp:500];
+    [ds addValue:2 timestamp:1010];
+    [ds addValue:3 timestamp:1500];
+
+    NSArray *points = [ds points];
+    XCTAssertEqual(points.count, 2u, @"The pre-window point claims bucket 0");
+    XCTAssertEqualWithAccuracy([points[0][@"value"] doubleValue], 1, 0.0001);
+    XCTAssertEqualWithAccuracy([points[1][@"value"] doubleValue], 3, 0.0001);
+}
+
+- (void)testSparseDataIsKeptIntact {
+    HAHistoryDownsampler *ds = [[HAHistoryDownsampler alloc] initWithStartTime:0 endTime:1000 maxPoints:100];
+    [ds addValue:1 timestamp:0];
+    [ds addValue:2 timestamp:500];
+    [ds addValue:3 timestamp:999];
+    XCTAssertEqual([ds points].count, 3u);
+}
+
+@end
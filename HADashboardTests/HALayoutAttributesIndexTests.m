@@ -0,0 +1,203 @@
+#import <XCTest/XCTest.h>
+#import "HALayoutAttributesIndex.h"
+#import "HAColumnarLayout.h"
+#import "HAMasonryLayout.h"
+
+#pragma mark - Synthetic Dashboard
+
+/// Deterministic dashboard of itemCount cards for the layout benchmarks:
+/// varied heights and sub-grid spans, spread over sectionCount sections.
+@interface HABenchmarkDashboard : NSObject <UICollectionViewDataSource, HAColumnarLayoutDelegate, HAMasonryLayoutDelegate>
+@property (nonatomic, assign) NSInteger sectionCount;
+@property (nonatomic, assign) NSInteger itemCount;
+@end
+
+@implementation HABenchmarkDashboard
+
+- (NSInteger)numberOfSectionsInCollectionView:(UICollectionView *)collectionView {
+    return self.sectionCount;
+}
+
+- (NSInteger)collectionView:(UICollectionView *)collectionView numberOfItemsInSection:(NSInteger)section {
+    NSInteger base = self.itemCount / self.sectionCount;
+    return base + (section < self.itemCount % self.sectionCount ? 1 : 0);
+}
+
+- (UICollectionViewCell *)collectionView:(UICollectionView *)collectionView cellForItemAtIndexPath:(NSIndexPath *)indexPath {
+    return [collectionView dequeueReusableCellWithReuseIdentifier:@"cell" forIndexPath:indexPath];
+}
+
+- (CGFloat)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+ heightForItemAtIndexPath:(NSIndexPath *)indexPath itemWidth:(CGFloat)itemWidth {
+    return 60.0 + ((indexPath.section * 31 + indexPath.item * 17) % 7) * 30.0;
+}
+
+- (CGFloat)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+ heightForHeaderInSection:(NSInteger)section {
+    return 32.0;
+}
+
+- (NSInteger)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+  gridColumnsForItemAtIndexPath:(NSIndexPath *)indexPath {
+    return (indexPath.item % 3 == 0) ? 12 : 6;
+}
+
+- (NSString *)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+     cardTypeForItemAtIndexPath:(NSIndexPath *)indexPath {
+    return (indexPath.item % 5 == 0) ? @"entities" : @"tile";
+}
+
+- (NSInteger)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+  entityCountForItemAtIndexPath:(NSIndexPath *)indexPath {
+    return 4;
+}
+
+@end
+
+#pragma mark - Layout Attributes Index Tests
+
+@interface HALayoutAttributesIndexTests : XCTestCase
+@end
+
+@implementation HALayoutAttributesIndexTests
+
+#pragma mark - Helpers
+
+- (UICollectionView *)collectionViewWithLayout:(UICollectionViewLayout *)layout dashboard:(HABenchmarkDashboard *)dashboard {
+    UICollectionView *cv = [[UICollectionView alloc] initWithFrame:CGRectMake(0, 0, 1024, 768) collectionViewLayout:layout];
+    cv.dataSource = dashboard;
+    [cv registerClass:[UICollectionViewCell class] forCellWithReuseIdentifier:@"cell"];
+    return cv;
+}
+
+- (UICollectionViewLayoutAttributes *)attributesAtItem:(NSInteger)item frame:(CGRect)frame {
+    UICollectionViewLayoutAttributes *attr =
+        [UICollectionViewLayoutAttributes layoutAttributesForCellWithIndexPath:[NSIndexPath indexPathForItem:item inSection:0]];
+    attr.frame = frame;
+    return attr;
+}
+
+- (NSSet *)linearScan:(NSArray<UICollectionViewLayoutAttributes *> *)all inRect:(CGRect)rect {
+    NSMutableSet *result = [NSMutableSet set];
+    for (UICollectionViewLayoutAttributes *attr in all) {
+        if (CGRectIntersectsRect(attr.frame, rect)) [result addObject:attr];
+    }
+    return result;
+}
+
+- (void)testMatchesLinearScan {
+    HALayoutAttributesIndex *index = [[HALayoutAttributesIndex alloc] init];
+    NSMutableArray *all = [NSMutableArray array];
+    srand48(42);
+    CGFloat y[3] = {0, 0, 0};
+    for (NSInteger i = 0; i < 600; i++) {
+        NSUInteger lane = (NSUInteger)(drand48() * 3);
+        CGFloat height = 40 + floor(drand48() * 300);
+        // Half-width pairs share a row, so lanes overlap vertically
+        BOOL pair = (drand48() < 0.3);
+        UICollectionViewLayoutAttributes *attr = [self attributesAtItem:i frame:CGRectMake(lane * 200, y[lane], pair ? 95 : 190, height)];
+        [index addAttributes:attr toLane:lane];
+        [all addObject:attr];
+        if (pair) {
+            UICollectionViewLayoutAttributes *partner = [self attributesAtItem:++i frame:CGRectMake(lane * 200 + 95, y[lane], 95, height / 2)];
+            [index addAttributes:partner toLane:lane];
+            [all addObject:partner];
+        }
+        y[lane] += height + 6;
+    }
+    [index build];
+    XCTAssertEqual(index.count, all.count);
+
+    for (NSInteger q = 0; q < 200; q++) {
+        CGRect rect = CGRectMake(drand48() * 400, drand48() * 60000, 100 + drand48() * 500, drand48() * 2000);
+        NSSet *expected = [self linearScan:all inRect:rect];
+        NSArray *found = [index attributesInRect:rect];
+        XCTAssertEqual(found.count, expected.count, @"No duplicates, nothing missed for %@", NSStringFromCGRect(rect));
+        XCTAssertEqualObjects([NSSet setWithArray:found], expected);
+    }
+}
+
+- (void)testUnsortedInsertion {
+    HALayoutAttributesIndex *index = [[HALayoutAttributesIndex alloc] init];
+    UICollectionViewLayoutAttributes *low = [self attributesAtItem:0 frame:CGRectMake(0, 500, 100, 100)];
+    UICollectionViewLayoutAttributes *high = [self attributesAtItem:1 frame:CGRectMake(0, 0, 100, 100)];
+    [index addAttributes:low toLane:2];
+    [index addAttributes:high toLane:2];
+    [index build];
+    XCTAssertEqualObjects([index attributesInRect:CGRectMake(0, 450, 100, 100)], @[low]);
+    XCTAssertEqualObjects([index attributesInRect:CGRectMake(0, 0, 100, 50)], @[high]);
+    XCTAssertEqual([index attributesInRect:CGRectMake(0, 200, 100, 100)].count, 0u);
+}
+
+- (void)testRemoveAll {
+    HALayoutAttributesIndex *index = [[HALayoutAttributesIndex alloc] init];
+    [index addAttributes:[self attributesAtItem:0 frame:CGRectMake(0, 0, 100, 100)] toLane:0];
+    [index build];
+    [index removeAllAttributes];
+    [index build];
+    XCTAssertEqual(index.count, 0u);
+    XCTAssertEqual([index attributesInRect:CGRectMake(0, 0, 1000, 1000)].count, 0u);
+}
+
+- (void)testColumnarReturnsEveryElementOnce {
+    HABenchmarkDashboard *dashboard = [[HABenchmarkDashboard alloc] init];
+    dashboard.sectionCount = 4;
+    dashboard.itemCount = 200;
+    HAColumnarLayout *layout = [[HAColumnarLayout alloc] init];
+    layout.delegate = dashboard;
+    UICollectionView *cv = [self collectionViewWithLayout:layout dashboard:dashboard];
+    [cv layoutIfNeeded];
+    CGSize size = layout.collectionViewContentSize;
+    NSArray *attrs = [layout layoutAttributesForElementsInRect:CGRectMake(0, 0, size.width, size.height)];
+    XCTAssertEqual(attrs.count, 204u, @"200 items and 4 headers");
+    XCTAssertEqual([NSSet setWithArray:attrs].count, attrs.count);
+}
+
+#pragma mark - Benchmark
+
+/// prepareLayout plus a top-to-bottom scroll in 60 pt steps (one query per frame).
+- (void)measureLayout:(UICollectionViewLayout *)layout items:(NSInteger)items sections:(NSInteger)sections {
+    HABenchmarkDashboard *dashboard = [[HABenchmarkDashboard alloc] init];
+    dashboard.sectionCount = sections;
+    dashboard.itemCount = items;
+    if ([layout isKindOfClass:[HAColumnarLayout class]]) {
+        ((HAColumnarLayout *)layout).delegate = dashboard;
+    } else {
+        ((HAMasonryLayout *)layout).delegate = dashboard;
+    }
+    UICollectionView *cv = [self collectionViewWithLayout:layout dashboard:dashboard];
+    [self measureBlock:^{
+        [layout invalidateLayout];
+        [layout prepareLayout];
+        CGFloat height = layout.collectionViewContentSize.height;
+        for (CGFloat y = 0; y < height; y += 60.0) {
+            [layout layoutAttributesForElementsInRect:CGRectMake(0, y, cv.bounds.size.width, cv.bounds.size.height)];
+        }
+    }];
+}
+
+- (void)testPerformanceColumnar50 {
+    [self measureLayout:[[HAColumnarLayout alloc] init] items:50 sections:4];
+}
+
+- (void)testPerformanceColumnar500 {
+    [self measureLayout:[[HAColumnarLayout alloc] init] items:500 sections:8];
+}
+
+- (void)testPerformanceColumnar5000 {
+    [self measureLayout:[[HAColumnarLayout alloc] init] items:5000 sections:16];
+}
+
+- (void)testPerformanceMasonry50 {
+    [self measureLayout:[[HAMasonryLayout alloc] init] items:50 sections:1];
+}
+
+- (void)testPerformanceMasonry500 {
+    [self measureLayout:[[HAMasonryLayout alloc] init] items:500 sections:1];
+}
+
+- (void)testPerformanceMasonry5000 {
+    [self measureLayout:[[HAMasonryLayout alloc] init] items:5000 sections:1];
+}
+
+@end
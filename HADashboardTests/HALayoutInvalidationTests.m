@@ -0,0 +1,220 @@
+#import <XCTest/XCTest.h>
+#import "HALayoutInvalidationContext.h"
+#import "HAColumnarLayout.h"
+#import "HAMasonryLayout.h"
+
+#pragma mark - Counting Data Source
+
+/// Heights are settable per index path; every height query is counted.
+@interface HAInvalidationTestDataSource : NSObject <UICollectionViewDataSource, HAColumnarLayoutDelegate, HAMasonryLayoutDelegate>
+@property (nonatomic, strong) NSArray<NSNumber *> *itemCounts;
+@property (nonatomic, strong) NSMutableDictionary<NSIndexPath *, NSNumber *> *heights;
+@property (nonatomic, assign) NSUInteger heightQueries;
+@end
+
+@implementation HAInvalidationTestDataSource
+
+- (NSInteger)numberOfSectionsInCollectionView:(UICollectionView *)collectionView {
+    return (NSInteger)self.itemCounts.count;
+}
+
+- (NSInteger)collectionView:(UICollectionView *)collectionView numberOfItemsInSection:(NSInteger)section {
+    return self.itemCounts[section].integerValue;
+}
+
+- (UICollectionViewCell *)collectionView:(UICollectionView *)collectionView cellForItemAtIndexPath:(NSIndexPath *)indexPath {
+    return [collectionView dequeueReusableCellWithReuseIdentifier:@"cell" forIndexPath:indexPath];
+}
+
+- (CGFloat)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+ heightForItemAtIndexPath:(NSIndexPath *)indexPath itemWidth:(CGFloat)itemWidth {
+    self.heightQueries++;
+    NSNumber *height = self.heights[indexPath];
+    return height ? height.floatValue : 100.0;
+}
+
+- (CGFloat)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+ heightForHeaderInSection:(NSInteger)section {
+    return 40.0;
+}
+
+- (NSString *)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+     cardTypeForItemAtIndexPath:(NSIndexPath *)indexPath {
+    return @"tile";
+}
+
+- (NSInteger)collectionView:(UICollectionView *)collectionView layout:(UICollectionViewLayout *)layout
+  entityCountForItemAtIndexPath:(NSIndexPath *)indexPath {
+    return 0;
+}
+
+@end
+
+#pragma mark - Layout Invalidation Tests
+
+@interface HALayoutInvalidationTests : XCTestCase
+@property (nonatomic, strong) HAInvalidationTestDataSource *dataSource;
+@end
+
+@implementation HALayoutInvalidationTests
+
+- (void)setUp {
+    [super setUp];
+    self.dataSource = [[HAInvalidationTestDataSource alloc] init];
+    self.dataSource.heights = [NSMutableDictionary dictionary];
+}
+
+- (UICollectionView *)collectionViewWithLayout:(UICollectionViewLayout *)layout {
+    UICollectionView *cv = [[UICollectionView alloc] initWithFrame:CGRectMake(0, 0, 1024, 768) collectionViewLayout:layout];
+    cv.dataSource = self.dataSource;
+    [cv registerClass:[UICollectionViewCell class] forCellWithReuseIdentifier:@"cell"];
+    [cv layoutIfNeeded];
+    return cv;
+}
+
+- (NSDictionary<NSIndexPath *, NSValue *> *)framesOfLayout:(UICollectionViewLayout *)layout {
+    CGSize size = layout.collectionViewContentSize;
+    NSMutableDictionary *frames = [NSMutableDictionary dictionary];
+    for (UICollectionViewLayoutAttributes *attr in [layout layoutAttributesForElementsInRect:CGRectMake(0, 0, size.width, size.height)]) {
+        if (attr.representedElementCategory == UICollectionElementCategoryCell) {
+            frames[attr.indexPath] = [NSValue valueWithCGRect:attr.frame];
+        }
+    }
+    return frames;
+}
+
+- (void)invalidateHeightAt:(NSIndexPath *)indexPath layout:(UICollectionViewLayout *)layout collectionView:(UICollectionView *)cv {
+    HALayoutInvalidationContext *context = [[HALayoutInvalidationContext alloc] init];
+    [context invalidateHeightsForItemsAtIndexPaths:@[indexPath]];
+    [layout invalidateLayoutWithContext:context];
+    [cv layoutIfNeeded];
+    [layout prepareLayout];
+}
+
+/// A fresh layout over the same data, for comparing frames.
+- (NSDictionary *)referenceFramesForLayout:(UICollectionViewLayout *)layout {
+    UICollectionView *cv = [self collectionViewWithLayout:layout];
+    [layout prepareLayout];
+    NSDictionary *frames = [self framesOfLayout:layout];
+    (void)cv;
+    return frames;
+}
+
+#pragma mark - Columnar Tests
+
+- (void)testColumnarRequeriesOnlyInvalidatedItem {
+    self.dataSource.itemCounts = @[@10, @10, @10, @10, @10, @10];
+    HAColumnarLayout *layout = [[HAColumnarLayout alloc] init];
+    layout.maxColumns = 3;
+    layout.delegate = self.dataSource;
+    UICollectionView *cv = [self collectionViewWithLayout:layout];
+    [layout prepareLayout];
+
+    NSIndexPath *changed = [NSIndexPath indexPathForItem:4 inSection:1];
+    UICollectionViewLayoutAttributes *besideBefore = [layout layoutAttributesForItemAtIndexPath:[NSIndexPath indexPathForItem:4 inSection:0]];
+    UICollectionViewLayoutAttributes *belowBefore = [layout layoutAttributesForItemAtIndexPath:[NSIndexPath indexPathForItem:0 inSection:4]];
+    CGRect belowFrame = belowBefore.frame;
+
+    self.dataSource.heights[changed] = @400;
+    self.dataSource.heightQueries = 0;
+    [self invalidateHeightAt:changed layout:layout collectionView:cv];
+    XCTAssertEqual(self.dataSource.heightQueries, 1u, @"Only the invalidated item is asked again");
+
+    // Section 0 is in the same row but another column: kept as is
+    XCTAssertEqual([layout layoutAttributesForItemAtIndexPath:[NSIndexPath indexPathForItem:4 inSection:0]], besideBefore);
+    // Section 1 became the tallest column, so the row below moved down
+    CGRect movedFrame = [layout layoutAttributesForItemAtIndexPath:[NSIndexPath indexPathForItem:0 inSection:4]].frame;
+    XCTAssertEqualWithAccuracy(CGRectGetMinY(movedFrame) - CGRectGetMinY(belowFrame), 300.0, 0.5);
+    XCTAssertEqual(CGRectGetMinY(belowBefore.frame), CGRectGetMinY(belowFrame), @"Handed-out attributes are not mutated");
+
+    HAColumnarLayout *reference = [[HAColumnarLayout alloc] init];
+    reference.maxColumns = 3;
+    reference.delegate = self.dataSource;
+    XCTAssertEqualObjects([self framesOfLayout:layout], [self referenceFramesForLayout:reference]);
+}
+
+- (void)testColumnarUnchangedHeightKeepsLayout {
+    self.dataSource.itemCounts = @[@5, @5];
+    HAColumnarLayout *layout = [[HAColumnarLayout alloc] init];
+    layout.delegate = self.dataSource;
+    UICollectionView *cv = [self collectionViewWithLayout:layout];
+    [layout prepareLayout];
+
+    NSIndexPath *ip = [NSIndexPath indexPathForItem:2 inSection:1];
+    UICollectionViewLayoutAttributes *before = [layout layoutAttributesForItemAtIndexPath:ip];
+    [self invalidateHeightAt:ip layout:layout collectionView:cv];
+    XCTAssertEqual([layout layoutAttributesForItemAtIndexPath:ip], before);
+}
+
+- (void)testColumnarFullInvalidationRequeriesEverything {
+    self.dataSource.itemCounts = @[@5, @5];
+    HAColumnarLayout *layout = [[HAColumnarLayout alloc] init];
+    layout.delegate = self.dataSource;
+    UICollectionView *cv = [self collectionViewWithLayout:layout];
+    [layout prepareLayout];
+
+    self.dataSource.heightQueries = 0;
+    [layout invalidateLayout];
+    [cv layoutIfNeeded];
+    [layout prepareLayout];
+    XCTAssertGreaterThanOrEqual(self.dataSource.heightQueries, 10u);
+}
+
+- (void)testColumnarEmptiedDashboardHasNoAttributes {
+    self.dataSource.itemCounts = @[@5, @5];
+    HAColumnarLayout *layout = [[HAColumnarLayout alloc] init];
+    layout.delegate = self.dataSource;
+    UICollectionView *cv = [self collectionViewWithLayout:layout];
+    [layout prepareLayout];
+    XCTAssertGreaterThan([layout layoutAttributesForElementsInRect:cv.bounds].count, 0u);
+
+    self.dataSource.itemCounts = @[];
+    [cv reloadData];
+    [layout invalidateLayout];
+    [layout prepareLayout];
+    XCTAssertEqual([layout layoutAttributesForElementsInRect:CGRectMake(0, 0, 1024, 10000)].count, 0u);
+    XCTAssertTrue(CGSizeEqualToSize(layout.collectionViewContentSize, CGSizeZero));
+}
+
+#pragma mark - Masonry Tests
+
+- (void)testMasonryReplacesFromChangedItemDown {
+    self.dataSource.itemCounts = @[@30];
+    for (NSInteger i = 0; i < 30; i++) {
+        self.dataSource.heights[[NSIndexPath indexPathForItem:i inSection:0]] = @(80 + (i * 37) % 120);
+    }
+    HAMasonryLayout *layout = [[HAMasonryLayout alloc] init];
+    layout.delegate = self.dataSource;
+    UICollectionView *cv = [self collectionViewWithLayout:layout];
+    [layout prepareLayout];
+
+    NSIndexPath *changed = [NSIndexPath indexPathForItem:12 inSection:0];
+    UICollectionViewLayoutAttributes *aboveBefore = [layout layoutAttributesForItemAtIndexPath:[NSIndexPath indexPathForItem:11 inSection:0]];
+
+    self.dataSource.heights[changed] = @500;
+    self.dataSource.heightQueries = 0;
+    [self invalidateHeightAt:changed layout:layout collectionView:cv];
+    XCTAssertEqual(self.dataSource.heightQueries, 1u);
+    XCTAssertEqual([layout layoutAttributesForItemAtIndexPath:[NSIndexPath indexPathForItem:11 inSection:0]], aboveBefore,
+                   @"Items before the change keep their attributes");
+
+    HAMasonryLayout *reference = [[HAMasonryLayout alloc] init];
+    reference.delegate = self.dataSource;
+    XCTAssertEqualObjects([self framesOfLayout:layout], [self referenceFramesForLayout:reference]);
+}
+
+- (void)testMasonryScrollDoesNotRequery {
+    self.dataSource.itemCounts = @[@20];
+    HAMasonryLayout *layout = [[HAMasonryLayout alloc] init];
+    layout.delegate = self.dataSource;
+    UICollectionView *cv = [self collectionViewWithLayout:layout];
+    [layout prepareLayout];
+
+    self.dataSource.heightQueries = 0;
+    [layout invalidateLayoutWithContext:[layout invalidationContextForBoundsChange:CGRectMake(0, 300, 1024, 768)]];
+    [layout prepareLayout];
+    XCTAssertEqual(self.dataSource.heightQueries, 0u);
+    (void)cv;
+}
+
+@end
@@ -1,5 +1,6 @@
 #import <XCTest/XCTest.h>
 #import "HAMJPEGStreamParser.h"
+#import "HAImageDecoder.h"
 #import "HAEntity.h"
 
 #pragma mark - HAMJPEGStreamParser Test Access
@@ -9,7 +10,41 @@
 @property (nonatomic, copy) NSData *boundaryData;
 - (void)extractBoundaryFromContentType:(NSString *)contentType;
 - (void)extractFrames;
+- (void)consumeData:(NSData *)data;
 - (void)decodeJPEGFromChunk:(NSData *)chunk;
+- (void)decodeJPEGData:(NSData *)jpegData;
+- (UIImage *)decodedImageFromJPEGData:(NSData *)jpegData;
+@end
+
+/// Records sliced frames instead of decoding them.
+@interface HAMJPEGFrameRecordingParser : HAMJPEGStreamParser
+@property (nonatomic, strong) NSMutableArray<NSData *> *frames;
+@end
+
+@implementation HAMJPEGFrameRecordingParser
+- (void)decodeJPEGData:(NSData *)jpegData {
+    if (!self.frames) self.frames = [NSMutableArray array];
+    [self.frames addObject:jpegData];
+}
+@end
+
+/// Decodes slowly (like an A5 with a 1080p stream) and records what it decoded.
+@interface HAMJPEGSlowDecodingParser : HAMJPEGStreamParser
+@property (nonatomic, strong) NSMutableArray<NSData *> *decodedJPEGs;
+@end
+
+@implementation HAMJPEGSlowDecodingParser
+- (UIImage *)decodedImageFromJPEGData:(NSData *)jpegData {
+    [NSThread sleepForTimeInterval:0.05];
+    @synchronized (self) {
+        if (!self.decodedJPEGs) self.decodedJPEGs = [NSMutableArray array];
+        [self.decodedJPEGs addObject:jpegData];
+    }
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(1, 1), YES, 1.0);
+    UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+    return image;
+}
 @end
 
 #pragma mark - MJPEG Parser Tests
@@ -108,8 +143,8 @@
     // Extract frames
     [self.parser extractFrames];
 
-    // The first frame should be extracted (between start and boundary)
-    // The second frame has no trailing boundary yet, so stays in buffer
+    // Both parts carry Content-Length, so both are sliced without waiting
+    // for a trailing boundary.
     // Frame decoding is async, so we just verify the buffer was consumed
     XCTAssertTrue(self.parser.buffer.length < body.length,
                   @"Buffer should be partially consumed after frame extraction");
@@ -140,6 +175,269 @@
 
 @end
 
+#pragma mark - Frame Slicing Tests
+
+@interface HAMJPEGFrameSlicingTests : XCTestCase
+@property (nonatomic, strong) HAMJPEGFrameRecordingParser *parser;
+@end
+
+@implementation HAMJPEGFrameSlicingTests
+
+- (void)setUp {
+    [super setUp];
+    [self resetParser];
+}
+
+- (void)resetParser {
+    [self.parser stop];
+    self.parser = [[HAMJPEGFrameRecordingParser alloc] init];
+    self.parser.buffer = [NSMutableData data];
+    [self.parser extractBoundaryFromContentType:@"multipart/x-mixed-replace;boundary=frame"];
+    [self.parser setValue:@YES forKey:@"streaming"];
+}
+
+- (void)tearDown {
+    [self.parser stop];
+    self.parser = nil;
+    [super tearDown];
+}
+
+/// SOI, pseudo-random payload, EOI. The payload deliberately contains a
+/// blank line and a second SOI, which must not confuse slicing.
+- (NSData *)fakeJPEGOfLength:(NSUInteger)length seed:(uint32_t)seed {
+    NSMutableData *data = [NSMutableData dataWithLength:length];
+    uint8_t *bytes = data.mutableBytes;
+    uint32_t state = seed * 2654435761u + 1;
+    for (NSUInteger i = 0; i < length; i++) {
+        state = state * 1664525u + 1013904223u;
+        bytes[i] = (uint8_t)(state >> 24);
+    }
+    bytes[0] = 0xFF; bytes[1] = 0xD8;
+    memcpy(bytes + length / 3, "\r\n\r\n", 4);
+    bytes[length / 2] = 0xFF; bytes[length / 2 + 1] = 0xD8;
+    bytes[length - 2] = 0xFF; bytes[length - 1] = 0xD9;
+    return data;
+}
+
+/// Framing as Home Assistant's camera_proxy_stream sends it.
+- (NSData *)streamWithFrames:(NSArray<NSData *> *)frames contentLength:(BOOL)contentLength {
+    NSMutableData *stream = [NSMutableData data];
+    for (NSData *frame in frames) {
+        NSString *headers = contentLength
+            ? [NSString stringWithFormat:@"--frame\r\nContent-Type: image/jpeg\r\nContent-Length: %lu\r\n\r\n", (unsigned long)frame.length]
+            : @"--frame\r\nContent-Type: image/jpeg\r\n\r\n";
+        [stream appendData:[headers dataUsingEncoding:NSUTF8StringEncoding]];
+        [stream appendData:frame];
+        [stream appendData:[@"\r\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    }
+    return stream;
+}
+
+- (void)feed:(NSData *)stream chunkSize:(NSUInteger)chunkSize {
+    for (NSUInteger offset = 0; offset < stream.length; offset += chunkSize) {
+        NSUInteger length = MIN(chunkSize, stream.length - offset);
+        [self.parser consumeData:[stream subdataWithRange:NSMakeRange(offset, length)]];
+    }
+}
+
+- (void)testContentLengthFramesAreSlicedExactly {
+    NSArray *frames = @[[self fakeJPEGOfLength:5000 seed:1], [self fakeJPEGOfLength:300 seed:2],
+                        [self fakeJPEGOfLength:12000 seed:3]];
+    [self feed:[self streamWithFrames:frames contentLength:YES] chunkSize:NSUIntegerMax];
+
+    XCTAssertEqualObjects(self.parser.frames, frames, @"Each part should be cut at its Content-Length");
+    XCTAssertLessThanOrEqual(self.parser.buffer.length, (NSUInteger)2, @"Only the trailing CRLF should remain");
+}
+
+- (void)testChunkedDeliveryMatchesWholeDelivery {
+    NSArray *frames = @[[self fakeJPEGOfLength:4000 seed:4], [self fakeJPEGOfLength:4001 seed:5],
+                        [self fakeJPEGOfLength:150 seed:6], [self fakeJPEGOfLength:9000 seed:7]];
+    NSData *stream = [self streamWithFrames:frames contentLength:YES];
+
+    for (NSNumber *chunkSize in @[@1, @7, @1024, @4096]) {
+        [self resetParser];
+        [self feed:stream chunkSize:chunkSize.unsignedIntegerValue];
+        XCTAssertEqualObjects(self.parser.frames, frames, @"Chunk size %@ should not change the frames", chunkSize);
+    }
+}
+
+- (void)testBoundaryFallbackWithoutContentLength {
+    NSArray *frames = @[[self fakeJPEGOfLength:3000 seed:8], [self fakeJPEGOfLength:3000 seed:9],
+                        [self fakeJPEGOfLength:3000 seed:10]];
+    [self feed:[self streamWithFrames:frames contentLength:NO] chunkSize:512];
+
+    // The last part has no boundary after it yet, so it stays buffered
+    XCTAssertEqual(self.parser.frames.count, 2u);
+    XCTAssertEqualObjects(self.parser.frames[0], frames[0]);
+    XCTAssertEqualObjects(self.parser.frames[1], frames[1]);
+}
+
+- (void)testMisleadingContentLengthFallsBackToBoundary {
+    NSData *jpeg = [self fakeJPEGOfLength:2000 seed:11];
+    NSMutableData *stream = [NSMutableData data];
+    // Stray CRLF between headers and JPEG: Content-Length no longer points at the SOI
+    NSString *headers = [NSString stringWithFormat:@"--frame\r\nContent-Length: %lu\r\n\r\n\r\n", (unsigned long)jpeg.length];
+    [stream appendData:[headers dataUsingEncoding:NSUTF8StringEncoding]];
+    [stream appendData:jpeg];
+    [stream appendData:[@"\r\n--frame\r\n" dataUsingEncoding:NSUTF8StringEncoding]];
+    [self feed:stream chunkSize:NSUIntegerMax];
+
+    XCTAssertEqual(self.parser.frames.count, 1u);
+    XCTAssertEqualObjects(self.parser.frames.firstObject, jpeg);
+}
+
+- (void)testBufferStaysBoundedAcrossManyFrames {
+    NSMutableArray *frames = [NSMutableArray array];
+    for (uint32_t i = 0; i < 50; i++) [frames addObject:[self fakeJPEGOfLength:20000 + i * 37 seed:i]];
+    NSData *stream = [self streamWithFrames:frames contentLength:YES];
+
+    NSUInteger chunkSize = 16 * 1024;
+    NSUInteger maxBuffered = 0;
+    for (NSUInteger offset = 0; offset < stream.length; offset += chunkSize) {
+        NSUInteger length = MIN(chunkSize, stream.length - offset);
+        [self.parser consumeData:[stream subdataWithRange:NSMakeRange(offset, length)]];
+        maxBuffered = MAX(maxBuffered, self.parser.buffer.length);
+    }
+    XCTAssertEqual(self.parser.frames.count, frames.count);
+    XCTAssertLessThanOrEqual(maxBuffered, 2 * 22000 + chunkSize,
+                             @"Consumed bytes should be dropped instead of accumulating");
+}
+
+- (void)testPerformanceParsingStream {
+    // 100 frames of ~200 KB (a 10 fps 720p camera for 10 s), in 16 KB reads
+    NSMutableArray *frames = [NSMutableArray array];
+    for (uint32_t i = 0; i < 100; i++) [frames addObject:[self fakeJPEGOfLength:200000 + i * 101 seed:i]];
+    NSData *stream = [self streamWithFrames:frames contentLength:YES];
+    NSMutableArray<NSData *> *chunks = [NSMutableArray array];
+    for (NSUInteger offset = 0; offset < stream.length; offset += 16 * 1024) {
+        [chunks addObject:[stream subdataWithRange:NSMakeRange(offset, MIN(16 * 1024, stream.length - offset))]];
+    }
+
+    [self measureBlock:^{
+        [self resetParser];
+        for (NSData *chunk in chunks) [self.parser consumeData:chunk];
+        XCTAssertEqual(self.parser.frames.count, frames.count);
+    }];
+}
+
+@end
+
+#pragma mark - Decode Backpressure Tests
+
+@interface HAMJPEGDecodeBackpressureTests : XCTestCase
+@end
+
+@implementation HAMJPEGDecodeBackpressureTests
+
+- (NSData *)frameWithMarker:(uint8_t)marker {
+    NSMutableData *data = [NSMutableData dataWithLength:200];
+    uint8_t *bytes = data.mutableBytes;
+    bytes[0] = 0xFF; bytes[1] = 0xD8;
+    bytes[100] = marker;
+    return data;
+}
+
+- (void)testBurstKeepsOnlyNewestFrame {
+    HAMJPEGSlowDecodingParser *parser = [[HAMJPEGSlowDecodingParser alloc] init];
+    [parser setValue:@YES forKey:@"streaming"];
+    __block NSUInteger delivered = 0;
+    parser.frameHandler = ^(UIImage *frame) { delivered++; };
+
+    // 20 frames arrive faster than one decode takes
+    NSUInteger total = 20;
+    for (uint8_t i = 0; i < total; i++) {
+        [parser decodeJPEGData:[self frameWithMarker:i]];
+    }
+
+    [self expectationForPredicate:[NSPredicate predicateWithBlock:^BOOL(HAMJPEGSlowDecodingParser *p, NSDictionary *bindings) {
+        return p.decodedFrameCount + p.droppedFrameCount >= total && delivered > 0;
+    }] evaluatedWithObject:parser handler:nil];
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+
+    XCTAssertLessThanOrEqual(parser.decodedFrameCount, 2u, @"Superseded frames should not be decoded");
+    XCTAssertGreaterThanOrEqual(parser.droppedFrameCount, total - 2, @"Every superseded frame is counted");
+    NSData *last;
+    @synchronized (parser) { last = parser.decodedJPEGs.lastObject; }
+    XCTAssertEqual(((const uint8_t *)last.bytes)[100], total - 1, @"The newest frame should be the one decoded");
+    [parser stop];
+}
+
+- (void)testStopDiscardsPendingFrame {
+    HAMJPEGSlowDecodingParser *parser = [[HAMJPEGSlowDecodingParser alloc] init];
+    [parser setValue:@YES forKey:@"streaming"];
+    parser.frameHandler = ^(UIImage *frame) { XCTFail(@"No frame should be delivered after stop"); };
+    [parser decodeJPEGData:[self frameWithMarker:1]];
+    [parser decodeJPEGData:[self frameWithMarker:2]];
+    [parser stop];
+
+    XCTestExpectation *settle = [self expectationWithDescription:@"decoder idle"];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(0.3 * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [settle fulfill];
+    });
+    [self waitForExpectationsWithTimeout:5 handler:nil];
+    XCTAssertLessThanOrEqual(parser.decodedJPEGs.count, 1u);
+}
+
+@end
+
+#pragma mark - Image Decoder Tests
+
+@interface HAImageDecoderTests : XCTestCase
+@end
+
+@implementation HAImageDecoderTests
+
+- (NSData *)jpegOfPixelSize:(CGSize)size {
+    UIGraphicsBeginImageContextWithOptions(size, YES, 1.0);
+    [[UIColor colorWithRed:0.2 green:0.4 blue:0.6 alpha:1] setFill];
+    UIRectFill(CGRectMake(0, 0, size.width, size.height));
+    [[UIColor whiteColor] setFill];
+    UIRectFill(CGRectMake(size.width / 4, size.height / 4, size.width / 2, size.height / 2));
+    UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+    return UIImageJPEGRepresentation(image, 0.8);
+}
+
+- (void)testDownsamplesToFillTarget {
+    NSData *jpeg = [self jpegOfPixelSize:CGSizeMake(1600, 900)];
+    UIImage *image = [HAImageDecoder decodedImageWithData:jpeg fillingPixelSize:CGSizeMake(320, 240)];
+    XCTAssertNotNil(image);
+    size_t width = CGImageGetWidth(image.CGImage), height = CGImageGetHeight(image.CGImage);
+    // 16:9 aspect-filling 4:3 — height is the binding side
+    XCTAssertGreaterThanOrEqual(height, 240u, @"Decoded image must still cover the tile");
+    XCTAssertLessThanOrEqual(width, 428u, @"Decoded image should not be much larger than needed");
+}
+
+- (void)testFullResolutionWhenTargetIsZeroOrLarger {
+    NSData *jpeg = [self jpegOfPixelSize:CGSizeMake(640, 480)];
+    UIImage *full = [HAImageDecoder decodedImageWithData:jpeg fillingPixelSize:CGSizeZero];
+    XCTAssertEqual(CGImageGetWidth(full.CGImage), 640u);
+    XCTAssertEqual(CGImageGetHeight(full.CGImage), 480u);
+
+    UIImage *larger = [HAImageDecoder decodedImageWithData:jpeg fillingPixelSize:CGSizeMake(2048, 1536)];
+    XCTAssertEqual(CGImageGetWidth(larger.CGImage), 640u, @"Never upscale while decoding");
+}
+
+- (void)testInvalidDataReturnsNil {
+    uint8_t garbage[] = {0xFF, 0xD8, 0x00, 0x01, 0x02, 0x03};
+    XCTAssertNil([HAImageDecoder decodedImageWithData:[NSData dataWithBytes:garbage length:sizeof(garbage)]
+                                     fillingPixelSize:CGSizeMake(100, 100)]);
+    XCTAssertNil([HAImageDecoder decodedImageWithData:nil fillingPixelSize:CGSizeZero]);
+}
+
+- (void)testPerformanceTileDecodeOfLargeFrame {
+    NSData *jpeg = [self jpegOfPixelSize:CGSizeMake(2560, 1440)];
+    [self measureBlock:^{
+        for (int i = 0; i < 10; i++) {
+            @autoreleasepool {
+                [HAImageDecoder decodedImageWithData:jpeg fillingPixelSize:CGSizeMake(640, 480)];
+            }
+        }
+    }];
+}
+
+@end
+
 #pragma mark - Camera Entity Tests
 
 @interface HACameraStreamPathTests : XCTestCase
@@ -0,0 +1,91 @@
+#import <XCTest/XCTest.h>
+#import <UIKit/UIKit.h>
+#import "HAPerfMonitor.h"
+#import "HACameraEntityCell.h"
+
+#pragma mark - HAPerfMonitor Test Access
+
+@interface HAPerfMonitor (TestAccess)
+@property (atomic, assign) BOOL collecting;
+- (NSArray *)takeCameraWindows;
+@end
+
+@interface HACameraEntityCell (TestAccess)
+@property (nonatomic, copy) NSString *currentEntityId;
+@property (nonatomic, assign) BOOL hlsFailed;
+@end
+
+#pragma mark - Perf Monitor Camera Tests
+
+@interface HAPerfMonitorTests : XCTestCase
+@property (nonatomic, strong) HAPerfMonitor *monitor;
+@end
+
+@implementation HAPerfMonitorTests
+
+- (void)setUp {
+    [super setUp];
+    // Collect without the display link and log file that start brings
+    self.monitor = [HAPerfMonitor sharedMonitor];
+    [self.monitor takeCameraWindows];
+    self.monitor.collecting = YES;
+}
+
+- (void)tearDown {
+    self.monitor.collecting = NO;
+    [self.monitor takeCameraWindows];
+    [super tearDown];
+}
+
+/// The window taken for entityId, or nil if the camera has none.
+- (id)windowForEntityId:(NSString *)entityId {
+    for (id window in [self.monitor takeCameraWindows]) {
+        if ([[window valueForKey:@"entityId"] isEqualToString:entityId]) return window;
+    }
+    return nil;
+}
+
+- (void)testBytesAreSummedPerCamera {
+    [self.monitor recordCameraBytes:1000 forEntityId:@"camera.front"];
+    [self.monitor recordCameraBytes:500 forEntityId:@"camera.front"];
+    [self.monitor recordCameraBytes:7 forEntityId:@"camera.back"];
+
+    NSArray *windows = [self.monitor takeCameraWindows];
+    XCTAssertEqual(windows.count, 2u);
+    XCTAssertEqualObjects([windows[0] valueForKey:@"entityId"], @"camera.back", @"sorted by entity id");
+    XCTAssertEqual([[windows[0] valueForKey:@"bytes"] unsignedLongLongValue], 7ull);
+    XCTAssertEqual([[windows[1] valueForKey:@"bytes"] unsignedLongLongValue], 1500ull);
+}
+
+- (void)testFramesAreCountedAndResetPerWindow {
+    for (NSUInteger i = 0; i < 3; i++) {
+        [self.monitor recordCameraFrameForEntityId:@"camera.front"];
+    }
+    XCTAssertEqual([[[self windowForEntityId:@"camera.front"] valueForKey:@"frames"] unsignedIntegerValue], 3u);
+
+    id idle = [self windowForEntityId:@"camera.front"];
+    XCTAssertNotNil(idle, @"cameras stay listed while the monitor runs");
+    XCTAssertEqual([[idle valueForKey:@"frames"] unsignedIntegerValue], 0u);
+}
+
+- (void)testNothingIsRecordedWhileStopped {
+    self.monitor.collecting = NO;
+    [self.monitor recordCameraFrameForEntityId:@"camera.front"];
+    [self.monitor recordCameraBytes:1000 forEntityId:@"camera.front"];
+    XCTAssertNil([self windowForEntityId:@"camera.front"]);
+}
+
+- (void)testHlsFallbackIsCountedOnce {
+    HACameraEntityCell *cell = [[HACameraEntityCell alloc] initWithFrame:CGRectMake(0, 0, 300, 200)];
+    cell.currentEntityId = @"camera.front";
+    cell.hlsFailed = YES;
+    cell.hlsFailed = YES;
+
+    // iOS 9 never tries HLS, so giving it up there is no fallback
+    NSUInteger expected = ([[[UIDevice currentDevice] systemVersion] compare:@"10.0"
+                                                                       options:NSNumericSearch] == NSOrderedAscending) ? 0 : 1;
+    id window = [self windowForEntityId:@"camera.front"];
+    XCTAssertEqual([[window valueForKey:@"fallbacks"] unsignedIntegerValue], expected);
+}
+
+@end
@@ -0,0 +1,152 @@
+#import <XCTest/XCTest.h>
+#import "HARequestCoalescer.h"
+
+#pragma mark - Request Coalescer Tests
+
+@interface HARequestCoalescerTests : XCTestCase
+@property (nonatomic, strong) HARequestCoalescer *coalescer;
+@property (nonatomic, assign) NSUInteger starts;
+@property (nonatomic, assign) NSUInteger cancels;
+@property (nonatomic, copy) HARequestFinishBlock finish;
+@end
+
+@implementation HARequestCoalescerTests
+
+- (void)setUp {
+    [super setUp];
+    self.coalescer = [[HARequestCoalescer alloc] initWithFreshness:60.0];
+    self.starts = 0;
+    self.cancels = 0;
+    self.finish = nil;
+}
+
+/// Records the start and keeps finish for the test to call.
+- (HARequestStartBlock)startBlockCancellable:(BOOL)cancellable {
+    return ^dispatch_block_t(HARequestFinishBlock finish) {
+        self.starts++;
+        self.finish = finish;
+        if (!cancellable) return nil;
+        return ^{ self.cancels++; };
+    };
+}
+
+- (void)testConcurrentLoadsShareOneRequest {
+    XCTestExpectation *first = [self expectationWithDescription:@"first"];
+    XCTestExpectation *second = [self expectationWithDescription:@"second"];
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:^(id result, NSError *error) {
+        XCTAssertEqualObjects(result, @"A");
+        [first fulfill];
+    }];
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:^(id result, NSError *error) {
+        XCTAssertEqualObjects(result, @"A");
+        [second fulfill];
+    }];
+    XCTAssertEqual(self.starts, 1u);
+    XCTAssertTrue([self.coalescer isLoadingKey:@"a"]);
+
+    self.finish(@"A", nil);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertFalse([self.coalescer isLoadingKey:@"a"]);
+}
+
+- (void)testFreshResultIsReused {
+    XCTestExpectation *loaded = [self expectationWithDescription:@"loaded"];
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:^(id result, NSError *error) {
+        [loaded fulfill];
+    }];
+    self.finish(@"A", nil);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    XCTestExpectation *reused = [self expectationWithDescription:@"reused"];
+    HARequestInterest *interest = [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES]
+                                               completion:^(id result, NSError *error) {
+        XCTAssertEqualObjects(result, @"A");
+        [reused fulfill];
+    }];
+    XCTAssertNil(interest);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertEqual(self.starts, 1u);
+    XCTAssertEqualObjects([self.coalescer freshResultForKey:@"a"], @"A");
+}
+
+- (void)testStaleResultIsLoadedAgain {
+    self.coalescer = [[HARequestCoalescer alloc] initWithFreshness:0];
+    XCTestExpectation *loaded = [self expectationWithDescription:@"loaded"];
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:^(id result, NSError *error) {
+        [loaded fulfill];
+    }];
+    self.finish(@"A", nil);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:nil];
+    XCTAssertEqual(self.starts, 2u);
+}
+
+- (void)testErrorsAreNotKept {
+    XCTestExpectation *failed = [self expectationWithDescription:@"failed"];
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:^(id result, NSError *error) {
+        XCTAssertNotNil(error);
+        [failed fulfill];
+    }];
+    self.finish(nil, [NSError errorWithDomain:@"test" code:1 userInfo:nil]);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertNil([self.coalescer freshResultForKey:@"a"]);
+}
+
+- (void)testRequestCancelledWhenLastInterestLeaves {
+    HARequestInterest *prefetch = [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:nil];
+    HARequestInterest *cell = [self.coalescer joinKey:@"a" completion:nil];
+    XCTAssertNotNil(cell);
+
+    [prefetch cancel];
+    XCTAssertEqual(self.cancels, 0u, @"the cell still wants it");
+    XCTAssertTrue([self.coalescer isLoadingKey:@"a"]);
+
+    [cell cancel];
+    [cell cancel];
+    XCTAssertEqual(self.cancels, 1u);
+    XCTAssertFalse([self.coalescer isLoadingKey:@"a"]);
+    XCTAssertNil([self.coalescer joinKey:@"a" completion:nil]);
+}
+
+- (void)testCancelledInterestGetsNoCallback {
+    __block BOOL called = NO;
+    HARequestInterest *gone = [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES]
+                                           completion:^(id result, NSError *error) { called = YES; }];
+    XCTestExpectation *stays = [self expectationWithDescription:@"stays"];
+    [self.coalescer joinKey:@"a" completion:^(id result, NSError *error) { [stays fulfill]; }];
+    [gone cancel];
+    self.finish(@"A", nil);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+    XCTAssertFalse(called);
+}
+
+- (void)testUncancellableLoadStaysJoinable {
+    HARequestInterest *prefetch = [self.coalescer loadKey:@"a" start:[self startBlockCancellable:NO] completion:nil];
+    [prefetch cancel];
+    XCTAssertTrue([self.coalescer isLoadingKey:@"a"]);
+
+    XCTestExpectation *joined = [self expectationWithDescription:@"joined"];
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:NO] completion:^(id result, NSError *error) {
+        XCTAssertEqualObjects(result, @"A");
+        [joined fulfill];
+    }];
+    XCTAssertEqual(self.starts, 1u);
+    self.finish(@"A", nil);
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+- (void)testFinishFromBackgroundThreadCompletesOnMain {
+    XCTestExpectation *loaded = [self expectationWithDescription:@"loaded"];
+    [self.coalescer loadKey:@"a" start:[self startBlockCancellable:YES] completion:^(id result, NSError *error) {
+        XCTAssertTrue([NSThread isMainThread]);
+        [loaded fulfill];
+    }];
+    HARequestFinishBlock finish = self.finish;
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        finish(@"A", nil);
+    });
+    [self waitForExpectationsWithTimeout:2.0 handler:nil];
+}
+
+@end
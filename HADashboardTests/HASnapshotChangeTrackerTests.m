@@ -0,0 +1,104 @@
+#import <XCTest/XCTest.h>
+#import "HASnapshotChangeTracker.h"
+
+#pragma mark - Snapshot Change Tracker Tests
+
+@interface HASnapshotChangeTrackerTests : XCTestCase
+@property (nonatomic, strong) HASnapshotChangeTracker *tracker;
+@end
+
+@implementation HASnapshotChangeTrackerTests
+
+- (void)setUp {
+    [super setUp];
+    self.tracker = [[HASnapshotChangeTracker alloc] init];
+}
+
+- (NSHTTPURLResponse *)responseWithStatus:(NSInteger)status headers:(NSDictionary *)headers {
+    return [[NSHTTPURLResponse alloc] initWithURL:[NSURL URLWithString:@"http://ha.local/api/camera_proxy/camera.door"]
+                                       statusCode:status
+                                      HTTPVersion:@"HTTP/1.1"
+                                     headerFields:headers];
+}
+
+- (NSData *)jpegWithMarker:(uint8_t)marker {
+    uint8_t bytes[] = {0xFF, 0xD8, 0x00, 0x10, marker, 0x42, 0xFF, 0xD9};
+    return [NSData dataWithBytes:bytes length:sizeof(bytes)];
+}
+
+- (void)testFirstSnapshotIsAlwaysChanged {
+    XCTAssertTrue([self.tracker recordResponse:[self responseWithStatus:200 headers:nil] data:[self jpegWithMarker:1]]);
+    XCTAssertEqual(self.tracker.unchangedStreak, 0u);
+}
+
+- (void)testIdenticalBytesAreUnchanged {
+    NSHTTPURLResponse *ok = [self responseWithStatus:200 headers:nil];
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    XCTAssertFalse([self.tracker recordResponse:ok data:[self jpegWithMarker:1]]);
+    XCTAssertFalse([self.tracker recordResponse:ok data:[self jpegWithMarker:1]]);
+    XCTAssertEqual(self.tracker.unchangedStreak, 2u);
+
+    XCTAssertTrue([self.tracker recordResponse:ok data:[self jpegWithMarker:2]]);
+    XCTAssertEqual(self.tracker.unchangedStreak, 0u);
+}
+
+- (void)testNotModifiedIsUnchanged {
+    NSHTTPURLResponse *ok = [self responseWithStatus:200 headers:@{@"ETag": @"\"abc\""}];
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    XCTAssertFalse([self.tracker recordResponse:[self responseWithStatus:304 headers:nil] data:[NSData data]]);
+    XCTAssertEqual(self.tracker.unchangedStreak, 1u);
+}
+
+- (void)testETagIsSentBack {
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"http://ha.local/"]];
+    [self.tracker applyToRequest:request];
+    XCTAssertNil([request valueForHTTPHeaderField:@"If-None-Match"], @"No ETag seen yet");
+
+    [self.tracker recordResponse:[self responseWithStatus:200 headers:@{@"ETag": @"\"abc\""}] data:[self jpegWithMarker:1]];
+    [self.tracker applyToRequest:request];
+    XCTAssertEqualObjects([request valueForHTTPHeaderField:@"If-None-Match"], @"\"abc\"");
+}
+
+- (void)testIntervalDoublesAndCaps {
+    NSHTTPURLResponse *ok = [self responseWithStatus:200 headers:nil];
+    self.tracker.maxInterval = 60.0;
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    XCTAssertEqualWithAccuracy([self.tracker intervalForBaseInterval:5.0], 5.0, 0.001);
+
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    XCTAssertEqualWithAccuracy([self.tracker intervalForBaseInterval:5.0], 10.0, 0.001);
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    XCTAssertEqualWithAccuracy([self.tracker intervalForBaseInterval:5.0], 20.0, 0.001);
+
+    for (int i = 0; i < 40; i++) {
+        [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    }
+    XCTAssertEqualWithAccuracy([self.tracker intervalForBaseInterval:5.0], 60.0, 0.001);
+    // A base above the cap is never shortened
+    XCTAssertEqualWithAccuracy([self.tracker intervalForBaseInterval:90.0], 90.0, 0.001);
+
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:2]];
+    XCTAssertEqualWithAccuracy([self.tracker intervalForBaseInterval:5.0], 5.0, 0.001);
+}
+
+- (void)testResetForgetsLastImage {
+    NSHTTPURLResponse *ok = [self responseWithStatus:200 headers:@{@"ETag": @"\"abc\""}];
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    [self.tracker recordResponse:ok data:[self jpegWithMarker:1]];
+    [self.tracker reset];
+
+    XCTAssertEqual(self.tracker.unchangedStreak, 0u);
+    NSMutableURLRequest *request = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"http://ha.local/"]];
+    [self.tracker applyToRequest:request];
+    XCTAssertNil([request valueForHTTPHeaderField:@"If-None-Match"]);
+    XCTAssertTrue([self.tracker recordResponse:ok data:[self jpegWithMarker:1]]);
+}
+
+- (void)testDigestDistinguishesSingleByte {
+    XCTAssertNotEqual([HASnapshotChangeTracker digestOfData:[self jpegWithMarker:1]],
+                      [HASnapshotChangeTracker digestOfData:[self jpegWithMarker:2]]);
+    XCTAssertEqual([HASnapshotChangeTracker digestOfData:[self jpegWithMarker:3]],
+                   [HASnapshotChangeTracker digestOfData:[self jpegWithMarker:3]]);
+}
+
+@end
@@ -0,0 +1,104 @@
+#import <XCTest/XCTest.h>
+#import <QuartzCore/QuartzCore.h>
+#import "HAUpdateFlusher.h"
+
+#pragma mark - Update Flusher Tests
+
+@interface HAUpdateFlusherTests : XCTestCase <HAUpdateFlusherDelegate>
+@property (nonatomic, strong) HAUpdateFlusher *flusher;
+@property (nonatomic, strong) NSMutableArray<NSIndexPath *> *flushed;
+@property (nonatomic, assign) NSUInteger flushCalls;
+@end
+
+@implementation HAUpdateFlusherTests
+
+- (void)setUp {
+    [super setUp];
+    self.flusher = [[HAUpdateFlusher alloc] init];
+    self.flusher.delegate = self;
+    self.flusher.coalesceInterval = 0.1;
+    self.flusher.maxLatency = 0.5;
+    self.flushed = [NSMutableArray array];
+    self.flushCalls = 0;
+}
+
+- (void)tearDown {
+    [self.flusher invalidate];
+    [super tearDown];
+}
+
+- (void)updateFlusher:(HAUpdateFlusher *)flusher flushIndexPaths:(NSArray<NSIndexPath *> *)indexPaths {
+    self.flushCalls++;
+    [self.flushed addObjectsFromArray:indexPaths];
+}
+
+- (NSArray<NSIndexPath *> *)paths:(NSUInteger)count {
+    NSMutableArray *paths = [NSMutableArray array];
+    for (NSUInteger i = 0; i < count; i++) [paths addObject:[NSIndexPath indexPathForItem:i inSection:0]];
+    return paths;
+}
+
+- (void)testWaitsForCoalesceInterval {
+    CFTimeInterval start = CACurrentMediaTime();
+    [self.flusher enqueueIndexPaths:[self paths:3]];
+    [self.flusher flushDueIndexPathsAtTime:start];
+    XCTAssertEqual(self.flushed.count, 0u);
+
+    [self.flusher flushDueIndexPathsAtTime:start + 0.2];
+    XCTAssertEqual(self.flushed.count, 3u);
+    XCTAssertEqual(self.flusher.pendingCount, 0u);
+}
+
+- (void)testReenqueueDoesNotPostpone {
+    CFTimeInterval start = CACurrentMediaTime();
+    NSArray *paths = [self paths:1];
+    [self.flusher enqueueIndexPaths:paths];
+    // A sensor reporting faster than the coalesce interval
+    for (NSUInteger i = 0; i < 5; i++) [self.flusher enqueueIndexPaths:paths];
+    [self.flusher flushDueIndexPathsAtTime:start + 0.15];
+    XCTAssertEqualObjects(self.flushed, paths);
+}
+
+- (void)testBudgetSpreadsOverFrames {
+    self.flusher.frameBudget = 0;
+    CFTimeInterval start = CACurrentMediaTime();
+    [self.flusher enqueueIndexPaths:[self paths:10]];
+
+    [self.flusher flushDueIndexPathsAtTime:start + 0.2];
+    XCTAssertEqual(self.flushCalls, 1u, @"One batch per frame with no budget");
+    XCTAssertEqual(self.flushed.count, 4u);
+    [self.flusher flushDueIndexPathsAtTime:start + 0.22];
+    XCTAssertEqual(self.flushed.count, 8u);
+    [self.flusher flushDueIndexPathsAtTime:start + 0.24];
+    XCTAssertEqual(self.flushed.count, 10u);
+    XCTAssertEqual([NSSet setWithArray:self.flushed].count, 10u);
+}
+
+- (void)testOverduePathsIgnoreBudget {
+    self.flusher.frameBudget = 0;
+    CFTimeInterval start = CACurrentMediaTime();
+    [self.flusher enqueueIndexPaths:[self paths:10]];
+    [self.flusher flushDueIndexPathsAtTime:start + 0.6];
+    XCTAssertEqual(self.flushed.count, 10u, @"Everything past maxLatency goes at once");
+}
+
+- (void)testPriorityPathSkipsCoalescing {
+    CFTimeInterval start = CACurrentMediaTime();
+    NSIndexPath *touched = [NSIndexPath indexPathForItem:7 inSection:1];
+    [self.flusher prioritizeIndexPath:touched forDuration:3.0];
+    [self.flusher enqueueIndexPaths:[[self paths:2] arrayByAddingObject:touched]];
+    [self.flusher flushDueIndexPathsAtTime:start];
+    XCTAssertEqualObjects(self.flushed, @[touched]);
+    XCTAssertEqual(self.flusher.pendingCount, 2u, @"The others still coalesce");
+}
+
+- (void)testRemoveAllPending {
+    CFTimeInterval start = CACurrentMediaTime();
+    [self.flusher enqueueIndexPaths:[self paths:3]];
+    [self.flusher removeAllPending];
+    XCTAssertEqual(self.flusher.pendingCount, 0u);
+    [self.flusher flushDueIndexPathsAtTime:start + 1.0];
+    XCTAssertEqual(self.flushed.count, 0u);
+}
+
+@end
@@ -0,0 +1,168 @@
+#import <XCTest/XCTest.h>
+#import "HAVisibilityEngine.h"
+#import "HADashboardConfig.h"
+#import "HAEntity.h"
+
+#pragma mark - Visibility Engine Tests
+
+@interface HAVisibilityEngineTests : XCTestCase
+@property (nonatomic, strong) NSMutableDictionary<NSString *, HAEntity *> *entities;
+@end
+
+@implementation HAVisibilityEngineTests
+
+- (void)setUp {
+    [super setUp];
+    self.entities = [NSMutableDictionary dictionary];
+}
+
+- (void)setState:(NSString *)state forEntityId:(NSString *)entityId {
+    self.entities[entityId] = [[HAEntity alloc] initWithDictionary:@{@"entity_id": entityId, @"state": state, @"attributes": @{}}];
+}
+
+- (HADashboardConfigItem *)item:(NSString *)entityId conditions:(NSArray *)conditions {
+    HADashboardConfigItem *item = [[HADashboardConfigItem alloc] init];
+    item.entityId = entityId;
+    item.cardType = @"tile";
+    item.visibilityConditions = conditions;
+    return item;
+}
+
+- (HADashboardConfig *)configWithItems:(NSArray<HADashboardConfigItem *> *)items {
+    HADashboardConfigSection *section = [[HADashboardConfigSection alloc] init];
+    section.items = items;
+    HADashboardConfig *config = [[HADashboardConfig alloc] init];
+    config.sections = @[section];
+    return config;
+}
+
+- (BOOL)met:(NSDictionary *)condition {
+    return [HAVisibilityEngine isConditionMet:condition withEntities:self.entities screenSize:CGSizeMake(768, 1024)];
+}
+
+#pragma mark - Condition Tests
+
+- (void)testLegacyStateCondition {
+    [self setState:@"on" forEntityId:@"light.a"];
+    XCTAssertTrue([self met:@{@"entity": @"light.a", @"state": @"on"}]);
+    XCTAssertFalse([self met:@{@"entity": @"light.a", @"state": @"off"}]);
+    XCTAssertFalse([self met:@{@"entity": @"light.a", @"state_not": @"on"}]);
+    XCTAssertTrue([self met:@{@"entity": @"light.a", @"state_not": @"off"}]);
+}
+
+- (void)testStateListAndNumber {
+    [self setState:@"3" forEntityId:@"input_number.x"];
+    XCTAssertTrue([self met:@{@"condition": @"state", @"entity": @"input_number.x", @"state": @[@"2", @"3"]}]);
+    XCTAssertTrue([self met:@{@"condition": @"state", @"entity": @"input_number.x", @"state": @3}]);
+    XCTAssertFalse([self met:@{@"condition": @"state", @"entity": @"input_number.x", @"state_not": @[@"3"]}]);
+}
+
+- (void)testMissingEntityHasEmptyState {
+    XCTAssertFalse([self met:@{@"entity": @"light.gone", @"state": @"on"}]);
+    XCTAssertTrue([self met:@{@"entity": @"light.gone", @"state_not": @"on"}]);
+}
+
+- (void)testNumericState {
+    [self setState:@"21.5" forEntityId:@"sensor.t"];
+    XCTAssertTrue([self met:@{@"condition": @"numeric_state", @"entity": @"sensor.t", @"above": @20, @"below": @"22"}]);
+    XCTAssertFalse([self met:@{@"condition": @"numeric_state", @"entity": @"sensor.t", @"above": @21.5}]);
+    XCTAssertFalse([self met:@{@"condition": @"numeric_state", @"entity": @"sensor.t", @"below": @21}]);
+
+    [self setState:@"25" forEntityId:@"input_number.limit"];
+    XCTAssertTrue([self met:@{@"condition": @"numeric_state", @"entity": @"sensor.t", @"below": @"input_number.limit"}]);
+
+    [self setState:@"unavailable" forEntityId:@"sensor.t"];
+    XCTAssertFalse([self met:@{@"condition": @"numeric_state", @"entity": @"sensor.t", @"above": @0}]);
+}
+
+- (void)testScreenCondition {
+    CGSize portrait = CGSizeMake(768, 1024), landscape = CGSizeMake(1024, 768);
+    NSDictionary *wide = @{@"condition": @"screen", @"media_query": @"(min-width: 1000px)"};
+    XCTAssertFalse([HAVisibilityEngine isConditionMet:wide withEntities:self.entities screenSize:portrait]);
+    XCTAssertTrue([HAVisibilityEngine isConditionMet:wide withEntities:self.entities screenSize:landscape]);
+
+    NSDictionary *narrowPortrait = @{@"condition": @"screen", @"media_query": @"(max-width: 800px) and (orientation: portrait)"};
+    XCTAssertTrue([HAVisibilityEngine isConditionMet:narrowPortrait withEntities:self.entities screenSize:portrait]);
+    XCTAssertFalse([HAVisibilityEngine isConditionMet:narrowPortrait withEntities:self.entities screenSize:landscape]);
+}
+
+- (void)testAndOr {
+    [self setState:@"on" forEntityId:@"light.a"];
+    [self setState:@"off" forEntityId:@"light.b"];
+    NSDictionary *a = @{@"condition": @"state", @"entity": @"light.a", @"state": @"on"};
+    NSDictionary *b = @{@"condition": @"state", @"entity": @"light.b", @"state": @"on"};
+    XCTAssertFalse([self met:@{@"condition": @"and", @"conditions": @[a, b]}]);
+    XCTAssertTrue([self met:@{@"condition": @"or", @"conditions": @[a, b]}]);
+    XCTAssertTrue([self met:@{@"condition": @"and", @"conditions": @[a, @{@"condition": @"or", @"conditions": @[b, a]}]}]);
+}
+
+- (void)testUnknownConditionIsMet {
+    XCTAssertTrue([self met:@{@"condition": @"user", @"users": @[@"abc"]}]);
+}
+
+#pragma mark - Incremental Tests
+
+- (void)testItemsWithoutConditionsAreVisible {
+    HAVisibilityEngine *engine = [[HAVisibilityEngine alloc] init];
+    HADashboardConfigItem *plain = [self item:@"light.a" conditions:nil];
+    [engine indexConfig:[self configWithItems:@[plain]]];
+    [engine evaluateWithEntities:self.entities screenSize:CGSizeMake(768, 1024)];
+    XCTAssertTrue([engine isItemVisible:plain]);
+    XCTAssertFalse([engine dependsOnEntityId:@"light.a"]);
+}
+
+- (void)testDependencyIndex {
+    HAVisibilityEngine *engine = [[HAVisibilityEngine alloc] init];
+    HADashboardConfigItem *item = [self item:@"sensor.t" conditions:@[
+        @{@"condition": @"or", @"conditions": @[
+            @{@"condition": @"state", @"entity": @"person.me", @"state": @"home"},
+            @{@"condition": @"numeric_state", @"entity": @"sensor.t", @"above": @"input_number.limit"}]}]];
+    [engine indexConfig:[self configWithItems:@[item]]];
+    XCTAssertTrue([engine dependsOnEntityId:@"person.me"]);
+    XCTAssertTrue([engine dependsOnEntityId:@"sensor.t"]);
+    XCTAssertTrue([engine dependsOnEntityId:@"input_number.limit"]);
+    XCTAssertFalse([engine dependsOnEntityId:@"light.other"]);
+}
+
+- (void)testEntityUpdateReportsExactChanges {
+    [self setState:@"off" forEntityId:@"light.a"];
+    [self setState:@"off" forEntityId:@"light.b"];
+    HADashboardConfigItem *whenA = [self item:@"sensor.1" conditions:@[@{@"entity": @"light.a", @"state": @"on"}]];
+    HADashboardConfigItem *unlessA = [self item:@"sensor.2" conditions:@[@{@"entity": @"light.a", @"state_not": @"on"}]];
+    HADashboardConfigItem *whenB = [self item:@"sensor.3" conditions:@[@{@"entity": @"light.b", @"state": @"on"}]];
+
+    HAVisibilityEngine *engine = [[HAVisibilityEngine alloc] init];
+    [engine indexConfig:[self configWithItems:@[whenA, unlessA, whenB]]];
+    [engine evaluateWithEntities:self.entities screenSize:CGSizeMake(768, 1024)];
+    XCTAssertFalse([engine isItemVisible:whenA]);
+    XCTAssertTrue([engine isItemVisible:unlessA]);
+
+    [self setState:@"on" forEntityId:@"light.a"];
+    [self setState:@"on" forEntityId:@"light.b"]; // not reported yet
+    HAVisibilityChange *change = [engine updateForEntityId:@"light.a" entities:self.entities];
+    XCTAssertEqualObjects(change.shownItems, @[whenA]);
+    XCTAssertEqualObjects(change.hiddenItems, @[unlessA]);
+    XCTAssertFalse([engine isItemVisible:whenB], @"Only items depending on light.a are re-evaluated");
+
+    change = [engine updateForEntityId:@"light.a" entities:self.entities];
+    XCTAssertFalse(change.hasChanges);
+}
+
+- (void)testScreenUpdateOnlyTouchesScreenItems {
+    [self setState:@"on" forEntityId:@"light.a"];
+    HADashboardConfigItem *wide = [self item:@"sensor.1" conditions:@[@{@"condition": @"screen", @"media_query": @"(min-width: 1000px)"}]];
+    HADashboardConfigItem *lit = [self item:@"sensor.2" conditions:@[@{@"entity": @"light.a", @"state": @"on"}]];
+
+    HAVisibilityEngine *engine = [[HAVisibilityEngine alloc] init];
+    [engine indexConfig:[self configWithItems:@[wide, lit]]];
+    [engine evaluateWithEntities:self.entities screenSize:CGSizeMake(768, 1024)];
+    XCTAssertFalse([engine isItemVisible:wide]);
+
+    [self setState:@"off" forEntityId:@"light.a"];
+    HAVisibilityChange *change = [engine updateForScreenSize:CGSizeMake(1024, 768) entities:self.entities];
+    XCTAssertEqualObjects(change.shownItems, @[wide]);
+    XCTAssertEqual(change.hiddenItems.count, 0u);
+    XCTAssertTrue([engine isItemVisible:lit]);
+}
+
+@end